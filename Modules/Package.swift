@@ -415,6 +415,11 @@ let package = Package(
             swiftSettings: [.swiftLanguageMode(.v5)]
         ),
         .testTarget(name: "WordPressReaderTests", dependencies: [.target(name: "WordPressReader")]),
+        .testTarget(
+            name: "TracksMiniTests",
+            dependencies: [.target(name: "TracksMini")],
+            swiftSettings: [.swiftLanguageMode(.v5)]
+        ),
         .testTarget(
             name: "JetpackSocialTests",
             dependencies: [
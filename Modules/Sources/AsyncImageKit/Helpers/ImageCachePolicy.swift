@@ -0,0 +1,217 @@
+import Foundation
+
+/// Determines the order in which images are evicted from ``MemoryCache`` under
+/// memory pressure: entries with the lowest priority are evicted first.
+public enum ImageCachePriority: Int, Comparable, CaseIterable, Hashable, Sendable {
+    /// Images that are cheap to re-create, e.g. prefetched thumbnails or
+    /// variants derived from a larger cached image.
+    case low
+    case normal
+    /// Images that are expensive to re-create or are likely to be on screen.
+    case high
+
+    public static func < (lhs: ImageCachePriority, rhs: ImageCachePriority) -> Bool {
+        lhs.rawValue < rhs.rawValue
+    }
+}
+
+/// Identifies a decoded image by its source and the size (in pixels) it was
+/// decoded for. The `nil` size represents the image at its original size.
+struct ImageCacheKey: Hashable, Sendable {
+    var url: String
+    var size: ImageSize?
+}
+
+/// The bookkeeping behind ``MemoryCache``.
+///
+/// The policy knows nothing about images: it tracks the cost, priority, and
+/// recency of each entry, which sizes are cached for each URL, and decides
+/// what to evict. It keeps one LRU list per priority, so all operations other
+/// than the variant lookup are O(1).
+///
+/// - warning: The type is not thread-safe.
+final class ImageCachePolicy {
+    /// The evictions target `costLimit * memoryPressureRatio` when the system
+    /// reports memory pressure.
+    static let memoryPressureRatio = 0.25
+
+    let costLimit: Int
+
+    private(set) var totalCost = 0
+
+    private var entries: [ImageCacheKey: Entry] = [:]
+    private var variants: [String: [ImageSize?]] = [:]
+    private var lists: [List]
+
+    init(costLimit: Int) {
+        self.costLimit = costLimit
+        self.lists = ImageCachePriority.allCases.map { _ in List() }
+    }
+
+    var count: Int { entries.count }
+
+    func contains(_ key: ImageCacheKey) -> Bool {
+        entries[key] != nil
+    }
+
+    func priority(for key: ImageCacheKey) -> ImageCachePriority? {
+        entries[key]?.priority
+    }
+
+    /// Registers the entry with the given cost and priority, and returns the
+    /// keys the caller must evict to stay within the cost limit. The returned
+    /// keys include `key` itself if its cost exceeds the limit.
+    @discardableResult
+    func insert(_ key: ImageCacheKey, cost: Int, priority: ImageCachePriority = .normal) -> [ImageCacheKey] {
+        remove(key)
+        guard cost <= costLimit else {
+            return [key]
+        }
+        let entry = Entry(key: key, cost: cost, priority: priority)
+        entries[key] = entry
+        variants[key.url, default: []].append(key.size)
+        lists[priority.rawValue].append(entry)
+        totalCost += cost
+        return trim(toCost: costLimit)
+    }
+
+    /// Marks the entry as recently used. Returns `false` if the entry is not
+    /// registered with the policy.
+    @discardableResult
+    func touch(_ key: ImageCacheKey) -> Bool {
+        guard let entry = entries[key] else {
+            return false
+        }
+        let list = lists[entry.priority.rawValue]
+        list.remove(entry)
+        list.append(entry)
+        return true
+    }
+
+    @discardableResult
+    func remove(_ key: ImageCacheKey) -> Bool {
+        guard let entry = entries.removeValue(forKey: key) else {
+            return false
+        }
+        lists[entry.priority.rawValue].remove(entry)
+        totalCost -= entry.cost
+        if var sizes = variants[key.url], let index = sizes.firstIndex(of: key.size) {
+            sizes.remove(at: index)
+            variants[key.url] = sizes.isEmpty ? nil : sizes
+        }
+        return true
+    }
+
+    func removeAll() {
+        entries = [:]
+        variants = [:]
+        lists = ImageCachePriority.allCases.map { _ in List() }
+        totalCost = 0
+    }
+
+    /// Returns the key of the smallest cached variant of the given URL that
+    /// can be downscaled to the given size without losing detail: the exact
+    /// match, a variant that is at least as large in both dimensions, or
+    /// the original image.
+    func bestVariant(for url: String, size: ImageSize?) -> ImageCacheKey? {
+        guard let sizes = variants[url] else {
+            return nil
+        }
+        guard let size else {
+            return sizes.contains(nil) ? ImageCacheKey(url: url, size: nil) : nil
+        }
+        var best: ImageSize?
+        var hasOriginal = false
+        for candidate in sizes {
+            guard let candidate else {
+                hasOriginal = true
+                continue
+            }
+            guard candidate.width >= size.width && candidate.height >= size.height else {
+                continue
+            }
+            if candidate == size {
+                return ImageCacheKey(url: url, size: size)
+            }
+            if best.map({ candidate.area < $0.area }) ?? true {
+                best = candidate
+            }
+        }
+        if let best {
+            return ImageCacheKey(url: url, size: best)
+        }
+        return hasOriginal ? ImageCacheKey(url: url, size: nil) : nil
+    }
+
+    /// Evicts the least recently used entries, starting with the lowest
+    /// priority, until the total cost is at or below the given cost. Entries
+    /// with a priority higher than `maxPriority` are never evicted.
+    func trim(toCost cost: Int, maxPriority: ImageCachePriority = .high) -> [ImageCacheKey] {
+        var evicted: [ImageCacheKey] = []
+        for priority in ImageCachePriority.allCases where priority <= maxPriority {
+            let list = lists[priority.rawValue]
+            while totalCost > cost, let entry = list.head {
+                remove(entry.key)
+                evicted.append(entry.key)
+            }
+        }
+        return evicted
+    }
+
+    /// Responds to memory pressure: evicts all low-priority entries, then the
+    /// least recently used remaining entries until the cache is down to
+    /// ``memoryPressureRatio`` of its cost limit.
+    func trimForMemoryPressure() -> [ImageCacheKey] {
+        trim(toCost: 0, maxPriority: .low) +
+        trim(toCost: Int(Double(costLimit) * ImageCachePolicy.memoryPressureRatio))
+    }
+}
+
+private extension ImageCachePolicy {
+    final class Entry {
+        let key: ImageCacheKey
+        let cost: Int
+        let priority: ImageCachePriority
+        weak var previous: Entry?
+        var next: Entry?
+
+        init(key: ImageCacheKey, cost: Int, priority: ImageCachePriority) {
+            self.key = key
+            self.cost = cost
+            self.priority = priority
+        }
+    }
+
+    /// A doubly linked list ordered from the least to the most recently used entry.
+    final class List {
+        private(set) var head: Entry?
+        private var tail: Entry?
+
+        func append(_ entry: Entry) {
+            entry.previous = tail
+            entry.next = nil
+            tail?.next = entry
+            tail = entry
+            if head == nil {
+                head = entry
+            }
+        }
+
+        func remove(_ entry: Entry) {
+            entry.previous?.next = entry.next
+            entry.next?.previous = entry.previous
+            if head === entry {
+                head = entry.next
+            }
+            if tail === entry {
+                tail = entry.previous
+            }
+            entry.previous = nil
+            entry.next = nil
+        }
+    }
+}
+
+private extension ImageSize {
+    var area: Int { width * height }
+}
@@ -1,4 +1,5 @@
 import UIKit
+import ImageIO
 
 public enum ImageDecoder {
     /// Returns an image created from the given URL. The image is decompressed.
@@ -20,14 +21,17 @@ public enum ImageDecoder {
 // Forces decompression (or bitmapping) to happen in the background.
 // It's very expensive for some image formats, such as JPEG.
 private func _makeImage(from data: Data, size: CGSize?) throws -> UIImage {
+    if data.isMatchingMagicNumbers(Data.gifMagicNumbers), let image = AnimatedImage(gifData: data) {
+        return image
+    }
+    if let size, let thumbnail = makeThumbnail(from: data, targetSize: size) {
+        return thumbnail
+    }
     guard let image = UIImage(data: data) else {
         throw URLError(.cannotDecodeContentData)
     }
-    if data.isMatchingMagicNumbers(Data.gifMagicNumbers) {
-        return AnimatedImage(gifData: data) ?? image
-    }
     if let size {
-        let size = aspectFillSize(imageSize: image.size.scaled(by: image.scale), targetSize: size)
+        let size = ImageDecoder.aspectFillSize(imageSize: image.size.scaled(by: image.scale), targetSize: size)
         return image.preparingThumbnail(of: size) ?? image
     }
     if isDecompressionNeeded(for: data) {
@@ -36,10 +40,40 @@ private func _makeImage(from data: Data, size: CGSize?) throws -> UIImage {
     return image
 }
 
-private func aspectFillSize(imageSize: CGSize, targetSize: CGSize) -> CGSize {
-    // Scale image to fill the target size but avoid upscaling
-    let scale = min(1, max(targetSize.width / imageSize.width, targetSize.height / imageSize.height))
-    return imageSize.scaled(by: scale).rounded()
+/// Decodes a thumbnail directly from the encoded data using `CGImageSource`,
+/// so the full-size bitmap is never created.
+private func makeThumbnail(from data: Data, targetSize: CGSize) -> UIImage? {
+    let sourceOptions = [kCGImageSourceShouldCache: false] as CFDictionary
+    guard let source = CGImageSourceCreateWithData(data as CFData, sourceOptions),
+          let properties = CGImageSourceCopyPropertiesAtIndex(source, 0, nil) as? [CFString: Any],
+          let width = properties[kCGImagePropertyPixelWidth] as? Int,
+          let height = properties[kCGImagePropertyPixelHeight] as? Int,
+          width > 0, height > 0 else {
+        return nil
+    }
+    // Orientations 5-8 (EXIF) swap the width and height of the displayed image.
+    let orientation = properties[kCGImagePropertyOrientation] as? UInt32 ?? 1
+    let imageSize = orientation >= 5 ? CGSize(width: height, height: width) : CGSize(width: width, height: height)
+    let thumbnailSize = ImageDecoder.aspectFillSize(imageSize: imageSize, targetSize: targetSize)
+    let options = [
+        kCGImageSourceCreateThumbnailFromImageAlways: true,
+        kCGImageSourceCreateThumbnailWithTransform: true,
+        kCGImageSourceShouldCacheImmediately: true,
+        kCGImageSourceThumbnailMaxPixelSize: max(thumbnailSize.width, thumbnailSize.height)
+    ] as CFDictionary
+    guard let image = CGImageSourceCreateThumbnailAtIndex(source, 0, options) else {
+        return nil
+    }
+    return UIImage(cgImage: image)
+}
+
+extension ImageDecoder {
+    /// Returns the size that fills the target size while preserving the aspect
+    /// ratio of the image. Never upscales.
+    static func aspectFillSize(imageSize: CGSize, targetSize: CGSize) -> CGSize {
+        let scale = min(1, max(targetSize.width / imageSize.width, targetSize.height / imageSize.height))
+        return imageSize.scaled(by: scale).rounded()
+    }
 }
 
 private func isDecompressionNeeded(for data: Data) -> Bool {
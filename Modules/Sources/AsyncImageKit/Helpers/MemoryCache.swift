@@ -3,29 +3,76 @@ import UIKit
 public protocol MemoryCacheProtocol: AnyObject, Sendable {
     subscript(key: String) -> UIImage? { get set }
 
+    /// Returns an image decoded for the given size (in pixels), or `nil` for
+    /// the original size.
+    func image(for imageURL: URL, size: ImageSize?) -> UIImage?
+
+    func setImage(_ image: UIImage?, for imageURL: URL, size: ImageSize?, priority: ImageCachePriority)
+
     func removeAllObjects()
 }
 
-/// - note: The type is thread-safe because it uses thread-safe `NSCache`.
+extension MemoryCacheProtocol {
+    public func image(for imageURL: URL, size: ImageSize?) -> UIImage? {
+        self[MemoryCache.makeKey(for: imageURL, size: size)]
+    }
+
+    public func setImage(_ image: UIImage?, for imageURL: URL, size: ImageSize?, priority: ImageCachePriority) {
+        self[MemoryCache.makeKey(for: imageURL, size: size)] = image
+    }
+}
+
+/// A memory cache for decoded images.
+///
+/// Images are stored per URL and target pixel size. If the requested size is
+/// not cached, but a larger variant of the same image is, the cache returns
+/// the larger variant instead of making the caller decode the image again,
+/// and stores a downscaled copy of it in the background for the next reads.
+/// On memory warning, the cache evicts the entries by priority instead of
+/// removing everything (see ``ImageCachePolicy``).
+///
+/// - note: The type is thread-safe.
 public final class MemoryCache: MemoryCacheProtocol, @unchecked Sendable {
 
     /// A shared image cache used by the entire system.
     public static let shared = MemoryCache()
 
-    private let cache = NSCache<NSString, AnyObject>()
+    private let lock = NSLock()
+    private let policy: ImageCachePolicy
+    private var objects: [ImageCacheKey: AnyObject] = [:]
+    private var pendingResizes: Set<ImageCacheKey> = []
+    private let resizeQueue = DispatchQueue(label: "org.wordpress.async-image-kit.memory-cache", qos: .utility)
 
-    private init() {
-        self.cache.totalCostLimit = 256_000_000 // 256 MB
+    /// - parameter costLimit: The maximum total cost (in bytes) of the
+    /// objects the cache holds. By default, 256 MB.
+    public init(costLimit: Int = 256_000_000) {
+        self.policy = ImageCachePolicy(costLimit: costLimit)
 
         NotificationCenter.default.addObserver(self, selector: #selector(didReceiveMemoryWarning), name: UIApplication.didReceiveMemoryWarningNotification, object: nil)
     }
 
     @objc private func didReceiveMemoryWarning() {
-        cache.removeAllObjects()
+        trimForMemoryPressure()
+    }
+
+    /// Evicts the low-priority and least recently used images, leaving only
+    /// a fraction of the cost limit in use.
+    public func trimForMemoryPressure() {
+        lock.withLock {
+            remove(policy.trimForMemoryPressure())
+        }
     }
 
     public func removeAllObjects() {
-        cache.removeAllObjects()
+        lock.withLock {
+            objects.removeAll()
+            policy.removeAll()
+        }
+    }
+
+    /// The total cost of the objects currently in the cache.
+    public var totalCost: Int {
+        lock.withLock { policy.totalCost }
     }
 
     // MARK: - UIImage
@@ -44,29 +91,115 @@ public final class MemoryCache: MemoryCacheProtocol, @unchecked Sendable {
     }
 
     public func setImage(_ image: UIImage, forKey key: String) {
-        cache.setObject(image, forKey: key as NSString, cost: image.cost)
+        setObject(image, for: ImageCacheKey(url: key, size: nil), cost: image.cost, priority: .normal)
     }
 
     public func getImage(forKey key: String) -> UIImage? {
-        cache.object(forKey: key as NSString) as? UIImage
+        object(for: ImageCacheKey(url: key, size: nil)) as? UIImage
     }
 
     public func removeImage(forKey key: String) {
-        cache.removeObject(forKey: key as NSString)
+        removeObject(for: ImageCacheKey(url: key, size: nil))
+    }
+
+    public func image(for imageURL: URL, size: ImageSize?) -> UIImage? {
+        let key = ImageCacheKey(url: imageURL.absoluteString, size: size)
+        let (image, needsResize) = lock.withLock { () -> (UIImage?, Bool) in
+            guard let variant = policy.bestVariant(for: key.url, size: size),
+                  let image = objects[variant] as? UIImage else {
+                return (nil, false)
+            }
+            policy.touch(variant)
+            let needsResize = variant != key && !(image is AnimatedImage) && pendingResizes.insert(key).inserted
+            return (image, needsResize)
+        }
+        if let image, let size, needsResize {
+            // The callers read the cache on the main thread, so the larger
+            // variant is returned as is and downscaled in the background.
+            resize(image, to: size, for: key)
+        }
+        return image
+    }
+
+    public func setImage(_ image: UIImage?, for imageURL: URL, size: ImageSize?, priority: ImageCachePriority = .normal) {
+        let key = ImageCacheKey(url: imageURL.absoluteString, size: size)
+        if let image {
+            setObject(image, for: key, cost: image.cost, priority: priority)
+        } else {
+            removeObject(for: key)
+        }
     }
 
     // MARK: - Data
 
     public func setData(_ data: Data, forKey key: String) {
-        cache.setObject(data as NSData, forKey: key as NSString, cost: data.count)
+        setObject(data as NSData, for: ImageCacheKey(url: key, size: nil), cost: data.count, priority: .normal)
     }
 
     public func geData(forKey key: String) -> Data? {
-        cache.object(forKey: key as NSString) as? Data
+        object(for: ImageCacheKey(url: key, size: nil)) as? Data
     }
 
     public func removeData(forKey key: String) {
-        cache.removeObject(forKey: key as NSString)
+        removeObject(for: ImageCacheKey(url: key, size: nil))
+    }
+
+    /// Waits for the downscaled variants that are being created.
+    func waitForPendingResizes() {
+        resizeQueue.sync {}
+    }
+
+    // MARK: - Private
+
+    /// Stores a downscaled copy of the image with a low priority because it
+    /// can be cheaply re-created from the larger variant.
+    private func resize(_ image: UIImage, to size: ImageSize, for key: ImageCacheKey) {
+        resizeQueue.async { [self] in
+            let thumbnail = image.preparingThumbnail(of: ImageDecoder.aspectFillSize(imageSize: image.pixelSize, targetSize: CGSize(size)))
+            lock.withLock {
+                pendingResizes.remove(key)
+                // Don't replace an image stored by the caller in the meantime.
+                if let thumbnail, objects[key] == nil {
+                    objects[key] = thumbnail
+                    remove(policy.insert(key, cost: thumbnail.cost, priority: .low))
+                }
+            }
+        }
+    }
+
+    private func object(for key: ImageCacheKey) -> AnyObject? {
+        lock.withLock {
+            guard let object = objects[key] else {
+                return nil
+            }
+            policy.touch(key)
+            return object
+        }
+    }
+
+    private func setObject(_ object: AnyObject, for key: ImageCacheKey, cost: Int, priority: ImageCachePriority) {
+        lock.withLock {
+            objects[key] = object
+            remove(policy.insert(key, cost: cost, priority: priority))
+        }
+    }
+
+    private func removeObject(for key: ImageCacheKey) {
+        lock.withLock {
+            objects[key] = nil
+            policy.remove(key)
+        }
+    }
+
+    /// - note: Must be called with the lock held.
+    private func remove(_ keys: [ImageCacheKey]) {
+        for key in keys {
+            objects[key] = nil
+        }
+    }
+
+    static func makeKey(for imageURL: URL, size: ImageSize?) -> String {
+        imageURL.absoluteString + (size.map { "?w=\($0.width),h=\($0.height)" } ?? "")
     }
 }
 
@@ -77,4 +210,8 @@ private extension UIImage {
         let imageCost = cgImage.map { $0.bytesPerRow * $0.height } ?? 0
         return dataCost + imageCost
     }
+
+    var pixelSize: CGSize {
+        cgImage.map { CGSize(width: $0.width, height: $0.height) } ?? size.scaled(by: scale)
+    }
 }
@@ -41,7 +41,7 @@ public final class ImageDownloader {
         let options = request.options
         let key = makeKey(for: request.source.url, size: options.size)
 
-        if let cachedImage = try self.fetch(key, options: request.options) {
+        if let cachedImage = try self.fetch(key, for: request) {
             return cachedImage
         }
 
@@ -56,7 +56,7 @@ public final class ImageDownloader {
             let result = try await generator.image(at: .zero)
             let image = UIImage(cgImage: result.image)
 
-            try store(image, for: key, options: options)
+            try store(image, for: key, request: request)
 
             return image
         }
@@ -64,7 +64,7 @@ public final class ImageDownloader {
         let data = try await data(for: request)
         let image = try await ImageDecoder.makeImage(from: data, size: options.size.map(CGSize.init))
 
-        try store(image, for: key, options: options)
+        try store(image, for: key, request: request)
 
         return image
     }
@@ -104,12 +104,16 @@ public final class ImageDownloader {
     ///
     /// - note: Use it to retrieve the image synchronously, which is no not possible
     /// with the async functions.
+    ///
+    /// If the image is not cached at the given size, but a larger variant of
+    /// it is, returns the larger variant. The downscaled variant is cached in
+    /// the background for the next calls.
     nonisolated public func cachedImage(for imageURL: URL, size: ImageSize? = nil) -> UIImage? {
-        cache[makeKey(for: imageURL, size: size)]
+        cache.image(for: imageURL, size: size)
     }
 
-    nonisolated public func setCachedImage(_ image: UIImage?, for imageURL: URL, size: ImageSize? = nil) {
-        cache[makeKey(for: imageURL, size: size)] = image
+    nonisolated public func setCachedImage(_ image: UIImage?, for imageURL: URL, size: ImageSize? = nil, priority: ImageCachePriority = .normal) {
+        cache.setImage(image, for: imageURL, size: size, priority: priority)
     }
 
     private nonisolated func makeKey(for imageURL: URL?, size: ImageSize?) -> String {
@@ -117,7 +121,7 @@ public final class ImageDownloader {
             assertionFailure("The request.url was nil") // This should never happen
             return ""
         }
-        return imageURL.absoluteString + (size.map { "?w=\($0.width),h=\($0.height)" } ?? "")
+        return MemoryCache.makeKey(for: imageURL, size: size)
     }
 
     /// The current disk usage of the URL cache, in bytes.
@@ -184,9 +188,10 @@ public final class ImageDownloader {
     }
 
     // MARK: Manual caching
-    private func fetch(_ key: String, options: ImageRequestOptions) throws -> UIImage? {
+    private func fetch(_ key: String, for request: ImageRequest) throws -> UIImage? {
+        let options = request.options
 
-        if options.isMemoryCacheEnabled, let image = cache[key] {
+        if options.isMemoryCacheEnabled, let url = request.source.url, let image = cache.image(for: url, size: options.size) {
             return image
         }
 
@@ -204,10 +209,11 @@ public final class ImageDownloader {
         return UIImage(data: pngData)
     }
 
-    private func store(_ image: UIImage, for key: String, options: ImageRequestOptions) throws {
+    private func store(_ image: UIImage, for key: String, request: ImageRequest) throws {
+        let options = request.options
 
-        if options.isMemoryCacheEnabled {
-            cache[key] = image
+        if options.isMemoryCacheEnabled, let url = request.source.url {
+            cache.setImage(image, for: url, size: options.size, priority: options.memoryCachePriority)
         }
 
         // If the image is immutable, store it in the disk cache "forever"
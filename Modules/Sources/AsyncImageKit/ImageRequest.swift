@@ -72,6 +72,10 @@ public struct ImageRequestOptions: Hashable, Sendable {
     /// If enabled, uses ``MemoryCache`` for caching decompressed images.
     public var isMemoryCacheEnabled = true
 
+    /// The priority of the decoded image in ``MemoryCache``. Under memory
+    /// pressure, lower-priority images are evicted first. By default, `.normal`.
+    public var memoryCachePriority: ImageCachePriority = .normal
+
     /// If enabled, uses `URLSession` preconfigured with a custom `URLCache`
     /// with a relatively high disk capacity. By default, `true`.
     public var isDiskCacheEnabled = true
@@ -89,12 +93,14 @@ public struct ImageRequestOptions: Hashable, Sendable {
         size: ImageSize? = nil,
         isMemoryCacheEnabled: Bool = true,
         isDiskCacheEnabled: Bool = true,
-        mutability: ResourceMutability = .mutable
+        mutability: ResourceMutability = .mutable,
+        memoryCachePriority: ImageCachePriority = .normal
     ) {
         self.size = size
         self.isMemoryCacheEnabled = isMemoryCacheEnabled
         self.isDiskCacheEnabled = isDiskCacheEnabled
         self.mutability = mutability
+        self.memoryCachePriority = memoryCachePriority
     }
 }
 
@@ -12,14 +12,21 @@ extension NSMutableAttributedString {
         guard let attributes else {
             return
         }
-        let rawString = self.string
+        NSAttributedString.quoteRanges(in: self.string).forEach {
+            self.addAttributes(attributes, range: $0)
+        }
+    }
+}
+
+extension NSAttributedString {
+
+    /// Returns the ranges of the quoted substrings, matched by their first occurrence in the string.
+    ///
+    static func quoteRanges(in rawString: String) -> [NSRange] {
         let scanner = Scanner(string: rawString)
         let quotes = scanner.scanQuotedText()
-        quotes.forEach {
-            if let itemRange = rawString.range(of: $0) {
-                let range = NSRange(itemRange, in: rawString)
-                self.addAttributes(attributes, range: range)
-            }
+        return quotes.compactMap {
+            rawString.range(of: $0).map { NSRange($0, in: rawString) }
         }
     }
 }
@@ -7,7 +7,17 @@ public class FormattableContentFormatter {
     ///
     fileprivate var dynamicAttributesCache = [String: AnyObject]()
 
-    public init() {}
+    /// The render plans outlive the rendered strings: they are kept when the cache is reset.
+    ///
+    private let planCache: FormattableContentRenderPlanCache
+
+    public init() {
+        self.planCache = .shared
+    }
+
+    init(planCache: FormattableContentRenderPlanCache) {
+        self.planCache = planCache
+    }
 
     public func render(content: FormattableContent, with styles: FormattableContentStyles) -> NSAttributedString {
         let attributedText = memoize {
@@ -62,12 +72,21 @@ public class FormattableContentFormatter {
     }
 
     private func text(from content: FormattableContent, with styles: FormattableContentStyles) -> NSAttributedString {
+        if let plan = planCache.plan(for: content) {
+            return plan.render(with: styles)
+        }
+        return sequentialText(from: content, with: styles)
+    }
+
+    /// Applies the ranges one at a time. Used for the ranges that can't be compiled into a render plan.
+    ///
+    func sequentialText(from content: FormattableContent, with styles: FormattableContentStyles) -> NSAttributedString {
 
         guard let text = content.text else {
             return NSAttributedString()
         }
 
-        let tightenedText = replaceCommonWhitespaceIssues(in: text)
+        let tightenedText = Self.replaceCommonWhitespaceIssues(in: text)
         let theString = NSMutableAttributedString(string: tightenedText, attributes: styles.attributes)
 
         if let quoteStyles = styles.quoteStyles {
@@ -89,7 +108,7 @@ public class FormattableContentFormatter {
     /// - Parameter baseString: string of the comment body before attributes are added
     /// - Returns: string of same length
     /// - Note: the length must be maintained or the formatting will break
-    private func replaceCommonWhitespaceIssues(in baseString: String) -> String {
+    static func replaceCommonWhitespaceIssues(in baseString: String) -> String {
         var newString: String
         // \u{200A} = hairline space (very skinny space).
         // we use these so that the ranges are still in the right position, but the extra space basically disappears
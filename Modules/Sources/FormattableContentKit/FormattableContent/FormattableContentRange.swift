@@ -50,6 +50,15 @@ public extension FormattableContentRange where Self: LinkContentRange {
     }
 }
 
+/// A range whose effect on the text is known without applying it, so that the ranges of a content can be
+/// compiled into a render plan. The range applies the style of its kind, and the link styles when it is a
+/// `LinkContentRange`, after inserting `insertedText` if any.
+///
+public protocol PlannableContentRange: FormattableContentRange {
+    /// The text inserted at the location of the range, or nil if the range only styles the text.
+    var insertedText: String? { get }
+}
+
 public protocol LinkContentRange {
     var url: URL? { get }
     func applyURLStyles(_ styles: FormattableContentStyles, to string: NSMutableAttributedString, shiftedRange: NSRange)
@@ -0,0 +1,208 @@
+import Foundation
+
+/// The text of a FormattableContent with all of its ranges resolved: the noticons are inserted, the
+/// shifts they cause are applied, and the styled runs are expressed in the coordinates of the final text.
+///
+/// The plan doesn't depend on the styles, so it is compiled once per content and rendered with
+/// whichever styles the content is displayed with.
+struct FormattableContentRenderPlan {
+    enum Style {
+        case quote
+        case range(FormattableRangeKind)
+        case link(URL)
+    }
+
+    struct Run {
+        var range: NSRange
+        let style: Style
+    }
+
+    /// The text of the content the plan was compiled from.
+    let sourceText: String
+    /// The text to render, with the noticons inserted.
+    let text: String
+    /// The styled runs, in the order they are applied: the attributes of a run override the ones of
+    /// the runs before it.
+    let runs: [Run]
+
+    /// Returns `nil` if a range of the content can't be compiled, in which case the ranges have to be
+    /// applied one at a time.
+    static func compile(_ content: FormattableContent) -> FormattableContentRenderPlan? {
+        guard let sourceText = content.text else {
+            return nil
+        }
+        let ranges = content.ranges.compactMap { $0 as? PlannableContentRange }
+        guard ranges.count == content.ranges.count else {
+            return nil
+        }
+
+        let text = NSMutableString(string: FormattableContentFormatter.replaceCommonWhitespaceIssues(in: sourceText))
+        var runs = NSAttributedString.quoteRanges(in: text as String).map {
+            Run(range: $0, style: .quote)
+        }
+        func append(_ range: NSRange, _ style: Style) {
+            // Empty runs have no effect, not even on the characters inserted next to them.
+            if range.length > 0 {
+                runs.append(Run(range: range, style: style))
+            }
+        }
+
+        var shift = 0
+        for range in ranges {
+            let location = range.range.location + shift
+
+            if let insertedText = range.insertedText {
+                // Replacing the characters covered by the range would change the runs in ways
+                // that aren't worth replicating.
+                guard range.range.length == 0, location <= text.length else {
+                    return nil
+                }
+                let insertedLength = (insertedText as NSString).length
+                text.insert(insertedText, at: location)
+                runs = runs.map { $0.inserting(insertedLength, at: location) }
+                append(NSRange(location: location, length: insertedText.count), .range(range.kind))
+                shift += insertedText.count
+                continue
+            }
+
+            // Don't style past the end of the text.
+            guard location <= text.length else {
+                continue
+            }
+            let styledRange = NSRange(location: location, length: min(range.range.length, text.length - location))
+            append(styledRange, .range(range.kind))
+            if let url = (range as? LinkContentRange)?.url {
+                append(styledRange, .link(url))
+            }
+        }
+
+        return FormattableContentRenderPlan(sourceText: sourceText, text: text as String, runs: runs)
+    }
+
+    /// Builds the attributed text in a single pass: the text is split at the boundaries of the runs,
+    /// and each piece gets the combined attributes of the runs covering it.
+    func render(with styles: FormattableContentStyles) -> NSAttributedString {
+        let styledRuns = runs.compactMap { run -> (NSRange, [NSAttributedString.Key: Any])? in
+            attributes(for: run.style, with: styles).map { (run.range, $0) }
+        }
+        guard !styledRuns.isEmpty else {
+            return NSAttributedString(string: text, attributes: styles.attributes)
+        }
+
+        let length = (text as NSString).length
+        var boundaries = Set([0, length])
+        for (range, _) in styledRuns {
+            boundaries.insert(range.location)
+            boundaries.insert(range.upperBound)
+        }
+        let sortedBoundaries = boundaries.sorted()
+
+        let string = NSMutableAttributedString(string: text)
+        string.beginEditing()
+        for (start, end) in zip(sortedBoundaries, sortedBoundaries.dropFirst()) {
+            var attributes = styles.attributes
+            for (range, runAttributes) in styledRuns where range.location <= start && end <= range.upperBound {
+                attributes.merge(runAttributes) { _, new in new }
+            }
+            string.setAttributes(attributes, range: NSRange(location: start, length: end - start))
+        }
+        string.endEditing()
+        return string
+    }
+
+    private func attributes(for style: Style, with styles: FormattableContentStyles) -> [NSAttributedString.Key: Any]? {
+        switch style {
+        case .quote:
+            return styles.quoteStyles
+        case .range(let kind):
+            return styles.rangeStylesMap?[kind]
+        case .link(let url):
+            guard let linksColor = styles.linksColor else {
+                return nil
+            }
+            return [.link: url, .foregroundColor: linksColor]
+        }
+    }
+}
+
+private extension FormattableContentRenderPlan.Run {
+    /// Moves the run the way `NSMutableAttributedString` does when characters are inserted: the new
+    /// characters take the attributes of the character before them, or of the first character when
+    /// they are inserted at the start of the text.
+    func inserting(_ length: Int, at location: Int) -> FormattableContentRenderPlan.Run {
+        var run = self
+        let inheritsAttributes = location > 0
+            ? range.location < location && location <= range.upperBound
+            : range.location == 0
+        if inheritsAttributes {
+            run.range.length += length
+        } else if location <= range.location {
+            run.range.location += length
+        }
+        return run
+    }
+}
+
+/// A bounded cache of the render plans, keyed by the text and the ranges of the content.
+///
+/// The cache is shared by all the formatters, and isn't cleared by `FormattableContentFormatter.resetCache()`:
+/// the plans don't depend on the styles, so they remain valid when the content is rendered again.
+/// Content that can't be compiled is cached too, so that it isn't compiled again on every render.
+final class FormattableContentRenderPlanCache {
+    static let shared = FormattableContentRenderPlanCache()
+
+    private final class Entry {
+        let sourceText: String
+        /// `nil` if the content can't be compiled.
+        let plan: FormattableContentRenderPlan?
+
+        init(sourceText: String, plan: FormattableContentRenderPlan?) {
+            self.sourceText = sourceText
+            self.plan = plan
+        }
+    }
+
+    private let cache = NSCache<NSNumber, Entry>()
+
+    init(countLimit: Int = 500) {
+        cache.countLimit = countLimit
+    }
+
+    /// Returns the cached plan for the content, compiling it on a miss.
+    func plan(for content: FormattableContent) -> FormattableContentRenderPlan? {
+        guard let text = content.text else {
+            return nil
+        }
+        let key = NSNumber(value: Self.key(for: content))
+        if let entry = cache.object(forKey: key), entry.sourceText == text {
+            return entry.plan
+        }
+        let plan = FormattableContentRenderPlan.compile(content)
+        cache.setObject(Entry(sourceText: text, plan: plan), forKey: key)
+        return plan
+    }
+
+    /// Returns `true` if the content was compiled already, whether or not it resulted in a plan.
+    func containsResult(for content: FormattableContent) -> Bool {
+        let entry = cache.object(forKey: NSNumber(value: Self.key(for: content)))
+        return entry != nil && entry?.sourceText == content.text
+    }
+
+    func removeAll() {
+        cache.removeAllObjects()
+    }
+
+    private static func key(for content: FormattableContent) -> Int {
+        var hasher = Hasher()
+        hasher.combine(content.text)
+        for range in content.ranges {
+            hasher.combine(ObjectIdentifier(type(of: range)))
+            hasher.combine(range.kind)
+            hasher.combine(range.range.location)
+            hasher.combine(range.range.length)
+            hasher.combine((range as? LinkContentRange)?.url)
+            hasher.combine((range as? PlannableContentRange)?.insertedText)
+        }
+        return hasher.finalize()
+    }
+}
@@ -3,7 +3,7 @@ import Foundation
 /// This class is used as part of the Notification Formattable Content system.
 /// It inserts the given icon into an attributed string at the given range.
 ///
-public class FormattableNoticonRange: FormattableContentRange {
+public class FormattableNoticonRange: PlannableContentRange {
     public var kind: FormattableRangeKind = .noticon
     public var range: NSRange
     public let value: String
@@ -12,6 +12,10 @@ public class FormattableNoticonRange: FormattableContentRange {
         return value + " "
     }
 
+    public var insertedText: String? {
+        return noticon
+    }
+
     public init(value: String, range: NSRange) {
         self.value = value
         self.range = range
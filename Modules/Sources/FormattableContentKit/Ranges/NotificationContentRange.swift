@@ -1,6 +1,6 @@
 import Foundation
 
-public class NotificationContentRange: FormattableContentRange, LinkContentRange {
+public class NotificationContentRange: PlannableContentRange, LinkContentRange {
     public let kind: FormattableRangeKind
     public let range: NSRange
 
@@ -17,6 +17,10 @@ public class NotificationContentRange: FormattableContentRange, LinkContentRange
         userID = properties.userID
         postID = properties.postID
     }
+
+    public var insertedText: String? {
+        return nil
+    }
 }
 
 extension NotificationContentRange {
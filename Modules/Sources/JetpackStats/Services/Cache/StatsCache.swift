@@ -0,0 +1,219 @@
+import Foundation
+
+/// A key that can be used with ``StatsCache``.
+protocol StatsCacheKey: Hashable, Sendable {
+    /// A stable identifier used as a file name when the entry is persisted.
+    var storageKey: String { get }
+}
+
+/// A bounded cache for stats responses.
+///
+/// - Concurrent requests for the same key share a single in-flight fetch.
+/// - Entries are evicted in the least-recently-used order once their total
+///   cost exceeds `costLimit`.
+/// - Entries that never expire (historical periods) are written to `storage`,
+///   so they are available immediately on the next launch.
+/// - Expired entries (current period) are returned as is while the refresh
+///   runs in the background, unless they are older than `maxStaleness`.
+actor StatsCache<Key: StatsCacheKey, Value: Sendable> {
+    let costLimit: Int
+    private let maxStaleness: TimeInterval
+    private let cost: @Sendable (Value) -> Int
+    private let storage: (any StatsCacheStorage<Value>)?
+    private let now: @Sendable () -> Date
+
+    private var entries: [Key: Entry] = [:]
+    private var totalCost = 0
+    private var inflight: [Key: Task<Value, Error>] = [:]
+
+    /// The most recently used entry.
+    private var head: Entry?
+    /// The least recently used entry.
+    private var tail: Entry?
+
+    init(
+        costLimit: Int,
+        maxStaleness: TimeInterval = 300,
+        storage: (any StatsCacheStorage<Value>)? = nil,
+        now: @escaping @Sendable () -> Date = Date.init,
+        cost: @escaping @Sendable (Value) -> Int
+    ) {
+        self.costLimit = costLimit
+        self.maxStaleness = maxStaleness
+        self.storage = storage
+        self.now = now
+        self.cost = cost
+    }
+
+    /// Returns the cached value for the given key or fetches it using the
+    /// given closure.
+    ///
+    /// - parameter ttl: The time to live for the fetched value. Pass `nil`
+    /// for the values that never change (historical periods).
+    func value(
+        for key: Key,
+        ttl: TimeInterval?,
+        fetch: @escaping @Sendable () async throws -> Value
+    ) async throws -> Value {
+        var entry = entries[key]
+        if entry == nil {
+            entry = await restoreEntry(for: key)
+        }
+        if let entry {
+            moveToFront(entry)
+            guard let entryTTL = entry.ttl else {
+                return entry.value
+            }
+            let age = now().timeIntervalSince(entry.timestamp)
+            if age <= entryTTL {
+                return entry.value
+            }
+            if age <= entryTTL + maxStaleness {
+                refresh(key, ttl: ttl, fetch: fetch)
+                return entry.value
+            }
+        }
+        return try await refresh(key, ttl: ttl, fetch: fetch).value
+    }
+
+    /// Returns the cached value without fetching or updating the recency.
+    func cachedValue(for key: Key) -> Value? {
+        entries[key]?.value
+    }
+
+    var count: Int {
+        entries.count
+    }
+
+    var currentCost: Int {
+        totalCost
+    }
+
+    func removeAll() {
+        entries.removeAll()
+        head = nil
+        tail = nil
+        totalCost = 0
+    }
+
+    // MARK: - Private
+
+    @discardableResult
+    private func refresh(
+        _ key: Key,
+        ttl: TimeInterval?,
+        fetch: @escaping @Sendable () async throws -> Value
+    ) -> Task<Value, Error> {
+        if let task = inflight[key] {
+            return task
+        }
+        // The task is isolated to the actor, so it can't start before it's
+        // registered as in-flight.
+        let task = Task<Value, Error> {
+            defer { inflight[key] = nil }
+            let value = try await fetch()
+            insert(value, for: key, ttl: ttl)
+            if ttl == nil, let storage {
+                // The value is already served from memory while it's written.
+                let storageKey = key.storageKey
+                await Task.detached(priority: .utility) {
+                    storage.setValue(value, forKey: storageKey)
+                }.value
+            }
+            return value
+        }
+        inflight[key] = task
+        return task
+    }
+
+    /// Reads the entry from `storage` without blocking the actor: the other
+    /// keys are served while the file is being decoded.
+    private func restoreEntry(for key: Key) async -> Entry? {
+        guard let storage else {
+            return nil
+        }
+        let storageKey = key.storageKey
+        let value = await Task.detached(priority: .userInitiated) {
+            storage.value(forKey: storageKey)
+        }.value
+        // The actor is reentrant, so the key could've been fetched in the meantime.
+        if let entry = entries[key] {
+            return entry
+        }
+        guard let value else {
+            return nil
+        }
+        return insert(value, for: key, ttl: nil)
+    }
+
+    @discardableResult
+    private func insert(_ value: Value, for key: Key, ttl: TimeInterval?) -> Entry {
+        if let existing = entries[key] {
+            unlink(existing)
+            totalCost -= existing.cost
+        }
+        let entry = Entry(key: key, value: value, timestamp: now(), ttl: ttl, cost: max(1, cost(value)))
+        entries[key] = entry
+        totalCost += entry.cost
+        linkAtFront(entry)
+        evictIfNeeded()
+        return entry
+    }
+
+    private func evictIfNeeded() {
+        // Never evict the most recently inserted entry, even if it alone
+        // exceeds the limit.
+        while totalCost > costLimit, let entry = tail, entry !== head {
+            unlink(entry)
+            entries[entry.key] = nil
+            totalCost -= entry.cost
+        }
+    }
+
+    private func moveToFront(_ entry: Entry) {
+        guard entry !== head else { return }
+        unlink(entry)
+        linkAtFront(entry)
+    }
+
+    private func linkAtFront(_ entry: Entry) {
+        entry.next = head
+        head?.previous = entry
+        head = entry
+        if tail == nil {
+            tail = entry
+        }
+    }
+
+    private func unlink(_ entry: Entry) {
+        entry.previous?.next = entry.next
+        entry.next?.previous = entry.previous
+        if head === entry {
+            head = entry.next
+        }
+        if tail === entry {
+            tail = entry.previous
+        }
+        entry.previous = nil
+        entry.next = nil
+    }
+
+    private final class Entry {
+        let key: Key
+        let value: Value
+        let timestamp: Date
+        let ttl: TimeInterval?
+        let cost: Int
+
+        weak var previous: Entry?
+        var next: Entry?
+
+        init(key: Key, value: Value, timestamp: Date, ttl: TimeInterval?, cost: Int) {
+            self.key = key
+            self.value = value
+            self.timestamp = timestamp
+            self.ttl = ttl
+            self.cost = cost
+        }
+    }
+}
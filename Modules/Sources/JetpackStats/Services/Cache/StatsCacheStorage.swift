@@ -0,0 +1,182 @@
+import Foundation
+
+/// Persists the cached stats responses across launches.
+protocol StatsCacheStorage<Value>: Sendable {
+    associatedtype Value: Sendable
+
+    func value(forKey key: String) -> Value?
+    func setValue(_ value: Value, forKey key: String)
+    func removeAll()
+}
+
+/// A value that can be stored using ``StatsCacheRecord``.
+protocol StatsCachePersistable: Sendable {
+    init(record: StatsCacheRecord)
+    var record: StatsCacheRecord { get }
+}
+
+/// A compact representation of a time series response.
+///
+/// The data points are stored as flat arrays of interleaved dates (seconds
+/// since the reference date) and values to keep the archives small and
+/// fast to decode.
+struct StatsCacheRecord: Codable, Sendable {
+    static let currentVersion = 1
+
+    var version = StatsCacheRecord.currentVersion
+    var total: [String: Int] = [:]
+    var metrics: [String: [Int64]] = [:]
+
+    static func encode(_ dataPoints: [DataPoint]) -> [Int64] {
+        var output: [Int64] = []
+        output.reserveCapacity(dataPoints.count * 2)
+        for dataPoint in dataPoints {
+            output.append(Int64(dataPoint.date.timeIntervalSinceReferenceDate))
+            output.append(Int64(dataPoint.value))
+        }
+        return output
+    }
+
+    static func decode(_ values: [Int64]) -> [DataPoint] {
+        stride(from: 0, to: values.count - 1, by: 2).map {
+            DataPoint(
+                date: Date(timeIntervalSinceReferenceDate: TimeInterval(values[$0])),
+                value: Int(values[$0 + 1])
+            )
+        }
+    }
+}
+
+/// Stores ``StatsCacheRecord`` values as binary property lists, one file
+/// per key.
+///
+/// Once the files take more than `sizeLimit` bytes, the least recently
+/// written ones are removed.
+struct StatsDiskCacheStorage<Value: StatsCachePersistable>: StatsCacheStorage {
+    let directoryURL: URL
+    let sizeLimit: Int
+
+    init(directoryURL: URL, sizeLimit: Int = 10 * 1024 * 1024) {
+        self.directoryURL = directoryURL
+        self.sizeLimit = sizeLimit
+    }
+
+    func value(forKey key: String) -> Value? {
+        let fileURL = makeFileURL(forKey: key)
+        guard let data = try? Data(contentsOf: fileURL) else {
+            return nil
+        }
+        guard let record = try? PropertyListDecoder().decode(StatsCacheRecord.self, from: data),
+              record.version == StatsCacheRecord.currentVersion else {
+            try? FileManager.default.removeItem(at: fileURL)
+            return nil
+        }
+        return Value(record: record)
+    }
+
+    func setValue(_ value: Value, forKey key: String) {
+        let encoder = PropertyListEncoder()
+        encoder.outputFormat = .binary
+        guard let data = try? encoder.encode(value.record) else {
+            return
+        }
+        // The cache is best-effort: if the write fails, the data is fetched again.
+        try? FileManager.default.createDirectory(at: directoryURL, withIntermediateDirectories: true)
+        try? data.write(to: makeFileURL(forKey: key), options: .atomic)
+        removeOldestFilesIfNeeded()
+    }
+
+    func removeAll() {
+        try? FileManager.default.removeItem(at: directoryURL)
+    }
+
+    private func removeOldestFilesIfNeeded() {
+        let keys: [URLResourceKey] = [.fileSizeKey, .contentModificationDateKey]
+        guard let fileURLs = try? FileManager.default.contentsOfDirectory(
+            at: directoryURL,
+            includingPropertiesForKeys: keys,
+            options: .skipsHiddenFiles
+        ) else {
+            return
+        }
+        var files = fileURLs.compactMap { fileURL -> (url: URL, size: Int, date: Date)? in
+            guard let values = try? fileURL.resourceValues(forKeys: Set(keys)) else {
+                return nil
+            }
+            return (fileURL, values.fileSize ?? 0, values.contentModificationDate ?? .distantPast)
+        }
+        var totalSize = files.reduce(0) { $0 + $1.size }
+        guard totalSize > sizeLimit else {
+            return
+        }
+        files.sort { $0.date < $1.date }
+        for file in files where totalSize > sizeLimit {
+            try? FileManager.default.removeItem(at: file.url)
+            totalSize -= file.size
+        }
+    }
+
+    private func makeFileURL(forKey key: String) -> URL {
+        directoryURL.appendingPathComponent(key, isDirectory: false).appendingPathExtension("plist")
+    }
+}
+
+// MARK: - StatsCachePersistable
+
+extension SiteMetricsResponse: StatsCachePersistable {
+    init(record: StatsCacheRecord) {
+        var total = SiteMetricsSet()
+        for (key, value) in record.total {
+            if let metric = SiteMetric(rawValue: key) {
+                total[metric] = value
+            }
+        }
+        var metrics: [SiteMetric: [DataPoint]] = [:]
+        for (key, values) in record.metrics {
+            if let metric = SiteMetric(rawValue: key) {
+                metrics[metric] = StatsCacheRecord.decode(values)
+            }
+        }
+        self.init(total: total, metrics: metrics)
+    }
+
+    var record: StatsCacheRecord {
+        var record = StatsCacheRecord()
+        for metric in SiteMetric.allCases {
+            if let value = total[metric] {
+                record.total[metric.rawValue] = value
+            }
+        }
+        for (metric, dataPoints) in metrics {
+            record.metrics[metric.rawValue] = StatsCacheRecord.encode(dataPoints)
+        }
+        return record
+    }
+}
+
+extension WordAdsMetricsResponse: StatsCachePersistable {
+    init(record: StatsCacheRecord) {
+        var total = WordAdsMetricsSet()
+        var metrics: [WordAdsMetric: [DataPoint]] = [:]
+        for metric in WordAdsMetric.allMetrics {
+            total[metric] = record.total[metric.id]
+            if let values = record.metrics[metric.id] {
+                metrics[metric] = StatsCacheRecord.decode(values)
+            }
+        }
+        self.init(total: total, metrics: metrics)
+    }
+
+    var record: StatsCacheRecord {
+        var record = StatsCacheRecord()
+        for metric in WordAdsMetric.allMetrics {
+            if let value = total[metric] {
+                record.total[metric.id] = value
+            }
+        }
+        for (metric, dataPoints) in metrics {
+            record.metrics[metric.id] = StatsCacheRecord.encode(dataPoints)
+        }
+        return record
+    }
+}
@@ -16,9 +16,9 @@ actor StatsService: StatsServiceProtocol {
     private var mocks: MockStatsService
 
     // Cache
-    private var siteStatsCache: [SiteStatsCacheKey: CachedEntity<SiteMetricsResponse>] = [:]
-    private var wordAdsStatsCache: [WordAdsStatsCacheKey: CachedEntity<WordAdsMetricsResponse>] = [:]
-    private var topListCache: [TopListCacheKey: CachedEntity<TopListResponse>] = [:]
+    private let siteStatsCache: StatsCache<SiteStatsCacheKey, SiteMetricsResponse>
+    private let wordAdsStatsCache: StatsCache<WordAdsStatsCacheKey, WordAdsMetricsResponse>
+    private let topListCache: StatsCache<TopListCacheKey, TopListResponse>
     private let currentPeriodTTL: TimeInterval = 30 // 30 seconds for current period
 
     let supportedMetrics: [SiteMetric] = [
@@ -47,6 +47,17 @@ actor StatsService: StatsServiceProtocol {
     }
 
     init(siteID: Int, api: WordPressComRestApi, timeZone: TimeZone) {
+        self.init(
+            siteID: siteID,
+            api: api,
+            timeZone: timeZone,
+            cacheDirectoryURL: StatsService.makeCacheDirectoryURL(siteID: siteID, timeZone: timeZone)
+        )
+    }
+
+    /// - parameter cacheDirectoryURL: The directory used to persist the stats
+    /// for the historical periods. Pass `nil` to keep the cache in memory.
+    init(siteID: Int, api: WordPressComRestApi, timeZone: TimeZone, cacheDirectoryURL: URL?) {
         self.siteID = siteID
         self.api = api
         self.service = StatsServiceRemoteV2(
@@ -56,28 +67,51 @@ actor StatsService: StatsServiceProtocol {
         )
         self.siteTimeZone = timeZone
         self.mocks = MockStatsService(timeZone: timeZone)
+
+        // The costs are measured in data points (or items for top lists).
+        self.siteStatsCache = StatsCache(
+            costLimit: 50_000,
+            storage: cacheDirectoryURL.map {
+                StatsDiskCacheStorage<SiteMetricsResponse>(directoryURL: $0.appendingPathComponent("site-stats", isDirectory: true))
+            },
+            cost: { $0.metrics.values.reduce(0) { $0 + $1.count } }
+        )
+        self.wordAdsStatsCache = StatsCache(
+            costLimit: 10_000,
+            storage: cacheDirectoryURL.map {
+                StatsDiskCacheStorage<WordAdsMetricsResponse>(directoryURL: $0.appendingPathComponent("wordads-stats", isDirectory: true))
+            },
+            cost: { $0.metrics.values.reduce(0) { $0 + $1.count } }
+        )
+        self.topListCache = StatsCache(
+            costLimit: 10_000,
+            cost: { $0.items.count }
+        )
+    }
+
+    /// Returns the default location of the persistent cache for the given site.
+    ///
+    /// The time zone is part of the path because the cached periods are
+    /// expressed in the site time zone. It's identified by its identifier
+    /// rather than its offset, which changes with daylight saving time.
+    static func makeCacheDirectoryURL(siteID: Int, timeZone: TimeZone) -> URL? {
+        let timeZoneID = timeZone.identifier.replacingOccurrences(of: "/", with: "_")
+        return FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first?
+            .appendingPathComponent("JetpackStats", isDirectory: true)
+            .appendingPathComponent("\(siteID)-\(timeZoneID)", isDirectory: true)
     }
 
     // MARK: - StatsServiceProtocol
 
     func getSiteStats(interval: DateInterval, granularity: DateRangeGranularity) async throws -> SiteMetricsResponse {
-        // Check cache first
         let cacheKey = SiteStatsCacheKey(interval: interval, granularity: granularity)
 
-        if let cached = siteStatsCache[cacheKey], !cached.isExpired {
-            return cached.data
-        }
-
-        // Fetch fresh data
-        let data = try await fetchSiteStats(interval: interval, granularity: granularity)
-
-        // Cache the result
         // Historical data never expires (ttl = nil), current period data expires after 30 seconds
         let ttl = intervalContainsCurrentDate(interval) ? currentPeriodTTL : nil
 
-        siteStatsCache[cacheKey] = CachedEntity(data: data, timestamp: Date(), ttl: ttl)
-
-        return data
+        return try await siteStatsCache.value(for: cacheKey, ttl: ttl) {
+            try await self.fetchSiteStats(interval: interval, granularity: granularity)
+        }
     }
 
     private func fetchSiteStats(interval: DateInterval, granularity: DateRangeGranularity) async throws -> SiteMetricsResponse {
@@ -101,23 +135,14 @@ actor StatsService: StatsServiceProtocol {
     }
 
     func getWordAdsStats(date: Date, granularity: DateRangeGranularity) async throws -> WordAdsMetricsResponse {
-        // Check cache first
         let cacheKey = WordAdsStatsCacheKey(date: date, granularity: granularity)
 
-        if let cached = wordAdsStatsCache[cacheKey], !cached.isExpired {
-            return cached.data
-        }
-
-        // Fetch fresh data
-        let data = try await fetchWordAdsStats(date: date, granularity: granularity)
-
-        // Cache the result
         // Historical data never expires (ttl = nil), current period data expires after 30 seconds
         let ttl = dateIsToday(date) ? currentPeriodTTL : nil
 
-        wordAdsStatsCache[cacheKey] = CachedEntity(data: data, timestamp: Date(), ttl: ttl)
-
-        return data
+        return try await wordAdsStatsCache.value(for: cacheKey, ttl: ttl) {
+            try await self.fetchWordAdsStats(date: date, granularity: granularity)
+        }
     }
 
     func getWordAdsEarnings() async throws -> WordPressKit.StatsWordAdsEarningsResponse {
@@ -181,22 +206,15 @@ actor StatsService: StatsServiceProtocol {
     }
 
     func getTopListData(_ item: TopListItemType, metric: SiteMetric, interval: DateInterval, granularity: DateRangeGranularity, limit: Int?, options: TopListItemOptions) async throws -> TopListResponse {
-        // Check cache first
         let cacheKey = TopListCacheKey(item: item, metric: metric, options: options, interval: interval, granularity: granularity, limit: limit)
-        if let cached = topListCache[cacheKey], !cached.isExpired {
-            return cached.data
-        }
 
-        // Fetch fresh data
-        do {
-            let data = try await _getTopListData(item, metric: metric, interval: interval, granularity: granularity, limit: limit, options: options)
-
-            // Cache the result
-            // Historical data never expires (ttl = nil), current period data expires after 30 seconds
-            let ttl = intervalContainsCurrentDate(interval) ? currentPeriodTTL : nil
-            topListCache[cacheKey] = CachedEntity(data: data, timestamp: Date(), ttl: ttl)
+        // Historical data never expires (ttl = nil), current period data expires after 30 seconds
+        let ttl = intervalContainsCurrentDate(interval) ? currentPeriodTTL : nil
 
-            return data
+        do {
+            return try await topListCache.value(for: cacheKey, ttl: ttl) {
+                try await self._getTopListData(item, metric: metric, interval: interval, granularity: granularity, limit: limit, options: options)
+            }
         } catch {
             if let error = StatsFeatureGateError.from(apiError: error, itemType: item) {
                 throw error
@@ -557,34 +575,45 @@ enum StatsServiceError: LocalizedError {
 
 // MARK: - Cache
 
-private struct SiteStatsCacheKey: Hashable {
+private struct SiteStatsCacheKey: StatsCacheKey {
     let interval: DateInterval
     let granularity: DateRangeGranularity
+
+    var storageKey: String {
+        "\(granularity)-\(Int(interval.start.timeIntervalSince1970))-\(Int(interval.end.timeIntervalSince1970))"
+    }
 }
 
-private struct WordAdsStatsCacheKey: Hashable {
+private struct WordAdsStatsCacheKey: StatsCacheKey {
     let date: Date
     let granularity: DateRangeGranularity
-}
 
-private struct CachedEntity<T> {
-    let data: T
-    let timestamp: Date
-    let ttl: TimeInterval?
-
-    var isExpired: Bool {
-        guard let ttl else {
-            return false // No TTL means it never expires
-        }
-        return Date().timeIntervalSince(timestamp) > ttl
+    var storageKey: String {
+        "\(granularity)-\(Int(date.timeIntervalSince1970))"
     }
 }
 
-private struct TopListCacheKey: Hashable {
+private struct TopListCacheKey: StatsCacheKey {
     let item: TopListItemType
     let metric: SiteMetric
     let options: TopListItemOptions
     let interval: DateInterval
     let granularity: DateRangeGranularity
     let limit: Int?
+
+    /// Top lists are kept only in memory, but the key is stable nonetheless
+    /// (unlike `hashValue`, which is seeded per launch).
+    var storageKey: String {
+        [
+            "\(item)",
+            "\(metric)",
+            "\(options.locationLevel)",
+            "\(options.deviceBreakdown)",
+            "\(options.utmParamGrouping)",
+            "\(granularity)",
+            "\(Int(interval.start.timeIntervalSince1970))",
+            "\(Int(interval.end.timeIntervalSince1970))",
+            limit.map { "\($0)" } ?? "all"
+        ].joined(separator: "-")
+    }
 }
@@ -32,6 +32,9 @@
 
 static NSString *SFHFKeychainUtilsErrorDomain = @"SFHFKeychainUtilsErrorDomain";
 
+NSNotificationName const SFHFKeychainUtilsDidChangeItemNotification = @"SFHFKeychainUtilsDidChangeItemNotification";
+NSString * const SFHFKeychainUtilsServiceNameKey = @"serviceName";
+
 #if __IPHONE_OS_VERSION_MIN_REQUIRED < 30000 && TARGET_IPHONE_SIMULATOR
 @interface SFHFKeychainUtils (PrivateMethods)
 + (SecKeychainItemRef) getKeychainItemReferenceForUsername:(NSString *)username
@@ -447,6 +450,8 @@ static NSString *SFHFKeychainUtilsErrorDomain = @"SFHFKeychainUtilsErrorDomain";
         return NO;
     }
 
+    [self postDidChangeItemNotificationForServiceName:serviceName];
+
     return YES;
 }
 
@@ -489,6 +494,8 @@ static NSString *SFHFKeychainUtilsErrorDomain = @"SFHFKeychainUtilsErrorDomain";
         return NO;
     }
 
+    [self postDidChangeItemNotificationForServiceName:serviceName];
+
     return YES;
 }
 
@@ -528,6 +535,72 @@ static NSString *SFHFKeychainUtilsErrorDomain = @"SFHFKeychainUtilsErrorDomain";
                           error:error];
 }
 
++ (NSDictionary<NSString *, NSString *> *)getPasswordsForServiceName:(NSString *)serviceName
+                                                         accessGroup:(NSString *)accessGroup
+                                                               error:(NSError **)error
+{
+    if (!serviceName) {
+        if (error != nil) {
+            *error = [NSError errorWithDomain: SFHFKeychainUtilsErrorDomain code: -2000 userInfo: nil];
+        }
+        return nil;
+    }
+
+    if (error != nil) {
+        *error = nil;
+    }
+
+    NSMutableDictionary *query = [[@{
+            (__bridge id)kSecClass: (__bridge NSString *)kSecClassGenericPassword,
+            (__bridge id)kSecAttrService: serviceName,
+            (__bridge id)kSecMatchLimit: (__bridge NSString *)kSecMatchLimitAll,
+            (__bridge id)kSecReturnAttributes: @YES,
+            (__bridge id)kSecReturnData: @YES
+    } mutableCopy] autorelease];
+
+#if TARGET_IPHONE_SIMULATOR
+    // Ignore access group if running in simulator
+#else
+    if (accessGroup.length > 0) {
+        query[(__bridge id)kSecAttrAccessGroup] = accessGroup;
+    }
+#endif
+
+    CFTypeRef result = NULL;
+    OSStatus status = SecItemCopyMatching((__bridge CFDictionaryRef)[NSDictionary dictionaryWithDictionary:query], &result);
+
+    if (status == errSecItemNotFound) {
+        return @{};
+    }
+
+    if (status != noErr) {
+        if (error != nil) {
+            *error = [NSError errorWithDomain:SFHFKeychainUtilsErrorDomain code:status userInfo:nil];
+        }
+
+        return nil;
+    }
+
+    NSMutableDictionary<NSString *, NSString *> *passwords = [[[NSMutableDictionary alloc] init] autorelease];
+    for (NSDictionary<id, id> *item in (__bridge NSArray *)result) {
+        NSString *username = item[(__bridge NSString *)kSecAttrAccount];
+        NSData *passwordData = item[(__bridge NSString *)kSecValueData];
+        // Items without password data are reported as missing, as `getPasswordForUsername:` does.
+        if (username == nil || passwordData == nil) {
+            continue;
+        }
+        NSString *password = [[[NSString alloc] initWithData:passwordData encoding:NSUTF8StringEncoding] autorelease];
+        if (password != nil) {
+            passwords[username] = password;
+        }
+    }
+    if (result != NULL) {
+        CFRelease(result);
+    }
+
+    return passwords;
+}
+
 + (NSArray<NSDictionary<NSString *, NSString *> *> *)getAllPasswordsForAccessGroup:(NSString *)accessGroup
                                                                              error:(NSError **)error {
     NSMutableDictionary *query = [[@{
@@ -573,4 +646,11 @@ static NSString *SFHFKeychainUtilsErrorDomain = @"SFHFKeychainUtilsErrorDomain";
     return nil;
 }
 
++ (void)postDidChangeItemNotificationForServiceName:(NSString *)serviceName
+{
+    [[NSNotificationCenter defaultCenter] postNotificationName:SFHFKeychainUtilsDidChangeItemNotification
+                                                        object:self
+                                                      userInfo:@{SFHFKeychainUtilsServiceNameKey: serviceName}];
+}
+
 @end
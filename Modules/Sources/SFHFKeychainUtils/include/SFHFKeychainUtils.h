@@ -29,6 +29,10 @@
 
 #import <Foundation/Foundation.h>
 
+/// Posted after an item is stored or deleted, on the thread that changed it.
+/// The user info holds the service name of the item under `SFHFKeychainUtilsServiceNameKey`.
+extern NSNotificationName const SFHFKeychainUtilsDidChangeItemNotification;
+extern NSString * const SFHFKeychainUtilsServiceNameKey;
 
 @interface SFHFKeychainUtils : NSObject {
     
@@ -65,6 +69,12 @@
                   accessGroup:(NSString *)accessGroup
                         error:(NSError **)error;
 
+/// Returns the passwords of every item of the service, keyed by username, with a single keychain query.
+/// The dictionary is empty if the service has no items, and nil if the query failed.
++ (NSDictionary<NSString *, NSString *> *)getPasswordsForServiceName:(NSString *)serviceName
+                                                         accessGroup:(NSString *)accessGroup
+                                                               error:(NSError **)error;
+
 + (NSArray<NSDictionary<NSString *, NSString *> *> *)getAllPasswordsForAccessGroup:(NSString *)accessGroup
                                                                              error:(NSError **)error;
 
@@ -8,7 +8,7 @@ open class Tracks {
     open var wpcomUserID: String?
 
     // MARK: - Private Properties
-    private let uploader: Uploader
+    private let eventQueue: TracksEventQueue
 
     // MARK: - Constants
     private static let version = "1.0"
@@ -19,7 +19,12 @@ open class Tracks {
     // MARK: - Initializers
     public init(appGroupName: String = BuildSettings.current.appGroupName,
          eventNamePrefix: String = BuildSettings.current.eventNamePrefix) {
-        uploader = Uploader(appGroupName: appGroupName)
+        eventQueue = TracksEventQueue.shared(appGroupName: appGroupName)
+        self.eventNamePrefix = eventNamePrefix
+    }
+
+    public init(eventQueue: TracksEventQueue, eventNamePrefix: String = BuildSettings.current.eventNamePrefix) {
+        self.eventQueue = eventQueue
         self.eventNamePrefix = eventNamePrefix
     }
 
@@ -27,7 +32,7 @@ open class Tracks {
     open func track(_ eventName: String, properties: [String: Any]? = nil) {
         let prefixedEventName = "\(eventNamePrefix)_\(eventName)"
         let payload = payloadWithEventName(prefixedEventName, properties: properties)
-        uploader.send(payload)
+        eventQueue.append(payload)
 
         logInfo("🔵 Tracked: \(prefixedEventName), \(properties ?? [:])")
     }
@@ -76,79 +81,6 @@ open class Tracks {
 
         return payload
     }
-
-    /// Private Internal Helper:
-    /// Encapsulates all of the Backend Tracks Interaction, and deals with NSURLSession's API.
-    ///
-    private class Uploader: NSObject, URLSessionDelegate {
-        // MARK: - Properties
-        private var session: Foundation.URLSession!
-
-        // MARK: - Constants
-        private let tracksURL = "https://public-api.wordpress.com/rest/v1.1/tracks/record"
-        private let httpMethod = "POST"
-        private let headers = [
-            "Content-Type": "application/json",
-            "Accept": "application/json",
-            "User-Agent": "WPiOS App Extension"
-        ]
-
-        // MARK: - Deinitializers
-        deinit {
-            session.finishTasksAndInvalidate()
-        }
-
-        // MARK: - Initializers
-        init(appGroupName: String) {
-            super.init()
-
-            // Random Identifier (Each Time)
-            let identifier = appGroupName + "." + UUID().uuidString
-
-            // Session Configuration
-            let configuration = URLSessionConfiguration.background(withIdentifier: identifier)
-            configuration.sharedContainerIdentifier = appGroupName
-
-            // URL Session
-            session = Foundation.URLSession(configuration: configuration, delegate: self, delegateQueue: OperationQueue.main)
-        }
-
-        // MARK: - Public Methods
-        func send(_ event: [String: Any]) {
-            // Build the targetURL
-            let targetURL = URL(string: tracksURL)!
-
-            // Payload
-            let dataToSend = [ "events": [event], "commonProps": [] ]
-            let requestBody = try? JSONSerialization.data(withJSONObject: dataToSend, options: .prettyPrinted)
-
-            // Request
-            var request = URLRequest(url: targetURL)
-            request.httpMethod = httpMethod
-            request.httpBody = requestBody
-
-            for (field, value) in headers {
-                request.setValue(value, forHTTPHeaderField: field)
-            }
-
-            // Task!
-            let task = session.downloadTask(with: request)
-            task.resume()
-        }
-
-        // MARK: - NSURLSessionDelegate
-        @objc func URLSession(_ session: Foundation.URLSession, task: URLSessionTask, didCompleteWithError error: NSError?) {
-            print("<> Tracker.didCompleteWithError: \(String(describing: error))")
-        }
-
-        @objc func urlSession(_ session: URLSession, didBecomeInvalidWithError error: Error?) {
-            print("<> Tracker.didBecomeInvalidWithError: \(String(describing: error))")
-        }
-
-        @objc func urlSessionDidFinishEvents(forBackgroundURLSession session: URLSession) {
-            print("<> Tracker.URLSessionDidFinishEventsForBackgroundURLSession")
-        }
-    }
 }
 
 private extension Tracks {
@@ -0,0 +1,352 @@
+import Foundation
+import OSLog
+
+/// A small durable queue of Tracks events.
+///
+/// The events are written to disk shortly after they are tracked and are sent
+/// in batches when either of the following happens:
+///
+/// - The number of pending events reaches `maxBatchSize`.
+/// - The oldest pending event is older than `maxEventAge`.
+/// - The extension host is about to resign active or enter background.
+/// - `flush()` is called explicitly.
+///
+/// The events are removed only after the upload succeeds. Failed uploads are
+/// retried with exponential backoff, unless the server rejects the batch
+/// with a client error, in which case it's dropped.
+///
+/// Each event is numbered when it's added, and an upload removes the events
+/// up to the last one it contained. The batch being uploaded is persisted, so
+/// that an upload started by a previous launch isn't sent again while the
+/// system completes it.
+public final class TracksEventQueue {
+    public struct Configuration {
+        /// The number of events that triggers an upload, and the maximum
+        /// number of events sent in one upload.
+        public var maxBatchSize = 20
+        /// The maximum number of events kept on disk. The oldest events are
+        /// dropped when the limit is reached.
+        public var maxQueueSize = 500
+        /// The maximum amount of time an event can wait in the queue before
+        /// it's uploaded.
+        public var maxEventAge: TimeInterval = 30
+        /// The delay before the first retry. It doubles with each failure.
+        public var retryBaseDelay: TimeInterval = 5
+        public var retryMaxDelay: TimeInterval = 300
+        /// The delay used to coalesce the writes of the events to disk.
+        public var saveDelay: TimeInterval = 1
+        /// How long to wait for an upload started by a previous launch to
+        /// complete before sending its events again.
+        public var previousLaunchUploadTimeout: TimeInterval = 600
+
+        public init() {}
+    }
+
+    private struct Entry {
+        let sequence: Int
+        let event: [String: Any]
+    }
+
+    /// The batch being uploaded, identified by the sequence number of its last event.
+    private struct InFlightBatch {
+        let lastSequence: Int
+        let startDate: Date
+        /// Whether the upload was started by a previous launch.
+        var isRestored = false
+    }
+
+    private let fileURL: URL?
+    private let uploader: TracksUploader
+    private let configuration: Configuration
+    private let queue = DispatchQueue(label: "org.wordpress.tracks.event-queue")
+
+    private var entries: [Entry] = []
+    private var nextSequence = 1
+    private var inFlightBatch: InFlightBatch?
+    private var failureCount = 0
+    private var nextAttemptDate: Date?
+    private var scheduledFlush: DispatchWorkItem?
+    private var scheduledSave: DispatchWorkItem?
+    private let notificationCenter: NotificationCenter
+    private var observers: [NSObjectProtocol] = []
+
+    /// - parameters:
+    ///   - fileURL: The location where the pending events are persisted.
+    ///   Pass `nil` to keep them only in memory.
+    public init(
+        fileURL: URL?,
+        uploader: TracksUploader,
+        configuration: Configuration = Configuration(),
+        notificationCenter: NotificationCenter = .default
+    ) {
+        self.fileURL = fileURL
+        self.uploader = uploader
+        self.configuration = configuration
+        self.notificationCenter = notificationCenter
+
+        queue.sync {
+            loadEvents()
+            if let inFlightBatch {
+                let deadline = inFlightBatch.startDate.addingTimeInterval(configuration.previousLaunchUploadTimeout)
+                scheduleFlush(after: max(deadline.timeIntervalSinceNow, 0))
+            }
+        }
+
+        uploader.setPreviousLaunchUploadHandler { [weak self] batchID, result in
+            guard let self, let lastSequence = Int(batchID) else { return }
+            self.queue.async {
+                self.didUpload(lastSequence: lastSequence, result: result)
+            }
+        }
+
+        let names: [Notification.Name] = [.NSExtensionHostWillResignActive, .NSExtensionHostDidEnterBackground]
+        observers = names.map {
+            notificationCenter.addObserver(forName: $0, object: nil, queue: nil) { [weak self] _ in
+                guard let self else { return }
+                self.queue.async {
+                    self.saveNow()
+                    self.uploadIfNeeded()
+                }
+            }
+        }
+
+        // Send the events left over from the previous launches.
+        flush()
+    }
+
+    deinit {
+        observers.forEach(notificationCenter.removeObserver)
+        scheduledFlush?.cancel()
+    }
+
+    /// The number of events waiting to be uploaded.
+    public var pendingEventCount: Int {
+        queue.sync { entries.count }
+    }
+
+    public func append(_ event: [String: Any]) {
+        guard JSONSerialization.isValidJSONObject(event) else {
+            return
+        }
+        queue.async {
+            self.entries.append(Entry(sequence: self.nextSequence, event: event))
+            self.nextSequence += 1
+            if self.entries.count > self.configuration.maxQueueSize {
+                self.entries.removeFirst(self.entries.count - self.configuration.maxQueueSize)
+            }
+            self.scheduleSave()
+
+            if self.entries.count >= self.configuration.maxBatchSize {
+                self.uploadIfNeeded()
+            } else if self.scheduledFlush == nil {
+                self.scheduleFlush(after: self.configuration.maxEventAge)
+            }
+        }
+    }
+
+    /// Uploads the pending events unless an upload is already in progress or
+    /// the queue is waiting to retry a failed upload.
+    public func flush() {
+        queue.async {
+            self.uploadIfNeeded()
+        }
+    }
+
+    /// Writes the pending events to disk without waiting for `saveDelay`.
+    func persistPendingEvents() {
+        queue.sync {
+            saveNow()
+        }
+    }
+
+    // MARK: - Private
+
+    private func uploadIfNeeded() {
+        if let inFlightBatch {
+            guard inFlightBatch.isRestored,
+                  inFlightBatch.startDate.addingTimeInterval(configuration.previousLaunchUploadTimeout) <= Date() else {
+                return
+            }
+            // The upload started by a previous launch never reported back.
+            self.inFlightBatch = nil
+        }
+        guard !entries.isEmpty else {
+            return
+        }
+        if let nextAttemptDate, nextAttemptDate > Date() {
+            return // The retry is already scheduled
+        }
+        scheduledFlush?.cancel()
+        scheduledFlush = nil
+
+        let batch = entries.prefix(configuration.maxBatchSize)
+        let lastSequence = batch[batch.endIndex - 1].sequence
+        let payload: [String: Any] = ["events": batch.map(\.event), "commonProps": [Any]()]
+        guard let body = try? JSONSerialization.data(withJSONObject: payload) else {
+            // Should never happen as the events are validated when added
+            removeEvents(through: lastSequence)
+            saveNow()
+            return
+        }
+
+        inFlightBatch = InFlightBatch(lastSequence: lastSequence, startDate: Date())
+        saveNow()
+        uploader.upload(body, batchID: String(lastSequence)) { [weak self] result in
+            self?.queue.async {
+                self?.didUpload(lastSequence: lastSequence, result: result)
+            }
+        }
+    }
+
+    private func didUpload(lastSequence: Int, result: Result<Void, Error>) {
+        // Ignore the uploads that were given up on.
+        guard inFlightBatch?.lastSequence == lastSequence else {
+            return
+        }
+        inFlightBatch = nil
+        switch result {
+        case .success:
+            removeEvents(through: lastSequence)
+            scheduleSave()
+            failureCount = 0
+            nextAttemptDate = nil
+            if entries.count >= configuration.maxBatchSize {
+                uploadIfNeeded()
+            } else if !entries.isEmpty {
+                scheduleFlush(after: configuration.maxEventAge)
+            }
+        case .failure(let error as TracksUploadError) where error.isPermanent:
+            // Sending the batch again would be rejected the same way.
+            Logger(subsystem: Bundle.main.bundleIdentifier ?? "TracksMini", category: "tracks").error("Dropped a batch of events rejected with status code \(error.statusCode)")
+            removeEvents(through: lastSequence)
+            scheduleSave()
+            failureCount = 0
+            nextAttemptDate = nil
+            if !entries.isEmpty {
+                uploadIfNeeded()
+            }
+        case .failure:
+            scheduleSave()
+            failureCount += 1
+            let delay = min(configuration.retryBaseDelay * pow(2, Double(failureCount - 1)), configuration.retryMaxDelay)
+            nextAttemptDate = Date().addingTimeInterval(delay)
+            scheduleFlush(after: delay)
+        }
+    }
+
+    /// Removes the events of an uploaded batch, which are still at the head
+    /// of the queue unless they were dropped to make room for new ones.
+    private func removeEvents(through lastSequence: Int) {
+        let count = entries.prefix { $0.sequence <= lastSequence }.count
+        entries.removeFirst(count)
+    }
+
+    private func scheduleFlush(after delay: TimeInterval) {
+        scheduledFlush?.cancel()
+        let workItem = DispatchWorkItem { [weak self] in
+            guard let self else { return }
+            self.scheduledFlush = nil
+            self.nextAttemptDate = nil
+            self.uploadIfNeeded()
+        }
+        scheduledFlush = workItem
+        queue.asyncAfter(deadline: .now() + delay, execute: workItem)
+    }
+
+    // MARK: - Persistence
+
+    private func scheduleSave() {
+        guard scheduledSave == nil else {
+            return
+        }
+        // Keeps the queue alive until the events are written.
+        let workItem = DispatchWorkItem {
+            self.scheduledSave = nil
+            self.saveEvents()
+        }
+        scheduledSave = workItem
+        queue.asyncAfter(deadline: .now() + configuration.saveDelay, execute: workItem)
+    }
+
+    private func saveNow() {
+        scheduledSave?.cancel()
+        scheduledSave = nil
+        saveEvents()
+    }
+
+    private func loadEvents() {
+        guard let fileURL,
+              let data = try? Data(contentsOf: fileURL),
+              let object = try? JSONSerialization.jsonObject(with: data) else {
+            return
+        }
+        guard let contents = object as? [String: Any],
+              let storedEntries = contents["events"] as? [[String: Any]] else {
+            return
+        }
+        entries = storedEntries.compactMap { entry in
+            guard let sequence = entry["seq"] as? Int, let event = entry["event"] as? [String: Any] else {
+                return nil
+            }
+            return Entry(sequence: sequence, event: event)
+        }
+        nextSequence = max(contents["nextSeq"] as? Int ?? 1, (entries.last?.sequence ?? 0) + 1)
+        if let inFlight = contents["inFlight"] as? [String: Any],
+           let lastSequence = inFlight["seq"] as? Int,
+           let startDate = inFlight["date"] as? TimeInterval {
+            inFlightBatch = InFlightBatch(lastSequence: lastSequence, startDate: Date(timeIntervalSince1970: startDate), isRestored: true)
+        }
+    }
+
+    private func saveEvents() {
+        guard let fileURL else { return }
+        if entries.isEmpty && inFlightBatch == nil {
+            try? FileManager.default.removeItem(at: fileURL)
+            return
+        }
+        var contents: [String: Any] = [
+            "events": entries.map { ["seq": $0.sequence, "event": $0.event] as [String: Any] },
+            "nextSeq": nextSequence
+        ]
+        if let inFlightBatch {
+            contents["inFlight"] = ["seq": inFlightBatch.lastSequence, "date": inFlightBatch.startDate.timeIntervalSince1970]
+        }
+        guard let data = try? JSONSerialization.data(withJSONObject: contents) else {
+            return
+        }
+        try? FileManager.default.createDirectory(at: fileURL.deletingLastPathComponent(), withIntermediateDirectories: true)
+        try? data.write(to: fileURL, options: .atomic)
+    }
+}
+
+extension TracksEventQueue {
+    private static let lock = NSLock()
+    private static var queues: [String: TracksEventQueue] = [:]
+
+    /// Returns the queue shared by all `Tracks` instances in the process
+    /// that use the given app group.
+    static func shared(appGroupName: String) -> TracksEventQueue {
+        lock.withLock {
+            if let queue = queues[appGroupName] {
+                return queue
+            }
+            let queue = TracksEventQueue(
+                fileURL: makeFileURL(appGroupName: appGroupName),
+                uploader: TracksURLSessionUploader.shared(appGroupName: appGroupName)
+            )
+            queues[appGroupName] = queue
+            return queue
+        }
+    }
+
+    /// Each process gets its own file to avoid the extensions sharing the
+    /// app group from overwriting each other's events.
+    private static func makeFileURL(appGroupName: String) -> URL? {
+        let containerURL = FileManager.default.containerURL(forSecurityApplicationGroupIdentifier: appGroupName)
+            ?? FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first
+        let fileName = "tracks-events-\(Bundle.main.bundleIdentifier ?? "default").json"
+        return containerURL?
+            .appendingPathComponent("Library/Caches/Tracks", isDirectory: true)
+            .appendingPathComponent(fileName, isDirectory: false)
+    }
+}
@@ -0,0 +1,143 @@
+import Foundation
+
+/// Sends batches of serialized Tracks events to the backend.
+public protocol TracksUploader: AnyObject {
+    /// Uploads the given request body and calls `completion` once the
+    /// server acknowledges (or rejects) it.
+    ///
+    /// - parameter batchID: Identifies the upload if it completes after the
+    ///   process is relaunched.
+    func upload(_ body: Data, batchID: String, completion: @escaping (Result<Void, Error>) -> Void)
+
+    /// Sets the handler called with the uploads started by a previous launch
+    /// of the process that complete in this one.
+    func setPreviousLaunchUploadHandler(_ handler: @escaping (_ batchID: String, Result<Void, Error>) -> Void)
+}
+
+/// The error reported when the server responds with an unsuccessful status code.
+public struct TracksUploadError: Error {
+    public let statusCode: Int
+
+    public init(statusCode: Int) {
+        self.statusCode = statusCode
+    }
+
+    /// Whether sending the same batch again would fail the same way: the
+    /// client errors other than timeouts and rate limiting.
+    var isPermanent: Bool {
+        (400..<500).contains(statusCode) && statusCode != 408 && statusCode != 429
+    }
+}
+
+/// Uploads events using a single long-lived background `URLSession`, so
+/// the transfers can complete after the extension is suspended.
+final class TracksURLSessionUploader: NSObject, TracksUploader, URLSessionDownloadDelegate {
+    private var session: URLSession!
+    private let lock = NSLock()
+    private var completions: [Int: (Result<Void, Error>) -> Void] = [:]
+    private var previousLaunchUploadHandler: ((String, Result<Void, Error>) -> Void)?
+    /// The previous launch uploads that completed before the handler was set.
+    private var previousLaunchResults: [(String, Result<Void, Error>)] = []
+
+    private let tracksURL = URL(string: "https://public-api.wordpress.com/rest/v1.1/tracks/record")!
+    private let headers = [
+        "Content-Type": "application/json",
+        "Accept": "application/json",
+        "User-Agent": "WPiOS App Extension"
+    ]
+
+    private static let lock = NSLock()
+    private static var uploaders: [String: TracksURLSessionUploader] = [:]
+
+    /// Returns the uploader for the given app group.
+    ///
+    /// Only one background session with a given identifier can exist in a
+    /// process, so the uploaders are shared.
+    static func shared(appGroupName: String) -> TracksURLSessionUploader {
+        lock.withLock {
+            if let uploader = uploaders[appGroupName] {
+                return uploader
+            }
+            let uploader = TracksURLSessionUploader(appGroupName: appGroupName)
+            uploaders[appGroupName] = uploader
+            return uploader
+        }
+    }
+
+    private init(appGroupName: String) {
+        super.init()
+
+        // The identifier has to be stable to let the system reconnect the
+        // session with the transfers started by the previous launches.
+        let identifier = [appGroupName, Bundle.main.bundleIdentifier, "tracks"]
+            .compactMap { $0 }
+            .joined(separator: ".")
+
+        let configuration = URLSessionConfiguration.background(withIdentifier: identifier)
+        configuration.sharedContainerIdentifier = appGroupName
+
+        session = URLSession(configuration: configuration, delegate: self, delegateQueue: nil)
+    }
+
+    func upload(_ body: Data, batchID: String, completion: @escaping (Result<Void, Error>) -> Void) {
+        var request = URLRequest(url: tracksURL)
+        request.httpMethod = "POST"
+        request.httpBody = body
+        for (field, value) in headers {
+            request.setValue(value, forHTTPHeaderField: field)
+        }
+
+        // Background sessions only support upload and download tasks.
+        let task = session.downloadTask(with: request)
+        task.taskDescription = batchID
+        lock.withLock {
+            completions[task.taskIdentifier] = completion
+        }
+        task.resume()
+    }
+
+    func setPreviousLaunchUploadHandler(_ handler: @escaping (String, Result<Void, Error>) -> Void) {
+        let results = lock.withLock {
+            previousLaunchUploadHandler = handler
+            defer { previousLaunchResults.removeAll() }
+            return previousLaunchResults
+        }
+        for (batchID, result) in results {
+            handler(batchID, result)
+        }
+    }
+
+    // MARK: - URLSessionDownloadDelegate
+
+    func urlSession(_ session: URLSession, downloadTask: URLSessionDownloadTask, didFinishDownloadingTo location: URL) {
+        // The response body is not used
+    }
+
+    func urlSession(_ session: URLSession, task: URLSessionTask, didCompleteWithError error: Error?) {
+        let result: Result<Void, Error>
+        if let error {
+            result = .failure(error)
+        } else if let response = task.response as? HTTPURLResponse, !(200..<300).contains(response.statusCode) {
+            result = .failure(TracksUploadError(statusCode: response.statusCode))
+        } else {
+            result = .success(())
+        }
+
+        let completion: ((Result<Void, Error>) -> Void)? = lock.withLock {
+            if let completion = completions.removeValue(forKey: task.taskIdentifier) {
+                return completion
+            }
+            // The completion is missing for the tasks started by the previous
+            // launches, which are reported by their batch ID instead.
+            guard let batchID = task.taskDescription else {
+                return nil
+            }
+            if let handler = previousLaunchUploadHandler {
+                return { handler(batchID, $0) }
+            }
+            previousLaunchResults.append((batchID, result))
+            return nil
+        }
+        completion?(result)
+    }
+}
@@ -39,6 +39,9 @@ public actor InMemoryDataStore<T: Sendable & Identifiable>: DataStore where T.ID
     /// A `Dictionary` to store the data in memory.
     private var storage: [T.ID: T] = [:]
 
+    /// The sync generation that last stored each item. See `store(_:generation:)`.
+    private var generations: [T.ID: Int] = [:]
+
     /// A publisher for sending and subscribing data changes.
     ///
     /// The publisher emits events when data changes, with identifiers of changed models.
@@ -78,6 +81,7 @@ public actor InMemoryDataStore<T: Sendable & Identifiable>: DataStore where T.ID
             if storage.removeValue(forKey: item.id) != nil {
                 updated.insert(item.id)
             }
+            generations.removeValue(forKey: item.id)
         }
 
         if !updated.isEmpty {
@@ -124,3 +128,44 @@ public actor InMemoryDataStore<T: Sendable & Identifiable>: DataStore where T.ID
         return stream.stream
     }
 }
+
+// MARK: - Incremental Sync
+
+extension InMemoryDataStore where T: Equatable {
+    /// Stores a page of items fetched by a sync, tagging them with the sync's generation.
+    ///
+    /// The items replace the stored items with the same ids in place, so the observers never see
+    /// the items disappear while the sync is in progress. They are notified once per page, and only
+    /// if the page adds or changes an item. The items already stored by a newer generation are
+    /// left untouched.
+    public func store<S: Sequence>(_ data: S, generation: Int) async throws where S.Element == T {
+        var updated = Set<T.ID>()
+        for item in data {
+            if let current = generations[item.id], current > generation {
+                continue
+            }
+            generations[item.id] = generation
+            if storage.updateValue(item, forKey: item.id) != item {
+                updated.insert(item.id)
+            }
+        }
+
+        if !updated.isEmpty {
+            updates.send(updated)
+        }
+    }
+
+    /// Removes the items that weren't stored by the given sync generation, i.e. the items that are no
+    /// longer returned by the server. Call it once the sync has stored its last page.
+    public func deleteItems(notStoredBy generation: Int) async throws {
+        let staleIDs = storage.keys.filter { generations[$0] != generation }
+        for id in staleIDs {
+            storage.removeValue(forKey: id)
+            generations.removeValue(forKey: id)
+        }
+
+        if !staleIDs.isEmpty {
+            updates.send(Set(staleIDs))
+        }
+    }
+}
@@ -0,0 +1,233 @@
+import Foundation
+import WordPressCoreProtocols
+
+/// Resolves the icons of the plugins in the WordPress.org plugin directory.
+///
+/// The installed plugins list resolves an icon per row, so the resolver:
+/// - Looks up the plugin directory in batches: the slugs requested within `batchDelay` of each
+///   other are passed to `lookUpDirectory` together.
+/// - Probes the icon candidates on the SVN server concurrently, with at most `maxConcurrentRequests`
+///   requests in flight across all plugins.
+/// - Shares the resolution between the concurrent requests for the same slug.
+/// - Remembers the icons, and the plugins without an icon, in the disk cache until they expire.
+actor PluginIconResolver {
+    struct Configuration: Sendable {
+        var batchDelay: Duration = .milliseconds(50)
+        var maxConcurrentRequests = 6
+        var iconLifetime: TimeInterval = 7 * 24 * 60 * 60
+        var missingIconLifetime: TimeInterval = 24 * 60 * 60
+        var saveDelay: Duration = .seconds(1)
+    }
+
+    /// Returns the icons found in the plugin directory, keyed by slug.
+    typealias DirectoryLookup = @Sendable (_ slugs: [String]) async -> [String: URL]
+
+    private struct CachedIcon: Codable {
+        /// `nil` if the plugin has no icon.
+        var url: URL?
+        var expirationDate: Date
+    }
+
+    private enum ProbeResult {
+        case found
+        case notFound
+        case failed
+    }
+
+    static let cacheKey = "plugin-icons"
+
+    private let configuration: Configuration
+    private let urlSession: URLSession
+    private let cache: any DiskCacheProtocol
+    private let lookUpDirectory: DirectoryLookup
+
+    private var cachedIcons: [String: CachedIcon]?
+    private var inFlight: [String: Task<URL?, Never>] = [:]
+    private var pendingSlugs: [String] = []
+    private var pendingLookup: Task<[String: URL], Never>?
+    private var saveTask: Task<Void, Never>?
+
+    private var availableRequests: Int
+    private var requestWaiters: [CheckedContinuation<Void, Never>] = []
+
+    init(
+        urlSession: URLSession,
+        cache: any DiskCacheProtocol,
+        configuration: Configuration = Configuration(),
+        lookUpDirectory: @escaping DirectoryLookup
+    ) {
+        self.urlSession = urlSession
+        self.cache = cache
+        self.configuration = configuration
+        self.lookUpDirectory = lookUpDirectory
+        self.availableRequests = configuration.maxConcurrentRequests
+    }
+
+    func iconURL(forSlug slug: String, now: Date = .now) async -> URL? {
+        if let cached = await loadCachedIcons()[slug], cached.expirationDate > now {
+            return cached.url
+        }
+
+        if let task = inFlight[slug] {
+            return await task.value
+        }
+
+        let task = Task { await resolve(slug) }
+        inFlight[slug] = task
+        let url = await task.value
+        inFlight[slug] = nil
+        return url
+    }
+
+    /// Writes the pending changes to the disk cache now.
+    func save() async {
+        saveTask?.cancel()
+        saveTask = nil
+        guard let cachedIcons else { return }
+        try? await cache.store(cachedIcons, forKey: Self.cacheKey)
+    }
+
+    // MARK: - Resolution
+
+    private func resolve(_ slug: String) async -> URL? {
+        if let url = await findIconInDirectory(slug: slug) {
+            remember(url, for: slug)
+            return url
+        }
+
+        guard let url = await findIconOnSVNServer(slug: slug) else {
+            return nil
+        }
+        remember(url, for: slug)
+        return url
+    }
+
+    private func findIconInDirectory(slug: String) async -> URL? {
+        pendingSlugs.append(slug)
+        let lookup: Task<[String: URL], Never>
+        if let pendingLookup {
+            lookup = pendingLookup
+        } else {
+            lookup = Task {
+                try? await Task.sleep(for: configuration.batchDelay)
+                return await lookUpPendingSlugs()
+            }
+            pendingLookup = lookup
+        }
+        return await lookup.value[slug]
+    }
+
+    private func lookUpPendingSlugs() async -> [String: URL] {
+        let slugs = pendingSlugs
+        pendingSlugs = []
+        pendingLookup = nil
+        return await lookUpDirectory(slugs)
+    }
+
+    /// Returns `.some(nil)` if the server has none of the candidates, or `nil` if the server
+    /// couldn't be reached, in which case the result isn't remembered.
+    private func findIconOnSVNServer(slug: String) async -> URL?? {
+        let candidates = Self.svnIconCandidates(slug: slug)
+        let results = await withTaskGroup(of: (Int, ProbeResult).self) { group in
+            for (index, url) in candidates.enumerated() {
+                group.addTask {
+                    (index, await self.probe(url))
+                }
+            }
+            var results = [ProbeResult](repeating: .failed, count: candidates.count)
+            for await (index, result) in group {
+                results[index] = result
+            }
+            return results
+        }
+
+        if let index = results.firstIndex(of: .found) {
+            return .some(candidates[index])
+        }
+        if results.contains(.failed) {
+            return nil
+        }
+        return .some(nil)
+    }
+
+    private func probe(_ url: URL) async -> ProbeResult {
+        await acquireRequest()
+        defer { releaseRequest() }
+
+        var request = URLRequest(url: url)
+        request.httpMethod = "HEAD"
+        guard let (_, response) = try? await urlSession.data(for: request),
+              let statusCode = (response as? HTTPURLResponse)?.statusCode else {
+            return .failed
+        }
+        switch statusCode {
+        case 200:
+            return .found
+        case 400..<500:
+            return .notFound
+        default:
+            return .failed
+        }
+    }
+
+    static func svnIconCandidates(slug: String) -> [URL] {
+        let url = URL(string: "https://ps.w.org")!
+            .appending(path: slug)
+            .appending(path: "assets")
+        let size = [256, 128]
+        let supportedFormat = ["png", "jpg", "jpeg", "gif"]
+        return zip(size, supportedFormat).map { size, format in
+            url.appending(path: "icon-\(size)x\(size).\(format)")
+        }
+    }
+
+    // MARK: - Request Limit
+
+    private func acquireRequest() async {
+        if availableRequests > 0 {
+            availableRequests -= 1
+            return
+        }
+        await withCheckedContinuation { continuation in
+            requestWaiters.append(continuation)
+        }
+    }
+
+    private func releaseRequest() {
+        if requestWaiters.isEmpty {
+            availableRequests += 1
+        } else {
+            // The request is handed over to the next waiter.
+            requestWaiters.removeFirst().resume()
+        }
+    }
+
+    // MARK: - Cache
+
+    private func loadCachedIcons() async -> [String: CachedIcon] {
+        if let cachedIcons {
+            return cachedIcons
+        }
+        let stored = (try? await cache.read([String: CachedIcon].self, forKey: Self.cacheKey, notOlderThan: nil)) ?? [:]
+        // Keep the icons remembered while the cache was being read.
+        let icons = stored.merging(cachedIcons ?? [:]) { _, new in new }
+        cachedIcons = icons
+        return icons
+    }
+
+    private func remember(_ url: URL?, for slug: String) {
+        let lifetime = url == nil ? configuration.missingIconLifetime : configuration.iconLifetime
+        let now = Date.now
+        var icons = (cachedIcons ?? [:]).filter { $0.value.expirationDate > now }
+        icons[slug] = CachedIcon(url: url, expirationDate: now.addingTimeInterval(lifetime))
+        cachedIcons = icons
+
+        guard saveTask == nil else { return }
+        // The icons are resolved in bursts, when the plugins list is displayed.
+        saveTask = Task {
+            try? await Task.sleep(for: configuration.saveDelay)
+            guard !Task.isCancelled else { return }
+            await save()
+        }
+    }
+}
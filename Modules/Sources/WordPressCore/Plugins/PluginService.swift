@@ -10,11 +10,17 @@ public actor PluginService: PluginServiceProtocol {
     private let pluginDirectoryBrowserDataStore = CategorizedPluginInformationDataStore()
     private let updateChecksDataStore = PluginUpdateChecksDataStore()
     private let urlSession: URLSession
+    private let iconResolver: PluginIconResolver
 
     public init(client: WordPressClient, wordpressCoreVersion: String?) {
+        self.init(client: client, wordpressCoreVersion: wordpressCoreVersion, urlSession: URLSession(configuration: .ephemeral), iconResolver: .shared)
+    }
+
+    init(client: WordPressClient, wordpressCoreVersion: String?, urlSession: URLSession, iconResolver: PluginIconResolver) {
         self.client = client
         self.wordpressCoreVersion = wordpressCoreVersion
-        self.urlSession = URLSession(configuration: .ephemeral)
+        self.urlSession = urlSession
+        self.iconResolver = iconResolver
         wpOrgClient = WordPressOrgApiClient(urlSession: urlSession)
     }
 
@@ -64,21 +70,15 @@ public actor PluginService: PluginServiceProtocol {
     }
 
     public func resolveIconURL(of slug: PluginWpOrgDirectorySlug, plugin: PluginInformation?) async -> URL? {
-        // TODO: Cache the icon URL
-
-        if let plugin, let url = await findIconFromPluginDirectory(pluginInfo: plugin) {
-            return url
-        }
-
-        if let url = await findIconFromPluginDirectory(slug: slug) {
+        if let plugin, let url = Self.findIconFromPluginDirectory(pluginInfo: plugin) {
             return url
         }
 
-        if let url = await findIconFromSVNServer(slug: slug) {
+        if let plugin = try? await pluginDirectoryDataStore.get(slug), let url = Self.findIconFromPluginDirectory(pluginInfo: plugin) {
             return url
         }
 
-        return nil
+        return await iconResolver.iconURL(forSlug: slug.slug)
     }
 
     public func updatePluginStatus(plugin: InstalledPlugin, activated: Bool) async throws -> InstalledPlugin {
@@ -118,28 +118,49 @@ public actor PluginService: PluginServiceProtocol {
     }
 }
 
-private extension PluginService {
-    func findIconFromPluginDirectory(slug: PluginWpOrgDirectorySlug) async -> URL? {
-        let pluginInfo: PluginInformation
+extension PluginIconResolver {
+    /// The resolver of all the plugin services: they remember the icons under the same disk cache key,
+    /// and the icons of the plugin directory don't depend on the site.
+    static let shared: PluginIconResolver = {
+        let urlSession = URLSession(configuration: .ephemeral)
+        let wpOrgClient = WordPressOrgApiClient(urlSession: urlSession)
+        return PluginIconResolver(urlSession: urlSession, cache: DiskCache.shared) { slugs in
+            await PluginService.findIconsFromPluginDirectory(slugs: slugs, using: wpOrgClient)
+        }
+    }()
+}
 
-        do {
-            if try await pluginDirectoryDataStore.get(slug) == nil {
-                try await fetchPluginInformation(slug: slug)
+private extension PluginService {
+    /// The maximum number of plugin directory requests in flight when looking up icons.
+    static let maxConcurrentDirectoryRequests = 4
+
+    static func findIconsFromPluginDirectory(slugs: [String], using wpOrgClient: WordPressOrgApiClient) async -> [String: URL] {
+        let plugins = await withTaskGroup(of: PluginInformation?.self) { group in
+            var slugs = slugs.map(PluginWpOrgDirectorySlug.init(slug:)).makeIterator()
+            for _ in 0..<Self.maxConcurrentDirectoryRequests {
+                guard let slug = slugs.next() else { break }
+                group.addTask { try? await wpOrgClient.pluginInformation(slug: slug) }
             }
-
-            if let info = try await pluginDirectoryDataStore.get(slug) {
-                pluginInfo = info
-            } else {
-                return nil
+            var fetched: [PluginInformation] = []
+            for await plugin in group {
+                if let plugin {
+                    fetched.append(plugin)
+                }
+                if let slug = slugs.next() {
+                    group.addTask { try? await wpOrgClient.pluginInformation(slug: slug) }
+                }
             }
-        } catch {
-            return nil
+            return fetched
         }
 
-        return await findIconFromPluginDirectory(pluginInfo: pluginInfo)
+        var icons: [String: URL] = [:]
+        for plugin in plugins {
+            icons[plugin.slug.slug] = findIconFromPluginDirectory(pluginInfo: plugin)
+        }
+        return icons
     }
 
-    func findIconFromPluginDirectory(pluginInfo: PluginInformation) async -> URL? {
+    static func findIconFromPluginDirectory(pluginInfo: PluginInformation) -> URL? {
         guard let icons = pluginInfo.icons else { return nil }
 
         let supportedFormat: Set<String> = ["png", "jpg", "jpeg", "gif"]
@@ -155,29 +176,6 @@ private extension PluginService {
         return nil
     }
 
-    func findIconFromSVNServer(slug: PluginWpOrgDirectorySlug) async -> URL? {
-        let url = URL(string: "https://ps.w.org")!
-            .appending(path: slug.slug)
-            .appending(path: "assets")
-        let size = [256, 128]
-        let supportedFormat = ["png", "jpg", "jpeg", "gif"]
-        let candidates = zip(size, supportedFormat).map { size, format in
-            url.appending(path: "icon-\(size)x\(size).\(format)")
-        }
-
-        for url in candidates {
-            var request = URLRequest(url: url)
-            request.httpMethod = "HEAD"
-
-            if let (_, response) = try? await urlSession.data(for: request),
-               (response  as? HTTPURLResponse)?.statusCode == 200 {
-                return url
-            }
-        }
-
-        return nil
-    }
-
     func checkPluginUpdates(plugins: [PluginWithViewContext]) async throws {
         let updateCheck = try await wpOrgClient.checkPluginUpdates(
             // Use a fairly recent version if the actual version is unknown.
@@ -1,64 +1,203 @@
 import Foundation
 
+/// A thread-safe hash map.
+///
+/// The keys are distributed across a number of shards, each protected by
+/// its own lock, so the callers accessing different keys rarely contend.
 public class LockingHashMap<Value>: @unchecked Sendable {
-    let lock = NSLock()
+    private let shards: [Shard]
+    private let shardMask: Int
 
-    var list: [AnyHashable: Value] = [:]
+    /// - parameters:
+    ///   - values: The initial values.
+    ///   - shardCount: The number of shards, rounded up to the power of two.
+    public init(_ values: [AnyHashable: Value] = [:], shardCount: Int = 16) {
+        var count = 1
+        while count < max(shardCount, 1) {
+            count <<= 1
+        }
+        self.shards = (0..<count).map { _ in Shard() }
+        self.shardMask = count - 1
 
-    public init(_ values: [AnyHashable: Value] = [:]) {
-        self.list = values
+        for (key, value) in values {
+            shard(for: key).storage[key] = value
+        }
     }
 
     public subscript(_ key: AnyHashable) -> Value? {
         get {
-            lock.withLock {
-                list[key]
+            let shard = shard(for: key)
+            return shard.lock.withLock {
+                shard.storage[key]
             }
         }
         set {
-            lock.withLock {
-                list[key] = newValue
+            let shard = shard(for: key)
+            shard.lock.withLock {
+                shard.storage[key] = newValue
             }
         }
     }
 
-    public var values: Dictionary<AnyHashable, Value>.Values {
-        lock.withLock {
-            self.list.values
+    /// Returns a snapshot of the stored values.
+    ///
+    /// - note: The shards are locked one at a time, so the snapshot may
+    /// include changes made concurrently to the shards visited later.
+    public var values: [Value] {
+        shards.flatMap { shard in
+            shard.lock.withLock {
+                Array(shard.storage.values)
+            }
+        }
+    }
+
+    /// Returns a snapshot of the stored keys and values.
+    public var snapshot: [AnyHashable: Value] {
+        var output: [AnyHashable: Value] = [:]
+        for shard in shards {
+            shard.lock.withLock {
+                output.merge(shard.storage) { _, new in new }
+            }
+        }
+        return output
+    }
+
+    public var count: Int {
+        shards.reduce(0) { count, shard in
+            count + shard.lock.withLock { shard.storage.count }
+        }
+    }
+
+    /// Returns the value for the given key, inserting the value returned by
+    /// `makeValue` if there is none.
+    ///
+    /// The check and the insertion are performed atomically, so `makeValue`
+    /// is called at most once for a missing key.
+    ///
+    /// - warning: `makeValue` is called while the shard is locked and must not
+    /// access the map.
+    public func getOrInsert(_ key: AnyHashable, _ makeValue: () throws -> Value) rethrows -> Value {
+        try getOrInsertValue(key, makeValue).value
+    }
+
+    /// Atomically updates the value for the given key.
+    ///
+    /// - parameter transform: Receives the current value (if any) and returns
+    /// the new one. Return `nil` to remove the value.
+    /// - returns: The new value.
+    ///
+    /// - warning: `transform` is called while the shard is locked and must not
+    /// access the map.
+    @discardableResult
+    public func compute(_ key: AnyHashable, _ transform: (Value?) throws -> Value?) rethrows -> Value? {
+        let shard = shard(for: key)
+        return try shard.lock.withLock {
+            let value = try transform(shard.storage[key])
+            shard.storage[key] = value
+            return value
         }
     }
 
     @discardableResult
     public func removeValue(forKey key: AnyHashable) -> Value? {
-        lock.withLock {
-            self.list.removeValue(forKey: key)
+        let shard = shard(for: key)
+        return shard.lock.withLock {
+            shard.storage.removeValue(forKey: key)
         }
     }
 
     public func removeAll() {
-        lock.withLock {
-            self.list.removeAll()
+        _ = removeAllValues()
+    }
+
+    // MARK: - Internal
+
+    func getOrInsertValue(_ key: AnyHashable, _ makeValue: () throws -> Value) rethrows -> (value: Value, isInserted: Bool) {
+        let shard = shard(for: key)
+        return try shard.lock.withLock {
+            if let value = shard.storage[key] {
+                return (value, false)
+            }
+            let value = try makeValue()
+            shard.storage[key] = value
+            return (value, true)
         }
     }
+
+    /// The number of values in each shard.
+    var shardSizes: [Int] {
+        shards.map { shard in
+            shard.lock.withLock { shard.storage.count }
+        }
+    }
+
+    /// Removes all values and returns the removed ones.
+    func removeAllValues() -> [Value] {
+        shards.flatMap { shard in
+            shard.lock.withLock {
+                let values = Array(shard.storage.values)
+                shard.storage.removeAll()
+                return values
+            }
+        }
+    }
+
+    private func shard(for key: AnyHashable) -> Shard {
+        shards[key.hashValue & shardMask]
+    }
+
+    private final class Shard {
+        let lock = NSLock()
+        var storage: [AnyHashable: Value] = [:]
+    }
 }
 
+/// A thread-safe hash map of tasks that cancels the tasks when they are
+/// removed.
 public class LockingTaskHashMap<T, E>: LockingHashMap<Task<T, E>>, @unchecked Sendable where T: Sendable, E: Error {
 
     @discardableResult
     public override func removeValue(forKey key: AnyHashable) -> Task<T, E>? {
-        lock.withLock {
-            let task = self.list.removeValue(forKey: key)
-            task?.cancel()
-            return task
-        }
+        let task = super.removeValue(forKey: key)
+        task?.cancel()
+        return task
     }
 
     public override func removeAll() {
-        lock.withLock {
-            for key in self.list.keys {
-                let task = self.list.removeValue(forKey: key)
-                task?.cancel()
+        for task in removeAllValues() {
+            task.cancel()
+        }
+    }
+
+    /// Returns the in-flight task for the given key or starts a new one.
+    ///
+    /// The task is removed from the map when it completes, so the next call
+    /// after that starts a new one.
+    public func task(forKey key: AnyHashable, makeTask: () -> Task<T, E>) -> Task<T, E> {
+        let (task, isInserted) = getOrInsertValue(key, makeTask)
+        if isInserted {
+            Task {
+                _ = await task.result
+                // Remove without cancelling, and only if it wasn't replaced.
+                compute(key) { $0 == task ? nil : $0 }
             }
         }
+        return task
+    }
+}
+
+extension LockingTaskHashMap where E == Never {
+    /// Returns the in-flight task for the given key or starts a new one
+    /// performing the given operation.
+    public func task(forKey key: AnyHashable, operation: @escaping @Sendable () async -> T) -> Task<T, Never> {
+        task(forKey: key, makeTask: { Task { await operation() } })
+    }
+}
+
+extension LockingTaskHashMap where E == any Error {
+    /// Returns the in-flight task for the given key or starts a new one
+    /// performing the given operation.
+    public func task(forKey key: AnyHashable, operation: @escaping @Sendable () async throws -> T) -> Task<T, any Error> {
+        task(forKey: key, makeTask: { Task { try await operation() } })
     }
 }
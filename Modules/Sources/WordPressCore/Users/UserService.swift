@@ -5,8 +5,27 @@ import WordPressAPI
 /// UserService is responsible for fetching user acounts via the .org REST API – it's the replacement for `UsersService` (the XMLRPC-based approach)
 ///
 public actor UserService: UserServiceProtocol {
+    /// A page of users, and the total number of pages if the server reported it.
+    struct UserPage: Sendable {
+        var users: [DisplayUser]
+        /// The number of users returned by the server, including the ones that can't be displayed.
+        var fetchedCount: Int
+        var totalPages: Int?
+    }
+
+    typealias PageFetcher = @Sendable (_ page: Int, _ perPage: Int) async throws -> UserPage
+
+    static let pageSize = 100
+
+    /// The maximum number of pages fetched concurrently once the total number of pages is known.
+    static let maxConcurrentPageRequests = 4
+
     private let client: WordPressClient
     private let userDataStore: InMemoryUserDataStore = .init()
+    private let fetchPage: PageFetcher
+
+    /// Incremented by every `fetchUsers()` call.
+    private var syncGeneration = 0
 
     private var _currentUser: UserWithEditContext?
     private var currentUser: UserWithEditContext? {
@@ -19,21 +38,75 @@ public actor UserService: UserServiceProtocol {
     }
 
     public init(client: WordPressClient) {
+        self.init(client: client) { page, perPage in
+            let response = try await client.api.users.listWithEditContext(
+                params: UserListParams(page: UInt32(page), perPage: UInt32(perPage))
+            )
+            return UserPage(
+                users: response.data.compactMap { DisplayUser(user: $0) },
+                fetchedCount: response.data.count,
+                totalPages: response.headerMap.wpTotalPages().map { Int($0) }
+            )
+        }
+    }
+
+    init(client: WordPressClient, fetchPage: @escaping PageFetcher) {
         self.client = client
+        self.fetchPage = fetchPage
     }
 
+    /// Fetches all users and updates the cached users in place.
+    ///
+    /// The fetched users are tagged with the generation of this sync, and the users that no
+    /// sync of this generation returned are removed once the last page is stored.
     public func fetchUsers() async throws {
-        let sequence = client.api.users.sequenceWithEditContext(params: .init(perPage: 100))
-        var started = false
-        for try await users in sequence {
-            if !started {
-                try await userDataStore.delete(query: .all)
-            }
+        syncGeneration += 1
+        let generation = syncGeneration
+        let pageSize = Self.pageSize
+        let fetchPage = self.fetchPage
 
-            try await userDataStore.store(users.compactMap { DisplayUser(user: $0) })
+        let firstPage = try await fetchPage(1, pageSize)
+        guard try await storePage(firstPage.users, generation: generation) else { return }
 
-            started = true
+        if let totalPages = firstPage.totalPages {
+            try await withThrowingTaskGroup(of: [DisplayUser].self) { group in
+                var pages = stride(from: 2, through: totalPages, by: 1).makeIterator()
+                for _ in 0..<Self.maxConcurrentPageRequests {
+                    guard let page = pages.next() else { break }
+                    group.addTask { try await fetchPage(page, pageSize).users }
+                }
+                for try await users in group {
+                    guard try await storePage(users, generation: generation) else {
+                        group.cancelAll()
+                        return
+                    }
+                    if let page = pages.next() {
+                        group.addTask { try await fetchPage(page, pageSize).users }
+                    }
+                }
+            }
+        } else {
+            // Without the total, fetch the pages one by one until a page isn't full.
+            var page = firstPage
+            var pageNumber = 1
+            while page.fetchedCount >= pageSize {
+                pageNumber += 1
+                page = try await fetchPage(pageNumber, pageSize)
+                guard try await storePage(page.users, generation: generation) else { return }
+            }
         }
+
+        // A newer sync removes the stale users when it completes.
+        guard generation == syncGeneration else { return }
+        try await userDataStore.deleteItems(notStoredBy: generation)
+    }
+
+    /// Returns `false` without storing the users if a newer sync has started, in which case
+    /// the sync of the given generation is abandoned.
+    private func storePage(_ users: [DisplayUser], generation: Int) async throws -> Bool {
+        guard generation == syncGeneration else { return false }
+        try await userDataStore.store(users, generation: generation)
+        return true
     }
 
     public func isCurrentUserCapableOf(_ capability: UserCapability) async -> Bool {
@@ -36,85 +36,103 @@ extension ReaderPost {
         return post
     }
 
+    /// Updates the given existing post, or a new one if `nil`, from a `RemoteReaderPost`.
+    ///
+    /// Use it instead of ``createOrUpdate(with:topic:context:)`` when the
+    /// existing posts were already fetched in bulk.
+    public static func createOrUpdate(
+        with remotePost: RemoteReaderPost,
+        existing: ReaderPost?,
+        topic: ReaderAbstractTopic?,
+        context: NSManagedObjectContext
+    ) -> ReaderPost {
+        let post = existing ?? context.insertNewObject(ofType: ReaderPost.self)
+        post.update(with: remotePost, isExisting: existing != nil, topic: topic, in: context)
+        return post
+    }
+
     /// Updates the receiver with values from a `RemoteReaderPost`.
+    ///
+    /// Only the values that differ from the current ones are assigned, so
+    /// refreshing a post that didn't change on the server leaves it clean.
     func update(
         with remotePost: RemoteReaderPost,
         isExisting: Bool,
         topic: ReaderAbstractTopic?,
         in context: NSManagedObjectContext
     ) {
-        authorID = remotePost.authorID
-        author = remotePost.author
-        authorAvatarURL = remotePost.authorAvatarURL
-        authorDisplayName = remotePost.authorDisplayName
-        authorEmail = remotePost.authorEmail
-        authorURL = remotePost.authorURL
+        setIfChanged(\.authorID, remotePost.authorID)
+        setIfChanged(\.author, remotePost.author)
+        setIfChanged(\.authorAvatarURL, remotePost.authorAvatarURL)
+        setIfChanged(\.authorDisplayName, remotePost.authorDisplayName)
+        setIfChanged(\.authorEmail, remotePost.authorEmail)
+        setIfChanged(\.authorURL, remotePost.authorURL)
         if let organizationID = remotePost.organizationID {
-            self.organizationID = organizationID
+            setIfChanged(\.organizationID, organizationID)
         }
-        siteIconURL = remotePost.siteIconURL
-        blogName = remotePost.blogName
-        blogDescription = remotePost.blogDescription
-        blogURL = remotePost.blogURL
-        commentCount = remotePost.commentCount
-        commentsOpen = remotePost.commentsOpen
-        date_created_gmt = Date.dateFromServerDate(remotePost.date_created_gmt ?? "")
-        featuredImage = remotePost.featuredImage
-        feedID = remotePost.feedID
-        feedItemID = remotePost.feedItemID
-        globalID = remotePost.globalID
-        isBlogAtomic = remotePost.isBlogAtomic
-        isBlogPrivate = remotePost.isBlogPrivate
-        isFollowing = remotePost.isFollowing
-        isLiked = remotePost.isLiked
-        isReblogged = remotePost.isReblogged
-        useExcerpt = remotePost.useExcerpt
-        isWPCom = remotePost.isWPCom
-        likeCount = remotePost.likeCount
-        permaLink = remotePost.permalink
-        postID = remotePost.postID
-        postTitle = remotePost.postTitle
-        mt_excerpt = remotePost.excerpt?.nonEmptyString()
-        railcar = remotePost.railcar
-        score = remotePost.score
-        siteID = remotePost.siteID
-        sortDate = remotePost.sortDate
-        isSeen = remotePost.isSeen
-        isSeenSupported = remotePost.isSeenSupported
-        isSubscribedComments = remotePost.isSubscribedComments
-        canSubscribeComments = remotePost.canSubscribeComments
-        receivesCommentNotifications = remotePost.receivesCommentNotifications
+        setIfChanged(\.siteIconURL, remotePost.siteIconURL)
+        setIfChanged(\.blogName, remotePost.blogName)
+        setIfChanged(\.blogDescription, remotePost.blogDescription)
+        setIfChanged(\.blogURL, remotePost.blogURL)
+        setIfChanged(\.commentCount, remotePost.commentCount)
+        setIfChanged(\.commentsOpen, remotePost.commentsOpen)
+        setIfChanged(\.date_created_gmt, Date.dateFromServerDate(remotePost.date_created_gmt ?? ""))
+        setIfChanged(\.featuredImage, remotePost.featuredImage)
+        setIfChanged(\.feedID, remotePost.feedID)
+        setIfChanged(\.feedItemID, remotePost.feedItemID)
+        setIfChanged(\.globalID, remotePost.globalID)
+        setIfChanged(\.isBlogAtomic, remotePost.isBlogAtomic)
+        setIfChanged(\.isBlogPrivate, remotePost.isBlogPrivate)
+        setIfChanged(\.isFollowing, remotePost.isFollowing)
+        setIfChanged(\.isLiked, remotePost.isLiked)
+        setIfChanged(\.isReblogged, remotePost.isReblogged)
+        setIfChanged(\.useExcerpt, remotePost.useExcerpt)
+        setIfChanged(\.isWPCom, remotePost.isWPCom)
+        setIfChanged(\.likeCount, remotePost.likeCount)
+        setIfChanged(\.permaLink, remotePost.permalink)
+        setIfChanged(\.postID, remotePost.postID)
+        setIfChanged(\.postTitle, remotePost.postTitle)
+        setIfChanged(\.mt_excerpt, remotePost.excerpt?.nonEmptyString())
+        setIfChanged(\.railcar, remotePost.railcar)
+        setIfChanged(\.score, remotePost.score)
+        setIfChanged(\.siteID, remotePost.siteID)
+        setIfChanged(\.sortDate, remotePost.sortDate)
+        setIfChanged(\.isSeen, remotePost.isSeen)
+        setIfChanged(\.isSeenSupported, remotePost.isSeenSupported)
+        setIfChanged(\.isSubscribedComments, remotePost.isSubscribedComments)
+        setIfChanged(\.canSubscribeComments, remotePost.canSubscribeComments)
+        setIfChanged(\.receivesCommentNotifications, remotePost.receivesCommentNotifications)
 
         // The `read/search` endpoint might return the same post on more than one
         // page. If this happens, preserve the original sortRank to avoid content
         // jumping around in the UI.
         if !(isExisting && topic is ReaderSearchTopic), let sortRank = remotePost.sortRank {
-            self.sortRank = sortRank
+            setIfChanged(\.sortRank, sortRank)
         }
 
-        statusString = remotePost.status
-        summary = remotePost.summary
-        tags = remotePost.tags
-        isSharingEnabled = remotePost.isSharingEnabled
-        isLikesEnabled = remotePost.isLikesEnabled
-        isSiteBlocked = false
+        setIfChanged(\.statusString, remotePost.status)
+        setIfChanged(\.summary, remotePost.summary)
+        setIfChanged(\.tags, remotePost.tags)
+        setIfChanged(\.isSharingEnabled, remotePost.isSharingEnabled)
+        setIfChanged(\.isLikesEnabled, remotePost.isLikesEnabled)
+        setIfChanged(\.isSiteBlocked, false)
 
         updateCrossPostMeta(from: remotePost, in: context)
         updatePrimaryTag(from: remotePost, topic: topic)
 
-        isExternal = remotePost.isExternal
-        isJetpack = remotePost.isJetpack
-        wordCount = remotePost.wordCount
-        readingTime = remotePost.readingTime
+        setIfChanged(\.isExternal, remotePost.isExternal)
+        setIfChanged(\.isJetpack, remotePost.isJetpack)
+        setIfChanged(\.wordCount, remotePost.wordCount)
+        setIfChanged(\.readingTime, remotePost.readingTime)
 
         updateSourceAttribution(from: remotePost, in: context)
 
-        content = RichContentFormatter.removeInlineStyles(
+        setIfChanged(\.content, RichContentFormatter.removeInlineStyles(
             RichContentFormatter.removeForbiddenTags(remotePost.content ?? "")
-        )
+        ))
 
-        self.topic = topic
-        pathForDisplayImage = remotePost.autoSuggestedFeaturedImage
+        setIfChanged(\.topic, topic)
+        setIfChanged(\.pathForDisplayImage, remotePost.autoSuggestedFeaturedImage)
     }
 }
 
@@ -123,16 +141,16 @@ extension ReaderPost {
 private extension ReaderPost {
     func updateCrossPostMeta(from remotePost: RemoteReaderPost, in context: NSManagedObjectContext) {
         guard let remoteMeta = remotePost.crossPostMeta else {
-            crossPostMeta = nil
+            setIfChanged(\.crossPostMeta, nil)
             return
         }
         let meta = crossPostMeta ?? context.insertNewObject(ofType: ReaderCrossPostMeta.self)
-        meta.siteURL = remoteMeta.siteURL ?? ""
-        meta.postURL = remoteMeta.postURL ?? ""
-        meta.commentURL = remoteMeta.commentURL ?? ""
-        meta.siteID = remoteMeta.siteID ?? 0
-        meta.postID = remoteMeta.postID ?? 0
-        crossPostMeta = meta
+        meta.setIfChanged(\.siteURL, remoteMeta.siteURL ?? "")
+        meta.setIfChanged(\.postURL, remoteMeta.postURL ?? "")
+        meta.setIfChanged(\.commentURL, remoteMeta.commentURL ?? "")
+        meta.setIfChanged(\.siteID, remoteMeta.siteID ?? 0)
+        meta.setIfChanged(\.postID, remoteMeta.postID ?? 0)
+        setIfChanged(\.crossPostMeta, meta)
     }
 
     func updatePrimaryTag(from remotePost: RemoteReaderPost, topic: ReaderAbstractTopic?) {
@@ -143,29 +161,29 @@ private extension ReaderPost {
             tag = remotePost.secondaryTag
             slug = remotePost.secondaryTagSlug
         }
-        primaryTag = tag
-        primaryTagSlug = slug
+        setIfChanged(\.primaryTag, tag)
+        setIfChanged(\.primaryTagSlug, slug)
     }
 
     func updateSourceAttribution(from remotePost: RemoteReaderPost, in context: NSManagedObjectContext) {
         guard let remote = remotePost.sourceAttribution else {
-            sourceAttribution = nil
+            setIfChanged(\.sourceAttribution, nil)
             return
         }
         let attribution = sourceAttribution ?? context.insertNewObject(ofType: SourcePostAttribution.self)
 
-        attribution.authorName = remote.authorName
-        attribution.authorURL = remote.authorURL
-        attribution.avatarURL = remote.avatarURL
-        attribution.blogName = remote.blogName
-        attribution.blogURL = remote.blogURL
-        attribution.permalink = remote.permalink
-        attribution.blogID = remote.blogID
-        attribution.postID = remote.postID
-        attribution.commentCount = remote.commentCount
-        attribution.likeCount = remote.likeCount
-        attribution.attributionType = Self.attributionType(from: remote.taxonomies)
-        sourceAttribution = attribution
+        attribution.setIfChanged(\.authorName, remote.authorName)
+        attribution.setIfChanged(\.authorURL, remote.authorURL)
+        attribution.setIfChanged(\.avatarURL, remote.avatarURL)
+        attribution.setIfChanged(\.blogName, remote.blogName)
+        attribution.setIfChanged(\.blogURL, remote.blogURL)
+        attribution.setIfChanged(\.permalink, remote.permalink)
+        attribution.setIfChanged(\.blogID, remote.blogID)
+        attribution.setIfChanged(\.postID, remote.postID)
+        attribution.setIfChanged(\.commentCount, remote.commentCount)
+        attribution.setIfChanged(\.likeCount, remote.likeCount)
+        attribution.setIfChanged(\.attributionType, Self.attributionType(from: remote.taxonomies))
+        setIfChanged(\.sourceAttribution, attribution)
     }
 
     static func attributionType(from taxonomies: [Any]?) -> String? {
@@ -387,19 +387,27 @@ public extension AbstractPost {
     }
 
     /// Updates the path for the display image by looking at the post content and trying to find an good image to use.
-    /// If no appropiated image is found the path is set to nil.
+    /// If no appropiated image is found the path is left unchanged.
     @objc
     func updatePathForDisplayImageBasedOnContent() {
+        if let path = pathForDisplayImageBasedOnContent() {
+            setIfChanged(\.pathForDisplayImage, path)
+        }
+    }
+
+    /// Returns the path of a good image to display for the post found in its
+    /// content, or `nil` if there is none.
+    @objc
+    func pathForDisplayImageBasedOnContent() -> String? {
         guard let content else {
-            return
+            return nil
         }
 
         if let result = DisplayableImageHelper.searchPostContentForImage(toDisplay: content), !result.isEmpty {
-            pathForDisplayImage = result
-            return
+            return result
         }
 
-        guard let allMedia = blog.media, !allMedia.isEmpty else { return }
+        guard let allMedia = blog.media, !allMedia.isEmpty else { return nil }
 
         let mediaIDs = DisplayableImageHelper.searchPostContentForAttachmentIds(inGalleries: content) as? Set<NSNumber> ?? []
         for media in allMedia {
@@ -409,9 +417,9 @@ public extension AbstractPost {
             }
 
             if let remoteURL = media.remoteURL {
-                pathForDisplayImage = remoteURL
-                break
+                return remoteURL
             }
         }
+        return nil
     }
 }
@@ -63,6 +63,8 @@ extension ContextManager {
             return
         }
 
+        logChangeStatistics(for: context)
+
         let inserted = Array(context.insertedObjects)
         do {
             try context.obtainPermanentIDs(for: inserted)
@@ -76,10 +78,40 @@ extension ContextManager {
             handleSaveError(error as NSError, in: context)
         }
     }
+
+    /// Saves the context like `internalSave(_:)`, but throws the error instead
+    /// of raising an exception, for the callers that report it.
+    func throwingSave(_ context: NSManagedObjectContext) throws {
+        guard context.hasChanges else {
+            return
+        }
+
+        logChangeStatistics(for: context)
+
+        // The objects inserted in a child context must get their permanent IDs
+        // before they are pushed to the parent, or they keep the temporary ones.
+        try context.obtainPermanentIDs(for: Array(context.insertedObjects))
+        try context.save()
+    }
 }
 
 private extension ContextManager {
 
+    /// Logs how many objects the save writes, flagging the objects that were
+    /// updated without changes to help find the mapping code responsible.
+    func logChangeStatistics(for context: NSManagedObjectContext) {
+        guard DDLogFlag.from(dynamicLogLevel).contains(.debug) else {
+            return
+        }
+        let statistics = ContextChangeStatistics(pendingChangesIn: context)
+        let contextName = context == mainContext ? "main" : (context.name ?? "derived")
+        if statistics.redundantUpdates > 0 {
+            DDLogDebug("Saving \(contextName) context with objects updated without changes (\(statistics))")
+        } else {
+            DDLogVerbose("Saving \(contextName) context (\(statistics))")
+        }
+    }
+
     func handleSaveError(_ error: NSError, in context: NSManagedObjectContext) {
         let isMainContext = context == mainContext
         let exceptionName: NSExceptionName = isMainContext ? .coreDataSaveMainException : .coreDataSaveDerivedException
@@ -25,6 +25,28 @@ public class ContextManager: NSObject, CoreDataStack, CoreDataStackSwift {
     ///   removed soon, I think it's okay to make this compromise.
     private let writerQueue: OperationQueue
 
+    /// The background contexts used by the `performAndSave` functions.
+    let contextPool: ManagedObjectContextPool
+
+    /// Guards `openCoalescedBatch` and the order in which the writes are added to `writerQueue`.
+    private let writeSchedulingLock = NSLock()
+
+    /// The batch that the next coalesced write joins, until the batch starts running or
+    /// another (non-coalesced) write is scheduled after it.
+    private var openCoalescedBatch: CoalescedWriteBatch?
+
+    /// The maximum number of coalesced writes saved in one transaction.
+    static let maximumCoalescedWriteCount = 50
+
+    /// Merges the changes made by batch requests into the main context.
+    let persistentHistory: PersistentHistoryTracker
+
+    /// The persistent history author of the saves made by the contexts in this process.
+    static let transactionAuthor = "app"
+
+    /// The persistent history author of the batch requests executed using `executeBatchRequest(_:)`.
+    public static let batchRequestTransactionAuthor = "app.batch"
+
     @objc
     public var mainContext: NSManagedObjectContext {
         persistentContainer.viewContext
@@ -49,31 +71,59 @@ public class ContextManager: NSObject, CoreDataStack, CoreDataStackSwift {
 
         self.modelName = modelName
         self.storeURL = storeURL
-        self.persistentContainer = Self.createPersistentContainer(storeURL: storeURL, modelName: modelName)
+        let persistentContainer = Self.createPersistentContainer(storeURL: storeURL, modelName: modelName)
+        self.persistentContainer = persistentContainer
         self.writerQueue = OperationQueue()
         self.writerQueue.name = "org.wordpress.CoreDataStack.writer"
         self.writerQueue.maxConcurrentOperationCount = 1
+        // One context for `writerQueue`, the rest for the synchronous (and nested) writes.
+        self.contextPool = ManagedObjectContextPool(capacity: 3) {
+            let context = persistentContainer.newBackgroundContext()
+            context.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy
+            context.transactionAuthor = ContextManager.transactionAuthor
+            return context
+        }
+        self.persistentHistory = PersistentHistoryTracker(
+            coordinator: persistentContainer.persistentStoreCoordinator,
+            mainContext: persistentContainer.viewContext,
+            tokenURL: storeURL == Self.inMemoryStoreURL ? nil : storeURL.appendingPathExtension("history-token"),
+            ownTransactionAuthor: Self.transactionAuthor
+        )
 
         super.init()
 
         mainContext.automaticallyMergesChangesFromParent = true
         mainContext.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy
+        mainContext.transactionAuthor = Self.transactionAuthor
+        persistentHistory.startObservingRemoteChanges()
         NullBlogPropertySanitizer(context: mainContext).sanitize()
     }
 
     public func newDerivedContext() -> NSManagedObjectContext {
         let context = persistentContainer.newBackgroundContext()
         context.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy
+        context.transactionAuthor = Self.transactionAuthor
         return context
     }
 
+    /// Merges the changes made to the store by batch requests into the main context.
+    ///
+    /// The app extensions use their own store, so the changes come from this process only. It's called
+    /// automatically when the store changes while the app is running. Call it when the app returns to the
+    /// foreground to pick up the changes made by the background tasks while the UI wasn't updated.
+    @objc
+    public func mergePersistentHistory() {
+        persistentHistory.scheduleProcessing()
+    }
+
     @objc(performAndSaveUsingBlock:)
     public func performAndSave(_ block: @escaping (NSManagedObjectContext) -> Void) {
-        let context = newDerivedContext()
+        let context = contextPool.checkOut()
         context.performAndWait {
             block(context)
 
             self.save(context, .alreadyInContextQueue)
+            self.contextPool.checkIn(context)
         }
     }
 
@@ -83,13 +133,14 @@ public class ContextManager: NSObject, CoreDataStack, CoreDataStackSwift {
         completion: (() -> Void)?,
         on queue: DispatchQueue
     ) {
-        let context = newDerivedContext()
-        self.writerQueue.addOperation(
+        addWriteOperation(
             AsyncBlockOperation { done in
+                let context = self.contextPool.checkOut()
                 context.perform {
                     block(context)
 
                     self.save(context, .alreadyInContextQueue)
+                    self.contextPool.checkIn(context)
                     queue.async { completion?() }
                     done()
                 }
@@ -102,14 +153,16 @@ public class ContextManager: NSObject, CoreDataStack, CoreDataStackSwift {
         completion: ((Result<T, Error>) -> Void)?,
         on queue: DispatchQueue
     ) {
-        let context = newDerivedContext()
-        self.writerQueue.addOperation(
+        addWriteOperation(
             AsyncBlockOperation { done in
+                let context = self.contextPool.checkOut()
                 context.perform {
                     let result = Result(catching: { try block(context) })
                     if case .success = result {
                         self.save(context, .alreadyInContextQueue)
                     }
+                    // Discards the changes made by a block that threw an error.
+                    self.contextPool.checkIn(context)
                     queue.async { completion?(result) }
                     done()
                 }
@@ -138,6 +191,46 @@ public class ContextManager: NSObject, CoreDataStack, CoreDataStackSwift {
         }
     }
 
+    public func performAndSaveCoalesced<T>(
+        _ block: @escaping (NSManagedObjectContext) throws -> T,
+        completion: ((Result<T, Error>) -> Void)?,
+        on queue: DispatchQueue
+    ) {
+        let write = CoalescedWrite { context in
+            let result = Result(catching: { try block(context) })
+            let notifyCompletion = { (saveError: Error?) in
+                let result = saveError.map { Result<T, Error>.failure($0) } ?? result
+                queue.async { completion?(result) }
+            }
+            if case .failure = result {
+                return (false, notifyCompletion)
+            }
+            return (true, notifyCompletion)
+        }
+
+        writeSchedulingLock.lock()
+        defer { writeSchedulingLock.unlock() }
+
+        if let batch = openCoalescedBatch, batch.writes.count < Self.maximumCoalescedWriteCount {
+            batch.writes.append(write)
+            return
+        }
+
+        let batch = CoalescedWriteBatch(writes: [write])
+        openCoalescedBatch = batch
+        writerQueue.addOperation(
+            AsyncBlockOperation { done in
+                self.performCoalescedWrites(in: batch, done: done)
+            }
+        )
+    }
+
+    public func performAndSaveCoalesced<T>(_ block: @escaping (NSManagedObjectContext) throws -> T) async throws -> T {
+        try await withCheckedThrowingContinuation { continuation in
+            performAndSaveCoalesced(block, completion: { continuation.resume(with: $0) }, on: DispatchQueue.global())
+        }
+    }
+
     @objc
     public func saveContextAndWait(_ context: NSManagedObjectContext) {
         save(context, .synchronously)
@@ -216,6 +309,78 @@ private extension ContextManager {
         return url.appendingPathComponent("WordPress.sqlite")
     }
 
+    /// Adds a write to `writerQueue`, after the writes (including the coalesced ones) scheduled before it.
+    func addWriteOperation(_ operation: Operation) {
+        writeSchedulingLock.lock()
+        defer { writeSchedulingLock.unlock() }
+
+        // The coalesced writes scheduled from now on must run after this one.
+        openCoalescedBatch = nil
+        writerQueue.addOperation(operation)
+    }
+
+    /// Runs the writes in the batch and saves their changes in one transaction, which the main context
+    /// merges in one go.
+    ///
+    /// Each write is made in its own child context, which is only saved into the batch's context if the write
+    /// succeeds. That way, a write sees the changes made by the writes before it, as if they were saved
+    /// separately, and a write that throws an error doesn't discard the changes made by the others.
+    ///
+    /// A write whose changes can't be saved into the batch's context completes with the save error, and so
+    /// do all the writes of the batch if the batch's context can't be saved.
+    func performCoalescedWrites(in batch: CoalescedWriteBatch, done: @escaping () -> Void) {
+        writeSchedulingLock.lock()
+        if openCoalescedBatch === batch {
+            openCoalescedBatch = nil
+        }
+        let writes = batch.writes
+        writeSchedulingLock.unlock()
+
+        let context = contextPool.checkOut()
+        context.perform {
+            var completions = [(saveError: Error?, notify: (Error?) -> Void)]()
+            if writes.count == 1, let write = writes.first {
+                let (isSuccess, notifyCompletion) = write.perform(context)
+                if !isSuccess {
+                    context.rollback()
+                }
+                completions.append((nil, notifyCompletion))
+            } else {
+                for write in writes {
+                    let childContext = NSManagedObjectContext(concurrencyType: .privateQueueConcurrencyType)
+                    childContext.parent = context
+                    childContext.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy
+                    childContext.performAndWait {
+                        let (isSuccess, notifyCompletion) = write.perform(childContext)
+                        var saveError: Error?
+                        if isSuccess {
+                            do {
+                                try self.throwingSave(childContext)
+                            } catch {
+                                DDLogError("Failed to save a coalesced write: \(error)")
+                                saveError = error
+                            }
+                        }
+                        completions.append((saveError, notifyCompletion))
+                    }
+                }
+            }
+
+            var batchSaveError: Error?
+            do {
+                try self.throwingSave(context)
+            } catch {
+                DDLogError("Failed to save the coalesced writes: \(error)")
+                batchSaveError = error
+            }
+            self.contextPool.checkIn(context)
+            for completion in completions {
+                completion.notify(completion.saveError ?? batchSaveError)
+            }
+            done()
+        }
+    }
+
     func save(_ context: NSManagedObjectContext, _ option: SaveContextOption) {
         let block: () -> Void = {
             self.internalSave(context)
@@ -288,6 +453,13 @@ private extension ContextManager {
         return objectModel
     }
 
+    /// The options every coordinator that opens the store has to use: a store with persistent history
+    /// tracking is opened read-only by a coordinator that doesn't enable it.
+    static let persistentStoreOptions: [String: NSObject] = [
+        NSPersistentHistoryTrackingKey: true as NSNumber,
+        NSPersistentStoreRemoteChangeNotificationPostOptionKey: true as NSNumber
+    ]
+
     static func createPersistentContainer(storeURL: URL, modelName: String) -> NSPersistentContainer {
         let objectModel = objectModel(named: modelName)
 
@@ -304,6 +476,9 @@ private extension ContextManager {
         let storeDescription = NSPersistentStoreDescription(url: storeURL)
         storeDescription.shouldInferMappingModelAutomatically = true
         storeDescription.shouldMigrateStoreAutomatically = true
+        for (key, value) in persistentStoreOptions {
+            storeDescription.setOption(value, forKey: key)
+        }
         let persistentContainer = NSPersistentContainer(name: "WordPress", managedObjectModel: objectModel)
         persistentContainer.persistentStoreDescriptions = [storeDescription]
         persistentContainer.loadPersistentStores { _, error in
@@ -367,12 +542,30 @@ extension ContextManager {
             persistentContainer.loadPersistentStores { _, error in
                 assert(error == nil)
             }
+            persistentHistory.reset()
         } catch {
             NSLog("failed to reset store: \(error)")
         }
     }
 }
 
+/// A write scheduled using `performAndSaveCoalesced`.
+struct CoalescedWrite {
+    /// Makes the changes in the given context. Returns whether the changes should be saved and a closure that
+    /// calls the write's completion block, which must be called after the changes are saved, with the error
+    /// that prevented them from being saved, if any.
+    let perform: (NSManagedObjectContext) -> (isSuccess: Bool, notifyCompletion: (_ saveError: Error?) -> Void)
+}
+
+/// The adjacent coalesced writes waiting in `ContextManager.writerQueue` to be saved together.
+final class CoalescedWriteBatch {
+    var writes: [CoalescedWrite]
+
+    init(writes: [CoalescedWrite]) {
+        self.writes = writes
+    }
+}
+
 private enum SaveContextOption {
     case synchronously
     case asynchronously
@@ -288,8 +288,9 @@ public extension CoreDataStack {
         let databaseReplaced = replaceDatabase(from: databaseLocation, to: currentDatabaseLocation)
 
         do {
-            let options = [NSMigratePersistentStoresAutomaticallyOption: true,
-                           NSInferMappingModelAutomaticallyOption: true]
+            var options: [String: NSObject] = [NSMigratePersistentStoresAutomaticallyOption: true as NSNumber,
+                                               NSInferMappingModelAutomaticallyOption: true as NSNumber]
+            options.merge(ContextManager.persistentStoreOptions) { _, new in new }
             try storeCoordinator.addPersistentStore(ofType: NSSQLiteStoreType,
                                                     configurationName: nil,
                                                     at: currentDatabaseLocation,
@@ -313,7 +314,8 @@ public extension CoreDataStack {
             restoreDatabaseBackup(at: currentDatabaseLocation)
             _ = try? storeCoordinator.addPersistentStore(ofType: NSSQLiteStoreType,
                                                          configurationName: nil,
-                                                         at: currentDatabaseLocation)
+                                                         at: currentDatabaseLocation,
+                                                         options: ContextManager.persistentStoreOptions)
             throw error
         }
     }
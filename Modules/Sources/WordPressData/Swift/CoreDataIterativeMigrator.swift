@@ -6,23 +6,32 @@ import CoreData
 ///
 class CoreDataIterativeMigrator {
 
-    private static func error(with code: IterativeMigratorErrorCodes, description: String) -> NSError {
+    static func error(with code: IterativeMigratorErrorCodes, description: String) -> NSError {
         return NSError(domain: "IterativeMigrator", code: code.rawValue, userInfo: [NSLocalizedDescriptionKey: description])
     }
 
     /// Migrates a store to a particular model using the list of models to do it iteratively, if required.
     ///
+    /// Only the models between the store's version and the target model are loaded. The versions that can be
+    /// migrated with inferred mappings are migrated in a single lightweight step, and custom mapping models are
+    /// used where they exist. See `CoreDataMigrationPlan`.
+    ///
+    /// The steps write to temporary folders, and the store is only replaced once the last step succeeded.
+    /// If the app was terminated while the store was being replaced, the original store is restored from
+    /// its backup first, and migrated again.
+    ///
     /// - Parameters:
     ///     - sourceStore: URL of the store on disk.
     ///     - storeType: Type of store (usually NSSQLiteStoreType).
     ///     - to: The target/most current model the migrator should migrate to.
     ///     - using: List of models on disk, sorted in migration order, that should include the to: model.
-    ///
-    /// - Returns: True if the process succeeded and didn't run into any errors. False if there was any problem and the store was left untouched.
+    ///     - progress: Reports the progress of the migration, with a unit for each step of the plan.
     ///
     /// - Throws: A whole bunch of crap is possible to be thrown between Core Data and FileManager.
     ///
-    static func iterativeMigrate(sourceStore: URL, storeType: String, to targetModel: NSManagedObjectModel, using modelNames: [String]) throws {
+    static func iterativeMigrate(sourceStore: URL, storeType: String, to targetModel: NSManagedObjectModel, using modelNames: [String], progress: Progress? = nil) throws {
+        try restoreInterruptedReplacement(of: sourceStore)
+
         // If the persistent store does not exist at the given URL,
         // assume that it hasn't yet been created and return success immediately.
         guard FileManager.default.fileExists(atPath: sourceStore.path) == true else {
@@ -43,93 +52,13 @@ class CoreDataIterativeMigrator {
             return
         }
 
-        // Find the current model used by the store.
-        guard let sourceModel = try model(for: sourceMetadata) else {
-            return
-        }
-
-        // Get NSManagedObjectModels for each of the model names given.
-        let objectModels = try models(for: modelNames)
-
-        // Build an inclusive list of models between the source and final models.
-        var modelsToMigrate = [NSManagedObjectModel]()
-        var firstFound = false, lastFound = false, reverse = false
-
-        for model in objectModels {
-            if model.isEqual(sourceModel) || model.isEqual(targetModel) {
-                if firstFound {
-                    lastFound = true
-                    // In case a reverse migration is being performed (descending through the
-                    // ordered array of models), check whether the source model is found
-                    // after the final model.
-                    reverse = model.isEqual(sourceModel)
-                } else {
-                    firstFound = true
-                }
-            }
-
-            if firstFound {
-                modelsToMigrate.append(model)
-            }
-
-            if lastFound {
-                break
-            }
-        }
-
-        // Ensure that the source model is at the start of the list.
-        if reverse {
-            modelsToMigrate = modelsToMigrate.reversed()
-        }
-
-        // Nested function for retrieving a model's version name.
-        // Used to give more context to errors.
-        func versionNameForModel(model: NSManagedObjectModel) -> String {
-            guard let index = objectModels.firstIndex(of: model) else {
-                return "Unknown"
-            }
-            return modelNames[index]
-        }
-
-        // Migrate between each model. Count - 2 because of zero-based index and we want
-        // to stop at the last pair (you can't migrate the last model to nothingness).
-        let upperBound = modelsToMigrate.count - 2
-        for index in 0...upperBound {
-            let modelFrom = modelsToMigrate[index]
-            let modelTo = modelsToMigrate[index + 1]
-
-            let migrateWithModel: NSMappingModel
-            // Check whether a custom mapping model exists.
-            if let customModel = NSMappingModel(from: nil, forSourceModel: modelFrom, destinationModel: modelTo) {
-                migrateWithModel = customModel
-            } else {
-                // No custom model, so use an inferred model.
-                do {
-                    let inferredModel = try NSMappingModel.inferredMappingModel(forSourceModel: modelFrom, destinationModel: modelTo)
-                    migrateWithModel = inferredModel
-                } catch {
-                    let versionFrom = versionNameForModel(model: modelFrom)
-                    let versionTo = versionNameForModel(model: modelTo)
-                    var description = "Mapping model could not be inferred, and no custom mapping model found."
-                    description = description + "Version From \(versionFrom), To \(versionTo)."
-                    description = description + " Original Error: \(error)"
-                    throw CoreDataIterativeMigrator.error(with: IterativeMigratorErrorCodes.failedOnCustomMappingModel, description: description)
-                }
-            }
-
-            // Migrate the model to the next step
-            DDLogWarn("⚠️ Attempting migration from \(modelNames[index]) to \(modelNames[index + 1])")
-
-            do {
-                try migrateStore(at: sourceStore, storeType: storeType, fromModel: modelFrom, toModel: modelTo, with: migrateWithModel)
-            } catch {
-                let versionFrom = versionNameForModel(model: modelFrom)
-                let versionTo = versionNameForModel(model: modelTo)
-                var description = "Failed migrating store from version \(versionFrom) to version \(versionTo)."
-                description = description + " Original Error: \(error)"
-                throw CoreDataIterativeMigrator.error(with: IterativeMigratorErrorCodes.failedMigratingStore, description: description)
-            }
-        }
+        let plan = try CoreDataMigrationPlan(
+            storeMetadata: sourceMetadata,
+            targetModel: targetModel,
+            modelNames: modelNames,
+            loadModel: model(named:)
+        )
+        try migrateStore(at: sourceStore, storeType: storeType, following: plan, progress: progress)
     }
 
     static func backupDatabase(at storeURL: URL) throws {
@@ -141,22 +70,31 @@ class CoreDataIterativeMigrator {
 //
 private extension CoreDataIterativeMigrator {
 
-    /// Build a temporary path to write the migrated store.
+    /// Build a temporary path to write the store migrated by a step.
     ///
-    static func createTemporaryFolder(at storeURL: URL) -> URL {
+    static func createTemporaryFolder(at storeURL: URL, step: Int) -> URL {
         let fileManager = FileManager.default
-        let tempDestinationURL = storeURL.deletingLastPathComponent().appendingPathComponent("migration").appendingPathComponent(storeURL.lastPathComponent)
+        let tempDestinationURL = storeURL.deletingLastPathComponent()
+            .appendingPathComponent("migration")
+            .appendingPathComponent("\(step)")
+            .appendingPathComponent(storeURL.lastPathComponent)
         try? fileManager.removeItem(at: tempDestinationURL.deletingLastPathComponent())
-        try? fileManager.createDirectory(at: tempDestinationURL.deletingLastPathComponent(), withIntermediateDirectories: false, attributes: nil)
+        try? fileManager.createDirectory(at: tempDestinationURL.deletingLastPathComponent(), withIntermediateDirectories: true, attributes: nil)
 
         return tempDestinationURL
     }
 
+    /// Delete the stores written by the steps of a migration.
+    ///
+    static func removeTemporaryFolders(at storeURL: URL) {
+        try? FileManager.default.removeItem(at: storeURL.deletingLastPathComponent().appendingPathComponent("migration"))
+    }
+
     /// Move the original source store to a backup location.
     ///
-    static func makeBackup(at storeURL: URL) throws -> URL {
+    static func makeBackup(at storeURL: URL, folderName: String = "backup") throws -> URL {
         let fileManager = FileManager.default
-        let backupURL = storeURL.deletingLastPathComponent().appendingPathComponent("backup")
+        let backupURL = storeURL.deletingLastPathComponent().appendingPathComponent(folderName)
         try? fileManager.removeItem(at: backupURL)
         try? fileManager.createDirectory(atPath: backupURL.path, withIntermediateDirectories: false, attributes: nil)
         do {
@@ -176,19 +114,16 @@ private extension CoreDataIterativeMigrator {
         return backupURL
     }
 
-    /// Copy migrated over the original files
+    /// Move the migrated files in place of the original ones.
     ///
-    static func copyMigratedOverOriginal(from tempDestinationURL: URL, to storeURL: URL) throws {
+    static func copyMigratedOverOriginal(from migratedURL: URL, to storeURL: URL) throws {
         do {
             let fileManager = FileManager.default
-            let files = try fileManager.contentsOfDirectory(atPath: tempDestinationURL.deletingLastPathComponent().path)
-            try files.forEach { file in
-                if file.hasPrefix(tempDestinationURL.lastPathComponent) {
-                    let fullPath = tempDestinationURL.deletingLastPathComponent().appendingPathComponent(file).path
-                    let toPath = storeURL.deletingLastPathComponent().appendingPathComponent(file).path
-                    try? fileManager.removeItem(atPath: toPath)
-                    try fileManager.moveItem(atPath: fullPath, toPath: toPath)
-                }
+            let migratedFolder = migratedURL.deletingLastPathComponent()
+            for file in try fileManager.contentsOfDirectory(atPath: migratedFolder.path) where file.hasPrefix(migratedURL.lastPathComponent) {
+                let destinationURL = storeURL.deletingLastPathComponent().appendingPathComponent(file)
+                try? fileManager.removeItem(at: destinationURL)
+                try fileManager.moveItem(at: migratedFolder.appendingPathComponent(file), to: destinationURL)
             }
         } catch {
             DDLogError("⛔️ Error while copying migrated over the original files: \(error)")
@@ -196,57 +131,182 @@ private extension CoreDataIterativeMigrator {
         }
     }
 
-    /// Delete backup copies of the original file before migration
+    /// The folder holding the original store while it's replaced by the migrated one.
+    ///
+    /// It isn't the `backup` folder, which keeps a store that couldn't be opened: restoring that one
+    /// would prevent the app from launching again.
+    ///
+    static func replacementBackupURL(for storeURL: URL) -> URL {
+        storeURL.deletingLastPathComponent().appendingPathComponent("migration-backup")
+    }
+
+    /// Written to the replacement backup once all the original files are in it, and before any migrated
+    /// file is moved in their place.
+    ///
+    static let completeBackupMarker = ".complete"
+
+    /// Replace the original store with the migrated one, keeping the original files in a backup location
+    /// until all the migrated files are in place.
+    ///
+    static func replaceStore(at storeURL: URL, withMigratedStoreAt migratedURL: URL) throws {
+        let backupURL = replacementBackupURL(for: storeURL)
+        var isBackupComplete = false
+        do {
+            _ = try makeBackup(at: storeURL, folderName: backupURL.lastPathComponent)
+            try Data().write(to: backupURL.appendingPathComponent(completeBackupMarker))
+            isBackupComplete = true
+            try copyMigratedOverOriginal(from: migratedURL, to: storeURL)
+        } catch {
+            do {
+                try restoreStore(from: backupURL, to: storeURL, removingMigratedFiles: isBackupComplete)
+            } catch let restoreError {
+                let description = "Failed restoring the store after failing to replace it with the migrated store."
+                    + " Original Error: \(error). Restore Error: \(restoreError)"
+                throw CoreDataIterativeMigrator.error(with: .failedRestoringStore, description: description)
+            }
+            throw error
+        }
+
+        do {
+            try FileManager.default.removeItem(at: backupURL)
+        } catch {
+            // The original store is restored and migrated again on the next launch.
+            DDLogError("⛔️ Error while deleting the original store after replacing it: \(error)")
+        }
+    }
+
+    /// Restore the original store if the app was terminated while replacing it with the migrated store.
+    ///
+    static func restoreInterruptedReplacement(of storeURL: URL) throws {
+        let backupURL = replacementBackupURL(for: storeURL)
+        guard FileManager.default.fileExists(atPath: backupURL.path) else {
+            return
+        }
+        DDLogWarn("⚠️ Restoring the store left over by an interrupted migration")
+        let isBackupComplete = FileManager.default.fileExists(atPath: backupURL.appendingPathComponent(completeBackupMarker).path)
+        do {
+            try restoreStore(from: backupURL, to: storeURL, removingMigratedFiles: isBackupComplete)
+        } catch {
+            let description = "Failed restoring the store left over by an interrupted migration. Original Error: \(error)"
+            throw CoreDataIterativeMigrator.error(with: .failedRestoringStore, description: description)
+        }
+    }
+
+    /// Move the original files back from the replacement backup.
     ///
-    static func deleteBackupCopies(at backupURL: URL) throws {
+    /// - Parameter removingMigratedFiles: Whether the files in the store's location were written by the
+    ///   migration. Otherwise they are the original files that weren't moved to the backup yet.
+    ///
+    static func restoreStore(from backupURL: URL, to storeURL: URL, removingMigratedFiles: Bool) throws {
         do {
             let fileManager = FileManager.default
-            let files = try fileManager.contentsOfDirectory(atPath: backupURL.path)
-            try files.forEach { file in
-                let fullPath = URL(fileURLWithPath: backupURL.path).appendingPathComponent(file).path
-                try fileManager.removeItem(atPath: fullPath)
+            let storeFolder = storeURL.deletingLastPathComponent()
+            if removingMigratedFiles {
+                for file in try fileManager.contentsOfDirectory(atPath: storeFolder.path) where file.hasPrefix(storeURL.lastPathComponent) {
+                    try fileManager.removeItem(at: storeFolder.appendingPathComponent(file))
+                }
+            }
+            for file in try fileManager.contentsOfDirectory(atPath: backupURL.path) where file != completeBackupMarker {
+                try fileManager.moveItem(at: backupURL.appendingPathComponent(file), to: storeFolder.appendingPathComponent(file))
             }
+            try fileManager.removeItem(at: backupURL)
         } catch {
-            DDLogError("⛔️ Error while deleting backup copies of the original file before migration: \(error)")
+            DDLogError("⛔️ Error while restoring the original files from the backup location: \(error)")
             throw error
         }
     }
 }
 
-// MARK: - Private helper functions
+// MARK: - Migrating
 //
-private extension CoreDataIterativeMigrator {
+extension CoreDataIterativeMigrator {
+
+    typealias StepMigration = (_ sourceURL: URL, _ destinationURL: URL, _ step: CoreDataMigrationPlan.Step) throws -> Void
 
-    static func migrateStore(at url: URL,
+    /// Migrates the store through the steps of the plan.
+    ///
+    /// Each step reads the store written by the previous one, starting with the store itself, and writes
+    /// to a temporary folder. The store is left untouched unless every step succeeds.
+    ///
+    /// - Parameter migrateStep: Migrates a single step. Replaced by the tests.
+    ///
+    static func migrateStore(at storeURL: URL,
                              storeType: String,
-                             fromModel: NSManagedObjectModel,
-                             toModel: NSManagedObjectModel,
-                             with mappingModel: NSMappingModel) throws {
-        let tempDestinationURL = createTemporaryFolder(at: url)
+                             following plan: CoreDataMigrationPlan,
+                             progress: Progress?,
+                             migrateStep: StepMigration? = nil) throws {
+        guard !plan.steps.isEmpty else {
+            return
+        }
+        progress?.totalUnitCount = Int64(plan.steps.count)
+        let migrateStep = migrateStep ?? { sourceURL, destinationURL, step in
+            try migrateStore(from: sourceURL, to: destinationURL, storeType: storeType, with: step, progress: progress)
+        }
 
-        // Migrate from the source model to the target model using the mapping,
-        // and store the resulting data at the temporary path.
-        let migrator = NSMigrationManager(sourceModel: fromModel, destinationModel: toModel)
+        var currentURL = storeURL
         do {
-            try migrator.migrateStore(from: url,
-                                      sourceType: storeType,
-                                      options: nil,
-                                      with: mappingModel,
-                                      toDestinationURL: tempDestinationURL,
-                                      destinationType: storeType,
-                                      destinationOptions: nil)
+            for (index, step) in plan.steps.enumerated() {
+                let destinationURL = createTemporaryFolder(at: storeURL, step: index)
+
+                let kind = step.isLightweight ? "lightweight" : "custom"
+                DDLogWarn("⚠️ Attempting \(kind) migration from \(step.sourceVersionName) to \(step.destinationVersionName)")
+
+                do {
+                    try migrateStep(currentURL, destinationURL, step)
+                } catch {
+                    var description = "Failed migrating store from version \(step.sourceVersionName) to version \(step.destinationVersionName)."
+                    description = description + " Original Error: \(error)"
+                    throw CoreDataIterativeMigrator.error(with: IterativeMigratorErrorCodes.failedMigratingStore, description: description)
+                }
+
+                if index > 0 {
+                    try? FileManager.default.removeItem(at: currentURL.deletingLastPathComponent())
+                }
+                currentURL = destinationURL
+            }
+            try replaceStore(at: storeURL, withMigratedStoreAt: currentURL)
         } catch {
+            removeTemporaryFolders(at: storeURL)
             throw error
         }
 
-        do {
-            let backupURL = try makeBackup(at: url)
-            try copyMigratedOverOriginal(from: tempDestinationURL, to: url)
-            try deleteBackupCopies(at: backupURL)
-        } catch {
-            throw error
+        removeTemporaryFolders(at: storeURL)
+    }
+
+    static func migrateStore(from sourceURL: URL,
+                             to destinationURL: URL,
+                             storeType: String,
+                             with step: CoreDataMigrationPlan.Step,
+                             progress: Progress?) throws {
+        let migrator = NSMigrationManager(sourceModel: step.sourceModel, destinationModel: step.destinationModel)
+
+        let stepProgress = progress.map { Progress(totalUnitCount: 100, parent: $0, pendingUnitCount: 1) }
+        let observation = stepProgress.map { stepProgress in
+            migrator.observe(\.migrationProgress) { migrator, _ in
+                stepProgress.completedUnitCount = Int64(migrator.migrationProgress * 100)
+            }
+        }
+        defer {
+            observation?.invalidate()
         }
+
+        // Migrate from the source model to the target model using the mapping,
+        // and store the resulting data at the destination. The persistent history
+        // is kept, since the store is opened with it.
+        try migrator.migrateStore(from: sourceURL,
+                                  sourceType: storeType,
+                                  options: ContextManager.persistentStoreOptions,
+                                  with: step.mappingModel,
+                                  toDestinationURL: destinationURL,
+                                  destinationType: storeType,
+                                  destinationOptions: ContextManager.persistentStoreOptions)
+        stepProgress?.completedUnitCount = 100
     }
+}
+
+// MARK: - Private helper functions
+//
+private extension CoreDataIterativeMigrator {
 
     static func metadataForPersistentStore(storeType: String, at url: URL) throws -> [String: Any]? {
         do {
@@ -259,28 +319,14 @@ private extension CoreDataIterativeMigrator {
         }
     }
 
-    static func model(for metadata: [String: Any]) throws -> NSManagedObjectModel? {
-        let bundle = Bundle.wordPressData
-        guard let sourceModel = NSManagedObjectModel.mergedModel(from: [bundle], forStoreMetadata: metadata) else {
-            let description = "Failed to find source model for metadata: \(metadata)"
-            throw error(with: .noSourceModelForMetadata, description: description)
-        }
-
-        return sourceModel
-    }
-
-    static func models(for names: [String]) throws -> [NSManagedObjectModel] {
-        let models = try names.map { name -> NSManagedObjectModel in
-            guard let url = urlForModel(name: name, in: nil),
-                let model = NSManagedObjectModel(contentsOf: url) else {
-                    let description = "No model found for \(name)"
-                    throw error(with: .noModelFound, description: description)
-            }
-
-            return model
+    static func model(named name: String) throws -> NSManagedObjectModel {
+        guard let url = urlForModel(name: name, in: nil),
+            let model = NSManagedObjectModel(contentsOf: url) else {
+                let description = "No model found for \(name)"
+                throw error(with: .noModelFound, description: description)
         }
 
-        return models
+        return model
     }
 
     static func urlForModel(name: String, in directory: String?) -> URL? {
@@ -311,4 +357,5 @@ enum IterativeMigratorErrorCodes: Int {
     case failedRetrievingMetadata = 120
     case failedOnCustomMappingModel = 130
     case failedMigratingStore = 140
+    case failedRestoringStore = 150
 }
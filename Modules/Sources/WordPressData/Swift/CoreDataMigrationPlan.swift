@@ -0,0 +1,193 @@
+import Foundation
+import CoreData
+
+/// CoreDataMigrationPlan: The migrations that take a store from the model version it was saved with to a target model.
+///
+/// Consecutive versions that Core Data can migrate between with inferred mappings are collapsed into a single
+/// lightweight step. A separate step is only planned for the versions that have a custom mapping model, or where
+/// skipping the versions in between would map the data differently.
+///
+struct CoreDataMigrationPlan {
+
+    struct Step {
+        /// The model versions the step goes through: two, unless lightweight steps were collapsed.
+        let versionNames: [String]
+        let sourceModel: NSManagedObjectModel
+        let destinationModel: NSManagedObjectModel
+        let mappingModel: NSMappingModel
+        /// True if the mapping model was inferred, false if it is a custom mapping model.
+        let isLightweight: Bool
+
+        var sourceVersionName: String {
+            versionNames.first ?? "Unknown"
+        }
+
+        var destinationVersionName: String {
+            versionNames.last ?? "Unknown"
+        }
+    }
+
+    let steps: [Step]
+
+    /// The model versions loaded to make the plan.
+    let loadedVersionNames: [String]
+
+    /// Plans the migration of a store to the target model.
+    ///
+    /// - Parameters:
+    ///     - storeMetadata: Metadata of the store to migrate.
+    ///     - targetModel: The model the store should be migrated to.
+    ///     - modelNames: List of model versions, sorted in migration order, that should include the target model.
+    ///     - loadModel: Loads a model version. The models are loaded from the end of the list, and only until the
+    ///       versions of the store and of the target model are found.
+    ///     - customMappingModel: Returns the custom mapping model between two models, if there is one.
+    ///
+    /// - Throws: An `IterativeMigratorErrorCodes` error if the store version can't be found, or a step can't be
+    ///   inferred and has no custom mapping model.
+    ///
+    init(storeMetadata: [String: Any],
+         targetModel: NSManagedObjectModel,
+         modelNames: [String],
+         loadModel: (String) throws -> NSManagedObjectModel,
+         customMappingModel: (NSManagedObjectModel, NSManagedObjectModel) -> NSMappingModel? = CoreDataMigrationPlan.customMappingModel(from:to:)) throws {
+        var models = [Int: NSManagedObjectModel]()
+        var loadedVersionNames = [String]()
+        var sourceIndex: Int?
+        var targetIndex: Int?
+
+        // The store is usually a few versions behind the target, which is usually the last version.
+        for index in modelNames.indices.reversed() {
+            if sourceIndex != nil && targetIndex != nil {
+                break
+            }
+            let model = try loadModel(modelNames[index])
+            models[index] = model
+            loadedVersionNames.append(modelNames[index])
+
+            if targetIndex == nil, model.isEqual(targetModel) {
+                targetIndex = index
+            }
+            if sourceIndex == nil, model.isConfiguration(withName: nil, compatibleWithStoreMetadata: storeMetadata) {
+                sourceIndex = index
+            }
+        }
+
+        guard let sourceIndex, let targetIndex else {
+            let description = "Failed to find the store and target models in: \(modelNames)"
+            throw CoreDataIterativeMigrator.error(with: .noSourceModelForMetadata, description: description)
+        }
+
+        // A reverse migration descends through the list.
+        let path = sourceIndex <= targetIndex
+            ? Array(sourceIndex...targetIndex)
+            : Array((targetIndex...sourceIndex).reversed())
+
+        var steps = [Step]()
+        // The lightweight step being collapsed, from `path[runStart]` to `path[runEnd]`.
+        var runStart = 0
+        var runEnd = 0
+        var runMapping: NSMappingModel?
+
+        func endRun() {
+            guard let mappingModel = runMapping else {
+                return
+            }
+            steps.append(Step(versionNames: path[runStart...runEnd].map { modelNames[$0] },
+                              sourceModel: models[path[runStart]]!,
+                              destinationModel: models[path[runEnd]]!,
+                              mappingModel: mappingModel,
+                              isLightweight: true))
+            runMapping = nil
+        }
+
+        for position in path.indices.dropLast() {
+            let sourceModel = models[path[position]]!
+            let destinationModel = models[path[position + 1]]!
+
+            if let mappingModel = customMappingModel(sourceModel, destinationModel) {
+                endRun()
+                steps.append(Step(versionNames: [modelNames[path[position]], modelNames[path[position + 1]]],
+                                  sourceModel: sourceModel,
+                                  destinationModel: destinationModel,
+                                  mappingModel: mappingModel,
+                                  isLightweight: false))
+                continue
+            }
+
+            let runSourceModel = models[path[runStart]]!
+            if runMapping != nil,
+               Self.canSkip(sourceModel, from: runSourceModel, to: destinationModel),
+               let mappingModel = try? NSMappingModel.inferredMappingModel(forSourceModel: runSourceModel, destinationModel: destinationModel) {
+                runEnd = position + 1
+                runMapping = mappingModel
+                continue
+            }
+
+            endRun()
+            do {
+                runMapping = try NSMappingModel.inferredMappingModel(forSourceModel: sourceModel, destinationModel: destinationModel)
+                runStart = position
+                runEnd = position + 1
+            } catch {
+                var description = "Mapping model could not be inferred, and no custom mapping model found."
+                description = description + "Version From \(modelNames[path[position]]), To \(modelNames[path[position + 1]])."
+                description = description + " Original Error: \(error)"
+                throw CoreDataIterativeMigrator.error(with: .failedOnCustomMappingModel, description: description)
+            }
+        }
+        endRun()
+
+        self.steps = steps
+        self.loadedVersionNames = loadedVersionNames
+    }
+
+    /// Looks for a custom mapping model in the main bundle.
+    ///
+    static func customMappingModel(from sourceModel: NSManagedObjectModel, to destinationModel: NSManagedObjectModel) -> NSMappingModel? {
+        NSMappingModel(from: nil, forSourceModel: sourceModel, destinationModel: destinationModel)
+    }
+
+    /// Whether a mapping inferred from `source` to `destination` migrates the data like the mappings inferred
+    /// through `skipped` do.
+    ///
+    /// Inferred mappings match entities and properties by renaming identifier. Skipping a version would carry
+    /// over the data of an identifier that the version removed and a later version added back.
+    ///
+    static func canSkip(_ skipped: NSManagedObjectModel, from source: NSManagedObjectModel, to destination: NSManagedObjectModel) -> Bool {
+        let sourceEntities = source.entitiesByIdentifier
+        let skippedEntities = skipped.entitiesByIdentifier
+
+        for (identifier, entity) in destination.entitiesByIdentifier {
+            guard let sourceEntity = sourceEntities[identifier] else {
+                continue
+            }
+            guard let skippedEntity = skippedEntities[identifier] else {
+                return false
+            }
+            let sourceProperties = sourceEntity.propertyIdentifiers
+            let skippedProperties = skippedEntity.propertyIdentifiers
+            for property in entity.propertyIdentifiers where sourceProperties.contains(property) && !skippedProperties.contains(property) {
+                return false
+            }
+        }
+        return true
+    }
+}
+
+private extension NSManagedObjectModel {
+    var entitiesByIdentifier: [String: NSEntityDescription] {
+        var entities = [String: NSEntityDescription]()
+        for entity in self.entities {
+            if let identifier = entity.renamingIdentifier ?? entity.name {
+                entities[identifier] = entity
+            }
+        }
+        return entities
+    }
+}
+
+private extension NSEntityDescription {
+    var propertyIdentifiers: Set<String> {
+        Set(properties.map { $0.renamingIdentifier ?? $0.name })
+    }
+}
@@ -34,4 +34,33 @@ public protocol CoreDataStackSwift: CoreDataStack {
     /// - Returns: The value returned by the `block`
     /// - Throws: The error thrown by the `block`, in which case the Core Data changes made by the `block` is discarded.
     func performAndSave<T>(_ block: @escaping (NSManagedObjectContext) throws -> T) async throws -> T
+
+    /// Execute the given block with a background context and save the changes _if the block does not throw an error_,
+    /// possibly in the same transaction as the adjacent coalesced writes.
+    ///
+    /// Use it for small, independent writes which are often made in quick succession (e.g. while syncing), so that
+    /// they don't each pay for a store transaction and a merge into the main context. The writes are performed in
+    /// the order they are scheduled in, and each write sees the changes made by the writes before it. A write that
+    /// throws an error only discards its own changes.
+    ///
+    /// - Parameters:
+    ///   - block: A closure that uses the given `NSManagedObjectContext` to make Core Data model changes. The changes
+    ///         are only saved if the block does not throw an error.
+    ///   - completion: A closure which is called with the `block`'s execution result, after the batch that includes
+    ///         the changes is saved.
+    ///   - queue: A queue on which to execute the completion block.
+    func performAndSaveCoalesced<T>(_ block: @escaping (NSManagedObjectContext) throws -> T, completion: ((Result<T, Error>) -> Void)?, on queue: DispatchQueue)
+
+    /// The `async` variant of `performAndSaveCoalesced(_:completion:on:)`.
+    func performAndSaveCoalesced<T>(_ block: @escaping (NSManagedObjectContext) throws -> T) async throws -> T
+}
+
+public extension CoreDataStackSwift {
+    func performAndSaveCoalesced<T>(_ block: @escaping (NSManagedObjectContext) throws -> T, completion: ((Result<T, Error>) -> Void)?, on queue: DispatchQueue) {
+        performAndSave(block, completion: completion, on: queue)
+    }
+
+    func performAndSaveCoalesced<T>(_ block: @escaping (NSManagedObjectContext) throws -> T) async throws -> T {
+        try await performAndSave(block)
+    }
 }
@@ -0,0 +1,61 @@
+import CoreData
+import Foundation
+
+/// A small pool of background contexts reused by the `ContextManager` writes.
+///
+/// Creating a context for every write registers a new context with the store
+/// coordinator and throws away its row cache, which adds up when the app makes
+/// dozens of small writes in a row (for example, during launch).
+///
+/// A context is owned by a single write between `checkOut()` and `checkIn(_:)`.
+/// It's reset when it's checked in, so no objects or unsaved changes are carried
+/// over to the next write that uses it.
+final class ManagedObjectContextPool {
+    private let lock = NSLock()
+    private let capacity: Int
+    private let makeContext: () -> NSManagedObjectContext
+    private var idleContexts: [NSManagedObjectContext] = []
+    private var _createdContextCount = 0
+
+    /// - Parameters:
+    ///   - capacity: The maximum number of idle contexts kept in the pool. More
+    ///         contexts are created if needed (e.g. for nested writes), but aren't reused.
+    ///   - makeContext: Creates a new private queue context.
+    init(capacity: Int, makeContext: @escaping () -> NSManagedObjectContext) {
+        self.capacity = capacity
+        self.makeContext = makeContext
+    }
+
+    /// The number of contexts created by the pool so far.
+    var createdContextCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return _createdContextCount
+    }
+
+    func checkOut() -> NSManagedObjectContext {
+        lock.lock()
+        if let context = idleContexts.popLast() {
+            lock.unlock()
+            return context
+        }
+        _createdContextCount += 1
+        lock.unlock()
+
+        return makeContext()
+    }
+
+    /// Returns the context to the pool.
+    ///
+    /// - warning: Must be called on the context's queue, after the write is done with it.
+    func checkIn(_ context: NSManagedObjectContext) {
+        context.reset()
+        context.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy
+
+        lock.lock()
+        defer { lock.unlock() }
+        if idleContexts.count < capacity {
+            idleContexts.append(context)
+        }
+    }
+}
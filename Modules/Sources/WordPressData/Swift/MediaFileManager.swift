@@ -152,12 +152,45 @@ public class MediaFileManager: NSObject {
         return CGSize(width: width, height: height)
     }
 
+    /// Writes the data to a file in the Media directory, and records the change in the size ledger.
+    ///
+    public func write(_ data: Data, to url: URL, options: Data.WritingOptions = []) throws {
+        try sizeLedger().recordChanges(at: url) {
+            try data.write(to: url, options: options)
+        }
+    }
+
+    /// Moves a file into the Media directory, and records the change in the size ledger.
+    ///
+    public func moveItem(at sourceURL: URL, to url: URL) throws {
+        try sizeLedger().recordChanges(at: sourceURL, url) {
+            try FileManager.default.moveItem(at: sourceURL, to: url)
+        }
+    }
+
+    /// Removes a file from the Media directory, and records the change in the size ledger.
+    ///
+    public func removeItem(at url: URL) throws {
+        try sizeLedger().recordChanges(at: url) {
+            try FileManager.default.removeItem(at: url)
+        }
+    }
+
+    /// Removes the files modified before the given date, then the least recently modified ones
+    /// until the Media directory fits within the given size, in bytes.
+    ///
+    public func evictFiles(modifiedBefore date: Date? = nil, toFitWithin byteLimit: Int64? = nil) throws {
+        try sizeLedger().evictFiles(modifiedBefore: date, toFitWithin: byteLimit)
+    }
+
     /// Calculates the allocated size of the Media directory, in bytes, or nil if an error was thrown.
     ///
+    /// - Note: The directory is only crawled if it was changed other than through this class
+    ///   since it was last measured.
+    ///
     func calculateSizeOfDirectory(onCompletion: @escaping (Int64?) -> Void) {
         DispatchQueue.global(qos: .default).async {
-            let fileManager = FileManager.default
-            let allocatedSize = try? fileManager.allocatedSizeOf(directoryURL: self.directoryURL())
+            let allocatedSize = try? self.sizeLedger().currentUsage().byteCount
             DispatchQueue.main.async {
                 onCompletion(allocatedSize)
             }
@@ -216,6 +249,20 @@ public class MediaFileManager: NSObject {
         }, onError: onError)
     }
 
+    /// Helper method for keeping the Media cache directory within its limits, by removing
+    /// the files that weren't modified for a month, then the oldest ones above 500 MB.
+    ///
+    @objc public class func evictExpiredMediaCacheFiles() {
+        do {
+            try MediaFileManager.cache.evictFiles(
+                modifiedBefore: Date(timeIntervalSinceNow: -30 * 86_400),
+                toFitWithin: 500 * 1024 * 1024
+            )
+        } catch {
+            DDLogError("Error while evicting the Media cache files: \(error.localizedDescription)")
+        }
+    }
+
     /// Helper method for getting the default upload directory URL.
     ///
     @objc public class func uploadsDirectoryURL() throws -> URL {
@@ -224,6 +271,23 @@ public class MediaFileManager: NSObject {
 
     // MARK: - Private
 
+    private static let sizeLedgersLock = NSLock()
+    private static var sizeLedgers: [URL: DirectorySizeLedger] = [:]
+
+    /// Returns the size ledger of the Media directory, which is shared by all the managers of the directory.
+    ///
+    private func sizeLedger() throws -> DirectorySizeLedger {
+        let directoryURL = try directoryURL()
+        MediaFileManager.sizeLedgersLock.lock()
+        defer { MediaFileManager.sizeLedgersLock.unlock() }
+        if let ledger = MediaFileManager.sizeLedgers[directoryURL] {
+            return ledger
+        }
+        let ledger = DirectorySizeLedger(directoryURL: directoryURL)
+        MediaFileManager.sizeLedgers[directoryURL] = ledger
+        return ledger
+    }
+
     /// Removes any local Media files, except any Media matching the predicate.
     ///
     fileprivate func purgeMediaFiles(exceptMedia predicate: NSPredicate, onCompletion: (() -> Void)?, onError: ((Error) -> Void)?) {
@@ -274,7 +338,7 @@ public class MediaFileManager: NSObject {
             }
             if fileManager.fileExists(atPath: url.path) {
                 do {
-                    try fileManager.removeItem(at: url)
+                    try removeItem(at: url)
                     removedCount += 1
                 } catch {
                     DDLogError("Error while removing unused Media at path: \(error.localizedDescription) - \(url.path)")
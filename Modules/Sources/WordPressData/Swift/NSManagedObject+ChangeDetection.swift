@@ -0,0 +1,131 @@
+import CoreData
+
+/// Adds change-detecting setters to the managed objects.
+///
+/// Core Data marks an object as updated on every assignment, even if the new
+/// value is equal to the current one. An object updated this way is saved
+/// (re-writing the whole row), sent in `NSManagedObjectContextObjectsDidChange`,
+/// and reloaded by every fetched results controller observing it. The mapping
+/// code that applies server responses should use these setters so that a
+/// refresh that brings no new data leaves the objects clean.
+public protocol ChangeDetecting: AnyObject {}
+
+extension NSManagedObject: ChangeDetecting {}
+
+public extension ChangeDetecting where Self: NSManagedObject {
+    /// Assigns the value only if it differs from the current one.
+    ///
+    /// - Returns: `true` if the value was changed.
+    @discardableResult
+    func setIfChanged<Value: Equatable>(_ keyPath: ReferenceWritableKeyPath<Self, Value>, _ value: Value) -> Bool {
+        guard self[keyPath: keyPath] != value else {
+            return false
+        }
+        self[keyPath: keyPath] = value
+        return true
+    }
+}
+
+public extension NSManagedObject {
+    /// Sets the value for the given key only if it is not equal (using
+    /// `isEqual:`) to the current one. This is the Objective-C counterpart of
+    /// ``ChangeDetecting/setIfChanged(_:_:)``.
+    ///
+    /// - Returns: `true` if the value was changed.
+    @objc(setValueIfChanged:forKey:)
+    @discardableResult
+    func setValueIfChanged(_ value: Any?, forKey key: String) -> Bool {
+        let current = self.value(forKey: key) as AnyObject?
+        let value = value as AnyObject?
+        switch (current, value) {
+        case (nil, nil):
+            return false
+        case let (current?, value?) where current.isEqual(value):
+            return false
+        default:
+            setValue(value, forKey: key)
+            return true
+        }
+    }
+
+    /// Replaces the contents of the to-many relationship with the given objects,
+    /// leaving the relationship untouched if it already contains exactly them.
+    ///
+    /// - Returns: `true` if the relationship was changed.
+    @objc(setObjectsIfChanged:forRelationship:)
+    @discardableResult
+    func setObjectsIfChanged(_ objects: Set<NSManagedObject>, forRelationship key: String) -> Bool {
+        let current = mutableSetValue(forKey: key)
+        guard current.count != objects.count || !objects.allSatisfy({ current.contains($0) }) else {
+            return false
+        }
+        // Only send the differences to avoid re-inserting the join rows.
+        let objects = Set(objects.map(AnyHashable.init))
+        current.intersect(objects)
+        current.union(objects)
+        return true
+    }
+}
+
+/// The number of objects a context is about to write to the store.
+///
+/// Use it to spot mapping code that dirties objects without changing them:
+/// these objects are counted as ``redundantUpdates``.
+public struct ContextChangeStatistics: Equatable, CustomStringConvertible {
+    public var inserted = 0
+    /// The updated objects with at least one changed persistent property.
+    public var updated = 0
+    /// The objects registered as updated whose persistent properties are all
+    /// equal to the saved values, e.g. because they were set to their current value.
+    public var redundantUpdates = 0
+    public var deleted = 0
+
+    public init(inserted: Int = 0, updated: Int = 0, redundantUpdates: Int = 0, deleted: Int = 0) {
+        self.inserted = inserted
+        self.updated = updated
+        self.redundantUpdates = redundantUpdates
+        self.deleted = deleted
+    }
+
+    /// Collects the statistics for the pending changes in the given context.
+    ///
+    /// - note: Must be called on the context queue.
+    public init(pendingChangesIn context: NSManagedObjectContext) {
+        inserted = context.insertedObjects.count
+        deleted = context.deletedObjects.count
+        for object in context.updatedObjects {
+            if object.hasChangedValuesComparedToCommitted {
+                updated += 1
+            } else {
+                redundantUpdates += 1
+            }
+        }
+    }
+
+    /// The total number of objects the save notifications will report.
+    public var dirtyObjects: Int {
+        inserted + updated + redundantUpdates + deleted
+    }
+
+    public var description: String {
+        "inserted: \(inserted), updated: \(updated), redundant updates: \(redundantUpdates), deleted: \(deleted)"
+    }
+}
+
+private extension NSManagedObject {
+    /// Core Data reports a property assigned its current value as changed, so
+    /// compare the changed values to the last saved ones.
+    var hasChangedValuesComparedToCommitted: Bool {
+        let changes = changedValues()
+        guard !changes.isEmpty else {
+            return false
+        }
+        let committed = committedValues(forKeys: Array(changes.keys))
+        return changes.contains { key, value in
+            guard let committedValue = committed[key] else {
+                return true
+            }
+            return !(committedValue as AnyObject).isEqual(value)
+        }
+    }
+}
@@ -0,0 +1,262 @@
+import CoreData
+import CocoaLumberjackSwift
+import Foundation
+
+/// Merges the changes made to the store outside of the app's own contexts into the main context.
+///
+/// The main context merges the saves made by the `ContextManager` contexts automatically, but not
+/// the changes made by batch requests, which bypass the contexts. The app extensions use their own
+/// store, so they don't write to this one. The tracker reads these changes from the persistent history, starting from the token saved
+/// by the previous run, and merges only the affected objects into the main context, so that the fetched
+/// results controllers observing it are updated.
+final class PersistentHistoryTracker {
+    /// The objects changed by the merged transactions.
+    struct Changes: Equatable {
+        var inserted = Set<NSManagedObjectID>()
+        var updated = Set<NSManagedObjectID>()
+        var deleted = Set<NSManagedObjectID>()
+
+        var isEmpty: Bool {
+            inserted.isEmpty && updated.isEmpty && deleted.isEmpty
+        }
+    }
+
+    /// How long the history is kept for the other consumers of the store.
+    static let historyRetentionPeriod: TimeInterval = 7 * 24 * 60 * 60
+    /// How often the history is pruned.
+    static let pruningInterval: TimeInterval = 24 * 60 * 60
+
+    private let coordinator: NSPersistentStoreCoordinator
+    private let mainContext: NSManagedObjectContext
+    private let tokenURL: URL?
+    private let ownTransactionAuthor: String
+
+    /// The context used to read and prune the history. Its queue serializes the processing.
+    private let historyContext: NSManagedObjectContext
+
+    /// The token of the last processed transaction. Only accessed on the `historyContext` queue.
+    private var lastToken: NSPersistentHistoryToken?
+    /// Only accessed on the `historyContext` queue.
+    private var lastPruningDate: Date?
+
+    private let lock = NSLock()
+    private var isProcessingScheduled = false
+    private var remoteChangeObserver: NSObjectProtocol?
+
+    /// - Parameters:
+    ///   - tokenURL: The file that stores the last processed token across launches. If `nil`, the token is
+    ///         kept in memory.
+    ///   - ownTransactionAuthor: The author of the transactions saved by the contexts the main context already
+    ///         merges changes from. These transactions are skipped.
+    init(
+        coordinator: NSPersistentStoreCoordinator,
+        mainContext: NSManagedObjectContext,
+        tokenURL: URL?,
+        ownTransactionAuthor: String
+    ) {
+        self.coordinator = coordinator
+        self.mainContext = mainContext
+        self.tokenURL = tokenURL
+        self.ownTransactionAuthor = ownTransactionAuthor
+
+        historyContext = NSManagedObjectContext(concurrencyType: .privateQueueConcurrencyType)
+        historyContext.persistentStoreCoordinator = coordinator
+        historyContext.name = "org.wordpress.CoreDataStack.history"
+
+        // Without a saved token, there is nothing the main context has missed yet.
+        lastToken = loadToken() ?? coordinator.currentPersistentHistoryToken(fromStores: nil)
+    }
+
+    deinit {
+        if let remoteChangeObserver {
+            NotificationCenter.default.removeObserver(remoteChangeObserver)
+        }
+    }
+
+    /// Processes the new transactions whenever the store is changed outside of the contexts.
+    func startObservingRemoteChanges() {
+        guard remoteChangeObserver == nil else {
+            return
+        }
+        remoteChangeObserver = NotificationCenter.default.addObserver(
+            forName: .NSPersistentStoreRemoteChange,
+            object: coordinator,
+            queue: nil
+        ) { [weak self] _ in
+            self?.scheduleProcessing()
+        }
+    }
+
+    /// Merges the new transactions into the main context in the background, then prunes the history if
+    /// it's due. Calls made while the processing is pending are coalesced.
+    func scheduleProcessing() {
+        lock.lock()
+        guard !isProcessingScheduled else {
+            lock.unlock()
+            return
+        }
+        isProcessingScheduled = true
+        lock.unlock()
+
+        historyContext.perform {
+            self.lock.lock()
+            self.isProcessingScheduled = false
+            self.lock.unlock()
+
+            self.merge(self.fetchNewChanges())
+            self.pruneHistoryIfNeeded(now: Date())
+        }
+    }
+
+    /// Merges the new transactions into the main context and returns the changed objects.
+    @discardableResult
+    func processNewTransactions() -> Changes {
+        var changes = Changes()
+        historyContext.performAndWait {
+            changes = fetchNewChanges()
+        }
+        // Merged outside of the history queue, since it waits for the main context.
+        merge(changes)
+        return changes
+    }
+
+    /// Deletes the transactions saved before the given date.
+    func pruneHistory(before date: Date) {
+        historyContext.performAndWait {
+            do {
+                try historyContext.execute(NSPersistentHistoryChangeRequest.deleteHistory(before: date))
+            } catch {
+                DDLogError("Failed to prune the persistent history: \(error)")
+            }
+        }
+    }
+
+    /// Forgets the processed transactions, e.g. after the store is destroyed.
+    func reset() {
+        historyContext.performAndWait {
+            lastToken = coordinator.currentPersistentHistoryToken(fromStores: nil)
+            saveToken()
+        }
+    }
+}
+
+private extension PersistentHistoryTracker {
+    /// - warning: Must be called on the `historyContext` queue.
+    func fetchNewChanges() -> Changes {
+        let request = NSPersistentHistoryChangeRequest.fetchHistory(after: lastToken)
+        request.resultType = .transactionsAndChanges
+
+        let transactions: [NSPersistentHistoryTransaction]
+        do {
+            let result = try historyContext.execute(request) as? NSPersistentHistoryResult
+            transactions = result?.result as? [NSPersistentHistoryTransaction] ?? []
+        } catch let error as NSError where error.code == NSPersistentHistoryTokenExpiredError {
+            // The history the main context missed has been pruned (or the store was migrated).
+            DDLogWarn("The persistent history token has expired. Refreshing all objects in the main context.")
+            lastToken = coordinator.currentPersistentHistoryToken(fromStores: nil)
+            saveToken()
+            mainContext.perform { [mainContext] in
+                mainContext.refreshAllObjects()
+            }
+            return Changes()
+        } catch {
+            DDLogError("Failed to fetch the persistent history: \(error)")
+            return Changes()
+        }
+
+        guard let lastTransaction = transactions.last else {
+            return Changes()
+        }
+
+        var changes = Changes()
+        for transaction in transactions where transaction.author != ownTransactionAuthor {
+            for change in transaction.changes ?? [] {
+                let objectID = change.changedObjectID
+                switch change.changeType {
+                case .insert:
+                    changes.inserted.insert(objectID)
+                case .update:
+                    if !changes.inserted.contains(objectID) {
+                        changes.updated.insert(objectID)
+                    }
+                case .delete:
+                    changes.inserted.remove(objectID)
+                    changes.updated.remove(objectID)
+                    changes.deleted.insert(objectID)
+                @unknown default:
+                    break
+                }
+            }
+        }
+
+        lastToken = lastTransaction.token
+        saveToken()
+        return changes
+    }
+
+    func merge(_ changes: Changes) {
+        guard !changes.isEmpty else {
+            return
+        }
+        NSManagedObjectContext.mergeChanges(
+            fromRemoteContextSave: [
+                NSInsertedObjectIDsKey: Array(changes.inserted),
+                NSUpdatedObjectIDsKey: Array(changes.updated),
+                NSDeletedObjectIDsKey: Array(changes.deleted),
+            ],
+            into: [mainContext]
+        )
+    }
+
+    /// - warning: Must be called on the `historyContext` queue.
+    func pruneHistoryIfNeeded(now: Date) {
+        if let lastPruningDate, now.timeIntervalSince(lastPruningDate) < Self.pruningInterval {
+            return
+        }
+        lastPruningDate = now
+        do {
+            let request = NSPersistentHistoryChangeRequest.deleteHistory(before: now.addingTimeInterval(-Self.historyRetentionPeriod))
+            try historyContext.execute(request)
+        } catch {
+            DDLogError("Failed to prune the persistent history: \(error)")
+        }
+    }
+
+    func loadToken() -> NSPersistentHistoryToken? {
+        guard let tokenURL, let data = try? Data(contentsOf: tokenURL) else {
+            return nil
+        }
+        return try? NSKeyedUnarchiver.unarchivedObject(ofClass: NSPersistentHistoryToken.self, from: data)
+    }
+
+    func saveToken() {
+        guard let tokenURL else {
+            return
+        }
+        do {
+            if let lastToken {
+                let data = try NSKeyedArchiver.archivedData(withRootObject: lastToken, requiringSecureCoding: true)
+                try data.write(to: tokenURL, options: .atomic)
+            } else if FileManager.default.fileExists(atPath: tokenURL.path) {
+                try FileManager.default.removeItem(at: tokenURL)
+            }
+        } catch {
+            DDLogError("Failed to save the persistent history token: \(error)")
+        }
+    }
+}
+
+public extension NSManagedObjectContext {
+    /// Executes the batch request so that its changes are merged into the main context.
+    ///
+    /// Batch requests write to the store directly, so the contexts don't see their changes. The request is
+    /// recorded in the persistent history under a different author than the context saves, which lets
+    /// `ContextManager` merge the inserted, updated, or deleted objects into the main context.
+    @discardableResult
+    func executeBatchRequest(_ request: NSPersistentStoreRequest) throws -> NSPersistentStoreResult {
+        let author = transactionAuthor
+        transactionAuthor = ContextManager.batchRequestTransactionAuthor
+        defer { transactionAuthor = author }
+        return try execute(request)
+    }
+}
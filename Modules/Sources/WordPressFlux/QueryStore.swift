@@ -86,8 +86,9 @@ open class QueryStore<State, Query>: StatefulStore<State>, Unsubscribable {
             }
         }
         set {
+            let oldValue = state
             inMemoryState = newValue
-            emitStateChange(old: state, new: newValue)
+            emitStateChange(old: oldValue, new: newValue)
         }
     }
 
@@ -102,6 +103,11 @@ open class QueryStore<State, Query>: StatefulStore<State>, Unsubscribable {
         super.init(initialState: initialState, dispatcher: dispatcher)
     }
 
+    override public init(initialState: State, dispatcher: ActionDispatcher = .global, emission: StateChangeEmission<State>) {
+        self.initialState = initialState
+        super.init(initialState: initialState, dispatcher: dispatcher, emission: emission)
+    }
+
     /// Registers a query with the store.
     ///
     /// The query will be active as long as the consumer keeps a reference to
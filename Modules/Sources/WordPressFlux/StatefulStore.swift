@@ -1,3 +1,5 @@
+import Foundation
+
 /// A store that holds all of its internal state in a generic State property.
 ///
 /// This class provides some common functionality for stores that want to keep
@@ -17,9 +19,21 @@
 /// need to do multiple changes to the state property, but only want one change
 /// notification to be dispatched.
 ///
+/// Stores that change their state several times per action can also opt into
+/// a different StateChangeEmission, to skip the changes that leave the state
+/// as it was, or to emit all the changes made in one run loop turn at once.
+///
 open class StatefulStore<State>: Store {
     private let stateDispatcher = Dispatcher<(State, State)>()
 
+    /// How the state changes are emitted.
+    ///
+    public let emission: StateChangeEmission<State>
+
+    /// The state before the first change that hasn't been emitted yet, when
+    /// the changes are coalesced.
+    private var pendingOldState: State?
+
     /// The internal state of the store.
     ///
     public var state: State {
@@ -32,6 +46,16 @@ open class StatefulStore<State>: Store {
     ///
     public init(initialState: State, dispatcher: ActionDispatcher = .global) {
         state = initialState
+        emission = .immediate
+        super.init(dispatcher: dispatcher)
+    }
+
+    /// Initializes a store with an initial state, and emits its state changes
+    /// as specified by the given emission.
+    ///
+    public init(initialState: State, dispatcher: ActionDispatcher = .global, emission: StateChangeEmission<State>) {
+        state = initialState
+        self.emission = emission
         super.init(dispatcher: dispatcher)
     }
 
@@ -47,6 +71,36 @@ open class StatefulStore<State>: Store {
     }
 
     func emitStateChange(old: State, new: State) {
+        guard emission.coalescesChanges else {
+            dispatchStateChange(old: old, new: new)
+            return
+        }
+        guard pendingOldState == nil else {
+            return
+        }
+        pendingOldState = old
+        DispatchQueue.main.async { [weak self] in
+            self?.flushStateChanges()
+        }
+    }
+
+    /// Emits the pending state changes right away, instead of waiting for the
+    /// next run loop turn.
+    ///
+    /// It does nothing unless the changes are coalesced.
+    ///
+    public func flushStateChanges() {
+        guard let old = pendingOldState else {
+            return
+        }
+        pendingOldState = nil
+        dispatchStateChange(old: old, new: state)
+    }
+
+    private func dispatchStateChange(old: State, new: State) {
+        if let isUnchanged = emission.isUnchanged, isUnchanged(old, new) {
+            return
+        }
         stateDispatcher.dispatch((old, new))
         emitChange()
     }
@@ -57,4 +111,58 @@ open class StatefulStore<State>: Store {
     public func onStateChange(_ handler: @escaping ((State, State)) -> Void) -> Receipt {
         return stateDispatcher.subscribe(handler)
     }
+
+    /// Registers a new observer, that will receive a tuple with the old and new
+    /// value at the given key path, only when that value changes.
+    ///
+    public func onStateChange<Value: Equatable>(of keyPath: KeyPath<State, Value>, _ handler: @escaping ((Value, Value)) -> Void) -> Receipt {
+        return stateDispatcher.subscribe { old, new in
+            let oldValue = old[keyPath: keyPath]
+            let newValue = new[keyPath: keyPath]
+            if oldValue != newValue {
+                handler((oldValue, newValue))
+            }
+        }
+    }
+}
+
+/// Specifies how a StatefulStore emits its state changes.
+///
+public struct StateChangeEmission<State> {
+    /// Whether the changes made within one run loop turn are emitted together.
+    let coalescesChanges: Bool
+
+    /// Returns true if the two states are the same, in which case the change
+    /// isn't emitted.
+    let isUnchanged: ((State, State) -> Bool)?
+
+    /// Every change is emitted right away, even if the state is the same as
+    /// before. This is the default.
+    ///
+    public static var immediate: StateChangeEmission {
+        return StateChangeEmission(coalescesChanges: false, isUnchanged: nil)
+    }
+
+    /// The changes made within one run loop turn are emitted once, on the next
+    /// turn, with the state before the first change and after the last one.
+    ///
+    public static var coalesced: StateChangeEmission {
+        return StateChangeEmission(coalescesChanges: true, isUnchanged: nil)
+    }
+}
+
+extension StateChangeEmission where State: Equatable {
+    /// Every change is emitted right away, unless the new state is equal to the
+    /// old one.
+    ///
+    public static var distinct: StateChangeEmission {
+        return StateChangeEmission(coalescesChanges: false, isUnchanged: ==)
+    }
+
+    /// The changes made within one run loop turn are emitted once, on the next
+    /// turn, unless they leave the state equal to what it was.
+    ///
+    public static var coalescedDistinct: StateChangeEmission {
+        return StateChangeEmission(coalescesChanges: true, isUnchanged: ==)
+    }
 }
@@ -0,0 +1,214 @@
+import Foundation
+import SFHFKeychainUtils
+#if canImport(UIKit)
+import UIKit
+#endif
+
+/// The keychain operations `KeychainCredentialCache` reads and writes through.
+public protocol KeychainCredentialStore {
+    /// The passwords of every item of the service, keyed by username.
+    /// Returns an empty dictionary if the service has no items.
+    func passwords(forServiceName serviceName: String, accessGroup: String?) throws -> [String: String]
+    func storePassword(_ password: String, for username: String, serviceName: String, accessGroup: String?) throws
+    func deletePassword(for username: String, serviceName: String, accessGroup: String?) throws
+}
+
+public enum KeychainCredentialCacheError: Error {
+    case missingUsernameOrServiceName
+}
+
+/// The keychain itself, through `SFHFKeychainUtils`.
+public struct SFHFKeychainCredentialStore: KeychainCredentialStore {
+    private let keychainUtils: SFHFKeychainUtils.Type
+
+    public init(keychainUtils: SFHFKeychainUtils.Type = SFHFKeychainUtils.self) {
+        self.keychainUtils = keychainUtils
+    }
+
+    public func passwords(forServiceName serviceName: String, accessGroup: String?) throws -> [String: String] {
+        try keychainUtils.getPasswords(forServiceName: serviceName, accessGroup: accessGroup)
+    }
+
+    public func storePassword(_ password: String, for username: String, serviceName: String, accessGroup: String?) throws {
+        try keychainUtils.storeUsername(username, andPassword: password, forServiceName: serviceName, accessGroup: accessGroup, updateExisting: true)
+    }
+
+    public func deletePassword(for username: String, serviceName: String, accessGroup: String?) throws {
+        try keychainUtils.deleteItem(forUsername: username, andServiceName: serviceName, accessGroup: accessGroup)
+    }
+}
+
+/// A read-through cache of the credentials stored in the keychain.
+///
+/// Every keychain read is an IPC round trip, and credentials such as the WordPress.com auth token
+/// or the XML-RPC password of a site are read for every request. The cache loads all the items of a
+/// service with a single query the first time one of them is read, and serves the following reads
+/// from memory. A service is reloaded after any of its items is stored or deleted, whether through
+/// the cache or directly through `SFHFKeychainUtils`.
+///
+/// The items written by another process sharing the keychain, such as an app extension, aren't
+/// seen until the cache is invalidated. The cache observing the keychain changes is invalidated
+/// when the app or the extension host enters the foreground.
+///
+/// Failed reads aren't cached: a locked device, for example, is retried on the next read.
+@objc public final class KeychainCredentialCache: NSObject, @unchecked Sendable {
+
+    public struct Counters: Equatable {
+        /// Reads served from memory.
+        public var hits = 0
+        /// Reads that had to load the service from the store.
+        public var misses = 0
+        /// Queries made to the store, including prefetches.
+        public var storeReads = 0
+        /// Stores and deletes made through the cache.
+        public var storeWrites = 0
+    }
+
+    @objc public static let shared = KeychainCredentialCache(store: SFHFKeychainCredentialStore(), observesKeychainChanges: true)
+
+    private struct ServiceKey: Hashable {
+        let serviceName: String
+        let accessGroup: String?
+    }
+
+    private let store: KeychainCredentialStore
+    private let lock = NSLock()
+    private let prefetchQueue = DispatchQueue(label: "org.wordpress.keychain-credential-cache", qos: .utility)
+    private var passwordsByService: [ServiceKey: [String: String]] = [:]
+    /// Bumped when a service is invalidated, so that a load that raced with a write isn't cached.
+    private var generation = 0
+    private var _counters = Counters()
+    private var observers: [NSObjectProtocol] = []
+
+    public var counters: Counters {
+        lock.withLock { _counters }
+    }
+
+    public init(store: KeychainCredentialStore, observesKeychainChanges: Bool = false) {
+        self.store = store
+        super.init()
+        if observesKeychainChanges {
+            observers.append(NotificationCenter.default.addObserver(forName: .SFHFKeychainUtilsDidChangeItem, object: nil, queue: nil) { [weak self] notification in
+                guard let serviceName = notification.userInfo?[SFHFKeychainUtilsServiceNameKey] as? String else {
+                    self?.invalidateAll()
+                    return
+                }
+                self?.invalidate(serviceName: serviceName)
+            })
+            // The other processes may have changed the keychain while this one was in the background.
+            var foregroundNotifications: [Notification.Name] = [.NSExtensionHostWillEnterForeground]
+            #if canImport(UIKit)
+            foregroundNotifications.append(UIApplication.willEnterForegroundNotification)
+            #endif
+            for name in foregroundNotifications {
+                observers.append(NotificationCenter.default.addObserver(forName: name, object: nil, queue: nil) { [weak self] _ in
+                    self?.invalidateAll()
+                })
+            }
+        }
+    }
+
+    deinit {
+        observers.forEach(NotificationCenter.default.removeObserver)
+    }
+
+    // MARK: - Reading
+
+    /// Returns the password of the user for the service, or nil if there is none.
+    ///
+    /// - Throws: The error of the store if the service isn't cached and couldn't be loaded.
+    public func password(for username: String, serviceName: String, accessGroup: String? = nil) throws -> String? {
+        let key = ServiceKey(serviceName: serviceName, accessGroup: accessGroup)
+        let cached: [String: String]? = lock.withLock {
+            let passwords = passwordsByService[key]
+            if passwords != nil {
+                _counters.hits += 1
+            } else {
+                _counters.misses += 1
+            }
+            return passwords
+        }
+        return try (cached ?? load(key))[username]
+    }
+
+    /// Returns nil without an error for a missing username or service name, as `SFHFKeychainUtils` did.
+    @available(swift, obsoleted: 1.0)
+    @objc(passwordForUsername:serviceName:error:)
+    public func objc_password(for username: String?, serviceName: String?, error: NSErrorPointer) -> String? {
+        guard let username, let serviceName else {
+            return nil
+        }
+        do {
+            return try password(for: username, serviceName: serviceName)
+        } catch let loadError {
+            error?.pointee = loadError as NSError
+            return nil
+        }
+    }
+
+    /// Loads the services that aren't cached yet in the background, so that the next reads don't
+    /// wait for the keychain.
+    public func prefetchPasswords(forServiceNames serviceNames: [String], accessGroup: String? = nil, completion: (() -> Void)? = nil) {
+        let keys = Set(serviceNames.map { ServiceKey(serviceName: $0, accessGroup: accessGroup) })
+        prefetchQueue.async { [self] in
+            for key in keys where lock.withLock({ passwordsByService[key] == nil }) {
+                _ = try? load(key)
+            }
+            completion?()
+        }
+    }
+
+    // MARK: - Writing
+
+    public func setPassword(_ password: String?, for username: String, serviceName: String, accessGroup: String? = nil) throws {
+        defer {
+            lock.withLock { _counters.storeWrites += 1 }
+            invalidate(serviceName: serviceName)
+        }
+        if let password {
+            try store.storePassword(password, for: username, serviceName: serviceName, accessGroup: accessGroup)
+        } else {
+            try store.deletePassword(for: username, serviceName: serviceName, accessGroup: accessGroup)
+        }
+    }
+
+    @available(swift, obsoleted: 1.0)
+    @objc(setPassword:forUsername:serviceName:error:)
+    public func objc_setPassword(_ password: String?, for username: String?, serviceName: String?) throws {
+        guard let username, let serviceName else {
+            throw KeychainCredentialCacheError.missingUsernameOrServiceName
+        }
+        try setPassword(password, for: username, serviceName: serviceName)
+    }
+
+    /// Drops the cached items of the service, in every access group.
+    public func invalidate(serviceName: String) {
+        lock.withLock {
+            generation += 1
+            passwordsByService = passwordsByService.filter { $0.key.serviceName != serviceName }
+        }
+    }
+
+    @objc public func invalidateAll() {
+        lock.withLock {
+            generation += 1
+            passwordsByService.removeAll()
+        }
+    }
+
+    // MARK: - Private
+
+    private func load(_ key: ServiceKey) throws -> [String: String] {
+        let loadGeneration = lock.withLock {
+            _counters.storeReads += 1
+            return generation
+        }
+        let passwords = try store.passwords(forServiceName: key.serviceName, accessGroup: key.accessGroup)
+        lock.withLock {
+            if generation == loadGeneration {
+                passwordsByService[key] = passwords
+            }
+        }
+        return passwords
+    }
+}
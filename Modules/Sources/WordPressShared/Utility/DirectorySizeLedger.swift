@@ -0,0 +1,309 @@
+import Foundation
+
+/// Keeps track of the size of an app-managed directory, such as the media cache,
+/// without crawling it every time the size is needed.
+///
+/// The changes made through ``recordChanges(at:_:)`` update the total right away.
+/// The ledger also remembers the modification date of the directory after its last
+/// recorded change, which is how it notices that files were added or removed some
+/// other way. Only then ``currentUsage()`` measures the directory again, visiting
+/// its items in parallel.
+///
+/// The modification date of the directory doesn't change when a file is overwritten
+/// in place or when the contents of a subdirectory change, so the changes of this kind
+/// made outside of the ledger are only picked up when the directory is measured again
+/// after `reconciliationInterval`.
+///
+/// The totals are persisted next to the directory, so they survive app launches, and
+/// excluded from backups. The ledger can be used from any thread.
+public final class DirectorySizeLedger {
+    public struct Usage: Codable, Equatable, Sendable {
+        /// The allocated size of the files, in bytes.
+        public var byteCount: Int64
+        public var fileCount: Int
+
+        public static let zero = Usage(byteCount: 0, fileCount: 0)
+
+        public init(byteCount: Int64, fileCount: Int) {
+            self.byteCount = byteCount
+            self.fileCount = fileCount
+        }
+    }
+
+    private struct Entry: Codable {
+        var usage: Usage
+        /// The modification date of the directory when `usage` was last known to be right.
+        var directoryModificationDate: Date?
+        /// When the directory was last measured.
+        var measurementDate: Date?
+    }
+
+    public let directoryURL: URL
+    private let storeURL: URL
+    private let reconciliationInterval: TimeInterval
+    private let fileManager: FileManager
+
+    private let lock = NSLock()
+    private var entry: Entry?
+    private var isSaveScheduled = false
+    private let saveQueue = DispatchQueue(label: "org.wordpress.DirectorySizeLedger", qos: .utility)
+
+    /// - Parameters:
+    ///   - directoryURL: The directory to keep track of.
+    ///   - storeURL: Where the totals are persisted. By default, it's a hidden file next to the directory,
+    ///     so that it isn't counted or purged with the directory's contents.
+    ///   - reconciliationInterval: How long the recorded usage is trusted before the directory is
+    ///     measured again, to pick up the changes its modification date doesn't reflect.
+    public init(directoryURL: URL, storeURL: URL? = nil, reconciliationInterval: TimeInterval = 86_400, fileManager: FileManager = .default) {
+        self.directoryURL = directoryURL
+        self.storeURL = storeURL ?? directoryURL.deletingLastPathComponent()
+            .appendingPathComponent(".\(directoryURL.lastPathComponent).size-ledger", isDirectory: false)
+        self.reconciliationInterval = reconciliationInterval
+        self.fileManager = fileManager
+        self.entry = (try? Data(contentsOf: self.storeURL)).flatMap {
+            try? JSONDecoder().decode(Entry.self, from: $0)
+        }
+    }
+
+    // MARK: - Usage
+
+    /// The recorded usage, which may not include the changes made outside of the ledger.
+    /// Returns `nil` if the directory was never measured.
+    public var recordedUsage: Usage? {
+        lock.lock()
+        defer { lock.unlock() }
+        return entry?.usage
+    }
+
+    /// Returns the usage of the directory, measuring it again only if it was changed
+    /// outside of the ledger or if it wasn't measured for `reconciliationInterval`.
+    ///
+    /// - warning: It may crawl the directory, so don't call it on the main thread.
+    public func currentUsage() throws -> Usage {
+        lock.lock()
+        if let entry,
+           let measurementDate = entry.measurementDate, -measurementDate.timeIntervalSinceNow < reconciliationInterval,
+           entry.directoryModificationDate != nil, entry.directoryModificationDate == directoryModificationDate() {
+            lock.unlock()
+            return entry.usage
+        }
+        lock.unlock()
+        return try reconcile()
+    }
+
+    /// Measures the directory and replaces the recorded usage.
+    @discardableResult
+    public func reconcile() throws -> Usage {
+        lock.lock()
+        defer { lock.unlock() }
+
+        let modificationDate = directoryModificationDate()
+        let usage = try measureDirectory()
+        update(Entry(usage: usage, directoryModificationDate: modificationDate, measurementDate: Date()))
+        return usage
+    }
+
+    // MARK: - Changes
+
+    /// Performs changes to the items at the given URLs, such as writing, moving, or removing
+    /// a file, and records how they change the usage of the directory. The URLs outside of
+    /// the directory are ignored.
+    ///
+    /// The changes are serialized, so that they aren't mistaken for changes made outside of
+    /// the ledger. An item added to or removed from the directory some other way while `body`
+    /// runs may still go unnoticed until the directory is measured again.
+    public func recordChanges<T>(at urls: URL..., _ body: () throws -> T) rethrows -> T {
+        lock.lock()
+        defer { lock.unlock() }
+
+        let directoryPath = directoryURL.standardizedFileURL.path + "/"
+        let urls = urls.filter { $0.standardizedFileURL.path.hasPrefix(directoryPath) }
+        let modificationDate = directoryModificationDate()
+        let wasReconciled = entry != nil && entry?.directoryModificationDate == modificationDate
+        let before = urls.map(usageOfItem(at:))
+        let childrenBefore = urls.map(isChildOfDirectory)
+        defer {
+            if var entry {
+                for (url, before) in zip(urls, before) {
+                    let after = usageOfItem(at: url)
+                    entry.usage.byteCount = max(0, entry.usage.byteCount + after.byteCount - before.byteCount)
+                    entry.usage.fileCount = max(0, entry.usage.fileCount + after.fileCount - before.fileCount)
+                }
+                // Only adding or removing an item of the directory itself changes its modification
+                // date. If it changed otherwise, the directory was also changed outside of the ledger.
+                let newModificationDate = directoryModificationDate()
+                let addsOrRemovesChildren = urls.map(isChildOfDirectory) != childrenBefore
+                if wasReconciled && (newModificationDate == modificationDate || addsOrRemovesChildren) {
+                    entry.directoryModificationDate = newModificationDate
+                } else {
+                    entry.directoryModificationDate = nil
+                }
+                update(entry)
+            }
+        }
+        return try body()
+    }
+
+    /// Removes the files modified before the given date, then the least recently modified ones
+    /// until the directory fits within the given size.
+    ///
+    /// - Parameters:
+    ///   - date: The files modified before this date are removed. If `nil`, the files are only
+    ///     removed to fit within the size.
+    ///   - byteLimit: The maximum size of the directory, in bytes. If `nil`, the files are only
+    ///     removed by age.
+    ///   - excludedFilenames: The files that are never removed.
+    /// - Returns: The usage of the directory after the eviction.
+    @discardableResult
+    public func evictFiles(modifiedBefore date: Date? = nil, toFitWithin byteLimit: Int64? = nil, excluding excludedFilenames: Set<String> = []) throws -> Usage {
+        let usage = try currentUsage()
+        if date == nil && (byteLimit.map { usage.byteCount <= $0 } ?? true) {
+            return usage
+        }
+
+        lock.lock()
+        defer { lock.unlock() }
+
+        let keys: Set<URLResourceKey> = [.isRegularFileKey, .contentModificationDateKey, .totalFileAllocatedSizeKey, .fileAllocatedSizeKey]
+        let files = try fileManager.contentsOfDirectory(at: directoryURL, includingPropertiesForKeys: Array(keys), options: [])
+            .compactMap { url -> (url: URL, date: Date, size: Int64)? in
+                guard !excludedFilenames.contains(url.lastPathComponent),
+                      let values = try? url.resourceValues(forKeys: keys), values.isRegularFile == true else {
+                    return nil
+                }
+                let size = Int64(values.totalFileAllocatedSize ?? values.fileAllocatedSize ?? 0)
+                return (url, values.contentModificationDate ?? .distantPast, size)
+            }
+            .sorted { $0.date < $1.date }
+
+        var remaining = entry?.usage ?? usage
+        for file in files {
+            let isExpired = date.map { file.date < $0 } ?? false
+            let isOverLimit = byteLimit.map { remaining.byteCount > $0 } ?? false
+            guard isExpired || isOverLimit else {
+                // The rest of the files are more recent.
+                break
+            }
+            do {
+                try fileManager.removeItem(at: file.url)
+                remaining.byteCount = max(0, remaining.byteCount - file.size)
+                remaining.fileCount = max(0, remaining.fileCount - 1)
+            } catch {
+                continue
+            }
+        }
+        update(Entry(usage: remaining, directoryModificationDate: directoryModificationDate(), measurementDate: entry?.measurementDate))
+        return remaining
+    }
+
+    /// Writes the recorded usage to disk now, instead of waiting for the scheduled save.
+    public func synchronize() {
+        saveQueue.sync {
+            save()
+        }
+    }
+}
+
+private extension DirectorySizeLedger {
+    /// - warning: Must be called with the lock held.
+    func update(_ entry: Entry) {
+        self.entry = entry
+        guard !isSaveScheduled else {
+            return
+        }
+        isSaveScheduled = true
+        // The changes often come in bursts, e.g. when scrolling through the media library.
+        saveQueue.asyncAfter(deadline: .now() + 1) { [weak self] in
+            self?.save()
+        }
+    }
+
+    /// - warning: Must be called on the `saveQueue`.
+    func save() {
+        lock.lock()
+        let entry = isSaveScheduled ? self.entry : nil
+        isSaveScheduled = false
+        lock.unlock()
+
+        guard let entry, let data = try? JSONEncoder().encode(entry) else {
+            return
+        }
+        try? data.write(to: storeURL, options: .atomic)
+        // The atomic write replaces the file, along with its attributes.
+        var storeURL = storeURL
+        var values = URLResourceValues()
+        values.isExcludedFromBackup = true
+        try? storeURL.setResourceValues(values)
+    }
+
+    func directoryModificationDate() -> Date? {
+        // A URL caches the resource values it reads, and the date is read before and after each change.
+        var directoryURL = directoryURL
+        directoryURL.removeAllCachedResourceValues()
+        return try? directoryURL.resourceValues(forKeys: [.contentModificationDateKey]).contentModificationDate
+    }
+
+    /// Returns `true` if there is an item at the URL directly in the directory.
+    func isChildOfDirectory(_ url: URL) -> Bool {
+        url.standardizedFileURL.deletingLastPathComponent().path == directoryURL.standardizedFileURL.path
+            && fileManager.fileExists(atPath: url.path)
+    }
+
+    /// Measures the items of the directory in parallel.
+    func measureDirectory() throws -> Usage {
+        let keys: [URLResourceKey] = [.isRegularFileKey, .isDirectoryKey, .totalFileAllocatedSizeKey, .fileAllocatedSizeKey]
+        let items = try fileManager.contentsOfDirectory(at: directoryURL, includingPropertiesForKeys: keys, options: [])
+        guard !items.isEmpty else {
+            return .zero
+        }
+
+        let batchCount = min(items.count, ProcessInfo.processInfo.activeProcessorCount * 4)
+        var usages = [Usage](repeating: .zero, count: batchCount)
+        usages.withUnsafeMutableBufferPointer { usages in
+            DispatchQueue.concurrentPerform(iterations: batchCount) { batch in
+                var usage = Usage.zero
+                for index in stride(from: batch, to: items.count, by: batchCount) {
+                    // The values were fetched along with the listing, so there is no need to read them again.
+                    let itemUsage = usageOfItem(at: items[index], ignoringCachedValues: false)
+                    usage.byteCount += itemUsage.byteCount
+                    usage.fileCount += itemUsage.fileCount
+                }
+                usages[batch] = usage
+            }
+        }
+        return usages.reduce(into: .zero) { total, usage in
+            total.byteCount += usage.byteCount
+            total.fileCount += usage.fileCount
+        }
+    }
+
+    /// Returns the usage of a file, or of the files in a directory, or zero if there is no item.
+    ///
+    /// A URL caches the resource values it reads, so by default they are cleared first: the same
+    /// URL is measured before and after a change, and callers may have read its values earlier.
+    func usageOfItem(at url: URL, ignoringCachedValues: Bool = true) -> Usage {
+        let keys: Set<URLResourceKey> = [.isRegularFileKey, .isDirectoryKey, .totalFileAllocatedSizeKey, .fileAllocatedSizeKey]
+        var url = url
+        if ignoringCachedValues {
+            url.removeAllCachedResourceValues()
+        }
+        guard let values = try? url.resourceValues(forKeys: keys) else {
+            return .zero
+        }
+        if values.isRegularFile == true {
+            return Usage(byteCount: Int64(values.totalFileAllocatedSize ?? values.fileAllocatedSize ?? 0), fileCount: 1)
+        }
+        guard values.isDirectory == true, let enumerator = fileManager.enumerator(at: url, includingPropertiesForKeys: Array(keys)) else {
+            return .zero
+        }
+        var usage = Usage.zero
+        for case let fileURL as URL in enumerator {
+            guard let values = try? fileURL.resourceValues(forKeys: keys), values.isRegularFile == true else {
+                continue
+            }
+            usage.byteCount += Int64(values.totalFileAllocatedSize ?? values.fileAllocatedSize ?? 0)
+            usage.fileCount += 1
+        }
+        return usage
+    }
+}
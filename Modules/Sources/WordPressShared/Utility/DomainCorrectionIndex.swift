@@ -0,0 +1,252 @@
+import Foundation
+
+/// An index of domain names that finds the known domain a single typo away from
+/// a given domain.
+///
+/// The domains are stored in a BK-tree keyed by their Damerau–Levenshtein
+/// distance, so a lookup is only compared with a small part of the list and
+/// doesn't create any candidate strings. It's built once, and can be queried
+/// from any thread.
+struct DomainCorrectionIndex {
+    private struct Node {
+        let characters: [Character]
+        let domain: String
+        let frequency: Int
+        var children: [(distance: Int, node: Int)] = []
+    }
+
+    private var nodes: [Node] = []
+    private let domains: Set<String>
+
+    /// The number of characters of the longest domain.
+    let maximumDomainLength: Int
+
+    /// - Parameters:
+    ///   - domains: The known domains.
+    ///   - frequencies: How often each domain is used. When several domains are a
+    ///     typo away, the most frequent one is suggested. Domains with no frequency
+    ///     count as 0.
+    init<S: Sequence<String>>(domains: S, frequencies: [String: Int] = [:]) {
+        self.domains = Set(domains)
+        self.maximumDomainLength = self.domains.map(\.count).max() ?? 0
+
+        // Sorted so that the tree doesn't depend on the order of the set.
+        for domain in self.domains.sorted() {
+            insert(Node(characters: Array(domain), domain: domain, frequency: frequencies[domain] ?? 0))
+        }
+    }
+
+    /// Returns the domain itself if it's known, the known domain it's most likely a
+    /// typo of, or `nil`.
+    ///
+    /// A typo is a single deleted character, a transposition of two adjacent characters,
+    /// or a letter (a–z) replaced or inserted. Among the domains with the same frequency,
+    /// the first one found by trying these edits in that order, from the start of the
+    /// domain, is suggested.
+    func suggestion(for domain: String) -> String? {
+        var comparisons = 0
+        return suggestion(for: domain, comparisons: &comparisons)
+    }
+
+    /// - Parameter comparisons: Incremented for each known domain the domain is
+    ///   compared with.
+    func suggestion(for domain: String, comparisons: inout Int) -> String? {
+        guard !domains.contains(domain) else {
+            return domain
+        }
+        guard !nodes.isEmpty else {
+            return nil
+        }
+
+        let word = Array(domain)
+        var matrix = [Int](repeating: 0, count: (word.count + 2) * (maximumDomainLength + 2))
+        var lastRows: [Character: Int] = [:]
+        var best: (node: Node, rank: EditRank)?
+        var pending = [0]
+        while let index = pending.popLast() {
+            let node = nodes[index]
+            let distance = Self.distance(from: word, to: node.characters, matrix: &matrix, lastRows: &lastRows)
+            comparisons += 1
+            if distance == 1, let rank = EditRank(from: word, to: node.characters) {
+                if let current = best {
+                    if node.frequency > current.node.frequency || (node.frequency == current.node.frequency && rank < current.rank) {
+                        best = (node, rank)
+                    }
+                } else {
+                    best = (node, rank)
+                }
+            }
+            for child in node.children where abs(child.distance - distance) <= 1 {
+                pending.append(child.node)
+            }
+        }
+        return best?.node.domain
+    }
+
+    private mutating func insert(_ node: Node) {
+        guard !nodes.isEmpty else {
+            nodes.append(node)
+            return
+        }
+
+        var matrix = [Int](repeating: 0, count: (maximumDomainLength + 2) * (maximumDomainLength + 2))
+        var lastRows: [Character: Int] = [:]
+        var index = 0
+        while true {
+            let distance = Self.distance(from: node.characters, to: nodes[index].characters, matrix: &matrix, lastRows: &lastRows)
+            if let child = nodes[index].children.first(where: { $0.distance == distance }) {
+                index = child.node
+            } else {
+                nodes[index].children.append((distance, nodes.count))
+                nodes.append(node)
+                return
+            }
+        }
+    }
+
+    /// The Damerau–Levenshtein distance, where a transposition of two adjacent
+    /// characters counts as a single edit.
+    ///
+    /// Unlike the optimal string alignment distance, which doesn't allow editing a
+    /// substring more than once, it satisfies the triangle inequality the tree relies
+    /// on to skip branches. Otherwise, a domain such as "live.com" could be missed
+    /// for "liv.ecom".
+    ///
+    /// - Parameters:
+    ///   - matrix: A buffer for the distance matrix, reused between calls. It's
+    ///     resized if needed.
+    ///   - lastRows: A buffer for the last row where each character of `a` was seen.
+    private static func distance(from a: [Character], to b: [Character], matrix: inout [Int], lastRows: inout [Character: Int]) -> Int {
+        guard !a.isEmpty, !b.isEmpty else {
+            return max(a.count, b.count)
+        }
+
+        // The first row and column hold a distance larger than any other, and the
+        // distance between the prefixes of length `i` and `j` is at `i + 1, j + 1`.
+        let width = b.count + 2
+        let size = (a.count + 2) * width
+        if matrix.count < size {
+            matrix = [Int](repeating: 0, count: size)
+        }
+        lastRows.removeAll(keepingCapacity: true)
+        let infinity = a.count + b.count
+        return matrix.withUnsafeMutableBufferPointer { d in
+            d[0] = infinity
+            for i in 0...a.count {
+                d[(i + 1) * width] = infinity
+                d[(i + 1) * width + 1] = i
+            }
+            for j in 0...b.count {
+                d[j + 1] = infinity
+                d[width + j + 1] = j
+            }
+            for i in 1...a.count {
+                // The last column where `a[i - 1]` was seen in `b`.
+                var lastColumn = 0
+                for j in 1...b.count {
+                    let k = lastRows[b[j - 1]] ?? 0
+                    let l = lastColumn
+                    let cost: Int
+                    if a[i - 1] == b[j - 1] {
+                        cost = 0
+                        lastColumn = j
+                    } else {
+                        cost = 1
+                    }
+                    d[(i + 1) * width + j + 1] = min(
+                        d[i * width + j] + cost,
+                        d[(i + 1) * width + j] + 1,
+                        d[i * width + j + 1] + 1,
+                        // The characters between the transposed ones are deleted or inserted.
+                        d[k * width + l] + (i - k - 1) + 1 + (j - l - 1)
+                    )
+                }
+                lastRows[a[i - 1]] = i
+            }
+            return d[(a.count + 1) * width + b.count + 1]
+        }
+    }
+}
+
+/// Where a correction comes in the order the edits of a domain are tried in:
+/// deletions, transpositions, replacements, and insertions. The letters are
+/// tried in alphabetical order, and the positions from the start of the domain.
+private struct EditRank: Comparable {
+    private let operation: Int
+    private let letter: Int
+    private let position: Int
+
+    /// Finds the first edit that turns the word into the domain, if the domain
+    /// is a single edit away.
+    init?(from word: [Character], to domain: [Character]) {
+        // The index of the first different character.
+        var prefix = 0
+        while prefix < word.count && prefix < domain.count && word[prefix] == domain[prefix] {
+            prefix += 1
+        }
+
+        switch domain.count - word.count {
+        case -1:
+            guard word[(prefix + 1)...].elementsEqual(domain[prefix...]) else {
+                return nil
+            }
+            // Deleting any character of a run gives the same domain.
+            var position = prefix
+            while position > 0 && word[position - 1] == word[prefix] {
+                position -= 1
+            }
+            self.init(operation: 0, letter: 0, position: position)
+        case 0:
+            guard prefix < word.count else {
+                return nil
+            }
+            if prefix + 1 < word.count,
+               word[prefix] == domain[prefix + 1], word[prefix + 1] == domain[prefix],
+               word[(prefix + 2)...].elementsEqual(domain[(prefix + 2)...]) {
+                self.init(operation: 1, letter: 0, position: prefix)
+            } else if let letter = Self.letter(domain[prefix]), word[(prefix + 1)...].elementsEqual(domain[(prefix + 1)...]) {
+                self.init(operation: 2, letter: letter, position: prefix)
+            } else {
+                return nil
+            }
+        case 1:
+            guard let letter = Self.letter(domain[prefix]) else {
+                return nil
+            }
+            if prefix == word.count {
+                // Replacing the end of the domain appends the letter.
+                self.init(operation: 2, letter: letter, position: prefix)
+                return
+            }
+            guard domain[(prefix + 1)...].elementsEqual(word[prefix...]) else {
+                return nil
+            }
+            // Inserting a letter anywhere in a run of that letter gives the same domain.
+            var position = prefix
+            while position > 0 && word[position - 1] == domain[prefix] {
+                position -= 1
+            }
+            self.init(operation: 3, letter: letter, position: position)
+        default:
+            return nil
+        }
+    }
+
+    private init(operation: Int, letter: Int, position: Int) {
+        self.operation = operation
+        self.letter = letter
+        self.position = position
+    }
+
+    static func < (lhs: EditRank, rhs: EditRank) -> Bool {
+        (lhs.operation, lhs.letter, lhs.position) < (rhs.operation, rhs.letter, rhs.position)
+    }
+
+    /// The index of the character in the alphabet used for replacements and insertions.
+    private static func letter(_ character: Character) -> Int? {
+        guard let ascii = character.asciiValue, (UInt8(ascii: "a")...UInt8(ascii: "z")).contains(ascii) else {
+            return nil
+        }
+        return Int(ascii - UInt8(ascii: "a"))
+    }
+}
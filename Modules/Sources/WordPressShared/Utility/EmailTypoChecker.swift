@@ -1,6 +1,7 @@
 import Foundation
 
-private let knownDomains = Set([
+/// The domains of popular email providers.
+let knownEmailDomains = Set([
     /* Default domains included */
     "aol.com", "att.net", "comcast.net", "facebook.com", "gmail.com", "gmx.com", "googlemail.com",
     "google.com", "hotmail.com", "hotmail.co.uk", "mac.com", "me.com", "msn.com",
@@ -42,6 +43,8 @@ private let knownDomains = Set([
     "hotmail.com", "gmail.com", "yahoo.com.mx", "live.com.mx", "yahoo.com", "hotmail.es", "live.com", "hotmail.com.mx", "prodigy.net.mx", "msn.com"
 ])
 
+private let domainCorrectionIndex = DomainCorrectionIndex(domains: knownEmailDomains)
+
 /// Provides suggestions to fix common typos on email addresses.
 ///
 /// It tries to match the email domain with a list of popular hosting providers,
@@ -66,72 +69,11 @@ open class EmailTypoChecker: NSObject {
         }
 
         // If the domain name is too long, don't try suggestion (resource consuming and useless)
-        guard domain.count < lengthOfLongestKnownDomain() + 1 else {
+        guard domain.count < domainCorrectionIndex.maximumDomainLength + 1 else {
             return email
         }
 
-        let suggestedDomain = suggest(domain)
+        let suggestedDomain = domainCorrectionIndex.suggestion(for: domain) ?? domain
         return account + "@" + suggestedDomain
     }
 }
-
-private func suggest(_ word: String) -> String {
-    if knownDomains.contains(word) {
-        return word
-    }
-
-    let candidates = edits(word).filter({ knownDomains.contains($0) })
-    return candidates.first ?? word
-}
-
-private func edits(_ word: String) -> [String] {
-    // deletes
-    let deleted = deletes(word)
-    let transposed = transposes(word)
-    let replaced = alphabet.flatMap({ character in
-        return replaces(character, ys: word)
-    })
-    let inserted = alphabet.flatMap({ character in
-        return between(character, ys: word)
-    })
-
-    return deleted + transposed + replaced + inserted
-}
-
-private func deletes(_ word: String) -> [String] {
-    return word.indices.map({ word.removing(at: $0) })
-}
-
-private func transposes(_ word: String) -> [String] {
-    return word.indices.compactMap({ index in
-        let (i, j) = (index, word.index(after: index))
-        guard j < word.endIndex else {
-            return nil
-        }
-        var copy = word
-        copy.replaceSubrange(i...j, with: String(word[j]) + String(word[i]))
-        return copy
-    })
-}
-
-private func replaces(_ x: Character, ys: String) -> [String] {
-    guard let head = ys.first else {
-        return [String(x)]
-    }
-    let tail = ys.dropFirst()
-    return [String(x) + String(tail)] + replaces(x, ys: String(tail)).map({ String(head) + $0 })
-}
-
-private func between(_ x: Character, ys: String) -> [String] {
-    guard let head = ys.first else {
-        return [String(x)]
-    }
-    let tail = ys.dropFirst()
-    return [String(x) + String(ys)] + between(x, ys: String(tail)).map({ String(head) + $0 })
-}
-
-private let alphabet = "abcdefghijklmnopqrstuvwxyz"
-
-private func lengthOfLongestKnownDomain() -> Int {
-    return knownDomains.map({ $0.count }).max() ?? 0
-}
@@ -1,33 +1,34 @@
 import Foundation
+import WordPressSharedObjC
 
 /// A fast excerpt generator that returns the first paragraph of plain text for
 /// a Gutenberg post.
+///
+/// The content is scanned once, starting from the first `<p>` element, and the
+/// scan stops as soon as there is enough text for the excerpt, so a long post
+/// costs about as much as a short one.
 public struct GutenbergExcerptGenerator {
-    /// Matches an opening `<p>` tag (optionally with attributes), but not other
-    /// elements that merely begin with `<p`, such as `<pre>` or `<param>`.
-    private static let openingParagraphRegex = try? NSRegularExpression(pattern: "<p(\\s[^>]*)?>", options: [.caseInsensitive])
-
-    /// Matches a run of one or more `<br>` tags, including self-closing and
-    /// attributed variants: `<br>`, `<br/>`, `<br />`, `<br class="…">`.
-    private static let lineBreakRegex = try? NSRegularExpression(pattern: "(<br\\b[^>]*>)+", options: [.caseInsensitive])
-
-    /// Matches any remaining HTML tag or shortcode.
-    private static let tagOrShortcodeRegex = try? NSRegularExpression(pattern: "<[^>]+>|\\[[^\\]]+\\]", options: [])
-
-    /// Whitespace collapsed into single spaces. Excludes U+00A0 (non-breaking
-    /// space) so an intentional `&nbsp;` survives into the excerpt.
-    private static let collapsibleWhitespace = CharacterSet.whitespacesAndNewlines
-        .subtracting(CharacterSet(charactersIn: "\u{00A0}"))
-
     public static func firstParagraph(from content: String, maxLength: Int = 150) -> String {
-        // Find the first real `<p>` element and its matching `</p>`.
-        guard let paragraphTag = firstMatch(of: openingParagraphRegex, in: content),
-              let pEnd = content.range(of: "</p>", options: .caseInsensitive, range: paragraphTag.upperBound..<content.endIndex) else {
+        // Find the first real `<p>` element.
+        guard let paragraphStart = indexAfterOpeningParagraphTag(in: content.unicodeScalars) else {
             return ""
         }
 
-        let paragraph = String(content[paragraphTag.upperBound..<pEnd.lowerBound])
-        let text = singleLinePlainText(from: paragraph)
+        // Two more characters than needed are enough to know the text has to be
+        // truncated, without a combining character changing where.
+        var scanner = PlainTextScanner(content.unicodeScalars, from: paragraphStart, stopsAtParagraphEnd: true)
+        let text = scanner.scan(upToCharacterCount: maxLength + 2)
+
+        // The paragraph has to be closed by a `</p>`.
+        if scanner.isAtEnd {
+            guard scanner.hasReachedParagraphEnd else {
+                return ""
+            }
+        } else {
+            guard content.range(of: "</p>", options: .caseInsensitive, range: scanner.position..<content.endIndex) != nil else {
+                return ""
+            }
+        }
 
         // Truncate if needed.
         if text.count <= maxLength {
@@ -46,33 +47,363 @@ public struct GutenbergExcerptGenerator {
     /// Remaining tags and shortcodes are removed, entities are decoded, and
     /// whitespace runs collapse into single spaces.
     public static func singleLinePlainText(from html: String) -> String {
-        // Convert `<br>` runs to spaces so words don't run together, then remove
-        // any remaining tags and shortcodes.
-        let withoutBreaks = replacingMatches(of: lineBreakRegex, in: html, withTemplate: " ")
-        let stripped = replacingMatches(of: tagOrShortcodeRegex, in: withoutBreaks, withTemplate: "")
-
-        // Decode entities and collapse every whitespace run into a single space,
-        // yielding single-line plain text.
-        return stripped
-            .stringByDecodingXMLCharacters()
-            .components(separatedBy: collapsibleWhitespace)
-            .filter { !$0.isEmpty }
-            .joined(separator: " ")
-    }
-
-    /// Returns the range of the first match of `regex` in `string`, or `nil`.
-    private static func firstMatch(of regex: NSRegularExpression?, in string: String) -> Range<String.Index>? {
-        guard let regex else { return nil }
-        let range = NSRange(string.startIndex..., in: string)
-        guard let match = regex.firstMatch(in: string, options: [], range: range) else { return nil }
-        return Range(match.range, in: string)
-    }
-
-    /// Replaces every match of `regex` in `string` with `template`, returning the
-    /// original string unchanged when the regex is unavailable.
-    private static func replacingMatches(of regex: NSRegularExpression?, in string: String, withTemplate template: String) -> String {
-        guard let regex else { return string }
-        let range = NSRange(string.startIndex..., in: string)
-        return regex.stringByReplacingMatches(in: string, options: [], range: range, withTemplate: template)
+        var scanner = PlainTextScanner(html.unicodeScalars, from: html.startIndex, stopsAtParagraphEnd: false)
+        return scanner.scan(upToCharacterCount: nil)
+    }
+
+    /// Returns the index after the first opening `<p>` tag (optionally with
+    /// attributes), skipping other elements that merely begin with `<p`, such as
+    /// `<pre>` or `<param>`.
+    private static func indexAfterOpeningParagraphTag(in scalars: String.UnicodeScalarView) -> String.Index? {
+        var searchStart = scalars.startIndex
+        while let tagStart = scalars[searchStart...].firstIndex(of: "<") {
+            searchStart = scalars.index(after: tagStart)
+            guard searchStart < scalars.endIndex, scalars[searchStart] == "p" || scalars[searchStart] == "P" else {
+                continue
+            }
+            let afterName = scalars.index(after: searchStart)
+            guard afterName < scalars.endIndex else {
+                return nil
+            }
+            if scalars[afterName] == ">" {
+                return scalars.index(after: afterName)
+            }
+            if PlainTextScanner.isRegexWhitespace(scalars[afterName]) {
+                // If there is no `>` left, no later `<p` can be a tag either.
+                return scalars[afterName...].firstIndex(of: ">").map(scalars.index(after:))
+            }
+        }
+        return nil
+    }
+}
+
+/// Produces the single-line plain text of an HTML fragment in one pass.
+///
+/// The output is the same as running these steps over the whole fragment, in order:
+///
+/// 1. Replace each run of `<br>` tags with a space.
+/// 2. Remove the remaining tags (`<[^>]+>`) and shortcodes (`\[[^\]]+\]`).
+/// 3. Decode the character references using `stringByDecodingXMLCharacters()`.
+/// 4. Collapse each whitespace run (except U+00A0) into a single space, and trim.
+///
+/// Each step is applied to the output of the previous one as it's produced,
+/// which is why e.g. an entity split by a tag is still decoded.
+private struct PlainTextScanner {
+    private let scalars: String.UnicodeScalarView
+    private let stopsAtParagraphEnd: Bool
+
+    /// The position of the first step in the input.
+    private(set) var position: String.Index
+    /// Whether the whole fragment (or paragraph) has been scanned.
+    private(set) var isAtEnd = false
+    /// Whether the scan stopped at the `</p>` closing the paragraph.
+    private(set) var hasReachedParagraphEnd = false
+
+    private var isInLineBreakRun = false
+    /// The text read ahead (after the tags are removed) while looking for a character reference.
+    private var readAhead: [Unicode.Scalar] = []
+    private var readAheadIndex = 0
+    /// A decoded high surrogate waiting for the low surrogate that may follow it.
+    private var pendingHighSurrogate: UInt16?
+
+    private var text = ""
+    private var textScalarCount = 0
+    private var hasPendingSpace = false
+
+    init(_ scalars: String.UnicodeScalarView, from start: String.Index, stopsAtParagraphEnd: Bool) {
+        self.scalars = scalars
+        self.position = start
+        self.stopsAtParagraphEnd = stopsAtParagraphEnd
+    }
+
+    /// Scans the input until the text has the given number of characters or the input ends.
+    mutating func scan(upToCharacterCount characterCount: Int?) -> String {
+        while let scalar = nextTextScalar() {
+            if scalar == "&" {
+                appendCharacterReference()
+            } else {
+                append(scalar)
+            }
+
+            if let characterCount, hasCharacters(characterCount) {
+                break
+            }
+        }
+        flushPendingHighSurrogate()
+        return text
+    }
+
+    // MARK: - Tags and shortcodes
+
+    /// Returns the next scalar of the input with the line breaks, tags, and shortcodes removed.
+    private mutating func nextStrippedScalar() -> Unicode.Scalar? {
+        while !isAtEnd && position < scalars.endIndex {
+            let scalar = scalars[position]
+            if scalar == "<" {
+                if stopsAtParagraphEnd && isParagraphEnd(at: position) {
+                    hasReachedParagraphEnd = true
+                    break
+                }
+                if let end = endOfLineBreak(at: position) {
+                    position = end
+                    if isInLineBreakRun {
+                        continue
+                    }
+                    isInLineBreakRun = true
+                    return " "
+                }
+                isInLineBreakRun = false
+                if let end = endOfElement(at: position, closedBy: ">") {
+                    position = end
+                    continue
+                }
+            } else if scalar == "[" {
+                isInLineBreakRun = false
+                if let end = endOfElement(at: position, closedBy: "]") {
+                    position = end
+                    continue
+                }
+            }
+            isInLineBreakRun = false
+            position = scalars.index(after: position)
+            return scalar
+        }
+        isAtEnd = true
+        return nil
+    }
+
+    /// Returns the index after the `<br>` tag (`<br\b[^>]*>`) starting at the given index.
+    private func endOfLineBreak(at start: String.Index) -> String.Index? {
+        var index = scalars.index(after: start)
+        for letter in ["b", "r"] as [Unicode.Scalar] {
+            // ASCII case-insensitive comparison.
+            guard index < scalars.endIndex, scalars[index].value | 0x20 == letter.value else {
+                return nil
+            }
+            index = scalars.index(after: index)
+        }
+        if index < scalars.endIndex && Self.isRegexWordCharacter(scalars[index]) {
+            return nil
+        }
+        while index < scalars.endIndex {
+            switch scalars[index] {
+            case ">":
+                return scalars.index(after: index)
+            case "<" where stopsAtParagraphEnd && isParagraphEnd(at: index):
+                return nil
+            default:
+                index = scalars.index(after: index)
+            }
+        }
+        return nil
+    }
+
+    /// Returns the index after the tag or shortcode starting at the given index, i.e. after the
+    /// first closing delimiter that is not the first character. The line breaks inside don't count,
+    /// since they are replaced (by a space) before the tags are removed.
+    private func endOfElement(at start: String.Index, closedBy delimiter: Unicode.Scalar) -> String.Index? {
+        var index = scalars.index(after: start)
+        var isEmpty = true
+        while index < scalars.endIndex {
+            let scalar = scalars[index]
+            if scalar == delimiter {
+                return isEmpty ? nil : scalars.index(after: index)
+            }
+            if scalar == "<" {
+                if stopsAtParagraphEnd && isParagraphEnd(at: index) {
+                    return nil
+                }
+                if let end = endOfLineBreak(at: index) {
+                    index = end
+                    isEmpty = false
+                    continue
+                }
+            }
+            isEmpty = false
+            index = scalars.index(after: index)
+        }
+        return nil
+    }
+
+    /// Whether a `</p>` starts at the given index. Like `String.range(of:options:)`, it
+    /// doesn't match if the `>` is followed by a combining mark.
+    private func isParagraphEnd(at start: String.Index) -> Bool {
+        var index = start
+        for expected in ["<", "/", "p", ">"] as [Unicode.Scalar] {
+            guard index < scalars.endIndex else {
+                return false
+            }
+            let scalar = scalars[index]
+            guard scalar == expected || (expected == "p" && scalar == "P") else {
+                return false
+            }
+            index = scalars.index(after: index)
+        }
+        return index == scalars.endIndex || !scalars[index].properties.isGraphemeExtend
+    }
+
+    // MARK: - Character references
+
+    private mutating func nextTextScalar() -> Unicode.Scalar? {
+        if readAheadIndex < readAhead.count {
+            defer { readAheadIndex += 1 }
+            return readAhead[readAheadIndex]
+        }
+        return nextStrippedScalar()
+    }
+
+    /// Decodes the character reference starting with the `&` that has just been read, matching
+    /// `stringByDecodingXMLCharacters()`: a reference ends at the first `;` before the next `&`, and
+    /// is 4 to 10 UTF-16 code units long.
+    private mutating func appendCharacterReference() {
+        var reference: [Unicode.Scalar] = ["&"]
+        var length = 1
+        while length <= 10, let scalar = nextTextScalar() {
+            reference.append(scalar)
+            length += scalar.utf16.count
+            if scalar == ";" || scalar == "&" {
+                break
+            }
+        }
+
+        if reference.last == ";", (4...10).contains(length), let decoded = Self.decode(reference) {
+            decoded.forEach { append(codeUnit: $0) }
+            return
+        }
+
+        // Not a reference: the `&` is kept, and what follows it is scanned again.
+        append("&")
+        readAhead = Array(reference.dropFirst()) + readAhead[readAheadIndex...]
+        readAheadIndex = 0
+    }
+
+    /// The named character references decoded by `NSString.decodeXMLCharacters(in:)`.
+    private static let namedCharacterReferences = NSString.xmlNamedCharacterReferences.mapValues(\.uint16Value)
+
+    private static func decode(_ reference: [Unicode.Scalar]) -> [UInt16]? {
+        let body = reference[1..<(reference.count - 1)]
+        guard body.first == "#" else {
+            let name = String(String.UnicodeScalarView(body))
+            return namedCharacterReferences[name].map { [$0] }
+        }
+
+        let isHexadecimal = body.dropFirst().first == "x" || body.dropFirst().first == "X"
+        let digits = body.dropFirst(isHexadecimal ? 2 : 1)
+        let isDigit: (Unicode.Scalar) -> Bool = isHexadecimal ? { $0.properties.isASCIIHexDigit } : { ("0"..."9").contains($0) }
+        guard !digits.isEmpty, digits.allSatisfy(isDigit) else {
+            // Defer the unusual forms, like a leading whitespace or a `0x` prefix, to the original.
+            let string = String(String.UnicodeScalarView(reference))
+            return Array(NSString.decodeXMLCharacters(in: string).utf16)
+        }
+        guard let value = UInt32(String(String.UnicodeScalarView(digits)), radix: isHexadecimal ? 16 : 10),
+              value > 0 && value < UInt32(UInt16.max) else {
+            return nil
+        }
+        return [UInt16(value)]
+    }
+
+    // MARK: - Whitespace
+
+    /// Appends a decoded UTF-16 code unit. Consecutive references can encode a surrogate pair, and
+    /// a lone surrogate becomes U+FFFD, like when the decoded `NSString` is bridged.
+    private mutating func append(codeUnit: UInt16) {
+        if UTF16.isLeadSurrogate(codeUnit) {
+            flushPendingHighSurrogate()
+            pendingHighSurrogate = codeUnit
+        } else if UTF16.isTrailSurrogate(codeUnit), let highSurrogate = pendingHighSurrogate {
+            pendingHighSurrogate = nil
+            let value = 0x10000 + (UInt32(highSurrogate - 0xD800) << 10) + UInt32(codeUnit - 0xDC00)
+            appendCollapsingWhitespace(Unicode.Scalar(value) ?? "\u{FFFD}")
+        } else {
+            append(Unicode.Scalar(codeUnit) ?? "\u{FFFD}")
+        }
+    }
+
+    private mutating func append(_ scalar: Unicode.Scalar) {
+        flushPendingHighSurrogate()
+        appendCollapsingWhitespace(scalar)
+    }
+
+    private mutating func flushPendingHighSurrogate() {
+        if pendingHighSurrogate != nil {
+            pendingHighSurrogate = nil
+            appendCollapsingWhitespace("\u{FFFD}")
+        }
+    }
+
+    private mutating func appendCollapsingWhitespace(_ scalar: Unicode.Scalar) {
+        if Self.isCollapsibleWhitespace(scalar) {
+            hasPendingSpace = !text.isEmpty
+            return
+        }
+        if hasPendingSpace {
+            hasPendingSpace = false
+            text.unicodeScalars.append(" ")
+            textScalarCount += 1
+        }
+        text.unicodeScalars.append(scalar)
+        textScalarCount += 1
+    }
+
+    /// Whether the text has at least the given number of characters. Counting the characters is only
+    /// needed once there are enough scalars, and then only every few scalars.
+    private func hasCharacters(_ count: Int) -> Bool {
+        guard textScalarCount >= count, (textScalarCount - count) % 8 == 0 else {
+            return false
+        }
+        return text.count >= count
+    }
+
+    // MARK: - Character classes
+
+    /// `CharacterSet.whitespacesAndNewlines`, except U+00A0 (non-breaking space),
+    /// so an intentional `&nbsp;` survives into the excerpt.
+    static func isCollapsibleWhitespace(_ scalar: Unicode.Scalar) -> Bool {
+        switch scalar.value {
+        case 0x09...0x0D, 0x20, 0x85:
+            return true
+        case 0xA0:
+            return false
+        case ..<0x80:
+            return false
+        default:
+            switch scalar.properties.generalCategory {
+            case .spaceSeparator, .lineSeparator, .paragraphSeparator:
+                return true
+            default:
+                return false
+            }
+        }
+    }
+
+    /// `\s` in `NSRegularExpression`: `[\t\n\f\r\p{Z}]`.
+    static func isRegexWhitespace(_ scalar: Unicode.Scalar) -> Bool {
+        switch scalar {
+        case "\t", "\n", "\u{0C}", "\r":
+            return true
+        default:
+            switch scalar.properties.generalCategory {
+            case .spaceSeparator, .lineSeparator, .paragraphSeparator:
+                return true
+            default:
+                return false
+            }
+        }
+    }
+
+    /// `\w` in `NSRegularExpression`, which `\b` is based on.
+    static func isRegexWordCharacter(_ scalar: Unicode.Scalar) -> Bool {
+        if scalar.isASCII {
+            return ("a"..."z").contains(scalar) || ("A"..."Z").contains(scalar) || ("0"..."9").contains(scalar) || scalar == "_"
+        }
+        if scalar == "\u{200C}" || scalar == "\u{200D}" || scalar.properties.isAlphabetic {
+            return true
+        }
+        switch scalar.properties.generalCategory {
+        case .nonspacingMark, .spacingMark, .enclosingMark, .decimalNumber, .connectorPunctuation:
+            return true
+        default:
+            return false
+        }
     }
 }
@@ -0,0 +1,340 @@
+import Foundation
+
+/// An immutable catalogue of the WordPress.com languages, indexed by id and slug.
+///
+/// The catalogue is loaded either from `Languages.json`, or from its compact binary
+/// representation (see `encoded()`). The binary representation is memory mapped and
+/// contains the hash tables used for the lookups, so loading it takes constant time,
+/// and the languages are only decoded when they are looked up.
+///
+/// It can be used from any thread.
+final class LanguageCatalogue {
+    enum Error: Swift.Error {
+        case invalidCompactRepresentation
+        case unsupportedLanguage(WPComLanguage)
+    }
+
+    private enum Storage {
+        case decoded(all: [WPComLanguage], popular: [WPComLanguage], ids: [Int: Int], slugs: [String: Int])
+        case compact(CompactLanguageCatalogue)
+    }
+
+    private let storage: Storage
+
+    private let lock = NSLock()
+    private var _all: [WPComLanguage]?
+    private var _popular: [WPComLanguage]?
+    private var deviceLanguages: [String: WPComLanguage] = [:]
+
+    /// Loads the catalogue from the contents of `Languages.json`.
+    init(jsonData: Data) throws {
+        let bundle = try JSONDecoder().decode(WPComLanguageBundle.self, from: jsonData)
+        let all = bundle.all
+
+        // The first language wins, like when searching the list.
+        var ids: [Int: Int] = [:]
+        var slugs: [String: Int] = [:]
+        for (index, language) in all.enumerated() {
+            if ids[language.id] == nil {
+                ids[language.id] = index
+            }
+            if slugs[language.slug] == nil {
+                slugs[language.slug] = index
+            }
+        }
+        storage = .decoded(all: all, popular: bundle.popular, ids: ids, slugs: slugs)
+    }
+
+    /// Loads the catalogue from its compact binary representation, created by `encoded()`.
+    init(compactData: Data) throws {
+        storage = .compact(try CompactLanguageCatalogue(data: compactData))
+    }
+
+    /// Loads the catalogue bundled with the framework, preferring its compact representation,
+    /// `Languages.catalogue`, generated by `Scripts/generate-language-catalogue.rb`.
+    static func loadBundled(from bundle: Bundle = .wordPressSharedBundle) -> LanguageCatalogue {
+        if let url = bundle.url(forResource: "Languages", withExtension: "catalogue"),
+           let data = try? Data(contentsOf: url, options: .alwaysMapped),
+           let catalogue = try? LanguageCatalogue(compactData: data) {
+            return catalogue
+        }
+        let url = bundle.url(forResource: "Languages", withExtension: "json")!
+        return try! LanguageCatalogue(jsonData: Data(contentsOf: url))
+    }
+
+    /// Every supported language, sorted by name.
+    var all: [WPComLanguage] {
+        switch storage {
+        case let .decoded(all, _, _, _):
+            return all
+        case let .compact(catalogue):
+            lock.lock()
+            defer { lock.unlock() }
+            if let _all {
+                return _all
+            }
+            let all = (0..<catalogue.recordCount).map(catalogue.language(at:))
+            _all = all
+            return all
+        }
+    }
+
+    /// The languages considered popular.
+    var popular: [WPComLanguage] {
+        switch storage {
+        case let .decoded(_, popular, _, _):
+            return popular
+        case let .compact(catalogue):
+            lock.lock()
+            defer { lock.unlock() }
+            if let _popular {
+                return _popular
+            }
+            let popular = catalogue.popularIndices().map(catalogue.language(at:))
+            _popular = popular
+            return popular
+        }
+    }
+
+    func language(id: Int) -> WPComLanguage? {
+        switch storage {
+        case let .decoded(all, _, ids, _):
+            return ids[id].map { all[$0] }
+        case let .compact(catalogue):
+            return catalogue.index(ofID: id).map(catalogue.language(at:))
+        }
+    }
+
+    func language(slug: String) -> WPComLanguage? {
+        switch storage {
+        case let .decoded(all, _, _, slugs):
+            return slugs[slug].map { all[$0] }
+        case let .compact(catalogue):
+            return catalogue.index(ofSlug: slug).map(catalogue.language(at:))
+        }
+    }
+
+    /// Returns the memoized result of `resolve` for the device language code.
+    func deviceLanguage(for languageCode: String, resolve: (String) -> WPComLanguage) -> WPComLanguage {
+        lock.lock()
+        if let language = deviceLanguages[languageCode] {
+            lock.unlock()
+            return language
+        }
+        lock.unlock()
+
+        let language = resolve(languageCode)
+        lock.lock()
+        deviceLanguages[languageCode] = language
+        lock.unlock()
+        return language
+    }
+
+    // MARK: - Compact Representation
+
+    /// Returns the compact binary representation of the catalogue.
+    ///
+    /// All the integers are little endian. The format is:
+    ///
+    /// - A header: the `WPLC` magic number, the version (`UInt16`), the number of languages (`UInt16`),
+    ///   the number of popular languages (`UInt16`), the size of the hash tables (`UInt16`, a power of 2),
+    ///   and the size of the strings (`UInt32`).
+    /// - The languages, sorted by name: the id (`UInt32`), the offset of the slug in the strings (`UInt32`),
+    ///   the length of the slug (`UInt16`), and the length of the name (`UInt16`), which follows the slug.
+    /// - The indices of the popular languages (`UInt16`).
+    /// - The hash table of the ids, then the hash table of the slugs. Each slot is the index of a language
+    ///   plus one (`UInt16`), or 0 if the slot is empty. The collisions are resolved by linear probing.
+    /// - The strings, in UTF-8.
+    ///
+    /// - SeeAlso: `Scripts/generate-language-catalogue.rb`, which has to produce the same output.
+    func encoded() throws -> Data {
+        let all = self.all
+        let popular = self.popular
+        let tableSize = CompactLanguageCatalogue.tableSize(forCount: all.count)
+
+        var records = Data()
+        var strings = Data()
+        var idTable = [UInt16](repeating: 0, count: tableSize)
+        var slugTable = [UInt16](repeating: 0, count: tableSize)
+        for (index, language) in all.enumerated() {
+            guard let id = UInt32(exactly: language.id), let slugLength = UInt16(exactly: language.slug.utf8.count),
+                  let nameLength = UInt16(exactly: language.name.utf8.count), let offset = UInt32(exactly: strings.count) else {
+                throw Error.unsupportedLanguage(language)
+            }
+            records.appendLittleEndian(id)
+            records.appendLittleEndian(offset)
+            records.appendLittleEndian(slugLength)
+            records.appendLittleEndian(nameLength)
+            strings.append(contentsOf: language.slug.utf8)
+            strings.append(contentsOf: language.name.utf8)
+
+            CompactLanguageCatalogue.insert(index, in: &idTable, at: CompactLanguageCatalogue.hash(id: id)) { other in
+                all[other].id == language.id
+            }
+            CompactLanguageCatalogue.insert(index, in: &slugTable, at: CompactLanguageCatalogue.hash(slug: language.slug.utf8)) { other in
+                all[other].slug == language.slug
+            }
+        }
+
+        var data = Data(CompactLanguageCatalogue.magic)
+        data.appendLittleEndian(CompactLanguageCatalogue.version)
+        data.appendLittleEndian(UInt16(all.count))
+        data.appendLittleEndian(UInt16(popular.count))
+        data.appendLittleEndian(UInt16(tableSize))
+        data.appendLittleEndian(UInt32(strings.count))
+        data.append(records)
+        for language in popular {
+            guard let index = all.firstIndex(of: language) else {
+                throw Error.unsupportedLanguage(language)
+            }
+            data.appendLittleEndian(UInt16(index))
+        }
+        idTable.forEach { data.appendLittleEndian($0) }
+        slugTable.forEach { data.appendLittleEndian($0) }
+        data.append(strings)
+        return data
+    }
+}
+
+/// Reads the languages from the compact representation of the catalogue without decoding it first.
+private struct CompactLanguageCatalogue {
+    static let magic: [UInt8] = Array("WPLC".utf8)
+    static let version: UInt16 = 1
+
+    private static let headerSize = 16
+    private static let recordSize = 12
+
+    private let data: Data
+    let recordCount: Int
+    private let popularCount: Int
+    private let tableSize: Int
+    private let popularOffset: Int
+    private let idTableOffset: Int
+    private let slugTableOffset: Int
+    private let stringsOffset: Int
+
+    init(data: Data) throws {
+        self.data = data
+        guard data.count >= Self.headerSize, data.prefix(4).elementsEqual(Self.magic) else {
+            throw LanguageCatalogue.Error.invalidCompactRepresentation
+        }
+        guard Self.read(UInt16.self, in: data, at: 4) == Self.version else {
+            throw LanguageCatalogue.Error.invalidCompactRepresentation
+        }
+        recordCount = Int(Self.read(UInt16.self, in: data, at: 6))
+        popularCount = Int(Self.read(UInt16.self, in: data, at: 8))
+        tableSize = Int(Self.read(UInt16.self, in: data, at: 10))
+        let stringsLength = Int(Self.read(UInt32.self, in: data, at: 12))
+
+        popularOffset = Self.headerSize + recordCount * Self.recordSize
+        idTableOffset = popularOffset + popularCount * 2
+        slugTableOffset = idTableOffset + tableSize * 2
+        stringsOffset = slugTableOffset + tableSize * 2
+        guard tableSize > recordCount, tableSize & (tableSize - 1) == 0, data.count == stringsOffset + stringsLength else {
+            throw LanguageCatalogue.Error.invalidCompactRepresentation
+        }
+    }
+
+    func language(at index: Int) -> WPComLanguage {
+        let record = Self.headerSize + index * Self.recordSize
+        let stringOffset = stringsOffset + Int(read(UInt32.self, at: record + 4))
+        let slugLength = Int(read(UInt16.self, at: record + 8))
+        let nameLength = Int(read(UInt16.self, at: record + 10))
+        return WPComLanguage(
+            id: Int(read(UInt32.self, at: record)),
+            name: string(at: stringOffset + slugLength, length: nameLength),
+            slug: string(at: stringOffset, length: slugLength)
+        )
+    }
+
+    func popularIndices() -> [Int] {
+        (0..<popularCount).map { Int(read(UInt16.self, at: popularOffset + $0 * 2)) }
+    }
+
+    func index(ofID id: Int) -> Int? {
+        guard let id = UInt32(exactly: id) else {
+            return nil
+        }
+        return lookUp(in: idTableOffset, at: Self.hash(id: id)) { index in
+            read(UInt32.self, at: Self.headerSize + index * Self.recordSize) == id
+        }
+    }
+
+    func index(ofSlug slug: String) -> Int? {
+        lookUp(in: slugTableOffset, at: Self.hash(slug: slug.utf8)) { index in
+            let record = Self.headerSize + index * Self.recordSize
+            let offset = data.startIndex + stringsOffset + Int(read(UInt32.self, at: record + 4))
+            let length = Int(read(UInt16.self, at: record + 8))
+            return data[offset..<(offset + length)].elementsEqual(slug.utf8)
+        }
+    }
+
+    // MARK: Hash Tables
+
+    static func tableSize(forCount count: Int) -> Int {
+        var size = 2
+        while size < count * 2 {
+            size *= 2
+        }
+        return size
+    }
+
+    static func hash(id: UInt32) -> UInt32 {
+        id &* 2_654_435_761
+    }
+
+    /// FNV-1a.
+    static func hash<S: Sequence<UInt8>>(slug: S) -> UInt32 {
+        slug.reduce(2_166_136_261) { hash, byte in
+            (hash ^ UInt32(byte)) &* 16_777_619
+        }
+    }
+
+    /// Inserts the index in the first empty slot, unless an equal language is already in the table.
+    static func insert(_ index: Int, in table: inout [UInt16], at hash: UInt32, isEqual: (Int) -> Bool) {
+        var slot = Int(hash & UInt32(table.count - 1))
+        while table[slot] != 0 {
+            if isEqual(Int(table[slot]) - 1) {
+                return
+            }
+            slot = (slot + 1) & (table.count - 1)
+        }
+        table[slot] = UInt16(index + 1)
+    }
+
+    private func lookUp(in tableOffset: Int, at hash: UInt32, matches: (Int) -> Bool) -> Int? {
+        var slot = Int(hash & UInt32(tableSize - 1))
+        for _ in 0..<tableSize {
+            let entry = Int(read(UInt16.self, at: tableOffset + slot * 2))
+            guard entry != 0 else {
+                return nil
+            }
+            if matches(entry - 1) {
+                return entry - 1
+            }
+            slot = (slot + 1) & (tableSize - 1)
+        }
+        return nil
+    }
+
+    // MARK: Reading
+
+    private func read<T: FixedWidthInteger>(_ type: T.Type, at offset: Int) -> T {
+        Self.read(type, in: data, at: offset)
+    }
+
+    private static func read<T: FixedWidthInteger>(_ type: T.Type, in data: Data, at offset: Int) -> T {
+        data.withUnsafeBytes { T(littleEndian: $0.loadUnaligned(fromByteOffset: offset, as: T.self)) }
+    }
+
+    private func string(at offset: Int, length: Int) -> String {
+        let start = data.startIndex + offset
+        return String(decoding: data[start..<(start + length)], as: UTF8.self)
+    }
+}
+
+private extension Data {
+    mutating func appendLittleEndian<T: FixedWidthInteger>(_ value: T) {
+        withUnsafeBytes(of: value.littleEndian) { append(contentsOf: $0) }
+    }
+}
@@ -10,39 +10,36 @@ public struct WordPressComLanguageDatabase {
 
     /// Languages considered 'popular'
     ///
-    public let popular: [WPComLanguage]
+    public var popular: [WPComLanguage] {
+        catalogue.popular
+    }
 
     /// Every supported language
     ///
-    public let all: [WPComLanguage]
+    public var all: [WPComLanguage] {
+        catalogue.all
+    }
 
     /// Allow mocking the device language code for testing purposes
     private let _deviceLanguageCode: String?
 
+    private let catalogue: LanguageCatalogue
+
+    /// The catalogue shared by every database, loaded once.
+    private static let bundledCatalogue = LanguageCatalogue.loadBundled()
+
     // MARK: - Public Methods
 
     /// Designated Initializer: will load the languages contained within the `Languages.json` file.
     ///
     private init() {
-        // Parse the json file
-        let path = Bundle.wordPressSharedBundle.path(forResource: "Languages", ofType: "json")
-        let data = try! Data(contentsOf: URL(fileURLWithPath: path!))
-        let bundle = try! JSONDecoder().decode(WPComLanguageBundle.self, from: data)
-
-        self.popular = bundle.popular
-        self.all = bundle.all
+        self.catalogue = Self.bundledCatalogue
         self._deviceLanguageCode = nil
     }
 
     /// Specifically marked internal for used by test code
-    internal init(deviceLanguageCode: String) {
-        // Parse the json file
-        let path = Bundle.wordPressSharedBundle.path(forResource: "Languages", ofType: "json")
-        let data = try! Data(contentsOf: URL(fileURLWithPath: path!))
-        let bundle = try! JSONDecoder().decode(WPComLanguageBundle.self, from: data)
-
-        self.popular = bundle.popular
-        self.all = bundle.all
+    internal init(deviceLanguageCode: String, catalogue: LanguageCatalogue? = nil) {
+        self.catalogue = catalogue ?? Self.bundledCatalogue
         self._deviceLanguageCode = deviceLanguageCode.lowercased()
     }
 
@@ -63,27 +60,29 @@ public struct WordPressComLanguageDatabase {
     /// - Returns: The language with the matching Identifier, or nil, in case it wasn't found.
     ///
     public func find(id: Int) -> WPComLanguage? {
-        return all.first(where: { $0.id == id })
+        return catalogue.language(id: id)
     }
 
     /// Returns the current device language as the corresponding WordPress.com language.
     /// If the language is not supported, it returns English.
     ///
     public var deviceLanguage: WPComLanguage {
-        let variants = LanguageTagVariants(string: deviceLanguageCode)
-        for variant in variants {
-            if let match = self.languageWithSlug(variant) {
-                return match
+        catalogue.deviceLanguage(for: deviceLanguageCode) { languageCode in
+            let variants = LanguageTagVariants(string: languageCode)
+            for variant in variants {
+                if let match = self.languageWithSlug(variant) {
+                    return match
+                }
             }
+            return languageWithSlug("en")!
         }
-        return languageWithSlug("en")!
     }
 
     /// Searches for a WordPress.com language that matches a language tag.
     ///
     fileprivate func languageWithSlug(_ slug: String) -> WPComLanguage? {
         let search = languageCodeReplacements[slug] ?? slug
-        return all.first { $0.slug == search }
+        return catalogue.language(slug: search)
     }
 
     // MARK: - Private Variables
@@ -0,0 +1,132 @@
+import Foundation
+
+/// Formats the dates displayed in lists, such as the post, comment, notification,
+/// and Reader lists, which format the same dates on every reload.
+///
+/// The formatters are created once per time zone and never changed afterwards.
+/// The formatted strings are memoized until the next minute, when the relative
+/// dates (e.g. "5 minutes ago") may change. The dates less than a minute away
+/// aren't memoized, since they change every second.
+///
+/// It can be used from any thread.
+final class MemoizedDateFormatter {
+    static let shared = MemoizedDateFormatter()
+
+    /// The maximum number of strings memoized within a minute.
+    static let memoCountLimit = 2_000
+
+    private enum Style: Hashable {
+        case medium
+        case mediumWithTime
+    }
+
+    private struct Key: Hashable {
+        let style: Style
+        let date: Date
+        let timeZone: TimeZone
+    }
+
+    private let locale: Locale?
+    private let calendar: Calendar?
+
+    private let lock = NSLock()
+    private let relativeFormatter: RelativeDateTimeFormatter
+    private var formatters: [Style: [TimeZone: DateFormatter]] = [:]
+    private var memo: [Key: String] = [:]
+    private var memoMinute: Double = -.infinity
+    private var _formattedCount = 0
+
+    /// The number of strings formatted rather than served from the memo.
+    var formattedCount: Int {
+        lock.withLock { _formattedCount }
+    }
+
+    /// - Parameters:
+    ///   - locale: The locale of the formatted dates. If `nil`, the current locale is used.
+    ///   - calendar: The calendar used to tell how many days away a date is. If `nil`, the
+    ///     current calendar is used.
+    init(locale: Locale? = nil, calendar: Calendar? = nil) {
+        self.locale = locale
+        self.calendar = calendar
+
+        relativeFormatter = RelativeDateTimeFormatter()
+        relativeFormatter.dateTimeStyle = .named
+        if let locale {
+            relativeFormatter.locale = locale
+        }
+    }
+
+    /// Formats the date as a relative date if it's within a week of `now`, or with
+    /// `DateFormatter.Style.medium` otherwise.
+    ///
+    /// - Parameter timeZone: The time zone of the absolute dates. If `nil`, the current time zone is used.
+    func mediumString(from date: Date, timeZone: TimeZone? = nil, now: Date = Date()) -> String {
+        string(from: date, style: .medium, timeZone: timeZone, now: now) { formatter in
+            let calendar = self.calendar ?? Calendar.current
+            if let days = calendar.dateComponents([.day], from: date, to: now).day, abs(days) < 7 {
+                return relativeFormatter.localizedString(fromTimeInterval: date.timeIntervalSince(now))
+            }
+            return formatter.string(from: date)
+        }
+    }
+
+    /// Formats the date as a medium relative date/time, e.g. "Today, 8:09 AM".
+    ///
+    /// - Parameter timeZone: The time zone of the dates. If `nil`, the current time zone is used.
+    func mediumStringWithTime(from date: Date, timeZone: TimeZone? = nil, now: Date = Date()) -> String {
+        string(from: date, style: .mediumWithTime, timeZone: timeZone, now: now) { formatter in
+            formatter.string(from: date)
+        }
+    }
+
+    private func string(from date: Date, style: Style, timeZone: TimeZone?, now: Date, format: (DateFormatter) -> String) -> String {
+        lock.lock()
+        defer { lock.unlock() }
+
+        let timeZone = timeZone ?? TimeZone.current
+        let key = Key(style: style, date: date, timeZone: timeZone)
+        let isMemoized = abs(date.timeIntervalSince(now)) >= 60
+
+        if isMemoized {
+            let minute = (now.timeIntervalSinceReferenceDate / 60).rounded(.down)
+            if minute != memoMinute || memo.count >= Self.memoCountLimit {
+                memo.removeAll(keepingCapacity: true)
+                memoMinute = minute
+            }
+            if let string = memo[key] {
+                return string
+            }
+        }
+
+        let string = format(formatter(style: style, timeZone: timeZone))
+        _formattedCount += 1
+        if isMemoized {
+            memo[key] = string
+        }
+        return string
+    }
+
+    /// - warning: Must be called with the lock held.
+    private func formatter(style: Style, timeZone: TimeZone) -> DateFormatter {
+        if let formatter = formatters[style]?[timeZone] {
+            return formatter
+        }
+
+        let formatter = DateFormatter()
+        if let locale {
+            formatter.locale = locale
+        }
+        formatter.timeZone = timeZone
+        switch style {
+        case .medium:
+            formatter.dateStyle = .medium
+            formatter.timeStyle = .none
+        case .mediumWithTime:
+            formatter.doesRelativeDateFormatting = true
+            formatter.dateStyle = .medium
+            formatter.timeStyle = .short
+        }
+        formatters[style, default: [:]][timeZone] = formatter
+        return formatter
+    }
+}
@@ -28,21 +28,6 @@ extension Date {
             return formatter
         }()
 
-        static let mediumDate: DateFormatter = {
-            let formatter = DateFormatter()
-            formatter.dateStyle = .medium
-            formatter.timeStyle = .none
-            return formatter
-        }()
-
-        static let mediumDateTime: DateFormatter = {
-            let formatter = DateFormatter()
-            formatter.doesRelativeDateFormatting = true
-            formatter.dateStyle = .medium
-            formatter.timeStyle = .short
-            return formatter
-        }()
-
         static let mediumUTCDateTime: DateFormatter = {
             let formatter = DateFormatter()
             formatter.dateStyle = .medium
@@ -122,21 +107,7 @@ extension Date {
     /// - Example: Jan 22, 2017
     ///
     public func toMediumString(inTimeZone timeZone: TimeZone? = nil) -> String {
-        let relativeFormatter = RelativeDateTimeFormatter()
-        relativeFormatter.dateTimeStyle = .named
-
-        let absoluteFormatter = DateFormatters.mediumDate
-
-        if let timeZone {
-            absoluteFormatter.timeZone = timeZone
-        }
-
-        let components = Calendar.current.dateComponents([.day], from: self, to: Date())
-        if let days = components.day, abs(days) < 7 {
-            return relativeFormatter.localizedString(fromTimeInterval: timeIntervalSinceNow)
-        } else {
-            return absoluteFormatter.string(from: self)
-        }
+        MemoizedDateFormatter.shared.mediumString(from: self, timeZone: timeZone)
     }
 
     /// Formats the current date as a medium relative date/time.
@@ -144,11 +115,7 @@ extension Date {
     ///
     /// - Parameter timeZone: An optional time zone used to adjust the date formatters.
     public func mediumStringWithTime(timeZone: TimeZone? = nil) -> String {
-        let formatter = DateFormatters.mediumDateTime
-        if let timeZone {
-            formatter.timeZone = timeZone
-        }
-        return formatter.string(from: self)
+        MemoizedDateFormatter.shared.mediumStringWithTime(from: self, timeZone: timeZone)
     }
 
     /// Formats the current date as (non relative) long date (no time) in UTC.
@@ -0,0 +1,41 @@
+import Foundation
+
+/// A thread-safe cache of compiled regular expressions, keyed by pattern and options.
+///
+/// The `String` helpers are mostly used with a handful of constant patterns and short
+/// strings, for which compiling the pattern costs more than matching it.
+final class RegularExpressionCache {
+    static let shared = RegularExpressionCache(countLimit: 128)
+
+    private let cache = NSCache<NSString, NSRegularExpression>()
+
+    /// - Parameter countLimit: The maximum number of regular expressions kept in the cache.
+    init(countLimit: Int) {
+        cache.countLimit = countLimit
+    }
+
+    /// Returns the compiled regular expression for the pattern, compiling it if needed.
+    ///
+    /// - Throws: an error if the pattern is not a valid regular expression.
+    func regularExpression(pattern: String, options: NSRegularExpression.Options = []) throws -> NSRegularExpression {
+        let key = "\(options.rawValue):\(pattern)" as NSString
+        if let regex = cache.object(forKey: key) {
+            return regex
+        }
+        let regex = try NSRegularExpression(pattern: pattern, options: options)
+        cache.setObject(regex, forKey: key)
+        return regex
+    }
+}
+
+extension NSRegularExpression {
+    /// Returns the literal text matched by the pattern, if the pattern only matches that text
+    /// as is: it has no metacharacters, and no option changes how it's matched.
+    static func literalText(ofPattern pattern: String, options: NSRegularExpression.Options) -> String? {
+        guard options.isDisjoint(with: [.caseInsensitive, .allowCommentsAndWhitespace, .ignoreMetacharacters, .anchorsMatchLines]) else {
+            return nil
+        }
+        let metacharacters: Set<Character> = ["\\", "^", "$", ".", "|", "?", "*", "+", "(", ")", "[", "]", "{", "}"]
+        return pattern.contains(where: metacharacters.contains) ? nil : pattern
+    }
+}
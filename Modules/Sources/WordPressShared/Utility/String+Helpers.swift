@@ -91,7 +91,14 @@ public extension String {
     /// - Throws: an error if it the pattern is not a valid regular expression.
     ///
     mutating func removePrefix(pattern: String, options: NSRegularExpression.Options = []) throws {
-        let regexp = try NSRegularExpression(pattern: "^\(pattern)", options: options)
+        if let literal = NSRegularExpression.literalText(ofPattern: pattern, options: options) {
+            // Compared by UTF-16 code units, like the regular expression would.
+            if (self as NSString).hasPrefix(literal) {
+                self = (self as NSString).substring(from: (literal as NSString).length)
+            }
+            return
+        }
+        let regexp = try RegularExpressionCache.shared.regularExpression(pattern: "^\(pattern)", options: options)
         let fullRange = NSRange(location: 0, length: (self as NSString).length)
         if let match = regexp.firstMatch(in: self, options: [], range: fullRange) {
             let matchRange = match.range
@@ -152,7 +159,18 @@ public extension String {
     /// - Throws: an error if it the pattern is not a valid regular expression.
     ///
     mutating func removeSuffix(pattern: String, options: NSRegularExpression.Options = []) throws {
-        let regexp = try NSRegularExpression(pattern: "\(pattern)$", options: options)
+        // `$` also matches before a line terminator at the end of the string, which is left to
+        // the regular expression.
+        if let literal = NSRegularExpression.literalText(ofPattern: pattern, options: options),
+           last.map({ !$0.isNewline }) ?? true {
+            // Compared by UTF-16 code units, like the regular expression would.
+            if (self as NSString).hasSuffix(literal) {
+                let string = self as NSString
+                self = string.substring(to: string.length - (literal as NSString).length)
+            }
+            return
+        }
+        let regexp = try RegularExpressionCache.shared.regularExpression(pattern: "\(pattern)$", options: options)
         let fullRange = NSRange(location: 0, length: (self as NSString).length)
         if let match = regexp.firstMatch(in: self, options: [], range: fullRange) {
             let matchRange = match.range
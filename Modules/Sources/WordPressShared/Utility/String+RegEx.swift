@@ -15,7 +15,7 @@ extension String {
     ///
     public func replacingMatches(of regex: String, options: NSRegularExpression.Options = [], using block: (String, [String]) -> String) -> String {
 
-        let regex = try! NSRegularExpression(pattern: regex, options: options)
+        let regex = try! RegularExpressionCache.shared.regularExpression(pattern: regex, options: options)
         let fullRange = NSRange(location: 0, length: count)
         let matches = regex.matches(in: self, options: [], range: fullRange)
         var newString = self
@@ -48,7 +48,7 @@ extension String {
     /// - Returns: the requested matches.
     ///
     public func matches(regex: String, options: NSRegularExpression.Options = []) -> [NSTextCheckingResult] {
-        let regex = try! NSRegularExpression(pattern: regex, options: options)
+        let regex = try! RegularExpressionCache.shared.regularExpression(pattern: regex, options: options)
         let fullRange = NSRange(location: 0, length: count)
 
         return regex.matches(in: self, options: [], range: fullRange)
@@ -65,7 +65,7 @@ extension String {
     ///
     public func replacingMatches(of regex: String, with template: String, options: NSRegularExpression.Options = []) -> String {
 
-        let regex = try! NSRegularExpression(pattern: regex, options: options)
+        let regex = try! RegularExpressionCache.shared.regularExpression(pattern: regex, options: options)
         let fullRange = NSRange(location: 0, length: count)
 
         return regex.stringByReplacingMatches(in: self,
@@ -1,117 +1,119 @@
 #import "WPAnalytics.h"
+#import "WPAnalyticsDispatcher.h"
+#import <os/lock.h>
 
 NSString *const WPAnalyticsStatEditorPublishedPostPropertyCategory = @"with_categories";
 NSString *const WPAnalyticsStatEditorPublishedPostPropertyPhoto = @"with_photos";
 NSString *const WPAnalyticsStatEditorPublishedPostPropertyTag = @"with_tags";
 NSString *const WPAnalyticsStatEditorPublishedPostPropertyVideo = @"with_videos";
 
+static NSUInteger const WPAnalyticsDispatcherCapacity = 1024;
+
+static os_unfair_lock WPAnalyticsTrackersLock = OS_UNFAIR_LOCK_INIT;
+static NSArray<id<WPAnalyticsTracker>> *WPAnalyticsRegisteredTrackers = nil;
+
 @implementation WPAnalytics
 
-+ (NSMutableArray *)trackers
+/// Returns the immutable snapshot of the registered trackers.
+///
+/// Every event captures the snapshot when it's tracked, so registering or
+/// removing trackers never affects the events that are already enqueued.
++ (NSArray<id<WPAnalyticsTracker>> *)trackers
 {
-    static NSMutableArray *trackers = nil;
-    
+    os_unfair_lock_lock(&WPAnalyticsTrackersLock);
+    NSArray *trackers = WPAnalyticsRegisteredTrackers ?: @[];
+    os_unfair_lock_unlock(&WPAnalyticsTrackersLock);
+    return trackers;
+}
+
++ (WPAnalyticsDispatcher *)dispatcher
+{
+    static WPAnalyticsDispatcher *dispatcher = nil;
+
     static dispatch_once_t predicate;
     dispatch_once(&predicate, ^{
-        trackers = [[NSMutableArray alloc] init];
+        dispatcher = [[WPAnalyticsDispatcher alloc] initWithCapacity:WPAnalyticsDispatcherCapacity];
     });
 
-    return trackers;
+    return dispatcher;
 }
 
 + (void)registerTracker:(id<WPAnalyticsTracker>)tracker
 {
     NSParameterAssert(tracker != nil);
-    [[self trackers] addObject:tracker];
+    os_unfair_lock_lock(&WPAnalyticsTrackersLock);
+    WPAnalyticsRegisteredTrackers = [(WPAnalyticsRegisteredTrackers ?: @[]) arrayByAddingObject:tracker];
+    os_unfair_lock_unlock(&WPAnalyticsTrackersLock);
 }
 
 + (void)clearTrackers
 {
-    [[self trackers] removeAllObjects];
+    // Make sure the trackers receive the events tracked before they are removed.
+    [self flush];
+
+    os_unfair_lock_lock(&WPAnalyticsTrackersLock);
+    WPAnalyticsRegisteredTrackers = nil;
+    os_unfair_lock_unlock(&WPAnalyticsTrackersLock);
+}
+
++ (void)flush
+{
+    [[self dispatcher] flush];
 }
 
 + (void)beginTimerForStat:(WPAnalyticsStat)stat
 {
-    for (id<WPAnalyticsTracker> tracker in [self trackers]) {
-        if ([tracker respondsToSelector:@selector(beginTimerForStat:)]) {
-            [tracker beginTimerForStat:stat];
-        }
-    }
+    [[self dispatcher] enqueueKind:WPAnalyticsDispatchKindBeginTimer stat:stat event:nil properties:nil trackers:[self trackers]];
 }
 
 + (void)endTimerForStat:(WPAnalyticsStat)stat withProperties:(NSDictionary *)properties
 {
-    for (id<WPAnalyticsTracker> tracker in [self trackers]) {
-        if ([tracker respondsToSelector:@selector(endTimerForStat:withProperties:)]) {
-            [tracker endTimerForStat:stat withProperties:properties];
-        }
-    }
+    [[self dispatcher] enqueueKind:WPAnalyticsDispatchKindEndTimer stat:stat event:nil properties:properties trackers:[self trackers]];
 }
 
 + (void)track:(WPAnalyticsStat)stat
 {
-    for (id<WPAnalyticsTracker> tracker in [self trackers]) {
-        [tracker track:stat];
-    }
+    [[self dispatcher] enqueueKind:WPAnalyticsDispatchKindStat stat:stat event:nil properties:nil trackers:[self trackers]];
 }
 
 + (void)track:(WPAnalyticsStat)stat withProperties:(NSDictionary *)properties
 {
     NSParameterAssert(properties != nil);
-    for (id<WPAnalyticsTracker> tracker in [self trackers]) {
-        [tracker track:stat withProperties:properties];
-    }
+    [[self dispatcher] enqueueKind:WPAnalyticsDispatchKindStatWithProperties stat:stat event:nil properties:properties trackers:[self trackers]];
 }
 
 + (void)trackString:(NSString *)event
 {
-    for (id<WPAnalyticsTracker> tracker in [self trackers]) {
-        [tracker trackString:event];
-    }
+    [[self dispatcher] enqueueKind:WPAnalyticsDispatchKindString stat:WPAnalyticsStatNoStat event:event properties:nil trackers:[self trackers]];
 }
 
 + (void)trackString:(NSString *)event withProperties:(NSDictionary *)properties
 {
     NSParameterAssert(properties != nil);
-    for (id<WPAnalyticsTracker> tracker in [self trackers]) {
-        [tracker trackString:event withProperties:properties];
-    }
+    [[self dispatcher] enqueueKind:WPAnalyticsDispatchKindStringWithProperties stat:WPAnalyticsStatNoStat event:event properties:properties trackers:[self trackers]];
 }
 
+// The session methods go through the dispatcher like the events, so that
+// the trackers are only ever called on its queue and in order.
+
 + (void)beginSession
 {
-    for (id<WPAnalyticsTracker> tracker in [self trackers]) {
-        if ([tracker respondsToSelector:@selector(beginSession)]) {
-            [tracker beginSession];
-        }
-    }
+    [[self dispatcher] enqueueKind:WPAnalyticsDispatchKindBeginSession stat:WPAnalyticsStatNoStat event:nil properties:nil trackers:[self trackers]];
 }
 
 + (void)endSession
 {
-    for (id<WPAnalyticsTracker> tracker in [self trackers]) {
-        if ([tracker respondsToSelector:@selector(endSession)]) {
-            [tracker endSession];
-        }
-    }
+    [[self dispatcher] enqueueKind:WPAnalyticsDispatchKindEndSession stat:WPAnalyticsStatNoStat event:nil properties:nil trackers:[self trackers]];
 }
 
 + (void)refreshMetadata
 {
-    for (id<WPAnalyticsTracker> tracker in [self trackers]) {
-        if ([tracker respondsToSelector:@selector(refreshMetadata)]) {
-            [tracker refreshMetadata];
-        }
-    }
+    [[self dispatcher] enqueueKind:WPAnalyticsDispatchKindRefreshMetadata stat:WPAnalyticsStatNoStat event:nil properties:nil trackers:[self trackers]];
 }
 
 + (void)clearQueuedEvents
 {
-    for (id<WPAnalyticsTracker>tracker in [self trackers]) {
-        if ([tracker respondsToSelector:@selector(clearQueuedEvents)]) {
-            [tracker clearQueuedEvents];
-        }
-    }
+    [[self dispatcher] enqueueKind:WPAnalyticsDispatchKindClearQueuedEvents stat:WPAnalyticsStatNoStat event:nil properties:nil trackers:[self trackers]];
 }
 
 @end
@@ -0,0 +1,46 @@
+#import <Foundation/Foundation.h>
+#import "WPAnalytics.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSUInteger, WPAnalyticsDispatchKind) {
+    WPAnalyticsDispatchKindStat,
+    WPAnalyticsDispatchKindStatWithProperties,
+    WPAnalyticsDispatchKindString,
+    WPAnalyticsDispatchKindStringWithProperties,
+    WPAnalyticsDispatchKindBeginTimer,
+    WPAnalyticsDispatchKindEndTimer,
+    WPAnalyticsDispatchKindBeginSession,
+    WPAnalyticsDispatchKindEndSession,
+    WPAnalyticsDispatchKindRefreshMetadata,
+    WPAnalyticsDispatchKindClearQueuedEvents,
+};
+
+/// Delivers analytics events to the trackers on a serial background queue.
+///
+/// The events are written into a fixed-size lock-free ring buffer, so
+/// `track` calls only pay for a few atomic operations and retains. The
+/// events are delivered in the order in which they were enqueued, and
+/// no events are dropped: when the buffer is full, the events are submitted
+/// to the queue as blocks until it catches up, so the callers never wait.
+@interface WPAnalyticsDispatcher : NSObject
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+- (void)enqueueKind:(WPAnalyticsDispatchKind)kind
+               stat:(WPAnalyticsStat)stat
+              event:(nullable NSString *)event
+         properties:(nullable NSDictionary *)properties
+           trackers:(NSArray<id<WPAnalyticsTracker>> *)trackers;
+
+/// Blocks the current thread until all the events enqueued so far are
+/// delivered to the trackers. Does nothing when called from a tracker.
+///
+/// The trackers must not wait for the calling thread while handling the
+/// events, or the two would deadlock.
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,237 @@
+#import "WPAnalyticsDispatcher.h"
+#import <stdatomic.h>
+
+/// A slot in the ring buffer. The object references are retained manually
+/// to keep the slots in a plain C array allocated once.
+typedef struct {
+    _Atomic(NSUInteger) sequence;
+    WPAnalyticsDispatchKind kind;
+    WPAnalyticsStat stat;
+    void *event;
+    void *properties;
+    void *trackers;
+} WPAnalyticsDispatchCell;
+
+static void *WPAnalyticsDispatchQueueKey = &WPAnalyticsDispatchQueueKey;
+
+@implementation WPAnalyticsDispatcher {
+    WPAnalyticsDispatchCell *_cells;
+    NSUInteger _mask;
+    _Atomic(NSUInteger) _enqueuePosition;
+    NSUInteger _dequeuePosition; // Accessed only on `_queue`
+    atomic_bool _isDrainScheduled;
+    _Atomic(NSUInteger) _overflowCount; // The events submitted as blocks and not delivered yet
+    dispatch_queue_t _queue;
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+    NSParameterAssert(capacity > 1);
+    self = [super init];
+    if (self) {
+        // Round up to the power of two to use a mask instead of a modulo.
+        NSUInteger size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _mask = size - 1;
+        _cells = calloc(size, sizeof(WPAnalyticsDispatchCell));
+        for (NSUInteger index = 0; index < size; index++) {
+            atomic_init(&_cells[index].sequence, index);
+        }
+        atomic_init(&_enqueuePosition, 0);
+        atomic_init(&_isDrainScheduled, false);
+        atomic_init(&_overflowCount, 0);
+        _dequeuePosition = 0;
+
+        dispatch_queue_attr_t attributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+        _queue = dispatch_queue_create("org.wordpress.analytics.dispatch", attributes);
+        dispatch_queue_set_specific(_queue, WPAnalyticsDispatchQueueKey, WPAnalyticsDispatchQueueKey, NULL);
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    for (NSUInteger index = 0; index <= _mask; index++) {
+        WPAnalyticsDispatchCell *cell = &_cells[index];
+        if (cell->event) { CFRelease(cell->event); }
+        if (cell->properties) { CFRelease(cell->properties); }
+        if (cell->trackers) { CFRelease(cell->trackers); }
+    }
+    free(_cells);
+}
+
+#pragma mark - Producer
+
+- (void)enqueueKind:(WPAnalyticsDispatchKind)kind
+               stat:(WPAnalyticsStat)stat
+              event:(NSString *)event
+         properties:(NSDictionary *)properties
+           trackers:(NSArray<id<WPAnalyticsTracker>> *)trackers
+{
+    if (trackers.count == 0) {
+        return;
+    }
+    // The callers may mutate the dictionary after the call returns.
+    properties = [properties copy];
+
+    if ([self isOnDispatchQueue]) {
+        // A tracker sends an event: deliver it right away to avoid waiting
+        // for the queue the tracker is running on.
+        [self deliverKind:kind stat:stat event:event properties:properties trackers:trackers];
+        return;
+    }
+
+    // Once the buffer overflows, the following events are submitted as
+    // blocks too until the queue catches up, to keep them in order.
+    if (atomic_load(&_overflowCount) > 0 ||
+        ![self tryEnqueueKind:kind stat:stat event:event properties:properties trackers:trackers]) {
+        atomic_fetch_add(&_overflowCount, 1);
+        dispatch_async(_queue, ^{
+            [self drain];
+            [self deliverKind:kind stat:stat event:event properties:properties trackers:trackers];
+            atomic_fetch_sub(&self->_overflowCount, 1);
+        });
+        return;
+    }
+
+    if (!atomic_exchange(&_isDrainScheduled, true)) {
+        dispatch_async(_queue, ^{
+            [self drain];
+        });
+    }
+}
+
+- (BOOL)tryEnqueueKind:(WPAnalyticsDispatchKind)kind
+                  stat:(WPAnalyticsStat)stat
+                 event:(NSString *)event
+            properties:(NSDictionary *)properties
+              trackers:(NSArray *)trackers
+{
+    NSUInteger position = atomic_load_explicit(&_enqueuePosition, memory_order_relaxed);
+    for (;;) {
+        WPAnalyticsDispatchCell *cell = &_cells[position & _mask];
+        NSUInteger sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&_enqueuePosition, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+                cell->kind = kind;
+                cell->stat = stat;
+                cell->event = event ? (void *)CFBridgingRetain(event) : NULL;
+                cell->properties = properties ? (void *)CFBridgingRetain(properties) : NULL;
+                cell->trackers = (void *)CFBridgingRetain(trackers);
+                atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+                return YES;
+            }
+            // Another producer claimed the slot; `position` is reloaded by the failed exchange.
+        } else if (difference < 0) {
+            return NO; // The buffer is full
+        } else {
+            position = atomic_load_explicit(&_enqueuePosition, memory_order_relaxed);
+        }
+    }
+}
+
+- (void)flush
+{
+    if ([self isOnDispatchQueue]) {
+        return;
+    }
+    dispatch_sync(_queue, ^{
+        [self drain];
+    });
+}
+
+#pragma mark - Consumer
+
+- (void)drain
+{
+    // Reset the flag before reading the buffer so that the events enqueued
+    // after the last read schedule a new drain.
+    atomic_store(&_isDrainScheduled, false);
+
+    for (;;) {
+        WPAnalyticsDispatchCell *cell = &_cells[_dequeuePosition & _mask];
+        NSUInteger sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        if (sequence != _dequeuePosition + 1) {
+            return; // Empty, or the next event is still being written
+        }
+
+        WPAnalyticsDispatchKind kind = cell->kind;
+        WPAnalyticsStat stat = cell->stat;
+        NSString *event = cell->event ? CFBridgingRelease(cell->event) : nil;
+        NSDictionary *properties = cell->properties ? CFBridgingRelease(cell->properties) : nil;
+        NSArray *trackers = CFBridgingRelease(cell->trackers);
+        cell->event = NULL;
+        cell->properties = NULL;
+        cell->trackers = NULL;
+        atomic_store_explicit(&cell->sequence, _dequeuePosition + _mask + 1, memory_order_release);
+        _dequeuePosition += 1;
+
+        @autoreleasepool {
+            [self deliverKind:kind stat:stat event:event properties:properties trackers:trackers];
+        }
+    }
+}
+
+- (void)deliverKind:(WPAnalyticsDispatchKind)kind
+               stat:(WPAnalyticsStat)stat
+              event:(NSString *)event
+         properties:(NSDictionary *)properties
+           trackers:(NSArray<id<WPAnalyticsTracker>> *)trackers
+{
+    for (id<WPAnalyticsTracker> tracker in trackers) {
+        switch (kind) {
+            case WPAnalyticsDispatchKindStat:
+                [tracker track:stat];
+                break;
+            case WPAnalyticsDispatchKindStatWithProperties:
+                [tracker track:stat withProperties:properties];
+                break;
+            case WPAnalyticsDispatchKindString:
+                [tracker trackString:event];
+                break;
+            case WPAnalyticsDispatchKindStringWithProperties:
+                [tracker trackString:event withProperties:properties];
+                break;
+            case WPAnalyticsDispatchKindBeginTimer:
+                if ([tracker respondsToSelector:@selector(beginTimerForStat:)]) {
+                    [tracker beginTimerForStat:stat];
+                }
+                break;
+            case WPAnalyticsDispatchKindEndTimer:
+                if ([tracker respondsToSelector:@selector(endTimerForStat:withProperties:)]) {
+                    [tracker endTimerForStat:stat withProperties:properties];
+                }
+                break;
+            case WPAnalyticsDispatchKindBeginSession:
+                if ([tracker respondsToSelector:@selector(beginSession)]) {
+                    [tracker beginSession];
+                }
+                break;
+            case WPAnalyticsDispatchKindEndSession:
+                if ([tracker respondsToSelector:@selector(endSession)]) {
+                    [tracker endSession];
+                }
+                break;
+            case WPAnalyticsDispatchKindRefreshMetadata:
+                if ([tracker respondsToSelector:@selector(refreshMetadata)]) {
+                    [tracker refreshMetadata];
+                }
+                break;
+            case WPAnalyticsDispatchKindClearQueuedEvents:
+                if ([tracker respondsToSelector:@selector(clearQueuedEvents)]) {
+                    [tracker clearQueuedEvents];
+                }
+                break;
+        }
+    }
+}
+
+- (BOOL)isOnDispatchQueue
+{
+    return dispatch_get_specific(WPAnalyticsDispatchQueueKey) == WPAnalyticsDispatchQueueKey;
+}
+
+@end
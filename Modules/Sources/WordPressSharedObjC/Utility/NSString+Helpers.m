@@ -4,6 +4,391 @@
 
 static NSString *const Ellipsis =  @"\u2026";
 
+#pragma mark - Emoticons
+
+/// What the emoticon scan found in a string.
+typedef NS_OPTIONS(NSUInteger, EmoticonMarkers) {
+    EmoticonMarkerImageTag = 1 << 0,
+    EmoticonMarkerSmilies = 1 << 1,
+    EmoticonMarkerWPComSmileys = 1 << 2,
+    EmoticonMarkerCoreEmoji = 1 << 3,
+};
+
+typedef struct {
+    const unichar *characters;
+    NSUInteger length;
+} EmoticonText;
+
+typedef struct {
+    unichar *characters;
+    NSUInteger length;
+    NSUInteger capacity;
+} EmoticonBuffer;
+
+/// Matches the remainder of a tag after its image path, and returns the end of the tag.
+typedef NSUInteger (*EmoticonTailMatcher)(EmoticonText text, NSUInteger location, NSRange *icon);
+
+/**
+ An image tag replaced by an emoji, matched exactly like the regular expression
+ `<img[^>]*?src=['"][^>]*?<path><tail>`, case insensitively.
+ */
+typedef struct {
+    EmoticonMarkers marker;
+    const char *path;
+    EmoticonTailMatcher matchTail;
+} EmoticonPattern;
+
+static const char *const EmoticonImageTag = "<img";
+
+/// Folds the characters that match the ASCII letters of the patterns case insensitively.
+static inline unichar EmoticonFold(unichar character)
+{
+    if (character >= 'A' && character <= 'Z') {
+        return character + ('a' - 'A');
+    }
+    if (character == 0x017F) { // LATIN SMALL LETTER LONG S
+        return 's';
+    }
+    if (character == 0x212A) { // KELVIN SIGN
+        return 'k';
+    }
+    return character;
+}
+
+/// The characters `.` doesn't match.
+static inline BOOL EmoticonIsLineTerminator(unichar character)
+{
+    return (character >= 0x0A && character <= 0x0D) || character == 0x85 || character == 0x2028 || character == 0x2029;
+}
+
+static inline BOOL EmoticonIsQuote(unichar character)
+{
+    return character == '\'' || character == '"';
+}
+
+/// The index after the character at `location`, keeping surrogate pairs together like `.` does.
+static inline NSUInteger EmoticonNextIndex(EmoticonText text, NSUInteger location)
+{
+    if (CFStringIsSurrogateHighCharacter(text.characters[location]) && location + 1 < text.length && CFStringIsSurrogateLowCharacter(text.characters[location + 1])) {
+        return location + 2;
+    }
+    return location + 1;
+}
+
+/// Whether the lowercase ASCII `literal` is at `location`, ignoring case.
+static BOOL EmoticonMatchesLiteral(EmoticonText text, NSUInteger location, const char *literal)
+{
+    for (NSUInteger index = 0; literal[index] != '\0'; index++) {
+        if (location + index >= text.length || EmoticonFold(text.characters[location + index]) != (unichar)literal[index]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+/**
+ Matches `[^/]+/?>` at `location`: the tag ends at the `/>` found at the first `/`, or otherwise
+ at the last `>` before it.
+ */
+static NSUInteger EmoticonMatchTagEnd(EmoticonText text, NSUInteger location)
+{
+    NSUInteger slash = location;
+    while (slash < text.length && text.characters[slash] != '/') {
+        slash++;
+    }
+    if (slash > location && slash + 1 < text.length && text.characters[slash + 1] == '>') {
+        return slash + 2;
+    }
+    for (NSUInteger end = slash; end > location + 1; end--) {
+        if (text.characters[end - 1] == '>') {
+            return end;
+        }
+    }
+    return NSNotFound;
+}
+
+/**
+ Matches `(.+?).<extension>['"]` at `location` followed by the end of the tag, where the
+ extension is one of `extensions`. When `allowsQuery` is set, anything but a quote can follow
+ the extension, as in `(.+?)(?:.gif|.png)[^'"]*['"]`.
+ */
+static NSUInteger EmoticonMatchFilename(EmoticonText text, NSUInteger location, const char *const *extensions, NSUInteger extensionCount, BOOL allowsQuery, NSRange *icon)
+{
+    NSUInteger iconEnd = location;
+    while (iconEnd < text.length && !EmoticonIsLineTerminator(text.characters[iconEnd])) {
+        iconEnd = EmoticonNextIndex(text, iconEnd);
+        if (iconEnd >= text.length || EmoticonIsLineTerminator(text.characters[iconEnd])) {
+            continue;
+        }
+
+        // The `.` before the extension matches any character.
+        NSUInteger extension = EmoticonNextIndex(text, iconEnd);
+        BOOL matchesExtension = NO;
+        for (NSUInteger index = 0; index < extensionCount && !matchesExtension; index++) {
+            matchesExtension = EmoticonMatchesLiteral(text, extension, extensions[index]);
+        }
+        if (!matchesExtension) {
+            continue;
+        }
+
+        NSUInteger quote = extension + 3;
+        while (allowsQuery && quote < text.length && !EmoticonIsQuote(text.characters[quote])) {
+            quote++;
+        }
+        if (quote >= text.length || !EmoticonIsQuote(text.characters[quote])) {
+            continue;
+        }
+        NSUInteger end = EmoticonMatchTagEnd(text, quote + 1);
+        if (end != NSNotFound) {
+            *icon = NSMakeRange(location, iconEnd - location);
+            return end;
+        }
+    }
+    return NSNotFound;
+}
+
+/// `(.+?)(?:.gif|.png)[^'"]*['"][^//]+/?>`
+static NSUInteger EmoticonMatchSmiliesTail(EmoticonText text, NSUInteger location, NSRange *icon)
+{
+    static const char *const extensions[] = { "gif", "png" };
+    return EmoticonMatchFilename(text, location, extensions, 2, YES, icon);
+}
+
+/// `(.+?).svg['"][^//]+/?>`
+static NSUInteger EmoticonMatchWPComSmileysTail(EmoticonText text, NSUInteger location, NSRange *icon)
+{
+    static const char *const extensions[] = { "svg" };
+    return EmoticonMatchFilename(text, location, extensions, 1, NO, icon);
+}
+
+/// `[^/]+/.+?.png['"][^//]+/?>`
+static NSUInteger EmoticonMatchCoreEmojiTail(EmoticonText text, NSUInteger location, NSRange *icon)
+{
+    static const char *const extensions[] = { "png" };
+    NSUInteger slash = location;
+    while (slash < text.length && text.characters[slash] != '/') {
+        slash++;
+    }
+    if (slash == location || slash == text.length) {
+        return NSNotFound;
+    }
+    return EmoticonMatchFilename(text, slash + 1, extensions, 1, NO, icon);
+}
+
+static const EmoticonPattern EmoticonPatterns[] = {
+    { EmoticonMarkerSmilies, "wp-includes/images/smilies/", EmoticonMatchSmiliesTail },
+    { EmoticonMarkerWPComSmileys, "wp-content/mu-plugins/wpcom-smileys/", EmoticonMatchWPComSmileysTail },
+    { EmoticonMarkerCoreEmoji, "images/core/emoji/", EmoticonMatchCoreEmojiTail },
+};
+static const NSUInteger EmoticonPatternCount = sizeof(EmoticonPatterns) / sizeof(EmoticonPatterns[0]);
+
+/// Matches an image tag of the pattern at `location`, and returns the end of the tag.
+static NSUInteger EmoticonMatchImageTag(EmoticonText text, NSUInteger location, EmoticonPattern pattern, NSRange *icon)
+{
+    size_t pathLength = strlen(pattern.path);
+    // Both `[^>]*?` stop at the end of the first tag.
+    for (NSUInteger source = location + strlen(EmoticonImageTag); source < text.length; source++) {
+        if (EmoticonMatchesLiteral(text, source, "src=") && source + 4 < text.length && EmoticonIsQuote(text.characters[source + 4])) {
+            for (NSUInteger path = source + 5; path < text.length; path++) {
+                if (EmoticonMatchesLiteral(text, path, pattern.path)) {
+                    NSUInteger end = pattern.matchTail(text, path + pathLength, icon);
+                    if (end != NSNotFound) {
+                        return end;
+                    }
+                }
+                if (text.characters[path] == '>') {
+                    break;
+                }
+            }
+        }
+        if (text.characters[source] == '>') {
+            break;
+        }
+    }
+    return NSNotFound;
+}
+
+#pragma mark - Emoticon Scan
+
+/// The number of states of the automaton, which is at most one per character of the markers.
+enum { EmoticonAutomatonCapacity = 96 };
+
+/// An Aho–Corasick automaton over the image tag and the image paths, with every transition resolved.
+typedef struct {
+    uint8_t transitions[EmoticonAutomatonCapacity][128];
+    EmoticonMarkers markers[EmoticonAutomatonCapacity];
+} EmoticonAutomaton;
+
+static const EmoticonAutomaton *EmoticonSharedAutomaton(void)
+{
+    static EmoticonAutomaton automaton;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        // The trie of the markers, where the root is state 0.
+        NSUInteger stateCount = 1;
+        for (NSUInteger index = 0; index <= EmoticonPatternCount; index++) {
+            const char *marker = (index == 0) ? EmoticonImageTag : EmoticonPatterns[index - 1].path;
+            uint8_t state = 0;
+            for (const char *character = marker; *character != '\0'; character++) {
+                uint8_t *next = &automaton.transitions[state][(uint8_t)*character];
+                if (*next == 0) {
+                    NSCAssert(stateCount < EmoticonAutomatonCapacity, @"Too many emoticon markers");
+                    *next = (uint8_t)stateCount++;
+                }
+                state = *next;
+            }
+            automaton.markers[state] |= (index == 0) ? EmoticonMarkerImageTag : EmoticonPatterns[index - 1].marker;
+        }
+
+        // Breadth-first, so that the failure of a state is resolved before the state.
+        uint8_t failures[EmoticonAutomatonCapacity] = { 0 };
+        uint8_t queue[EmoticonAutomatonCapacity];
+        NSUInteger head = 0;
+        NSUInteger tail = 0;
+        for (NSUInteger character = 0; character < 128; character++) {
+            if (automaton.transitions[0][character] != 0) {
+                queue[tail++] = automaton.transitions[0][character];
+            }
+        }
+        while (head < tail) {
+            uint8_t state = queue[head++];
+            automaton.markers[state] |= automaton.markers[failures[state]];
+            for (NSUInteger character = 0; character < 128; character++) {
+                uint8_t next = automaton.transitions[state][character];
+                uint8_t failureNext = automaton.transitions[failures[state]][character];
+                if (next != 0) {
+                    failures[next] = failureNext;
+                    queue[tail++] = next;
+                } else {
+                    automaton.transitions[state][character] = failureNext;
+                }
+            }
+        }
+    });
+    return &automaton;
+}
+
+/// Finds which markers are in the text, with a single pass.
+static EmoticonMarkers EmoticonScanMarkers(EmoticonText text)
+{
+    const EmoticonAutomaton *automaton = EmoticonSharedAutomaton();
+    EmoticonMarkers markers = 0;
+    uint8_t state = 0;
+    for (NSUInteger index = 0; index < text.length; index++) {
+        unichar character = EmoticonFold(text.characters[index]);
+        state = character < 128 ? automaton->transitions[state][character] : 0;
+        markers |= automaton->markers[state];
+    }
+    return markers;
+}
+
+#pragma mark - Emoticon Replacement
+
+static EmoticonBuffer EmoticonBufferCreate(NSUInteger capacity)
+{
+    return (EmoticonBuffer){ malloc(MAX(capacity, 1) * sizeof(unichar)), 0, MAX(capacity, 1) };
+}
+
+/// The buffers start with the length of the text, which the replacements never grow.
+static void EmoticonBufferReserve(EmoticonBuffer *buffer, NSUInteger length)
+{
+    if (buffer->length + length > buffer->capacity) {
+        buffer->capacity = MAX(buffer->capacity * 2, buffer->length + length);
+        buffer->characters = reallocf(buffer->characters, buffer->capacity * sizeof(unichar));
+    }
+}
+
+static void EmoticonBufferAppend(EmoticonBuffer *buffer, const unichar *characters, NSUInteger length)
+{
+    EmoticonBufferReserve(buffer, length);
+    memcpy(buffer->characters + buffer->length, characters, length * sizeof(unichar));
+    buffer->length += length;
+}
+
+static void EmoticonBufferAppendString(EmoticonBuffer *buffer, NSString *string)
+{
+    NSUInteger length = [string length];
+    EmoticonBufferReserve(buffer, length);
+    [string getCharacters:buffer->characters + buffer->length range:NSMakeRange(0, length)];
+    buffer->length += length;
+}
+
+/**
+ Writes the text into the buffer, with the tags of the pattern replaced by the strings returned by
+ `replacement`. Returns whether any tag was replaced.
+ */
+static BOOL EmoticonReplaceMatches(EmoticonText text, EmoticonPattern pattern, EmoticonBuffer *buffer, NSString *(^replacement)(NSRange match, NSRange icon))
+{
+    buffer->length = 0;
+    BOOL replaced = NO;
+    NSUInteger copiedLocation = 0;
+    NSUInteger location = 0;
+    while (location < text.length) {
+        if (text.characters[location] != '<' || !EmoticonMatchesLiteral(text, location, EmoticonImageTag)) {
+            location++;
+            continue;
+        }
+        NSRange icon = NSMakeRange(NSNotFound, 0);
+        NSUInteger end = EmoticonMatchImageTag(text, location, pattern, &icon);
+        if (end == NSNotFound) {
+            location++;
+            continue;
+        }
+
+        NSRange match = NSMakeRange(location, end - location);
+        NSString *emoji = replacement(match, icon);
+        if (emoji) {
+            EmoticonBufferAppend(buffer, text.characters + copiedLocation, location - copiedLocation);
+            EmoticonBufferAppendString(buffer, emoji);
+            copiedLocation = end;
+            replaced = YES;
+        }
+        // Like the regular expressions, the next tag is looked for after the match.
+        location = end;
+    }
+    EmoticonBufferAppend(buffer, text.characters + copiedLocation, text.length - copiedLocation);
+    return replaced;
+}
+
+static NSDictionary *EmoticonReplacements(void)
+{
+    static NSDictionary *replacements;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        replacements = @{
+            @"icon_arrow": @"➡",
+            @"icon_biggrin": @"😃",
+            @"icon_confused": @"😕",
+            @"icon_cool": @"😎",
+            @"icon_cry": @"😭",
+            @"icon_eek": @"😮",
+            @"icon_evil": @"😈",
+            @"icon_exclaim": @"❗",
+            @"icon_idea": @"💡",
+            @"icon_lol": @"😄",
+            @"icon_mad": @"😠",
+            @"icon_mrgreen": @"🐸",
+            @"icon_neutral": @"😐",
+            @"icon_question": @"❓",
+            @"icon_razz": @"😛",
+            @"icon_redface": @"😊",
+            @"icon_rolleyes": @"😒",
+            @"icon_sad": @"😞",
+            @"icon_smile": @"😊",
+            @"icon_surprised": @"😮",
+            @"icon_twisted": @"👿",
+            @"icon_wink": @"😉",
+            // NOTE: There is not a perfect match for the following four with
+            // currently supported emoji. We'll try to get as close as we can.
+            @"frownie":@"😞",
+            @"mrgreen":@"😊",
+            @"rolleyes":@"😒",
+            @"simple-smile":@"😊"
+        };
+    });
+    return replacements;
+}
+
 @implementation NSString (Helpers)
 
 #pragma mark Helpers
@@ -110,85 +495,54 @@ static NSString *const Ellipsis =  @"\u2026";
 
 - (NSString *)stringByReplacingHTMLEmoticonsWithEmoji
 {
-    NSMutableString *result = [NSMutableString stringWithString:self];
-
-    NSDictionary *replacements = @{
-                                   @"icon_arrow": @"➡",
-                                   @"icon_biggrin": @"😃",
-                                   @"icon_confused": @"😕",
-                                   @"icon_cool": @"😎",
-                                   @"icon_cry": @"😭",
-                                   @"icon_eek": @"😮",
-                                   @"icon_evil": @"😈",
-                                   @"icon_exclaim": @"❗",
-                                   @"icon_idea": @"💡",
-                                   @"icon_lol": @"😄",
-                                   @"icon_mad": @"😠",
-                                   @"icon_mrgreen": @"🐸",
-                                   @"icon_neutral": @"😐",
-                                   @"icon_question": @"❓",
-                                   @"icon_razz": @"😛",
-                                   @"icon_redface": @"😊",
-                                   @"icon_rolleyes": @"😒",
-                                   @"icon_sad": @"😞",
-                                   @"icon_smile": @"😊",
-                                   @"icon_surprised": @"😮",
-                                   @"icon_twisted": @"👿",
-                                   @"icon_wink": @"😉",
-                                   // NOTE: There is not a perfect match for the following four with
-                                   // currently supported emoji. We'll try to get as close as we can.
-                                   @"frownie":@"😞",
-                                   @"mrgreen":@"😊",
-                                   @"rolleyes":@"😒",
-                                   @"simple-smile":@"😊"
-                                   };
-
-    static NSRegularExpression *smiliesRegex;
-    static NSRegularExpression *coreEmojiImgRegex;
-    static NSRegularExpression *wpcomSvgSmilies;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        NSError *error;
-        smiliesRegex = [NSRegularExpression regularExpressionWithPattern:@"<img[^>]*?src=['\"][^>]*?wp-includes/images/smilies/(.+?)(?:.gif|.png)[^'\"]*['\"][^//]+/?>" options:NSRegularExpressionCaseInsensitive error:&error];
-        coreEmojiImgRegex = [NSRegularExpression regularExpressionWithPattern:@"<img[^>]*?src=['\"][^>]*?images/core/emoji/[^/]+/.+?.png['\"][^//]+/?>" options:NSRegularExpressionCaseInsensitive error:&error];
-        wpcomSvgSmilies = [NSRegularExpression regularExpressionWithPattern:@"<img[^>]*?src=['\"][^>]*?wp-content/mu-plugins/wpcom-smileys/(.+?).svg['\"][^//]+/?>" options:NSRegularExpressionCaseInsensitive error:&error];
+    NSUInteger length = [self length];
+    if (length == 0) {
+        return [NSString stringWithString:self];
+    }
 
-    });
+    unichar *characters = malloc(length * sizeof(unichar));
+    [self getCharacters:characters range:NSMakeRange(0, length)];
+    EmoticonText source = { characters, length };
 
-    NSArray *matches = [smiliesRegex matchesInString:result options:0 range:NSMakeRange(0, [result length])];
-    for (NSTextCheckingResult *match in [matches reverseObjectEnumerator]) {
-        NSRange range = [match rangeAtIndex:1];
-        NSString *icon = [result substringWithRange:range];
-        NSString *replacement = [replacements objectForKey:icon];
-        if (replacement) {
-            [result replaceCharactersInRange:[match range] withString:replacement];
-        }
+    // Most content has no emoticons: a single scan finds out which patterns can match.
+    EmoticonMarkers markers = EmoticonScanMarkers(source);
+    if (!(markers & EmoticonMarkerImageTag) || markers == EmoticonMarkerImageTag) {
+        free(characters);
+        return [NSString stringWithString:self];
     }
 
-    matches = [wpcomSvgSmilies matchesInString:result options:0 range:NSMakeRange(0, [result length])];
-    for (NSTextCheckingResult *match in [matches reverseObjectEnumerator]) {
-        NSRange range = [match rangeAtIndex:1];
-        NSString *icon = [result substringWithRange:range];
-        NSString *replacement = [replacements objectForKey:icon];
-        if (replacement) {
-            [result replaceCharactersInRange:[match range] withString:replacement];
+    NSDictionary *replacements = EmoticonReplacements();
+    EmoticonBuffer buffer = { characters, length, length };
+    EmoticonBuffer destination = EmoticonBufferCreate(length);
+    for (NSUInteger index = 0; index < EmoticonPatternCount; index++) {
+        EmoticonPattern pattern = EmoticonPatterns[index];
+        if (!(markers & pattern.marker)) {
+            continue;
         }
-    }
 
-    matches = [coreEmojiImgRegex matchesInString:result options:0 range:NSMakeRange(0, [result length])];
-    for (NSTextCheckingResult *match in [matches reverseObjectEnumerator]) {
-        NSRange range = [match rangeAtIndex:0];
-        NSString *tag = [result substringWithRange:range];
-        NSString *replacement = [NSString emojiFromCoreEmojiImageTag:tag];
-        if (replacement) {
-            [result replaceCharactersInRange:[match range] withString:replacement];
+        source = (EmoticonText){ buffer.characters, buffer.length };
+        BOOL replaced = EmoticonReplaceMatches(source, pattern, &destination, ^NSString *(NSRange match, NSRange icon) {
+            if (pattern.marker == EmoticonMarkerCoreEmoji) {
+                NSString *tag = [[NSString alloc] initWithCharacters:source.characters + match.location length:match.length];
+                return [NSString emojiFromCoreEmojiImageTag:tag];
+            }
+            NSString *iconName = [[NSString alloc] initWithCharacters:source.characters + icon.location length:icon.length];
+            return [replacements objectForKey:iconName];
+        });
+
+        if (replaced) {
+            // The next patterns match the replaced content, like the regular expressions used to.
+            EmoticonBuffer replacedBuffer = destination;
+            destination = (EmoticonBuffer){ buffer.characters, 0, buffer.capacity };
+            buffer = replacedBuffer;
+            markers = EmoticonScanMarkers((EmoticonText){ buffer.characters, buffer.length });
         }
     }
+    free(destination.characters);
 
-    return [NSString stringWithString:result];
+    return [[NSString alloc] initWithCharactersNoCopy:buffer.characters length:buffer.length freeWhenDone:YES];
 }
 
-
 /*
  * Uses a RegEx to strip all HTML tags from a string and unencode entites
  */
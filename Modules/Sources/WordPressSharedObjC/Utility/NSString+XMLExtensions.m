@@ -396,5 +396,21 @@ static HTMLEscapeMap gAsciiHTMLEscapeMap[] = {
     return [NSString encodeXMLCharactersIn:self];
 }
 
++ (NSDictionary<NSString *, NSNumber *> *)xmlNamedCharacterReferences {
+    static NSDictionary *references;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSUInteger count = sizeof(gAsciiHTMLEscapeMap) / sizeof(HTMLEscapeMap);
+        NSMutableDictionary *dictionary = [NSMutableDictionary dictionaryWithCapacity:count];
+        for (NSUInteger i = 0; i < count; ++i) {
+            NSString *escapeSequence = gAsciiHTMLEscapeMap[i].escapeSequence;
+            NSString *name = [escapeSequence substringWithRange:NSMakeRange(1, escapeSequence.length - 2)];
+            dictionary[name] = @(gAsciiHTMLEscapeMap[i].uchar);
+        }
+        references = [dictionary copy];
+    });
+    return references;
+}
+
 
 @end
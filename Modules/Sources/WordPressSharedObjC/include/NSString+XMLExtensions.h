@@ -7,4 +7,8 @@
 - (NSString *)stringByDecodingXMLCharacters;
 - (NSString *)stringByEncodingXMLCharacters;
 
+/// The named character references decoded by `decodeXMLCharactersIn:`, keyed by
+/// name without the leading `&` and the trailing `;`.
+@property (class, nonatomic, readonly) NSDictionary<NSString *, NSNumber *> *xmlNamedCharacterReferences;
+
 @end
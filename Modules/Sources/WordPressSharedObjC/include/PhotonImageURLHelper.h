@@ -39,4 +39,50 @@
                  forceResize:(BOOL)forceResize
                 imageQuality:(NSUInteger)quality;
 
+/**
+ Create "photonized" URLs of the passed image URL at each of the passed sizes.
+ The image URL is only parsed once, so prefer this to repeated calls when an image is
+ displayed at several sizes.
+
+ @param sizes `CGSize` values with the desired "points" sizes of the photon images.
+ @param url The URL to the source image.
+ @param forceResize See `photonURLWithSize:forImageURL:forceResize:imageQuality:`.
+ @param quality An integer value 1 - 100. Passed values are constrained to this range.
+
+ @return The URLs to the photon service, in the order of `sizes`.
+ */
++ (NSArray<NSURL *> *)photonURLsWithSizes:(NSArray<NSValue *> *)sizes
+                              forImageURL:(NSURL *)url
+                              forceResize:(BOOL)forceResize
+                             imageQuality:(NSUInteger)quality;
+
+@end
+
+/**
+ Builds photon URLs for a single source image.
+
+ The source URL is parsed when the builder is created: each URL is then the precomputed
+ scheme-stripped host and path, followed by a query written into a buffer reused across calls.
+ A builder isn't thread-safe.
+ */
+@interface PhotonImageURLBuilder : NSObject
+
+/**
+ @param url The URL to the source image.
+ @param scale The scale multiplied to the "points" sizes, usually the scale of the screen.
+ */
+- (instancetype)initWithImageURL:(NSURL *)url scale:(CGFloat)scale NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ The photon URL of the source image at the passed "points" size.
+ See `+[PhotonImageURLHelper photonURLWithSize:forImageURL:forceResize:imageQuality:]`.
+ */
+- (NSURL *)URLWithSize:(CGSize)size forceResize:(BOOL)forceResize imageQuality:(NSUInteger)quality;
+
+/**
+ Inspects the host to see if it is a photon host, like `i0.wp.com`.
+ */
++ (BOOL)isPhotonHost:(NSString *)host;
+
 @end
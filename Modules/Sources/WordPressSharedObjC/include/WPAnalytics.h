@@ -605,10 +605,17 @@ extern NSString *const WPAnalyticsStatEditorPublishedPostPropertyTag;
 extern NSString *const WPAnalyticsStatEditorPublishedPostPropertyVideo;
 
 @protocol WPAnalyticsTracker;
+
+/// Dispatches the analytics events to the registered trackers.
+///
+/// The `track` and session methods return immediately: they are delivered
+/// to the trackers in order on a background serial queue. Use `flush` to
+/// wait until the events tracked so far are delivered.
 @interface WPAnalytics : NSObject
 
 + (void)registerTracker:(id<WPAnalyticsTracker>)tracker;
 + (void)clearTrackers;
++ (void)flush;
 + (void)beginSession;
 + (void)refreshMetadata;
 + (void)beginTimerForStat:(WPAnalyticsStat)stat;
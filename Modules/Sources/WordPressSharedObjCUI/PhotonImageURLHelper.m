@@ -1,11 +1,25 @@
 #import "PhotonImageURLHelper.h"
 
-@implementation PhotonImageURLHelper
-
 static const NSUInteger DefaultPhotonImageQuality = 80;
 static const NSInteger MaxPhotonImageQuality = 100;
 static const NSInteger MinPhotonImageQuality = 1;
 
+/// Fits the query of any reasonable size. Larger sizes grow the buffer.
+static const size_t PhotonQueryCapacity = 128;
+
+typedef NS_ENUM(NSUInteger, PhotonImageURLKind) {
+    /// Photon can't resize the image, the source URL is returned instead.
+    PhotonImageURLKindUnsupported,
+    /// A photon URL without parameters, returned as is.
+    PhotonImageURLKindUnchanged,
+    /// A photon URL with photon parameters.
+    PhotonImageURLKindPhoton,
+    /// An mshots URL, which only accepts its own size parameters.
+    PhotonImageURLKindMshots,
+};
+
+@implementation PhotonImageURLHelper
+
 + (NSURL *)photonURLWithSize:(CGSize)size forImageURL:(NSURL *)url
 {
     return [self photonURLWithSize:size forImageURL:url forceResize:YES imageQuality:DefaultPhotonImageQuality];
@@ -13,106 +27,182 @@ static const NSInteger MinPhotonImageQuality = 1;
 
 + (NSURL *)photonURLWithSize:(CGSize)size forImageURL:(NSURL *)url forceResize:(BOOL)forceResize imageQuality:(NSUInteger)quality
 {
-    // Photon will fail if the URL doesn't end in one of the accepted extensions
-    NSArray *acceptedImageTypes = @[@"gif", @"jpg", @"jpeg", @"png"];
-    if ([acceptedImageTypes indexOfObject:url.pathExtension] == NSNotFound) {
-        if (![url scheme]) {
-            return [NSURL URLWithString:[NSString stringWithFormat:@"http://%@", [url absoluteString]]];
-        }
-        return url;
+    PhotonImageURLBuilder *builder = [[PhotonImageURLBuilder alloc] initWithImageURL:url scale:[[UIScreen mainScreen] scale]];
+    return [builder URLWithSize:size forceResize:forceResize imageQuality:quality];
+}
+
++ (NSArray<NSURL *> *)photonURLsWithSizes:(NSArray<NSValue *> *)sizes forImageURL:(NSURL *)url forceResize:(BOOL)forceResize imageQuality:(NSUInteger)quality
+{
+    PhotonImageURLBuilder *builder = [[PhotonImageURLBuilder alloc] initWithImageURL:url scale:[[UIScreen mainScreen] scale]];
+    NSMutableArray<NSURL *> *photonURLs = [NSMutableArray arrayWithCapacity:sizes.count];
+    for (NSValue *size in sizes) {
+        NSURL *photonURL = [builder URLWithSize:size.CGSizeValue forceResize:forceResize imageQuality:quality];
+        [photonURLs addObject:photonURL ?: url];
     }
+    return photonURLs;
+}
 
-    NSString *urlString = [url absoluteString];
-    CGFloat scale = [[UIScreen mainScreen] scale];
-    size.width *= scale;
-    size.height *= scale;
-    quality = MIN(MAX(quality, MinPhotonImageQuality), MaxPhotonImageQuality);
+@end
 
-    // If the URL is already a Photon URL reject its photon params, and substitute our own.
-    if ([self isURLPhotonURL:url]) {
-        NSRange range = [urlString rangeOfString:@"?" options:NSBackwardsSearch];
-        if (range.location != NSNotFound) {
-            BOOL useSSL = ([urlString rangeOfString:@"ssl=1"].location != NSNotFound);
-            urlString = [urlString substringToIndex:range.location];
-            NSString *queryString = [self photonQueryStringForSize:size usingSSL:useSSL forceResize:forceResize quality:quality];
-            urlString = [NSString stringWithFormat:@"%@?%@", urlString, queryString];
-            return [NSURL URLWithString:urlString];
-        }
-        // Saftey net. Don't photon photon!
-        return url;
-    }
+@implementation PhotonImageURLBuilder {
+    NSURL *_url;
+    CGFloat _scale;
+    PhotonImageURLKind _kind;
+    BOOL _useSSL;
+    /// The scheme-stripped host and path, followed by the query of the last URL.
+    char *_buffer;
+    size_t _prefixLength;
+    size_t _capacity;
+}
 
-    // Compose the URL
-    NSRange range = [urlString rangeOfString:@"://"];
-    if (range.location != NSNotFound && range.location < 6) {
-        urlString = [urlString substringFromIndex:(range.location + range.length)];
+- (instancetype)initWithImageURL:(NSURL *)url scale:(CGFloat)scale
+{
+    self = [super init];
+    if (self) {
+        _url = url;
+        _scale = scale;
+        [self parseImageURL:url];
     }
+    return self;
+}
 
-    // Photon rejects resizing mshots
-    if ([urlString rangeOfString:@"/mshots/"].location != NSNotFound) {
-        if (size.height == 0) {
-            urlString = [urlString stringByAppendingFormat:@"?w=%i", (int)size.width];
-        } else {
-            urlString = [urlString stringByAppendingFormat:@"?w=%i&h=%i", (int)size.width, (int)size.height];
-        }
-        return [NSURL URLWithString:urlString];
+- (void)dealloc
+{
+    free(_buffer);
+}
+
+- (NSURL *)URLWithSize:(CGSize)size forceResize:(BOOL)forceResize imageQuality:(NSUInteger)quality
+{
+    if (_kind == PhotonImageURLKindUnsupported || _kind == PhotonImageURLKindUnchanged) {
+        return _url;
     }
 
-    // Strip original resizing parameters, or we might get an image too small
-    NSRange imgpressRange = [urlString rangeOfString:@"?w="];
-    if (imgpressRange.location != NSNotFound) {
-        urlString = [urlString substringToIndex:imgpressRange.location];
+    size.width *= _scale;
+    size.height *= _scale;
+    quality = MIN(MAX(quality, MinPhotonImageQuality), MaxPhotonImageQuality);
+
+    size_t queryLength = [self writeQueryForSize:size forceResize:forceResize quality:quality];
+    if (_prefixLength + queryLength >= _capacity) {
+        [self reserveQueryCapacity:queryLength + 1];
+        queryLength = [self writeQueryForSize:size forceResize:forceResize quality:quality];
     }
 
-    BOOL useSSL = [[url scheme] isEqualToString:@"https"];
-    NSString *queryString = [self photonQueryStringForSize:size usingSSL:useSSL forceResize:forceResize quality:quality];
-    NSString *photonURLString = [NSString stringWithFormat:@"https://i0.wp.com/%@?%@", urlString, queryString];
-    return [NSURL URLWithString:photonURLString];
+    NSString *urlString = [[NSString alloc] initWithBytes:_buffer length:_prefixLength + queryLength encoding:NSUTF8StringEncoding];
+    return [NSURL URLWithString:urlString];
 }
 
++ (BOOL)isPhotonHost:(NSString *)host
+{
+    // Looks for `i\d+\.wp\.com` anywhere in the host, ignoring case.
+    const char *characters = host.UTF8String;
+    if (characters == NULL) { // relative URLs may not have a host
+        return NO;
+    }
+    for (const char *character = characters; *character != '\0'; character++) {
+        if (*character != 'i' && *character != 'I') {
+            continue;
+        }
+        const char *digits = character + 1;
+        const char *end = digits;
+        while (*end >= '0' && *end <= '9') {
+            end++;
+        }
+        if (end > digits && strncasecmp(end, ".wp.com", 7) == 0) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+#pragma mark - Private Methods
+
 /**
- Constructs a Photon query string from the  supplied parameters.
+ Stores everything the photon URLs of the image have in common, up to and including the `?`
+ that starts their query.
  */
-+ (NSString *)photonQueryStringForSize:(CGSize)size usingSSL:(BOOL)useSSL forceResize:(BOOL)forceResize quality:(NSUInteger)quality
+- (void)parseImageURL:(NSURL *)url
 {
-    NSString *queryString;
-    if (size.height == 0) {
-        queryString = [NSString stringWithFormat:@"w=%i", (int)size.width];
-    } else {
-        NSString *method = forceResize ? @"resize" : @"fit";
-        queryString = [NSString stringWithFormat:@"%@=%.0f,%.0f", method, size.width, size.height];
+    // Photon will fail if the URL doesn't end in one of the accepted extensions
+    NSString *extension = url.pathExtension;
+    if (!([extension isEqualToString:@"gif"] || [extension isEqualToString:@"jpg"] || [extension isEqualToString:@"jpeg"] || [extension isEqualToString:@"png"])) {
+        _kind = PhotonImageURLKindUnsupported;
+        if (![url scheme]) {
+            _url = [NSURL URLWithString:[NSString stringWithFormat:@"http://%@", [url absoluteString]]];
+        }
+        return;
     }
 
-    if (useSSL) {
-        queryString = [NSString stringWithFormat:@"%@&ssl=1", queryString];
+    NSString *urlString = [url absoluteString];
+    NSString *prefix;
+
+    // If the URL is already a Photon URL reject its photon params, and substitute our own.
+    if ([[self class] isPhotonHost:[url host]]) {
+        NSRange range = [urlString rangeOfString:@"?" options:NSBackwardsSearch];
+        if (range.location == NSNotFound) {
+            // Saftey net. Don't photon photon!
+            _kind = PhotonImageURLKindUnchanged;
+            return;
+        }
+        _kind = PhotonImageURLKindPhoton;
+        _useSSL = ([urlString rangeOfString:@"ssl=1"].location != NSNotFound);
+        prefix = [urlString substringToIndex:NSMaxRange(range)];
+    } else {
+        NSRange range = [urlString rangeOfString:@"://"];
+        if (range.location != NSNotFound && range.location < 6) {
+            urlString = [urlString substringFromIndex:NSMaxRange(range)];
+        }
+
+        if ([urlString rangeOfString:@"/mshots/"].location != NSNotFound) {
+            _kind = PhotonImageURLKindMshots;
+            prefix = [urlString stringByAppendingString:@"?"];
+        } else {
+            // Strip original resizing parameters, or we might get an image too small
+            NSRange imgpressRange = [urlString rangeOfString:@"?w="];
+            if (imgpressRange.location != NSNotFound) {
+                urlString = [urlString substringToIndex:imgpressRange.location];
+            }
+            _kind = PhotonImageURLKindPhoton;
+            _useSSL = [[url scheme] isEqualToString:@"https"];
+            prefix = [NSString stringWithFormat:@"https://i0.wp.com/%@?", urlString];
+        }
     }
 
-    queryString = [NSString stringWithFormat:@"quality=%lu&%@", (unsigned long)quality, queryString];
-    
-    return queryString;
+    const char *prefixBytes = prefix.UTF8String;
+    _prefixLength = strlen(prefixBytes);
+    [self reserveQueryCapacity:PhotonQueryCapacity];
+    memcpy(_buffer, prefixBytes, _prefixLength);
+}
+
+- (void)reserveQueryCapacity:(size_t)queryCapacity
+{
+    _capacity = _prefixLength + queryCapacity;
+    _buffer = reallocf(_buffer, _capacity);
 }
 
 /**
- Inspects the specified URL to see if its uses Photon.
- 
- @return True if the URL is a photon URL. False otherwise.
+ Writes the query after the prefix, and returns its length. The query is truncated when it
+ doesn't fit the buffer, but the returned length is always the full one.
  */
-+ (BOOL)isURLPhotonURL:(NSURL *)url
+- (size_t)writeQueryForSize:(CGSize)size forceResize:(BOOL)forceResize quality:(NSUInteger)quality
 {
-    static NSRegularExpression *regex;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        NSError *error;
-        regex = [NSRegularExpression regularExpressionWithPattern:@"i\\d+\\.wp\\.com" options:NSRegularExpressionCaseInsensitive error:&error];
-    });
-    NSString *host = [url host];
-    if ([host length] > 0) { // relative URLs may not have a host
-        NSInteger count = [regex numberOfMatchesInString:host options:0 range:NSMakeRange(0, [host length])];
-        if (count > 0) {
-            return YES;
+    char *query = _buffer + _prefixLength;
+    size_t capacity = _capacity - _prefixLength;
+    const char *ssl = _useSSL ? "&ssl=1" : "";
+    int length;
+    if (_kind == PhotonImageURLKindMshots) {
+        // Photon rejects resizing mshots
+        if (size.height == 0) {
+            length = snprintf(query, capacity, "w=%i", (int)size.width);
+        } else {
+            length = snprintf(query, capacity, "w=%i&h=%i", (int)size.width, (int)size.height);
         }
+    } else if (size.height == 0) {
+        length = snprintf(query, capacity, "quality=%lu&w=%i%s", (unsigned long)quality, (int)size.width, ssl);
+    } else {
+        const char *method = forceResize ? "resize" : "fit";
+        length = snprintf(query, capacity, "quality=%lu&%s=%.0f,%.0f%s", (unsigned long)quality, method, (double)size.width, (double)size.height, ssl);
     }
-    return NO;
+    return (size_t)MAX(length, 0);
 }
 
 @end
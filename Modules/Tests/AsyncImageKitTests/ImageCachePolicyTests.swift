@@ -0,0 +1,228 @@
+import UIKit
+import Testing
+@testable import AsyncImageKit
+
+struct ImageCachePolicyTests {
+    private let url = "https://example.files.wordpress.com/2023/09/image.jpg"
+
+    // MARK: - Variants
+
+    @Test func exactVariant() {
+        let policy = ImageCachePolicy(costLimit: 1000)
+        policy.insert(key(256, 256), cost: 10)
+        policy.insert(key(1024, 1024), cost: 100)
+
+        #expect(policy.bestVariant(for: url, size: ImageSize(width: 256, height: 256)) == key(256, 256))
+    }
+
+    @Test func smallestLargerVariant() {
+        let policy = ImageCachePolicy(costLimit: 1000)
+        policy.insert(ImageCacheKey(url: url, size: nil), cost: 500)
+        policy.insert(key(2048, 2048), cost: 200)
+        policy.insert(key(1024, 1024), cost: 100)
+        policy.insert(key(128, 128), cost: 1)
+
+        #expect(policy.bestVariant(for: url, size: ImageSize(width: 256, height: 256)) == key(1024, 1024))
+    }
+
+    @Test func variantMustCoverBothDimensions() {
+        let policy = ImageCachePolicy(costLimit: 1000)
+        policy.insert(key(1024, 100), cost: 10)
+
+        #expect(policy.bestVariant(for: url, size: ImageSize(width: 256, height: 256)) == nil)
+    }
+
+    @Test func originalIsUsedAsFallback() {
+        let policy = ImageCachePolicy(costLimit: 1000)
+        policy.insert(ImageCacheKey(url: url, size: nil), cost: 500)
+        policy.insert(key(128, 128), cost: 1)
+
+        #expect(policy.bestVariant(for: url, size: ImageSize(width: 256, height: 256)) == ImageCacheKey(url: url, size: nil))
+        #expect(policy.bestVariant(for: url, size: nil) == ImageCacheKey(url: url, size: nil))
+    }
+
+    @Test func originalIsNotServedBySizedVariants() {
+        let policy = ImageCachePolicy(costLimit: 1000)
+        policy.insert(key(1024, 1024), cost: 100)
+
+        #expect(policy.bestVariant(for: url, size: nil) == nil)
+    }
+
+    @Test func removedVariantsAreNotReturned() {
+        let policy = ImageCachePolicy(costLimit: 1000)
+        policy.insert(key(1024, 1024), cost: 100)
+        policy.remove(key(1024, 1024))
+
+        #expect(policy.bestVariant(for: url, size: ImageSize(width: 256, height: 256)) == nil)
+        #expect(policy.count == 0)
+        #expect(policy.totalCost == 0)
+    }
+
+    // MARK: - Eviction
+
+    @Test func evictsLeastRecentlyUsed() {
+        let policy = ImageCachePolicy(costLimit: 30)
+        policy.insert(key(1, 1), cost: 10)
+        policy.insert(key(2, 2), cost: 10)
+        policy.insert(key(3, 3), cost: 10)
+        policy.touch(key(1, 1))
+
+        let evicted = policy.insert(key(4, 4), cost: 10)
+
+        #expect(evicted == [key(2, 2)])
+        #expect(policy.totalCost == 30)
+    }
+
+    @Test func evictsLowerPriorityFirst() {
+        let policy = ImageCachePolicy(costLimit: 30)
+        policy.insert(key(1, 1), cost: 10, priority: .high)
+        policy.insert(key(2, 2), cost: 10, priority: .normal)
+        policy.insert(key(3, 3), cost: 10, priority: .low)
+
+        let evicted = policy.insert(key(4, 4), cost: 20, priority: .normal)
+
+        #expect(evicted == [key(3, 3), key(2, 2)])
+        #expect(policy.contains(key(1, 1)))
+    }
+
+    @Test func rejectsEntriesOverCostLimit() {
+        let policy = ImageCachePolicy(costLimit: 30)
+        policy.insert(key(1, 1), cost: 10)
+
+        #expect(policy.insert(key(2, 2), cost: 31) == [key(2, 2)])
+        #expect(policy.contains(key(1, 1)))
+        #expect(!policy.contains(key(2, 2)))
+    }
+
+    @Test func reinsertingReplacesCost() {
+        let policy = ImageCachePolicy(costLimit: 100)
+        policy.insert(key(1, 1), cost: 10, priority: .low)
+        policy.insert(key(1, 1), cost: 20, priority: .high)
+
+        #expect(policy.count == 1)
+        #expect(policy.totalCost == 20)
+        #expect(policy.priority(for: key(1, 1)) == .high)
+    }
+
+    @Test func memoryPressureTrimsByPriority() {
+        let policy = ImageCachePolicy(costLimit: 100)
+        for index in 0..<4 {
+            policy.insert(key(index, 0), cost: 10, priority: .low)
+            policy.insert(key(index, 1), cost: 10, priority: .normal)
+        }
+        policy.insert(key(0, 2), cost: 10, priority: .high)
+
+        let evicted = policy.trimForMemoryPressure()
+
+        // THEN all low-priority entries are evicted and normal-priority ones
+        // until the cache is down to 25% of the limit
+        #expect(evicted.count == 7)
+        #expect(policy.totalCost == 20)
+        #expect(policy.contains(key(3, 1)))
+        #expect(policy.contains(key(0, 2)))
+    }
+
+    // MARK: - MemoryCache
+
+    @Test func memoryCacheDownscalesLargerVariant() throws {
+        let cache = MemoryCache(costLimit: 100_000_000)
+        let imageURL = try #require(URL(string: url))
+        let image = makeImage(width: 1024, height: 680)
+        cache.setImage(image, for: imageURL, size: nil)
+
+        // THEN the larger variant is returned right away and downscaled in
+        // the background
+        let size = ImageSize(width: 256, height: 256)
+        #expect(cache.image(for: imageURL, size: size) === image)
+        cache.waitForPendingResizes()
+        let thumbnail = try #require(cache.image(for: imageURL, size: size))
+
+        #expect(thumbnail !== image)
+        #expect(thumbnail.size.scaled(by: thumbnail.scale) == CGSize(width: 386, height: 256))
+
+        // THEN the downscaled variant is stored with a low priority and
+        // evicted first under memory pressure
+        cache.trimForMemoryPressure()
+        #expect(cache.image(for: imageURL, size: nil) != nil)
+        #expect(cache.totalCost == image.cgImage.map { $0.bytesPerRow * $0.height })
+    }
+
+    @Test func memoryCacheDoesNotUpscaleSmallerVariant() throws {
+        let cache = MemoryCache(costLimit: 100_000_000)
+        let imageURL = try #require(URL(string: url))
+        cache.setImage(makeImage(width: 128, height: 128), for: imageURL, size: ImageSize(width: 128, height: 128))
+
+        #expect(cache.image(for: imageURL, size: ImageSize(width: 256, height: 256)) == nil)
+    }
+
+    // MARK: - Trace
+
+    /// Replays a trace resembling a media library session: scrolling through
+    /// a grid of thumbnails, with some of the items already opened in detail,
+    /// and periodic memory warnings. Compares the hits of exact-key lookups to
+    /// variant lookups.
+    @Test func mediaLibraryTraceIsServedFromLargerVariants() {
+        let grid = ImageSize(width: 256, height: 256)
+        let detail = ImageSize(width: 1170, height: 2532)
+        let costs: [ImageSize: Int] = [grid: 256 * 256 * 4, detail: 1170 * 1560 * 4]
+
+        var trace: [(url: String, size: ImageSize)] = []
+        for page in 0..<100 {
+            // Each page overlaps the previous one, as when scrolling back and forth.
+            let items = (page * 40..<page * 40 + 100).map { $0 % 2_000 }
+            for item in items where item % 10 == 0 {
+                trace.append(("https://example.files.wordpress.com/\(item).jpg", detail))
+            }
+            for item in items {
+                trace.append(("https://example.files.wordpress.com/\(item).jpg", grid))
+            }
+        }
+
+        let policy = ImageCachePolicy(costLimit: 256_000_000)
+        let exactPolicy = ImageCachePolicy(costLimit: 256_000_000)
+        var hits = 0
+        var variantHits = 0
+        var exactHits = 0
+        for (index, request) in trace.enumerated() {
+            if index % 5_000 == 4_999 {
+                _ = policy.trimForMemoryPressure()
+                _ = exactPolicy.trimForMemoryPressure()
+            }
+            let key = ImageCacheKey(url: request.url, size: request.size)
+            if let variant = policy.bestVariant(for: request.url, size: request.size) {
+                policy.touch(variant)
+                hits += 1
+                if variant != key {
+                    variantHits += 1
+                    policy.insert(key, cost: costs[request.size]!, priority: .low)
+                }
+            } else {
+                policy.insert(key, cost: costs[request.size]!)
+            }
+            if exactPolicy.contains(key) {
+                exactPolicy.touch(key)
+                exactHits += 1
+            } else {
+                exactPolicy.insert(key, cost: costs[request.size]!)
+            }
+        }
+
+        #expect(variantHits > 0)
+        #expect(hits > exactHits)
+        #expect(policy.totalCost <= policy.costLimit)
+    }
+
+    // MARK: - Helpers
+
+    private func key(_ width: Int, _ height: Int) -> ImageCacheKey {
+        ImageCacheKey(url: url, size: ImageSize(width: width, height: height))
+    }
+
+    private func makeImage(width: Int, height: Int) -> UIImage {
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1
+        return UIGraphicsImageRenderer(size: CGSize(width: width, height: height), format: format).image {
+            $0.fill(CGRect(x: 0, y: 0, width: width, height: height))
+        }
+    }
+}
@@ -0,0 +1,49 @@
+import Foundation
+@preconcurrency import WordPressKit
+
+/// Responds to `stats/visits` requests with a fixed response and records
+/// the requests it receives.
+final class MockWordPressComRestApi: WordPressComRestApi, @unchecked Sendable {
+    private let lock = NSLock()
+    private var _requestedPaths: [String] = []
+
+    /// The delay before the response is delivered.
+    var responseDelay: TimeInterval = 0.05
+
+    var requestedPaths: [String] {
+        lock.withLock { _requestedPaths }
+    }
+
+    override func GET(
+        _ URLString: String,
+        parameters: [String: AnyObject]?,
+        success: @escaping SuccessResponseBlock,
+        failure: @escaping FailureReponseBlock
+    ) -> Progress? {
+        lock.withLock { _requestedPaths.append(URLString) }
+
+        let response = makeVisitsResponse(parameters: parameters)
+        DispatchQueue.global().asyncAfter(deadline: .now() + responseDelay) {
+            if let response {
+                success(response as AnyObject, nil)
+            } else {
+                failure(NSError(domain: "MockWordPressComRestApi", code: 404), nil)
+            }
+        }
+        return Progress()
+    }
+
+    private func makeVisitsResponse(parameters: [String: AnyObject]?) -> [String: Any]? {
+        guard let date = parameters?["date"] as? String else {
+            return nil
+        }
+        return [
+            "date": date,
+            "unit": "day",
+            "fields": ["period", "views", "visitors"],
+            "data": [
+                [date, 10, 4]
+            ]
+        ]
+    }
+}
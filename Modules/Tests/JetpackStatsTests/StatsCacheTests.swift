@@ -0,0 +1,221 @@
+import Testing
+import Foundation
+@testable import JetpackStats
+
+@Suite
+struct StatsCacheTests {
+    let calendar = Calendar.mock(timeZone: .eastern)
+
+    // MARK: - StatsService
+
+    @Test("Concurrent identical requests share a single fetch")
+    func concurrentRequestsAreDeduplicated() async throws {
+        // GIVEN
+        let api = MockWordPressComRestApi()
+        let service = StatsService(siteID: 1, api: api, timeZone: .eastern, cacheDirectoryURL: nil)
+        let interval = makeHistoricalInterval()
+
+        // WHEN
+        try await withThrowingTaskGroup(of: SiteMetricsResponse.self) { group in
+            for _ in 0..<5 {
+                group.addTask {
+                    try await service.getSiteStats(interval: interval, granularity: .day)
+                }
+            }
+            for try await response in group {
+                #expect(response.total.views == 10)
+            }
+        }
+
+        // THEN
+        #expect(api.requestedPaths.count == 1)
+    }
+
+    @Test("Historical periods are restored from disk without network requests")
+    func historicalPeriodsArePersisted() async throws {
+        // GIVEN
+        let directoryURL = makeTemporaryDirectory()
+        defer { try? FileManager.default.removeItem(at: directoryURL) }
+        let interval = makeHistoricalInterval()
+
+        let api = MockWordPressComRestApi()
+        let service = StatsService(siteID: 1, api: api, timeZone: .eastern, cacheDirectoryURL: directoryURL)
+        let response = try await service.getSiteStats(interval: interval, granularity: .day)
+        #expect(api.requestedPaths.count == 1)
+
+        // WHEN a new service is created (cold start)
+        let coldStartAPI = MockWordPressComRestApi()
+        let coldStartService = StatsService(siteID: 1, api: coldStartAPI, timeZone: .eastern, cacheDirectoryURL: directoryURL)
+        let restored = try await coldStartService.getSiteStats(interval: interval, granularity: .day)
+
+        // THEN
+        #expect(coldStartAPI.requestedPaths.isEmpty)
+        #expect(restored.total.views == response.total.views)
+        #expect(restored.total.visitors == response.total.visitors)
+        #expect(restored.metrics[.views]?.map(\.date) == response.metrics[.views]?.map(\.date))
+        #expect(restored.metrics[.views]?.map(\.value) == response.metrics[.views]?.map(\.value))
+    }
+
+    @Test("Current period is not persisted to disk")
+    func currentPeriodIsNotPersisted() async throws {
+        // GIVEN
+        let directoryURL = makeTemporaryDirectory()
+        defer { try? FileManager.default.removeItem(at: directoryURL) }
+        let interval = calendar.makeDateInterval(for: .today)
+
+        let api = MockWordPressComRestApi()
+        let service = StatsService(siteID: 1, api: api, timeZone: .eastern, cacheDirectoryURL: directoryURL)
+        _ = try await service.getSiteStats(interval: interval, granularity: .day)
+
+        // WHEN
+        let coldStartAPI = MockWordPressComRestApi()
+        let coldStartService = StatsService(siteID: 1, api: coldStartAPI, timeZone: .eastern, cacheDirectoryURL: directoryURL)
+        _ = try await coldStartService.getSiteStats(interval: interval, granularity: .day)
+
+        // THEN
+        #expect(coldStartAPI.requestedPaths.count == 1)
+    }
+
+    // MARK: - StatsCache
+
+    @Test("Least recently used entries are evicted when over the cost limit")
+    func leastRecentlyUsedEntriesAreEvicted() async throws {
+        // GIVEN
+        let cache = StatsCache<TestKey, Int>(costLimit: 3, cost: { _ in 1 })
+        for index in 0..<3 {
+            _ = try await cache.value(for: TestKey(index), ttl: nil) { index }
+        }
+
+        // WHEN the first entry is accessed and a new one is inserted
+        _ = try await cache.value(for: TestKey(0), ttl: nil) { -1 }
+        _ = try await cache.value(for: TestKey(3), ttl: nil) { 3 }
+
+        // THEN the least recently used entry is evicted
+        #expect(await cache.count == 3)
+        #expect(await cache.currentCost == 3)
+        #expect(await cache.cachedValue(for: TestKey(0)) == 0)
+        #expect(await cache.cachedValue(for: TestKey(1)) == nil)
+        #expect(await cache.cachedValue(for: TestKey(2)) == 2)
+        #expect(await cache.cachedValue(for: TestKey(3)) == 3)
+    }
+
+    @Test("Expired entries are returned while they are refreshed in the background")
+    func expiredEntriesAreRefreshedInBackground() async throws {
+        // GIVEN
+        let clock = TestClock()
+        let cache = StatsCache<TestKey, Int>(costLimit: 10, maxStaleness: 60, now: clock.now, cost: { _ in 1 })
+        _ = try await cache.value(for: TestKey(0), ttl: 10) { 1 }
+        clock.advance(by: 30)
+
+        // WHEN
+        let stale = try await cache.value(for: TestKey(0), ttl: 1000) { 2 }
+
+        // THEN the stale value is returned first and replaced by the refresh,
+        // which a request past the staleness limit waits for
+        #expect(stale == 1)
+        clock.advance(by: 100)
+        #expect(try await cache.value(for: TestKey(0), ttl: 1000) { 3 } == 2)
+        #expect(await cache.cachedValue(for: TestKey(0)) == 2)
+    }
+
+    @Test("Entries older than the staleness limit are fetched again")
+    func entriesPastStalenessAreFetched() async throws {
+        // GIVEN
+        let clock = TestClock()
+        let cache = StatsCache<TestKey, Int>(costLimit: 10, maxStaleness: 60, now: clock.now, cost: { _ in 1 })
+        _ = try await cache.value(for: TestKey(0), ttl: 10) { 1 }
+
+        // WHEN
+        clock.advance(by: 71)
+
+        // THEN
+        #expect(try await cache.value(for: TestKey(0), ttl: 10) { 2 } == 2)
+    }
+
+    @Test("Failed fetches are not cached")
+    func failedFetchesAreNotCached() async throws {
+        // GIVEN
+        let cache = StatsCache<TestKey, Int>(costLimit: 10, cost: { _ in 1 })
+
+        // WHEN
+        await #expect(throws: StatsServiceError.self) {
+            try await cache.value(for: TestKey(0), ttl: nil) { throw StatsServiceError.unknown }
+        }
+
+        // THEN
+        #expect(await cache.count == 0)
+        #expect(try await cache.value(for: TestKey(0), ttl: nil) { 1 } == 1)
+    }
+
+    // MARK: - StatsDiskCacheStorage
+
+    @Test("The least recently written files are removed when over the size limit")
+    func diskCacheIsPrunedBySize() throws {
+        // GIVEN
+        let directoryURL = makeTemporaryDirectory()
+        defer { try? FileManager.default.removeItem(at: directoryURL) }
+        let response = SiteMetricsResponse(total: SiteMetricsSet(), metrics: [
+            .views: (0..<100).map { DataPoint(date: Date(timeIntervalSinceReferenceDate: Double($0) * 86_400), value: $0) }
+        ])
+        StatsDiskCacheStorage<SiteMetricsResponse>(directoryURL: directoryURL).setValue(response, forKey: "a")
+        let fileURL = directoryURL.appendingPathComponent("a.plist")
+        let fileSize = try #require(try fileURL.resourceValues(forKeys: [.fileSizeKey]).fileSize)
+
+        let storage = StatsDiskCacheStorage<SiteMetricsResponse>(directoryURL: directoryURL, sizeLimit: fileSize * 2)
+        storage.setValue(response, forKey: "b")
+        try FileManager.default.setAttributes([.modificationDate: Date(timeIntervalSinceNow: -60)], ofItemAtPath: fileURL.path)
+
+        // WHEN
+        storage.setValue(response, forKey: "c")
+
+        // THEN
+        #expect(storage.value(forKey: "a") == nil)
+        #expect(storage.value(forKey: "b") != nil)
+        #expect(storage.value(forKey: "c") != nil)
+    }
+
+    @Test("The cache directory doesn't change with daylight saving time")
+    func cacheDirectoryIsKeyedByTimeZoneIdentifier() throws {
+        let timeZone = try #require(TimeZone(identifier: "America/New_York"))
+        let directoryURL = try #require(StatsService.makeCacheDirectoryURL(siteID: 1, timeZone: timeZone))
+        #expect(directoryURL.lastPathComponent == "1-America_New_York")
+    }
+
+    // MARK: - Helpers
+
+    private func makeHistoricalInterval() -> DateInterval {
+        let start = calendar.date(from: DateComponents(year: 2025, month: 1, day: 10))!
+        let end = calendar.date(byAdding: .day, value: 1, to: start)!
+        return DateInterval(start: start, end: end)
+    }
+
+    private func makeTemporaryDirectory() -> URL {
+        FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString, isDirectory: true)
+    }
+}
+
+private struct TestKey: StatsCacheKey {
+    let value: Int
+
+    init(_ value: Int) {
+        self.value = value
+    }
+
+    var storageKey: String {
+        "\(value)"
+    }
+}
+
+/// A clock that only moves when told to.
+private final class TestClock: @unchecked Sendable {
+    private let lock = NSLock()
+    private var date = Date(timeIntervalSinceReferenceDate: 0)
+
+    var now: @Sendable () -> Date {
+        { [self] in lock.withLock { date } }
+    }
+
+    func advance(by interval: TimeInterval) {
+        lock.withLock { date += interval }
+    }
+}
@@ -0,0 +1,405 @@
+import Foundation
+import XCTest
+@testable import TracksMini
+
+final class TracksEventQueueTests: XCTestCase {
+    private var fileURL: URL!
+    private var uploader: StubUploader!
+
+    override func setUp() {
+        super.setUp()
+
+        fileURL = FileManager.default.temporaryDirectory
+            .appendingPathComponent(UUID().uuidString, isDirectory: true)
+            .appendingPathComponent("events.json")
+        uploader = StubUploader()
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: fileURL.deletingLastPathComponent())
+
+        super.tearDown()
+    }
+
+    func testEventsAreUploadedInBatchesWhenBatchSizeIsReached() throws {
+        // Given
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxBatchSize = 3
+        configuration.maxEventAge = 60
+        let queue = makeQueue(configuration: configuration)
+
+        // When
+        let expectation = expectation(description: "upload")
+        uploader.onUpload = { _ in expectation.fulfill() }
+        for index in 0..<3 {
+            queue.append(["_en": "event_\(index)"])
+        }
+        wait(for: [expectation], timeout: 1)
+
+        // Then
+        XCTAssertEqual(uploader.uploads.count, 1)
+        let events = try uploader.events(at: 0)
+        XCTAssertEqual(events.map { $0["_en"] as? String }, ["event_0", "event_1", "event_2"])
+        waitUntil { queue.pendingEventCount == 0 }
+    }
+
+    func testEventsAreUploadedWhenOldestEventExpires() {
+        // Given
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxBatchSize = 10
+        configuration.maxEventAge = 0.1
+        let queue = makeQueue(configuration: configuration)
+
+        // When
+        let expectation = expectation(description: "upload")
+        uploader.onUpload = { _ in expectation.fulfill() }
+        queue.append(["_en": "event"])
+
+        // Then
+        wait(for: [expectation], timeout: 1)
+        XCTAssertEqual(uploader.uploads.count, 1)
+    }
+
+    func testEventsAreUploadedWhenHostResignsActive() {
+        // Given
+        let notificationCenter = NotificationCenter()
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxEventAge = 60
+        let queue = makeQueue(configuration: configuration, notificationCenter: notificationCenter)
+        queue.append(["_en": "event"])
+
+        // When
+        let expectation = expectation(description: "upload")
+        uploader.onUpload = { _ in expectation.fulfill() }
+        notificationCenter.post(name: .NSExtensionHostWillResignActive, object: nil)
+
+        // Then
+        wait(for: [expectation], timeout: 1)
+        XCTAssertEqual(uploader.uploads.count, 1)
+    }
+
+    func testPendingEventsArePersistedAcrossLaunches() {
+        // Given events that were never uploaded
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxEventAge = 60
+        var queue: TracksEventQueue? = makeQueue(configuration: configuration)
+        queue?.append(["_en": "event_0"])
+        queue?.append(["_en": "event_1"])
+        XCTAssertEqual(queue?.pendingEventCount, 2)
+        queue?.persistPendingEvents()
+        queue = nil
+
+        // When the queue is created again
+        let expectation = expectation(description: "upload")
+        let nextUploader = StubUploader()
+        nextUploader.onUpload = { _ in expectation.fulfill() }
+        let nextQueue = TracksEventQueue(fileURL: fileURL, uploader: nextUploader, configuration: configuration)
+
+        // Then the pending events are sent on launch
+        wait(for: [expectation], timeout: 1)
+        XCTAssertEqual(try nextUploader.events(at: 0).count, 2)
+        waitUntil { nextQueue.pendingEventCount == 0 }
+        XCTAssertFalse(FileManager.default.fileExists(atPath: fileURL.path))
+    }
+
+    func testFailedUploadsAreRetriedWithBackoff() {
+        // Given
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxBatchSize = 1
+        configuration.retryBaseDelay = 0.1
+        uploader.result = .failure(URLError(.timedOut))
+        let queue = makeQueue(configuration: configuration)
+
+        // When the first attempt fails
+        let expectation = expectation(description: "retry")
+        expectation.expectedFulfillmentCount = 2
+        uploader.onUpload = { [uploader] count in
+            if count == 1 {
+                uploader?.result = .success(())
+            }
+            expectation.fulfill()
+        }
+        queue.append(["_en": "event"])
+
+        // Then the events are kept and sent again after the delay
+        wait(for: [expectation], timeout: 2)
+        XCTAssertEqual(uploader.uploads.count, 2)
+        waitUntil { queue.pendingEventCount == 0 }
+    }
+
+    func testBatchesRejectedWithClientErrorsAreDropped() {
+        // Given
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxBatchSize = 1
+        configuration.retryBaseDelay = 0.1
+        uploader.result = .failure(TracksUploadError(statusCode: 400))
+        let queue = makeQueue(configuration: configuration)
+
+        // When
+        let expectation = expectation(description: "upload")
+        uploader.onUpload = { _ in expectation.fulfill() }
+        queue.append(["_en": "event"])
+
+        // Then the batch isn't sent again
+        wait(for: [expectation], timeout: 1)
+        waitUntil { queue.pendingEventCount == 0 }
+        XCTAssertEqual(uploader.uploads.count, 1)
+    }
+
+    func testBatchesRateLimitedAreRetried() {
+        // Given
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxBatchSize = 1
+        configuration.retryBaseDelay = 0.1
+        uploader.result = .failure(TracksUploadError(statusCode: 429))
+        let queue = makeQueue(configuration: configuration)
+
+        // When the first attempt is rate limited
+        let expectation = expectation(description: "retry")
+        expectation.expectedFulfillmentCount = 2
+        uploader.onUpload = { [uploader] count in
+            if count == 1 {
+                uploader?.result = .success(())
+            }
+            expectation.fulfill()
+        }
+        queue.append(["_en": "event"])
+
+        // Then the events are sent again after the delay
+        wait(for: [expectation], timeout: 2)
+        XCTAssertEqual(uploader.uploads.count, 2)
+        waitUntil { queue.pendingEventCount == 0 }
+    }
+
+    func testRequestBodyIsCompact() throws {
+        // Given
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxBatchSize = 1
+        let queue = makeQueue(configuration: configuration)
+
+        // When
+        let expectation = expectation(description: "upload")
+        uploader.onUpload = { _ in expectation.fulfill() }
+        queue.append(["_en": "event"])
+        wait(for: [expectation], timeout: 1)
+
+        // Then
+        let body = try XCTUnwrap(String(data: uploader.uploads[0], encoding: .utf8))
+        XCTAssertFalse(body.contains("\n"))
+    }
+
+    func testOldestEventsAreDroppedWhenQueueIsFull() {
+        // Given
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxBatchSize = 100
+        configuration.maxQueueSize = 5
+        configuration.maxEventAge = 60
+        let queue = makeQueue(configuration: configuration)
+
+        // When
+        for index in 0..<8 {
+            queue.append(["_en": "event_\(index)"])
+        }
+
+        // Then
+        XCTAssertEqual(queue.pendingEventCount, 5)
+    }
+
+    func testUploadsAreLimitedToBatchSize() throws {
+        // Given more pending events than fit in a batch
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxBatchSize = 100
+        configuration.maxEventAge = 60
+        var queue: TracksEventQueue? = makeQueue(configuration: configuration)
+        for index in 0..<5 {
+            queue?.append(["_en": "event_\(index)"])
+        }
+        queue?.persistPendingEvents()
+        queue = nil
+
+        // When they are sent on the next launch
+        configuration.maxBatchSize = 3
+        configuration.maxEventAge = 0.1
+        let expectation = expectation(description: "upload")
+        expectation.expectedFulfillmentCount = 2
+        uploader.onUpload = { _ in expectation.fulfill() }
+        let nextQueue = makeQueue(configuration: configuration)
+
+        // Then
+        wait(for: [expectation], timeout: 1)
+        XCTAssertEqual(try uploader.events(at: 0).map { $0["_en"] as? String }, ["event_0", "event_1", "event_2"])
+        XCTAssertEqual(try uploader.events(at: 1).map { $0["_en"] as? String }, ["event_3", "event_4"])
+        waitUntil { nextQueue.pendingEventCount == 0 }
+    }
+
+    func testEventsDroppedDuringUploadAreNotMistakenForUploadedOnes() throws {
+        // Given an upload in progress
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxBatchSize = 2
+        configuration.maxQueueSize = 3
+        configuration.maxEventAge = 60
+        uploader.holdsCompletions = true
+        let queue = makeQueue(configuration: configuration)
+        queue.append(["_en": "event_0"])
+        queue.append(["_en": "event_1"])
+        waitUntil { self.uploader.uploads.count == 1 }
+
+        // When the queue drops its oldest event before the upload completes
+        queue.append(["_en": "event_2"])
+        queue.append(["_en": "event_3"])
+        XCTAssertEqual(queue.pendingEventCount, 3)
+        uploader.holdsCompletions = false
+        uploader.completeHeldUploads(with: .success(()))
+
+        // Then only the uploaded events are removed
+        waitUntil { self.uploader.uploads.count == 2 }
+        XCTAssertEqual(try uploader.events(at: 1).map { $0["_en"] as? String }, ["event_2", "event_3"])
+    }
+
+    func testUploadInProgressAtRelaunchIsNotSentAgain() {
+        // Given an upload that is still in progress when the process exits
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxBatchSize = 2
+        configuration.maxEventAge = 60
+        uploader.holdsCompletions = true
+        var queue: TracksEventQueue? = makeQueue(configuration: configuration)
+        queue?.append(["_en": "event_0"])
+        queue?.append(["_en": "event_1"])
+        waitUntil { self.uploader.uploads.count == 1 }
+        queue?.persistPendingEvents()
+        queue = nil
+
+        // When the system completes it on the next launch
+        let nextUploader = StubUploader()
+        let nextQueue = TracksEventQueue(fileURL: fileURL, uploader: nextUploader, configuration: configuration)
+        XCTAssertEqual(nextQueue.pendingEventCount, 2)
+        nextUploader.completePreviousLaunchUpload(batchID: uploader.batchIDs[0], with: .success(()))
+
+        // Then the events are removed without being sent again
+        waitUntil { nextQueue.pendingEventCount == 0 }
+        XCTAssertTrue(nextUploader.uploads.isEmpty)
+    }
+
+    func testUploadInProgressAtRelaunchIsSentAgainAfterTimeout() {
+        // Given an upload that never reports back after a relaunch
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxBatchSize = 2
+        configuration.maxEventAge = 60
+        configuration.previousLaunchUploadTimeout = 0.1
+        uploader.holdsCompletions = true
+        var queue: TracksEventQueue? = makeQueue(configuration: configuration)
+        queue?.append(["_en": "event_0"])
+        queue?.append(["_en": "event_1"])
+        waitUntil { self.uploader.uploads.count == 1 }
+        queue?.persistPendingEvents()
+        queue = nil
+
+        // When
+        let expectation = expectation(description: "upload")
+        let nextUploader = StubUploader()
+        nextUploader.onUpload = { _ in expectation.fulfill() }
+        let nextQueue = TracksEventQueue(fileURL: fileURL, uploader: nextUploader, configuration: configuration)
+
+        // Then
+        wait(for: [expectation], timeout: 1)
+        XCTAssertEqual(try nextUploader.events(at: 0).count, 2)
+        waitUntil { nextQueue.pendingEventCount == 0 }
+    }
+
+    func testWritesAreCoalesced() {
+        // Given
+        var configuration = TracksEventQueue.Configuration()
+        configuration.maxEventAge = 60
+        configuration.saveDelay = 60
+        let queue = makeQueue(configuration: configuration)
+
+        // When
+        for index in 0..<10 {
+            queue.append(["_en": "event_\(index)"])
+        }
+
+        // Then nothing is written until the delay expires or the host goes away
+        XCTAssertEqual(queue.pendingEventCount, 10)
+        XCTAssertFalse(FileManager.default.fileExists(atPath: fileURL.path))
+        queue.persistPendingEvents()
+        XCTAssertTrue(FileManager.default.fileExists(atPath: fileURL.path))
+    }
+
+    // MARK: - Helpers
+
+    private func makeQueue(
+        configuration: TracksEventQueue.Configuration,
+        notificationCenter: NotificationCenter = NotificationCenter()
+    ) -> TracksEventQueue {
+        TracksEventQueue(fileURL: fileURL, uploader: uploader, configuration: configuration, notificationCenter: notificationCenter)
+    }
+
+    private func waitUntil(timeout: TimeInterval = 1, _ condition: @escaping () -> Bool) {
+        let predicate = NSPredicate { _, _ in condition() }
+        wait(for: [XCTNSPredicateExpectation(predicate: predicate, object: nil)], timeout: timeout)
+    }
+}
+
+private final class StubUploader: TracksUploader {
+    private let lock = NSLock()
+    private var _uploads: [Data] = []
+    private var _batchIDs: [String] = []
+    private var heldCompletions: [(Result<Void, Error>) -> Void] = []
+    private var previousLaunchUploadHandler: ((String, Result<Void, Error>) -> Void)?
+
+    var result: Result<Void, Error> = .success(())
+    var onUpload: ((Int) -> Void)?
+    /// Keeps the uploads in progress until `completeHeldUploads(with:)` is called.
+    var holdsCompletions = false
+
+    var uploads: [Data] {
+        lock.withLock { _uploads }
+    }
+
+    var batchIDs: [String] {
+        lock.withLock { _batchIDs }
+    }
+
+    func upload(_ body: Data, batchID: String, completion: @escaping (Result<Void, Error>) -> Void) {
+        let count = lock.withLock {
+            _uploads.append(body)
+            _batchIDs.append(batchID)
+            if holdsCompletions {
+                heldCompletions.append(completion)
+            }
+            return _uploads.count
+        }
+        guard !holdsCompletions else {
+            return
+        }
+        let result = self.result
+        DispatchQueue.global().async {
+            completion(result)
+            self.onUpload?(count)
+        }
+    }
+
+    func setPreviousLaunchUploadHandler(_ handler: @escaping (String, Result<Void, Error>) -> Void) {
+        lock.withLock {
+            previousLaunchUploadHandler = handler
+        }
+    }
+
+    func completeHeldUploads(with result: Result<Void, Error>) {
+        let completions = lock.withLock {
+            defer { heldCompletions.removeAll() }
+            return heldCompletions
+        }
+        completions.forEach { $0(result) }
+    }
+
+    func completePreviousLaunchUpload(batchID: String, with result: Result<Void, Error>) {
+        let handler = lock.withLock { previousLaunchUploadHandler }
+        handler?(batchID, result)
+    }
+
+    func events(at index: Int) throws -> [[String: Any]] {
+        let object = try JSONSerialization.jsonObject(with: uploads[index]) as? [String: Any]
+        return try XCTUnwrap(object?["events"] as? [[String: Any]])
+    }
+}
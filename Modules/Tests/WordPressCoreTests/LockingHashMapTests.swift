@@ -195,6 +195,124 @@ struct LockingHashMapTests {
 
         #expect(Array(map.values).isEmpty)
     }
+
+    // MARK: - getOrInsert / compute
+
+    @Test("getOrInsert returns existing value without calling the closure")
+    func testGetOrInsertExisting() {
+        let map = LockingHashMap<Int>(["key": 1])
+        let value = map.getOrInsert("key") {
+            Issue.record("closure must not be called")
+            return 2
+        }
+        #expect(value == 1)
+    }
+
+    @Test("getOrInsert creates each value exactly once under contention")
+    func testGetOrInsertIsAtomic() async {
+        let map = LockingHashMap<Int>(shardCount: 4)
+        let counter = LockingHashMap<Int>()
+
+        await withTaskGroup(of: Int.self) { group in
+            for i in 0..<1_000 {
+                group.addTask {
+                    map.getOrInsert(i % 10) {
+                        counter.compute(i % 10) { ($0 ?? 0) + 1 }
+                        return i % 10
+                    }
+                }
+            }
+            for await value in group {
+                #expect((0..<10).contains(value))
+            }
+        }
+
+        #expect(map.count == 10)
+        #expect(counter.values.allSatisfy { $0 == 1 })
+    }
+
+    @Test("compute updates values atomically")
+    func testComputeIsAtomic() async {
+        let map = LockingHashMap<Int>()
+
+        await withTaskGroup(of: Void.self) { group in
+            for _ in 0..<1_000 {
+                group.addTask {
+                    map.compute("counter") { ($0 ?? 0) + 1 }
+                }
+            }
+        }
+
+        #expect(map["counter"] == 1_000)
+    }
+
+    @Test("compute removes the value when the closure returns nil")
+    func testComputeRemoves() {
+        let map = LockingHashMap<Int>(["key": 1])
+        let value = map.compute("key") { _ in nil }
+        #expect(value == nil)
+        #expect(map["key"] == nil)
+        #expect(map.count == 0)
+    }
+
+    // MARK: - Snapshots
+
+    @Test("snapshot is not affected by later mutations")
+    func testSnapshotIsIndependent() {
+        let map = LockingHashMap<Int>(["a": 1, "b": 2])
+        let snapshot = map.snapshot
+        let values = map.values
+        map["c"] = 3
+        map.removeValue(forKey: "a")
+
+        #expect(snapshot == ["a": 1, "b": 2])
+        #expect(values.sorted() == [1, 2])
+    }
+
+    @Test("taking snapshots while writing is safe")
+    func testSnapshotsDuringWrites() async {
+        let map = LockingHashMap<Int>()
+
+        await withTaskGroup(of: Void.self) { group in
+            for i in 0..<500 {
+                group.addTask {
+                    map[i] = i
+                }
+                group.addTask {
+                    let snapshot = map.snapshot
+                    for (key, value) in snapshot {
+                        #expect(key == AnyHashable(value))
+                    }
+                }
+            }
+        }
+
+        #expect(map.count == 500)
+    }
+
+    @Test("contended updates are spread across the shards", arguments: [1, 16])
+    func testContendedUpdatesAreSpreadAcrossShards(shardCount: Int) async {
+        let map = LockingHashMap<Int>(shardCount: shardCount)
+
+        await withTaskGroup(of: Void.self) { group in
+            for worker in 0..<8 {
+                group.addTask {
+                    for i in 0..<2_000 {
+                        let key = (worker * 2_000 + i) % 1_024
+                        map.compute(key) { ($0 ?? 0) + 1 }
+                    }
+                }
+            }
+        }
+
+        #expect(map.values.reduce(0, +) == 16_000)
+        let shardSizes = map.shardSizes
+        #expect(shardSizes.count == shardCount)
+        #expect(shardSizes.reduce(0, +) == 1_024)
+        // Every shard takes its share of the keys, so the writers rarely
+        // wait for the same lock.
+        #expect(shardSizes.allSatisfy { $0 > 0 && $0 <= 2 * 1_024 / shardCount })
+    }
 }
 
 // MARK: - LockingTaskHashMap Tests
@@ -348,6 +466,71 @@ struct LockingTaskHashMapTests {
         #expect(Array(map.values).isEmpty)
     }
 
+    // MARK: - Single-Flight
+
+    @Test("task(forKey:) shares the in-flight task between callers")
+    func testSingleFlightSharesTask() async {
+        let map = LockingTaskHashMap<Int, Never>()
+        let counter = LockingHashMap<Int>()
+
+        let values = await withTaskGroup(of: Int.self) { group in
+            for _ in 0..<100 {
+                group.addTask {
+                    await map.task(forKey: "site") {
+                        counter.compute("calls") { ($0 ?? 0) + 1 }
+                        try? await Task.sleep(for: .milliseconds(100))
+                        return 42
+                    }.value
+                }
+            }
+            return await group.reduce(into: []) { $0.append($1) }
+        }
+
+        #expect(values.count == 100)
+        #expect(values.allSatisfy { $0 == 42 })
+        #expect(counter["calls"] == 1)
+    }
+
+    @Test("task(forKey:) removes the task once it completes")
+    func testSingleFlightRemovesCompletedTask() async throws {
+        let map = LockingTaskHashMap<Int, any Error>()
+
+        let value = try await map.task(forKey: "site") { 1 }.value
+        #expect(value == 1)
+
+        for _ in 0..<100 where map["site"] != nil {
+            try await Task.sleep(for: .milliseconds(10))
+        }
+        #expect(map["site"] == nil)
+
+        let next = try await map.task(forKey: "site") { 2 }.value
+        #expect(next == 2)
+    }
+
+    @Test("removeAll cancels tasks added concurrently")
+    func testRemoveAllDuringInsertions() async {
+        let map = LockingTaskHashMap<Int, Never>()
+
+        await withTaskGroup(of: Void.self) { group in
+            for i in 0..<200 {
+                group.addTask {
+                    map[i] = Task {
+                        try? await Task.sleep(for: .seconds(10))
+                        return i
+                    }
+                }
+                if i % 50 == 0 {
+                    group.addTask {
+                        map.removeAll()
+                    }
+                }
+            }
+        }
+        map.removeAll()
+
+        #expect(map.count == 0)
+    }
+
     // MARK: - Error-Throwing Tasks
 
     @Test("works with throwing tasks")
@@ -0,0 +1,268 @@
+import Foundation
+import Testing
+import WordPressCoreProtocols
+@testable import WordPressCore
+
+// The URL protocol stub is shared, so the tests can't run in parallel.
+@Suite(.serialized, .timeLimit(.minutes(1)))
+final class PluginIconResolverTests {
+    private let server = StubIconServer()
+    private let cache = InMemoryDiskCache()
+    private let directory = StubPluginDirectory()
+
+    init() {
+        StubIconURLProtocol.server = server
+    }
+
+    deinit {
+        StubIconURLProtocol.server = nil
+    }
+
+    @Test func returnsIconFromDirectoryWithoutProbing() async {
+        directory.icons = ["akismet": URL(string: "https://ps.w.org/akismet/assets/icon.png")!]
+        let resolver = makeResolver()
+
+        let url = await resolver.iconURL(forSlug: "akismet")
+
+        #expect(url == URL(string: "https://ps.w.org/akismet/assets/icon.png"))
+        #expect(server.requestCount == 0)
+    }
+
+    @Test func prefersFirstCandidateFoundOnSVNServer() async {
+        let candidates = PluginIconResolver.svnIconCandidates(slug: "jetpack")
+        for candidate in candidates {
+            server.statusCodes[candidate] = 200
+        }
+        let resolver = makeResolver()
+
+        let url = await resolver.iconURL(forSlug: "jetpack")
+
+        #expect(url == candidates.first)
+        #expect(server.requestCount == candidates.count)
+    }
+
+    @Test func batchesDirectoryLookups() async {
+        let slugs = (0..<10).map { "plugin-\($0)" }
+        let resolver = makeResolver()
+
+        await withTaskGroup(of: Void.self) { group in
+            for slug in slugs {
+                group.addTask { _ = await resolver.iconURL(forSlug: slug) }
+            }
+        }
+
+        #expect(directory.lookups.count == 1)
+        #expect(Set(directory.lookups.flatMap { $0 }) == Set(slugs))
+    }
+
+    @Test func coalescesConcurrentRequestsForSameSlug() async {
+        let resolver = makeResolver()
+
+        await withTaskGroup(of: Void.self) { group in
+            for _ in 0..<5 {
+                group.addTask { _ = await resolver.iconURL(forSlug: "akismet") }
+            }
+        }
+
+        #expect(directory.lookups == [["akismet"]])
+        #expect(server.requestCount == PluginIconResolver.svnIconCandidates(slug: "akismet").count)
+    }
+
+    @Test func limitsConcurrentProbes() async {
+        server.responseDelay = .milliseconds(20)
+        let resolver = makeResolver(maxConcurrentRequests: 3)
+
+        await withTaskGroup(of: Void.self) { group in
+            for index in 0..<10 {
+                group.addTask { _ = await resolver.iconURL(forSlug: "plugin-\(index)") }
+            }
+        }
+
+        #expect(server.requestCount == 10 * PluginIconResolver.svnIconCandidates(slug: "plugin").count)
+        #expect(server.maxConcurrentRequests <= 3)
+        #expect(server.maxConcurrentRequests > 1)
+    }
+
+    @Test func remembersIconsAcrossLaunches() async {
+        directory.icons = ["akismet": URL(string: "https://ps.w.org/akismet/assets/icon.png")!]
+        let firstLaunch = makeResolver()
+        _ = await firstLaunch.iconURL(forSlug: "akismet")
+        _ = await firstLaunch.iconURL(forSlug: "no-icon")
+        await firstLaunch.save()
+        let requestCount = server.requestCount
+
+        let secondLaunch = makeResolver()
+        #expect(await secondLaunch.iconURL(forSlug: "akismet") == URL(string: "https://ps.w.org/akismet/assets/icon.png"))
+        #expect(await secondLaunch.iconURL(forSlug: "no-icon") == nil)
+
+        #expect(directory.lookups.count == 2)
+        #expect(server.requestCount == requestCount)
+    }
+
+    @Test func resolvesExpiredIconsAgain() async {
+        let resolver = makeResolver()
+        _ = await resolver.iconURL(forSlug: "no-icon")
+        let candidate = PluginIconResolver.svnIconCandidates(slug: "no-icon")[1]
+        server.statusCodes[candidate] = 200
+
+        #expect(await resolver.iconURL(forSlug: "no-icon", now: .now.addingTimeInterval(60)) == nil)
+        #expect(await resolver.iconURL(forSlug: "no-icon", now: .now.addingTimeInterval(2 * 24 * 60 * 60)) == candidate)
+    }
+
+    @Test func doesNotRememberUnreachableServer() async {
+        server.isReachable = false
+        let resolver = makeResolver()
+        #expect(await resolver.iconURL(forSlug: "jetpack") == nil)
+
+        server.isReachable = true
+        let candidate = PluginIconResolver.svnIconCandidates(slug: "jetpack")[0]
+        server.statusCodes[candidate] = 200
+        #expect(await resolver.iconURL(forSlug: "jetpack") == candidate)
+    }
+
+    // MARK: - Helpers
+
+    private func makeResolver(maxConcurrentRequests: Int = 6) -> PluginIconResolver {
+        let configuration = URLSessionConfiguration.ephemeral
+        configuration.protocolClasses = [StubIconURLProtocol.self]
+        var resolverConfiguration = PluginIconResolver.Configuration()
+        resolverConfiguration.batchDelay = .milliseconds(100)
+        resolverConfiguration.maxConcurrentRequests = maxConcurrentRequests
+        let directory = self.directory
+        return PluginIconResolver(
+            urlSession: URLSession(configuration: configuration),
+            cache: cache,
+            configuration: resolverConfiguration
+        ) { slugs in
+            directory.lookUp(slugs)
+        }
+    }
+}
+
+private final class StubPluginDirectory: @unchecked Sendable {
+    private let lock = NSLock()
+    private var _icons: [String: URL] = [:]
+    private var _lookups: [[String]] = []
+
+    var icons: [String: URL] {
+        get { lock.withLock { _icons } }
+        set { lock.withLock { _icons = newValue } }
+    }
+
+    var lookups: [[String]] {
+        lock.withLock { _lookups }
+    }
+
+    func lookUp(_ slugs: [String]) -> [String: URL] {
+        lock.withLock {
+            _lookups.append(slugs)
+            return _icons.filter { slugs.contains($0.key) }
+        }
+    }
+}
+
+/// Responds to the HEAD requests with the given status codes, or 404.
+private final class StubIconServer: @unchecked Sendable {
+    private let lock = NSLock()
+    private var _statusCodes: [URL: Int] = [:]
+    private var _isReachable = true
+    private var _requestCount = 0
+    private var _concurrentRequests = 0
+    private var _maxConcurrentRequests = 0
+
+    var responseDelay: Duration = .zero
+
+    var statusCodes: [URL: Int] {
+        get { lock.withLock { _statusCodes } }
+        set { lock.withLock { _statusCodes = newValue } }
+    }
+
+    var isReachable: Bool {
+        get { lock.withLock { _isReachable } }
+        set { lock.withLock { _isReachable = newValue } }
+    }
+
+    var requestCount: Int {
+        lock.withLock { _requestCount }
+    }
+
+    var maxConcurrentRequests: Int {
+        lock.withLock { _maxConcurrentRequests }
+    }
+
+    /// Returns the status code, or `nil` if the server is unreachable.
+    func beginRequest(_ url: URL) -> Int? {
+        lock.withLock {
+            _requestCount += 1
+            _concurrentRequests += 1
+            _maxConcurrentRequests = max(_maxConcurrentRequests, _concurrentRequests)
+            return _isReachable ? _statusCodes[url] ?? 404 : nil
+        }
+    }
+
+    func endRequest() {
+        lock.withLock { _concurrentRequests -= 1 }
+    }
+}
+
+private final class StubIconURLProtocol: URLProtocol, @unchecked Sendable {
+    nonisolated(unsafe) static var server: StubIconServer?
+
+    override class func canInit(with request: URLRequest) -> Bool {
+        true
+    }
+
+    override class func canonicalRequest(for request: URLRequest) -> URLRequest {
+        request
+    }
+
+    override func startLoading() {
+        guard let server = Self.server, let url = request.url else {
+            client?.urlProtocol(self, didFailWithError: URLError(.unknown))
+            return
+        }
+        let statusCode = server.beginRequest(url)
+        let (seconds, attoseconds) = server.responseDelay.components
+        let delay = Double(seconds) + Double(attoseconds) / 1e18
+        DispatchQueue.global().asyncAfter(deadline: .now() + delay) { [self] in
+            server.endRequest()
+            guard let statusCode else {
+                client?.urlProtocol(self, didFailWithError: URLError(.notConnectedToInternet))
+                return
+            }
+            let response = HTTPURLResponse(url: url, statusCode: statusCode, httpVersion: nil, headerFields: nil)!
+            client?.urlProtocol(self, didReceive: response, cacheStoragePolicy: .notAllowed)
+            client?.urlProtocolDidFinishLoading(self)
+        }
+    }
+
+    override func stopLoading() {}
+}
+
+private actor InMemoryDiskCache: DiskCacheProtocol {
+    private var entries: [String: Data] = [:]
+
+    func read<T>(_ type: T.Type, forKey key: String, notOlderThan interval: TimeInterval?) throws -> T? where T: Decodable {
+        try entries[key].map { try JSONDecoder().decode(T.self, from: $0) }
+    }
+
+    func store<T>(_ value: T, forKey key: String) throws where T: Encodable {
+        entries[key] = try JSONEncoder().encode(value)
+    }
+
+    func remove(key: String) throws {
+        entries[key] = nil
+    }
+
+    func removeAll(progress: (@Sendable (CacheDeletionProgress) async throws -> Void)?) async throws {
+        entries.removeAll()
+    }
+
+    func count() async throws -> Int {
+        entries.count
+    }
+
+    func diskUsage() async throws -> DiskCacheUsage {
+        DiskCacheUsage(fileCount: entries.count, byteCount: Int64(entries.values.reduce(0) { $0 + $1.count }))
+    }
+}
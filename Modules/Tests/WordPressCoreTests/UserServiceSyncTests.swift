@@ -0,0 +1,211 @@
+import Foundation
+import Testing
+import WordPressAPI
+@testable import WordPressCore
+
+@Suite(.timeLimit(.minutes(1)))
+struct UserServiceSyncTests {
+
+    @Test
+    func testFetchesAllPages() async throws {
+        let server = StubUserServer(users: makeUsers(250))
+        let service = makeService(server: server)
+
+        try await service.fetchUsers()
+
+        #expect(try await service.allUsers().map(\.id) == server.users.map(\.id))
+        #expect(server.requestedPages.sorted() == [1, 2, 3])
+    }
+
+    @Test
+    func testFetchesLaterPagesConcurrently() async throws {
+        let server = StubUserServer(users: makeUsers(1_000), responseDelay: .milliseconds(20))
+        let service = makeService(server: server)
+
+        try await service.fetchUsers()
+
+        #expect(try await service.allUsers().count == 1_000)
+        #expect(server.maxConcurrentRequests > 1)
+        #expect(server.maxConcurrentRequests <= UserService.maxConcurrentPageRequests)
+    }
+
+    @Test
+    func testFetchesPagesSequentiallyWithoutTotal() async throws {
+        let server = StubUserServer(users: makeUsers(200), reportsTotalPages: false)
+        let service = makeService(server: server)
+
+        try await service.fetchUsers()
+
+        #expect(try await service.allUsers().count == 200)
+        #expect(server.requestedPages == [1, 2, 3])
+        #expect(server.maxConcurrentRequests == 1)
+    }
+
+    @Test
+    func testRemovesStaleUsersAfterLastPage() async throws {
+        let server = StubUserServer(users: makeUsers(250))
+        let service = makeService(server: server)
+        try await service.fetchUsers()
+
+        server.users.removeAll { $0.id == 10 || $0.id == 240 }
+        try await service.fetchUsers()
+
+        let ids = Set(try await service.allUsers().map(\.id))
+        #expect(ids.count == 248)
+        #expect(!ids.contains(10))
+        #expect(!ids.contains(240))
+    }
+
+    @Test
+    func testKeepsUsersWhenSyncFails() async throws {
+        let server = StubUserServer(users: makeUsers(250))
+        let service = makeService(server: server)
+        try await service.fetchUsers()
+
+        server.users.removeAll { $0.id == 10 }
+        server.failingPage = 3
+        await #expect(throws: URLError.self) {
+            try await service.fetchUsers()
+        }
+
+        #expect(try await service.allUsers().count == 250)
+    }
+
+    @Test
+    func testObserversNeverSeeListCollapse() async throws {
+        let server = StubUserServer(users: makeUsers(500), responseDelay: .milliseconds(5))
+        let service = makeService(server: server)
+        try await service.fetchUsers()
+
+        let stream = await service.streamAll()
+        let observer = Task {
+            var counts: [Int] = []
+            for await result in stream {
+                counts.append(try result.get().count)
+            }
+            return counts
+        }
+
+        server.users = server.users.map { makeUser(id: $0.id, displayName: "Renamed \($0.id)") }
+        try await service.fetchUsers()
+        try await Task.sleep(for: .milliseconds(100))
+        observer.cancel()
+
+        let counts = try await observer.value
+        #expect(counts.count > 1)
+        #expect(counts.allSatisfy { $0 == 500 })
+        #expect(try await service.allUsers().allSatisfy { $0.displayName.hasPrefix("Renamed") })
+    }
+
+    @Test
+    func testUnchangedUsersDoNotNotifyObservers() async throws {
+        let server = StubUserServer(users: makeUsers(250))
+        let service = makeService(server: server)
+        try await service.fetchUsers()
+
+        let stream = await service.streamAll()
+        let observer = Task {
+            var count = 0
+            for await _ in stream {
+                count += 1
+            }
+            return count
+        }
+
+        try await service.fetchUsers()
+        try await Task.sleep(for: .milliseconds(100))
+        observer.cancel()
+
+        // Only the initial result.
+        #expect(await observer.value == 1)
+    }
+
+    // MARK: - Helpers
+
+    private func makeService(server: StubUserServer) -> UserService {
+        let client = WordPressClient(api: MockWordPressClientAPI(), siteURL: URL(string: "https://example.com")!)
+        return UserService(client: client) { page, perPage in
+            try await server.fetchPage(page, perPage: perPage)
+        }
+    }
+}
+
+private func makeUsers(_ count: Int) -> [DisplayUser] {
+    (1...count).map { makeUser(id: Int64($0)) }
+}
+
+private func makeUser(id: Int64, displayName: String? = nil) -> DisplayUser {
+    DisplayUser(
+        id: id,
+        handle: "@user\(id)",
+        username: String(format: "user%05d", id),
+        firstName: "First",
+        lastName: "Last",
+        displayName: displayName ?? "User \(id)",
+        profilePhotoUrl: nil,
+        role: .subscriber,
+        emailAddress: "user\(id)@example.com",
+        websiteUrl: nil,
+        biography: nil
+    )
+}
+
+private final class StubUserServer: @unchecked Sendable {
+    private let lock = NSLock()
+    private var _users: [DisplayUser]
+    private var _failingPage: Int?
+    private var _requestedPages: [Int] = []
+    private var _concurrentRequests = 0
+    private var _maxConcurrentRequests = 0
+
+    let reportsTotalPages: Bool
+    let responseDelay: Duration
+
+    init(users: [DisplayUser], reportsTotalPages: Bool = true, responseDelay: Duration = .zero) {
+        self._users = users
+        self.reportsTotalPages = reportsTotalPages
+        self.responseDelay = responseDelay
+    }
+
+    var users: [DisplayUser] {
+        get { lock.withLock { _users } }
+        set { lock.withLock { _users = newValue } }
+    }
+
+    var failingPage: Int? {
+        get { lock.withLock { _failingPage } }
+        set { lock.withLock { _failingPage = newValue } }
+    }
+
+    var requestedPages: [Int] {
+        lock.withLock { _requestedPages }
+    }
+
+    var maxConcurrentRequests: Int {
+        lock.withLock { _maxConcurrentRequests }
+    }
+
+    func fetchPage(_ page: Int, perPage: Int) async throws -> UserService.UserPage {
+        let (users, isFailing) = lock.withLock {
+            _requestedPages.append(page)
+            _concurrentRequests += 1
+            _maxConcurrentRequests = max(_maxConcurrentRequests, _concurrentRequests)
+            return (_users, _failingPage == page)
+        }
+        defer {
+            lock.withLock { _concurrentRequests -= 1 }
+        }
+
+        try await Task.sleep(for: responseDelay)
+        if isFailing {
+            throw URLError(.timedOut)
+        }
+        let pageUsers = Array(users.dropFirst((page - 1) * perPage).prefix(perPage))
+        let totalPages = (users.count + perPage - 1) / perPage
+        return UserService.UserPage(
+            users: pageUsers,
+            fetchedCount: pageUsers.count,
+            totalPages: reportsTotalPages ? totalPages : nil
+        )
+    }
+}
@@ -0,0 +1,87 @@
+import CoreData
+import Testing
+@testable import WordPressData
+
+@MainActor
+struct ChangeDetectionTests {
+    private let contextManager = ContextManager.forTesting()
+    private var mainContext: NSManagedObjectContext { contextManager.mainContext }
+
+    @Test func setIfChangedSkipsEqualValues() throws {
+        let post = try makeSavedPost()
+
+        #expect(!post.setIfChanged(\.postTitle, "Title"))
+        #expect(!post.setIfChanged(\.likeCount, NSNumber(value: 10)))
+        #expect(!mainContext.hasChanges)
+
+        #expect(post.setIfChanged(\.postTitle, "New Title"))
+        #expect(mainContext.updatedObjects == [post])
+    }
+
+    @Test func setValueIfChangedSkipsEqualValues() throws {
+        let post = try makeSavedPost()
+
+        #expect(!post.setValueIfChanged("Title", forKey: "postTitle"))
+        #expect(!post.setValueIfChanged(nil, forKey: "summary"))
+        #expect(!mainContext.hasChanges)
+
+        #expect(post.setValueIfChanged(nil, forKey: "postTitle"))
+        #expect(post.postTitle == nil)
+        #expect(post.setValueIfChanged("Summary", forKey: "summary"))
+        #expect(post.summary == "Summary")
+    }
+
+    @Test func setObjectsIfChangedSkipsSameObjects() throws {
+        let post = PostBuilder(mainContext).build()
+        let categories = (1...3).map { makeCategory(id: $0, blog: post.blog) }
+        post.setObjectsIfChanged(objects(categories[0...1]), forRelationship: "categories")
+        try mainContext.save()
+
+        #expect(!post.setObjectsIfChanged(objects(categories[0...1]), forRelationship: "categories"))
+        #expect(!mainContext.hasChanges)
+
+        #expect(post.setObjectsIfChanged(objects(categories[1...2]), forRelationship: "categories"))
+        #expect(post.categories == Set(categories[1...2]))
+    }
+
+    @Test func statisticsCountRedundantUpdates() throws {
+        let post = try makeSavedPost()
+        let otherPost = try makeSavedPost()
+        let deletedPost = try makeSavedPost()
+
+        // WHEN one post is assigned its current value and the other is changed
+        post.postTitle = "Title"
+        otherPost.postTitle = "New Title"
+        mainContext.delete(deletedPost)
+        _ = NSEntityDescription.insertNewObject(forEntityName: ReaderPost.entityName(), into: mainContext)
+
+        // THEN
+        let statistics = ContextChangeStatistics(pendingChangesIn: mainContext)
+        #expect(statistics == ContextChangeStatistics(inserted: 1, updated: 1, redundantUpdates: 1, deleted: 1))
+        #expect(statistics.dirtyObjects == 4)
+    }
+
+    // MARK: - Helpers
+
+    private func makeSavedPost() throws -> ReaderPost {
+        let post = NSEntityDescription.insertNewObject(forEntityName: ReaderPost.entityName(), into: mainContext) as! ReaderPost
+        post.postTitle = "Title"
+        post.likeCount = 10
+        post.sortRank = 0
+        try mainContext.save()
+        return post
+    }
+
+    private func objects(_ categories: ArraySlice<PostCategory>) -> Set<NSManagedObject> {
+        Set(categories.map { $0 as NSManagedObject })
+    }
+
+    private func makeCategory(id: Int, blog: Blog) -> PostCategory {
+        let category = PostCategory(context: mainContext)
+        category.blog = blog
+        category.categoryID = NSNumber(value: id)
+        category.categoryName = "Category \(id)"
+        category.parentID = 0
+        return category
+    }
+}
@@ -305,6 +305,261 @@ class ContextManagerTests: XCTestCase {
         }, on: .main)
     }
 
+    func testWritesReusePooledContexts() {
+        let contextManager = ContextManager.forTesting()
+
+        let completed = (1...20).map { userID in
+            let expectation = self.expectation(description: "Account \(userID) saved")
+            contextManager.performAndSave({ context in
+                _ = WPAccount.fixture(context: context, userID: userID)
+            }, completion: { expectation.fulfill() }, on: .main)
+            return expectation
+        }
+        wait(for: completed, timeout: 1)
+
+        contextManager.performAndSave { context in
+            _ = WPAccount.fixture(context: context, userID: 21)
+        }
+
+        XCTAssertEqual(contextManager.contextPool.createdContextCount, 1)
+        XCTAssertEqual(contextManager.mainContext.countObjects(ofType: WPAccount.self), 21)
+    }
+
+    func testPooledContextDoesNotKeepObjectsOrChangesFromPreviousWrite() async throws {
+        let contextManager = ContextManager.forTesting()
+
+        do {
+            try await contextManager.performAndSave { context in
+                _ = WPAccount.fixture(context: context, userID: 1)
+                throw NSError.testInstance()
+            }
+            XCTFail("The above call should throw")
+        } catch {
+            // Expected
+        }
+
+        let (registeredObjects, accounts) = try await contextManager.performAndSave { context in
+            (context.registeredObjects.count, context.countObjects(ofType: WPAccount.self))
+        }
+        XCTAssertEqual(registeredObjects, 0)
+        XCTAssertEqual(accounts, 0)
+        XCTAssertEqual(contextManager.contextPool.createdContextCount, 1)
+    }
+
+    func testCoalescedWritesAreSavedInOneTransaction() throws {
+        let contextManager = ContextManager.forTesting()
+        let storeSaves = observeStoreSaves(in: contextManager)
+
+        // Keep the writer busy, so that the following writes are scheduled before any of them runs.
+        let writerBlocked = DispatchSemaphore(value: 0)
+        contextManager.performAndSave({ _ in writerBlocked.wait() }, completion: nil, on: .main)
+
+        let completed = (1...10).map { userID in
+            let expectation = self.expectation(description: "Account \(userID) saved")
+            contextManager.performAndSaveCoalesced({ context in
+                _ = WPAccount.fixture(context: context, userID: userID)
+                return userID
+            }, completion: { result in
+                XCTAssertEqual(try? result.get(), userID)
+                XCTAssertEqual(contextManager.mainContext.countObjects(ofType: WPAccount.self), 10)
+                expectation.fulfill()
+            }, on: .main)
+            return expectation
+        }
+        writerBlocked.signal()
+        wait(for: completed, timeout: 1, enforceOrder: true)
+
+        XCTAssertEqual(storeSaves.count, 1)
+    }
+
+    func testCoalescedWriteErrorOnlyDiscardsItsChanges() throws {
+        let contextManager = ContextManager.forTesting()
+        let writerBlocked = DispatchSemaphore(value: 0)
+        contextManager.performAndSave({ _ in writerBlocked.wait() }, completion: nil, on: .main)
+
+        let expectedError = NSError.testInstance()
+        var results = [Result<Int, Error>]()
+        let completed = expectation(description: "All writes completed")
+        completed.expectedFulfillmentCount = 3
+        let write: (NSManagedObjectContext, Int) throws -> Int = { context, userID in
+            _ = WPAccount.fixture(context: context, userID: userID, username: "User \(userID)")
+            if userID == 2 {
+                throw expectedError
+            }
+            // The write sees the changes made by the earlier writes in the same batch
+            return context.countObjects(ofType: WPAccount.self)
+        }
+        for userID in 1...3 {
+            contextManager.performAndSaveCoalesced({ try write($0, userID) }, completion: {
+                results.append($0)
+                completed.fulfill()
+            }, on: .main)
+        }
+        writerBlocked.signal()
+        wait(for: [completed], timeout: 1)
+
+        XCTAssertEqual(try results[0].get(), 1)
+        XCTAssertThrowsError(try results[1].get()) { error in
+            XCTAssertEqual(error as NSError, expectedError)
+        }
+        XCTAssertEqual(try results[2].get(), 2)
+
+        let usernames = try contextManager.mainContext.fetch(WPAccount.fetchRequest()).map(\.username)
+        XCTAssertEqual(Set(usernames), ["User 1", "User 3"])
+    }
+
+    func testCoalescedWriteReportsSaveError() throws {
+        let contextManager = ContextManager.forTesting()
+        let completed = expectation(description: "Write completed")
+
+        contextManager.performAndSaveCoalesced({ context in
+            // A blog without the mandatory URLs fails the validation.
+            _ = NSEntityDescription.insertNewObject(forEntityName: Blog.entityName(), into: context)
+        }, completion: { result in
+            XCTAssertThrowsError(try result.get())
+            completed.fulfill()
+        }, on: .main)
+        wait(for: [completed], timeout: 1)
+
+        XCTAssertEqual(contextManager.mainContext.countObjects(ofType: Blog.self), 0)
+    }
+
+    func testCoalescedWriteSaveErrorOnlyFailsItsWrite() throws {
+        let contextManager = ContextManager.forTesting()
+        let writerBlocked = DispatchSemaphore(value: 0)
+        contextManager.performAndSave({ _ in writerBlocked.wait() }, completion: nil, on: .main)
+
+        var results = [Result<NSManagedObjectID, Error>]()
+        let completed = expectation(description: "All writes completed")
+        completed.expectedFulfillmentCount = 3
+        for userID in 1...3 {
+            contextManager.performAndSaveCoalesced({ context in
+                if userID == 2 {
+                    let blog = NSEntityDescription.insertNewObject(forEntityName: Blog.entityName(), into: context)
+                    return blog.objectID
+                }
+                return WPAccount.fixture(context: context, userID: userID).objectID
+            }, completion: {
+                results.append($0)
+                completed.fulfill()
+            }, on: .main)
+        }
+        writerBlocked.signal()
+        wait(for: [completed], timeout: 1)
+
+        XCTAssertThrowsError(try results[1].get())
+        XCTAssertEqual(contextManager.mainContext.countObjects(ofType: WPAccount.self), 2)
+        XCTAssertEqual(contextManager.mainContext.countObjects(ofType: Blog.self), 0)
+    }
+
+    func testCoalescedWritesGetPermanentObjectIDs() throws {
+        let contextManager = ContextManager.forTesting()
+        let writerBlocked = DispatchSemaphore(value: 0)
+        contextManager.performAndSave({ _ in writerBlocked.wait() }, completion: nil, on: .main)
+
+        var objects = [WPAccount]()
+        let completed = expectation(description: "All writes completed")
+        completed.expectedFulfillmentCount = 3
+        for userID in 1...3 {
+            contextManager.performAndSaveCoalesced({ context in
+                WPAccount.fixture(context: context, userID: userID)
+            }, completion: {
+                if let account = try? $0.get() {
+                    objects.append(account)
+                }
+                completed.fulfill()
+            }, on: .main)
+        }
+        writerBlocked.signal()
+        wait(for: [completed], timeout: 1)
+
+        XCTAssertEqual(objects.count, 3)
+        for account in objects {
+            XCTAssertFalse(account.objectID.isTemporaryID)
+            XCTAssertNoThrow(try contextManager.mainContext.existingObject(with: account.objectID))
+        }
+    }
+
+    func testCoalescedWritesKeepOrderWithOtherWrites() {
+        let contextManager = ContextManager.forTesting()
+        let writerBlocked = DispatchSemaphore(value: 0)
+        contextManager.performAndSave({ _ in writerBlocked.wait() }, completion: nil, on: .main)
+
+        var order = [String]()
+        let completed = expectation(description: "All writes completed")
+        completed.expectedFulfillmentCount = 3
+        contextManager.performAndSaveCoalesced({ _ in "first" }, completion: {
+            order.append(try! $0.get())
+            completed.fulfill()
+        }, on: .main)
+        contextManager.performAndSave({ _ in "second" }, completion: {
+            order.append($0)
+            completed.fulfill()
+        }, on: .main)
+        contextManager.performAndSaveCoalesced({ _ in "third" }, completion: {
+            order.append(try! $0.get())
+            completed.fulfill()
+        }, on: .main)
+        writerBlocked.signal()
+        wait(for: [completed], timeout: 1)
+
+        XCTAssertEqual(order, ["first", "second", "third"])
+    }
+
+    // MARK: - Launch-time benchmarks
+
+    /// Simulates the small writes made by the different syncs during app launch.
+    func testPerformanceOfSeparateLaunchWrites() {
+        let contextManager = ContextManager.forTesting()
+        var userID = 0
+        measure {
+            let completed = expectation(description: "All writes completed")
+            completed.expectedFulfillmentCount = 50
+            for _ in 1...50 {
+                userID += 1
+                contextManager.performAndSave({ [userID] context in
+                    _ = WPAccount.fixture(context: context, userID: userID)
+                }, completion: { completed.fulfill() }, on: .main)
+            }
+            wait(for: [completed], timeout: 10)
+        }
+    }
+
+    func testPerformanceOfCoalescedLaunchWrites() {
+        let contextManager = ContextManager.forTesting()
+        var userID = 0
+        measure {
+            let completed = expectation(description: "All writes completed")
+            completed.expectedFulfillmentCount = 50
+            for _ in 1...50 {
+                userID += 1
+                contextManager.performAndSaveCoalesced({ [userID] context in
+                    _ = WPAccount.fixture(context: context, userID: userID)
+                }, completion: { _ in completed.fulfill() }, on: .main)
+            }
+            wait(for: [completed], timeout: 10)
+        }
+    }
+
+    /// Returns the list of the changes saved into the store by the background contexts.
+    private func observeStoreSaves(in contextManager: ContextManager) -> StoreSaves {
+        let saves = StoreSaves()
+        let coordinator = contextManager.mainContext.persistentStoreCoordinator
+        let observer = NotificationCenter.default.addObserver(forName: .NSManagedObjectContextDidSave, object: nil, queue: nil) { notification in
+            guard let context = notification.object as? NSManagedObjectContext,
+                  context.parent == nil,
+                  context !== contextManager.mainContext,
+                  context.persistentStoreCoordinator === coordinator else {
+                return
+            }
+            saves.append()
+        }
+        addTeardownBlock {
+            NotificationCenter.default.removeObserver(observer)
+        }
+        return saves
+    }
+
     private func newAccountInContext(context: NSManagedObjectContext) -> WPAccount {
         let account = NSEntityDescription.insertNewObject(forEntityName: WPAccount.entityName(), into: context) as! WPAccount
         account.username = "username"
@@ -366,3 +621,20 @@ class ContextManagerTests: XCTestCase {
         return url
     }
 }
+
+private final class StoreSaves: @unchecked Sendable {
+    private let lock = NSLock()
+    private var _count = 0
+
+    var count: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return _count
+    }
+
+    func append() {
+        lock.lock()
+        defer { lock.unlock() }
+        _count += 1
+    }
+}
@@ -157,6 +157,217 @@ struct CoreDataMigrationTests {
         #expect(fetchedKeys == moderationKeys)
     }
 
+    @Test func planCollapsesLightweightSteps() throws {
+        let modelNames = sortedModelNames()
+        let sourceName = modelNames[modelNames.count - 8]
+        let metadata = try storeMetadata(forModelNamed: sourceName)
+        let targetModel = try loadModel(named: try #require(modelNames.last))
+
+        var loadedNames = [String]()
+        let plan = try CoreDataMigrationPlan(storeMetadata: metadata, targetModel: targetModel, modelNames: modelNames) { name in
+            loadedNames.append(name)
+            return try loadModel(named: name)
+        }
+
+        // Only the models from the store's version to the target are loaded.
+        #expect(loadedNames == Array(modelNames.suffix(8).reversed()))
+        #expect(plan.loadedVersionNames == loadedNames)
+        #expect(plan.steps.count < 7)
+        #expect(plan.steps.allSatisfy(\.isLightweight))
+        #expect(versionPath(of: plan) == Array(modelNames.suffix(8)))
+    }
+
+    @Test func planRunsCustomMappingsOnTheirOwn() throws {
+        let modelNames = sortedModelNames()
+        let path = Array(modelNames.suffix(6))
+        let metadata = try storeMetadata(forModelNamed: path[0])
+        let targetModel = try loadModel(named: path[5])
+        let customSource = try loadModel(named: path[2])
+        let customDestination = try loadModel(named: path[3])
+
+        let plan = try CoreDataMigrationPlan(
+            storeMetadata: metadata,
+            targetModel: targetModel,
+            modelNames: modelNames,
+            loadModel: loadModel(named:),
+            customMappingModel: { source, destination in
+                guard source.isEqual(customSource), destination.isEqual(customDestination) else {
+                    return nil
+                }
+                return try? NSMappingModel.inferredMappingModel(forSourceModel: source, destinationModel: destination)
+            }
+        )
+
+        let customSteps = plan.steps.filter { !$0.isLightweight }
+        #expect(customSteps.map(\.versionNames) == [[path[2], path[3]]])
+        #expect(plan.steps.first?.versionNames == Array(path[0...2]))
+        #expect(versionPath(of: plan) == path)
+    }
+
+    @Test func planDoesNotSkipVersionsThatRemoveAnAttribute() throws {
+        let source = makeModel(attributes: ["title", "status"])
+        let skipped = makeModel(attributes: ["title"])
+        let destination = makeModel(attributes: ["title", "status"])
+
+        // Skipping the version that removed `status` would keep the old values.
+        #expect(!CoreDataMigrationPlan.canSkip(skipped, from: source, to: destination))
+        #expect(CoreDataMigrationPlan.canSkip(destination, from: source, to: destination))
+        #expect(CoreDataMigrationPlan.canSkip(skipped, from: skipped, to: destination))
+    }
+
+    @Test func migrationAcrossSeveralVersions() throws {
+        let modelNames = sortedModelNames()
+        let sourceName = modelNames[modelNames.count - 8]
+        let storeUrl = storeURL(named: "WordPressSeveralVersions.sqlite")
+        try makeStore(at: storeUrl, modelNamed: sourceName, blogCount: 10)
+
+        let targetModel = try loadModel(named: try #require(modelNames.last))
+        let progress = Progress()
+        try CoreDataIterativeMigrator.iterativeMigrate(
+            sourceStore: storeUrl,
+            storeType: NSSQLiteStoreType,
+            to: targetModel,
+            using: modelNames,
+            progress: progress
+        )
+
+        #expect(progress.fractionCompleted == 1)
+        let metadata = try NSPersistentStoreCoordinator.metadataForPersistentStore(ofType: NSSQLiteStoreType, at: storeUrl)
+        #expect(targetModel.isConfiguration(withName: nil, compatibleWithStoreMetadata: metadata))
+
+        let folder = storeUrl.deletingLastPathComponent()
+        #expect(!FileManager.default.fileExists(atPath: folder.appendingPathComponent("migration-backup").path))
+        #expect(!FileManager.default.fileExists(atPath: folder.appendingPathComponent("migration").path))
+
+        let psc = NSPersistentStoreCoordinator(managedObjectModel: targetModel)
+        _ = try psc.addPersistentStore(ofType: NSSQLiteStoreType, configurationName: nil, at: storeUrl, options: nil)
+        let context = NSManagedObjectContext(concurrencyType: .mainQueueConcurrencyType)
+        context.persistentStoreCoordinator = psc
+        #expect(try context.count(for: NSFetchRequest<NSManagedObject>(entityName: "Blog")) == 10)
+    }
+
+    @Test func failedMigrationRestoresTheStore() throws {
+        let modelNames = sortedModelNames()
+        let sourceName = modelNames[modelNames.count - 3]
+        let storeUrl = storeURL(named: "WordPressFailedMigration.sqlite")
+        try makeStore(at: storeUrl, modelNamed: sourceName, blogCount: 1)
+        let originalMetadata = try NSPersistentStoreCoordinator.metadataForPersistentStore(ofType: NSSQLiteStoreType, at: storeUrl)
+
+        // The target isn't in the list of models, so the migration fails before touching the store.
+        let targetModel = makeModel(attributes: ["title"])
+        #expect(throws: NSError.self) {
+            try CoreDataIterativeMigrator.iterativeMigrate(
+                sourceStore: storeUrl,
+                storeType: NSSQLiteStoreType,
+                to: targetModel,
+                using: modelNames
+            )
+        }
+
+        let metadata = try NSPersistentStoreCoordinator.metadataForPersistentStore(ofType: NSSQLiteStoreType, at: storeUrl)
+        #expect(NSDictionary(dictionary: metadata).isEqual(to: originalMetadata))
+    }
+
+    @Test func failedStepLeavesTheStoreUntouched() throws {
+        let modelNames = sortedModelNames()
+        let path = Array(modelNames.suffix(4))
+        let storeUrl = storeURL(named: "WordPressFailedStep.sqlite")
+        try makeStore(at: storeUrl, modelNamed: path[0], blogCount: 1)
+        let originalMetadata = try NSPersistentStoreCoordinator.metadataForPersistentStore(ofType: NSSQLiteStoreType, at: storeUrl)
+
+        // A custom mapping for the last version makes a plan of several steps.
+        let customSource = try loadModel(named: path[2])
+        let plan = try CoreDataMigrationPlan(
+            storeMetadata: originalMetadata,
+            targetModel: try loadModel(named: path[3]),
+            modelNames: modelNames,
+            loadModel: loadModel(named:),
+            customMappingModel: { source, destination in
+                guard source.isEqual(customSource) else {
+                    return nil
+                }
+                return try? NSMappingModel.inferredMappingModel(forSourceModel: source, destinationModel: destination)
+            }
+        )
+        try #require(plan.steps.count >= 2)
+
+        var migratedSteps = 0
+        #expect(throws: NSError.self) {
+            try CoreDataIterativeMigrator.migrateStore(at: storeUrl, storeType: NSSQLiteStoreType, following: plan, progress: nil) { sourceURL, destinationURL, step in
+                guard migratedSteps < plan.steps.count - 1 else {
+                    throw CocoaError(.fileWriteOutOfSpace)
+                }
+                try CoreDataIterativeMigrator.migrateStore(from: sourceURL, to: destinationURL, storeType: NSSQLiteStoreType, with: step, progress: nil)
+                migratedSteps += 1
+            }
+        }
+
+        #expect(migratedSteps == plan.steps.count - 1)
+        let metadata = try NSPersistentStoreCoordinator.metadataForPersistentStore(ofType: NSSQLiteStoreType, at: storeUrl)
+        #expect(NSDictionary(dictionary: metadata).isEqual(to: originalMetadata))
+        let folder = storeUrl.deletingLastPathComponent()
+        #expect(!FileManager.default.fileExists(atPath: folder.appendingPathComponent("migration").path))
+        #expect(!FileManager.default.fileExists(atPath: folder.appendingPathComponent("migration-backup").path))
+    }
+
+    @Test func interruptedReplacementIsRestored() throws {
+        let modelNames = sortedModelNames()
+        let sourceName = modelNames[modelNames.count - 3]
+        let storeUrl = storeURL(named: "WordPressInterrupted.sqlite")
+        try makeStore(at: storeUrl, modelNamed: sourceName, blogCount: 1)
+        let originalMetadata = try NSPersistentStoreCoordinator.metadataForPersistentStore(ofType: NSSQLiteStoreType, at: storeUrl)
+
+        // The original files were moved to the backup, and a migrated file was partially written.
+        let fileManager = FileManager.default
+        let folder = storeUrl.deletingLastPathComponent()
+        let backupUrl = folder.appendingPathComponent("migration-backup")
+        try fileManager.createDirectory(at: backupUrl, withIntermediateDirectories: false)
+        for file in try fileManager.contentsOfDirectory(atPath: folder.path) where file.hasPrefix(storeUrl.lastPathComponent) {
+            try fileManager.moveItem(at: folder.appendingPathComponent(file), to: backupUrl.appendingPathComponent(file))
+        }
+        try Data().write(to: backupUrl.appendingPathComponent(".complete"))
+        try Data("partial".utf8).write(to: storeUrl)
+
+        try CoreDataIterativeMigrator.iterativeMigrate(
+            sourceStore: storeUrl,
+            storeType: NSSQLiteStoreType,
+            to: try loadModel(named: sourceName),
+            using: modelNames
+        )
+
+        let metadata = try NSPersistentStoreCoordinator.metadataForPersistentStore(ofType: NSSQLiteStoreType, at: storeUrl)
+        #expect(NSDictionary(dictionary: metadata).isEqual(to: originalMetadata))
+        #expect(!fileManager.fileExists(atPath: backupUrl.path))
+    }
+
+    @Test func migrationAcrossManyVersionsTakesFewSteps() throws {
+        let modelNames = sortedModelNames()
+        let path = Array(modelNames.suffix(12))
+        let storeUrl = storeURL(named: "WordPressManyVersions.sqlite")
+        try makeStore(at: storeUrl, modelNamed: path[0], blogCount: 10)
+        let targetModel = try loadModel(named: try #require(path.last))
+        let plan = try CoreDataMigrationPlan(
+            storeMetadata: try NSPersistentStoreCoordinator.metadataForPersistentStore(ofType: NSSQLiteStoreType, at: storeUrl),
+            targetModel: targetModel,
+            modelNames: modelNames,
+            loadModel: loadModel(named:)
+        )
+
+        let progress = Progress()
+        try CoreDataIterativeMigrator.iterativeMigrate(
+            sourceStore: storeUrl,
+            storeType: NSSQLiteStoreType,
+            to: targetModel,
+            using: modelNames,
+            progress: progress
+        )
+
+        // One step per run of lightweight versions, instead of one per version.
+        #expect(plan.steps.count < path.count - 1)
+        #expect(progress.totalUnitCount == Int64(plan.steps.count))
+        #expect(progress.fractionCompleted == 1)
+    }
+
     // MARK: - Helpers
 
     private func urlForModel(name: String) -> URL? {
@@ -178,10 +389,64 @@ struct CoreDataMigrationTests {
         return url
     }
 
+    /// A store in its own folder, as the migrator writes its backup next to the store.
     private func storeURL(named fileName: String) -> URL {
-        let url = FileManager.default.temporaryDirectory.appendingPathComponent(fileName)
-        try? FileManager.default.removeItem(at: url)
-        return url
+        let folder = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        try? FileManager.default.createDirectory(at: folder, withIntermediateDirectories: true)
+        return folder.appendingPathComponent(fileName)
+    }
+
+    private func sortedModelNames() -> [String] {
+        let modelFileURL = Bundle.wordPressData.url(forResource: "WordPress", withExtension: "momd")
+        let versionInfo = modelFileURL.flatMap { NSDictionary(contentsOf: $0.appendingPathComponent("VersionInfo.plist")) }
+        let versionHashes = versionInfo?["NSManagedObjectModel_VersionHashes"] as? [String: AnyObject] ?? [:]
+        return versionHashes.keys.sorted { $0.compare($1, options: .numeric) == .orderedAscending }
+    }
+
+    private func loadModel(named name: String) throws -> NSManagedObjectModel {
+        let url = try #require(urlForModel(name: name))
+        return try #require(NSManagedObjectModel(contentsOf: url))
+    }
+
+    private func makeStore(at storeUrl: URL, modelNamed name: String, blogCount: Int) throws {
+        let psc = NSPersistentStoreCoordinator(managedObjectModel: try loadModel(named: name))
+        let store = try psc.addPersistentStore(ofType: NSSQLiteStoreType, configurationName: nil, at: storeUrl, options: nil)
+        let context = NSManagedObjectContext(concurrencyType: .mainQueueConcurrencyType)
+        context.persistentStoreCoordinator = psc
+        for index in 0..<blogCount {
+            let blog = insertDummyBlog(in: context, blogID: NSNumber(value: index))
+            _ = insertDummyPost(in: context, blog: blog)
+        }
+        try context.save()
+        try psc.remove(store)
+    }
+
+    private func storeMetadata(forModelNamed name: String) throws -> [String: Any] {
+        let storeUrl = storeURL(named: "\(name).sqlite")
+        try makeStore(at: storeUrl, modelNamed: name, blogCount: 0)
+        return try NSPersistentStoreCoordinator.metadataForPersistentStore(ofType: NSSQLiteStoreType, at: storeUrl)
+    }
+
+    /// The versions the plan goes through, in order.
+    private func versionPath(of plan: CoreDataMigrationPlan) -> [String] {
+        plan.steps.reduce(into: [String]()) { path, step in
+            path += path.isEmpty ? step.versionNames : Array(step.versionNames.dropFirst())
+        }
+    }
+
+    private func makeModel(attributes: [String]) -> NSManagedObjectModel {
+        let entity = NSEntityDescription()
+        entity.name = "Post"
+        entity.properties = attributes.map { name in
+            let attribute = NSAttributeDescription()
+            attribute.name = name
+            attribute.attributeType = .stringAttributeType
+            attribute.isOptional = true
+            return attribute
+        }
+        let model = NSManagedObjectModel()
+        model.entities = [entity]
+        return model
     }
 
     private func insertDummyBlog(in context: NSManagedObjectContext, blogID: NSNumber) -> NSManagedObject {
@@ -265,6 +265,60 @@ struct ReaderPostMappingTests {
 
         try mainContext.save()
     }
+
+    // MARK: - Change detection
+
+    @Test func refreshWithSameValuesLeavesPostClean() throws {
+        // GIVEN a saved post with all the relationships the mapping manages
+        let topic = makeTopic(ReaderTagTopic.self, path: "/tags/test", title: "Test")
+        let post = makeReaderPost()
+        post.update(with: makeRemotePostWithRelationships(), isExisting: false, topic: topic, in: mainContext)
+        try mainContext.save()
+
+        // WHEN the same post is received again
+        post.update(with: makeRemotePostWithRelationships(), isExisting: true, topic: topic, in: mainContext)
+
+        // THEN nothing is written
+        #expect(!mainContext.hasChanges)
+        #expect(ContextChangeStatistics(pendingChangesIn: mainContext) == ContextChangeStatistics())
+    }
+
+    @Test func refreshUpdatesOnlyChangedPosts() throws {
+        let topic = makeTopic(ReaderTagTopic.self, path: "/tags/test", title: "Test")
+        let posts = (0..<3).map { _ in makeReaderPost() }
+        let remotePosts = (0..<3).map { index in
+            let remotePost = makeRemotePostWithRelationships()
+            remotePost.globalID = "global-id-\(index)"
+            return remotePost
+        }
+        for (post, remotePost) in zip(posts, remotePosts) {
+            post.update(with: remotePost, isExisting: false, topic: topic, in: mainContext)
+        }
+        try mainContext.save()
+
+        // WHEN only one of the posts changed on the server
+        remotePosts[1].likeCount = 11
+        for (post, remotePost) in zip(posts, remotePosts) {
+            post.update(with: remotePost, isExisting: true, topic: topic, in: mainContext)
+        }
+
+        // THEN
+        #expect(mainContext.updatedObjects == [posts[1]])
+        #expect(posts[1].changedValues().keys.sorted() == ["likeCount"])
+        #expect(ContextChangeStatistics(pendingChangesIn: mainContext) == ContextChangeStatistics(updated: 1))
+    }
+
+    @Test func removingRelationshipsIsWritten() throws {
+        let post = makeReaderPost()
+        post.update(with: makeRemotePostWithRelationships(), isExisting: false, topic: nil, in: mainContext)
+        try mainContext.save()
+
+        post.update(with: makeRemotePost(), isExisting: true, topic: nil, in: mainContext)
+
+        #expect(post.crossPostMeta == nil)
+        #expect(post.sourceAttribution == nil)
+        #expect(post.hasChanges)
+    }
 }
 
 // MARK: - Helpers
@@ -341,4 +395,25 @@ private extension ReaderPostMappingTests {
 
         return post
     }
+
+    func makeRemotePostWithRelationships() -> RemoteReaderPost {
+        let post = makeRemotePost()
+        post.autoSuggestedFeaturedImage = "https://example.com/auto-image.jpg"
+        post.primaryTag = "Swift"
+        post.primaryTagSlug = "swift"
+
+        let crossPostMeta = RemoteReaderCrossPostMeta()
+        crossPostMeta.siteURL = "https://cross.example.com"
+        crossPostMeta.postURL = "https://cross.example.com/post"
+        crossPostMeta.siteID = 999
+        crossPostMeta.postID = 888
+        post.setValue(crossPostMeta, forKey: "crossPostMeta")
+
+        let attribution = RemoteSourcePostAttribution()
+        attribution.authorName = "Jane"
+        attribution.blogID = 42
+        attribution.taxonomies = ["site-pick"]
+        post.sourceAttribution = attribution
+        return post
+    }
 }
@@ -0,0 +1,226 @@
+import CoreData
+import XCTest
+
+@testable import WordPressData
+
+class PersistentHistoryTrackerTests: XCTestCase {
+    private var storeURL: URL!
+
+    override func setUpWithError() throws {
+        storeURL = URL.Helpers.temporaryFile(named: "PersistentHistoryTrackerTests-\(UUID().uuidString).sqlite")
+    }
+
+    override func tearDownWithError() throws {
+        let directory = storeURL.deletingLastPathComponent()
+        let files = try FileManager.default.contentsOfDirectory(atPath: directory.path)
+        for file in files where file.hasPrefix(storeURL.lastPathComponent) {
+            try FileManager.default.removeItem(at: directory.appendingPathComponent(file))
+        }
+    }
+
+    func testChangesFromAnotherCoordinatorAreMergedIntoMainContext() throws {
+        let contextManager = ContextManager(modelName: ContextManagerModelNameCurrent, store: storeURL)
+        contextManager.performAndSave { context in
+            _ = WPAccount.fixture(context: context, userID: 1, username: "First")
+            _ = WPAccount.fixture(context: context, userID: 2, username: "Second")
+        }
+        let accounts = try makeAccountsController(in: contextManager.mainContext)
+        XCTAssertEqual(userIDs(in: accounts), [1, 2])
+
+        // WHEN another coordinator changes the store
+        let otherContainer = try makeContainer(sharing: contextManager)
+        let otherContext = otherContainer.viewContext
+        let first = try XCTUnwrap(WPAccount.lookup(withUserID: 1, in: otherContext))
+        first.mockKeychain()
+        first.username = "First (Updated)"
+        try otherContext.delete(XCTUnwrap(WPAccount.lookup(withUserID: 2, in: otherContext)))
+        _ = WPAccount.fixture(context: otherContext, userID: 3, username: "Third")
+        try otherContext.save()
+
+        contextManager.persistentHistory.processNewTransactions()
+
+        // THEN the main context and its fetched results controllers are updated
+        let merged = expectation(for: NSPredicate { _, _ in
+            self.userIDs(in: accounts) == [1, 3] && accounts.fetchedObjects?.first?.username == "First (Updated)"
+        }, evaluatedWith: nil)
+        wait(for: [merged], timeout: 5)
+    }
+
+    func testOwnSavesAreNotMergedAgain() throws {
+        let contextManager = ContextManager(modelName: ContextManagerModelNameCurrent, store: storeURL)
+        contextManager.performAndSave { context in
+            _ = WPAccount.fixture(context: context, userID: 1)
+        }
+
+        XCTAssertTrue(contextManager.persistentHistory.processNewTransactions().isEmpty)
+    }
+
+    func testBatchRequestsAreMergedIntoMainContext() throws {
+        let contextManager = ContextManager(modelName: ContextManagerModelNameCurrent, store: storeURL)
+        contextManager.performAndSave { context in
+            for userID in 1...3 {
+                _ = WPAccount.fixture(context: context, userID: userID)
+            }
+        }
+        let accounts = try makeAccountsController(in: contextManager.mainContext)
+        XCTAssertEqual(userIDs(in: accounts), [1, 2, 3])
+
+        contextManager.performAndSave { context in
+            let request = NSFetchRequest<NSFetchRequestResult>(entityName: WPAccount.entityName())
+            request.predicate = NSPredicate(format: "userID = 2")
+            XCTAssertNoThrow(try context.executeBatchRequest(NSBatchDeleteRequest(fetchRequest: request)))
+        }
+        contextManager.persistentHistory.processNewTransactions()
+
+        let merged = expectation(for: NSPredicate { _, _ in
+            self.userIDs(in: accounts) == [1, 3]
+        }, evaluatedWith: nil)
+        wait(for: [merged], timeout: 5)
+    }
+
+    func testProcessedTokenIsKeptAcrossLaunches() throws {
+        let tokenURL = storeURL.appendingPathExtension("test-token")
+        let appContainer = try makeContainer(storeURL: storeURL)
+        let otherContainer = try makeContainer(storeURL: storeURL)
+
+        // The app processes the changes made by another coordinator
+        let firstLaunch = makeTracker(for: appContainer, tokenURL: tokenURL)
+        try insertAccount(userID: 1, in: otherContainer.viewContext)
+        XCTAssertEqual(firstLaunch.processNewTransactions().inserted.count, 1)
+
+        // The next launch only processes the changes made after that
+        let secondLaunch = makeTracker(for: appContainer, tokenURL: tokenURL)
+        XCTAssertTrue(secondLaunch.processNewTransactions().isEmpty)
+
+        try insertAccount(userID: 2, in: otherContainer.viewContext)
+        XCTAssertEqual(secondLaunch.processNewTransactions().inserted.count, 1)
+    }
+
+    func testPruningDeletesOldTransactions() throws {
+        let container = try makeContainer(storeURL: storeURL)
+        let tracker = makeTracker(for: container, tokenURL: nil)
+        try insertAccount(userID: 1, in: container.viewContext)
+        XCTAssertEqual(try transactionCount(in: container), 1)
+
+        tracker.pruneHistory(before: Date().addingTimeInterval(-60))
+        XCTAssertEqual(try transactionCount(in: container), 1)
+
+        tracker.pruneHistory(before: Date().addingTimeInterval(1))
+        XCTAssertEqual(try transactionCount(in: container), 0)
+    }
+
+    // MARK: - Foreground refresh benchmarks
+
+    /// The changes made by another coordinator are picked up by refreshing every object in the main context.
+    func testPerformanceOfForegroundRefreshWithoutHistory() throws {
+        let (contextManager, otherContainer, accounts) = try makeForegroundRefreshFixture()
+        var iteration = 0
+        measureMetrics([.wallClockTime], automaticallyStartMeasuring: false) {
+            iteration += 1
+            try? updateAccounts(in: otherContainer, iteration: iteration)
+
+            startMeasuring()
+            contextManager.mainContext.refreshAllObjects()
+            try? accounts.performFetch()
+            accounts.fetchedObjects?.forEach { _ = $0.username }
+            stopMeasuring()
+        }
+    }
+
+    /// The changes made by another coordinator are picked up by merging the changed objects.
+    func testPerformanceOfForegroundRefreshWithHistory() throws {
+        let (contextManager, otherContainer, accounts) = try makeForegroundRefreshFixture()
+        var iteration = 0
+        measureMetrics([.wallClockTime], automaticallyStartMeasuring: false) {
+            iteration += 1
+            try? updateAccounts(in: otherContainer, iteration: iteration)
+
+            startMeasuring()
+            contextManager.persistentHistory.processNewTransactions()
+            accounts.fetchedObjects?.forEach { _ = $0.username }
+            stopMeasuring()
+        }
+    }
+
+    // MARK: - Helpers
+
+    private func makeForegroundRefreshFixture() throws -> (ContextManager, NSPersistentContainer, NSFetchedResultsController<WPAccount>) {
+        let contextManager = ContextManager(modelName: ContextManagerModelNameCurrent, store: storeURL)
+        contextManager.performAndSave { context in
+            for userID in 1...1000 {
+                _ = WPAccount.fixture(context: context, userID: userID, username: "User \(userID)")
+            }
+        }
+        let accounts = try makeAccountsController(in: contextManager.mainContext)
+        return (contextManager, try makeContainer(sharing: contextManager), accounts)
+    }
+
+    /// Simulates another coordinator updating a few accounts.
+    private func updateAccounts(in container: NSPersistentContainer, iteration: Int) throws {
+        let context = container.viewContext
+        for userID in 1...5 {
+            let account = try XCTUnwrap(WPAccount.lookup(withUserID: Int64(userID * 100), in: context))
+            account.mockKeychain()
+            account.username = "User \(userID * 100) (\(iteration))"
+        }
+        try context.save()
+    }
+
+    private func makeContainer(sharing contextManager: ContextManager) throws -> NSPersistentContainer {
+        try makeContainer(storeURL: storeURL, model: XCTUnwrap(contextManager.mainContext.persistentStoreCoordinator?.managedObjectModel))
+    }
+
+    /// Creates a Core Data stack with its own coordinator opening the same store.
+    private func makeContainer(storeURL: URL, model: NSManagedObjectModel? = nil) throws -> NSPersistentContainer {
+        let model = try model ?? XCTUnwrap(ContextManager.forTesting().mainContext.persistentStoreCoordinator?.managedObjectModel)
+        let container = NSPersistentContainer(name: "WordPress", managedObjectModel: model)
+        let description = NSPersistentStoreDescription(url: storeURL)
+        description.setOption(true as NSNumber, forKey: NSPersistentHistoryTrackingKey)
+        description.setOption(true as NSNumber, forKey: NSPersistentStoreRemoteChangeNotificationPostOptionKey)
+        container.persistentStoreDescriptions = [description]
+        container.loadPersistentStores { _, error in
+            XCTAssertNil(error)
+        }
+        container.viewContext.transactionAuthor = "other"
+        return container
+    }
+
+    private func makeTracker(for container: NSPersistentContainer, tokenURL: URL?) -> PersistentHistoryTracker {
+        PersistentHistoryTracker(
+            coordinator: container.persistentStoreCoordinator,
+            mainContext: container.viewContext,
+            tokenURL: tokenURL,
+            ownTransactionAuthor: ContextManager.transactionAuthor
+        )
+    }
+
+    private func insertAccount(userID: Int, in context: NSManagedObjectContext) throws {
+        _ = WPAccount.fixture(context: context, userID: userID)
+        try context.save()
+    }
+
+    private func transactionCount(in container: NSPersistentContainer) throws -> Int {
+        let request = NSPersistentHistoryChangeRequest.fetchHistory(after: nil as NSPersistentHistoryToken?)
+        request.resultType = .transactionsOnly
+        let result = try container.newBackgroundContext().execute(request) as? NSPersistentHistoryResult
+        return (result?.result as? [NSPersistentHistoryTransaction])?.count ?? 0
+    }
+
+    private func makeAccountsController(in context: NSManagedObjectContext) throws -> NSFetchedResultsController<WPAccount> {
+        let request = NSFetchRequest<WPAccount>(entityName: WPAccount.entityName())
+        request.sortDescriptors = [NSSortDescriptor(key: "userID", ascending: true)]
+        let controller = NSFetchedResultsController(fetchRequest: request, managedObjectContext: context, sectionNameKeyPath: nil, cacheName: nil)
+        // The controller only tracks the changes in the context if it has a delegate.
+        controller.delegate = controllerDelegate
+        try controller.performFetch()
+        return controller
+    }
+
+    private func userIDs(in controller: NSFetchedResultsController<WPAccount>) -> [Int] {
+        controller.fetchedObjects?.map { $0.userID.intValue } ?? []
+    }
+
+    private let controllerDelegate = FetchedResultsControllerDelegate()
+}
+
+private final class FetchedResultsControllerDelegate: NSObject, NSFetchedResultsControllerDelegate {}
@@ -0,0 +1,173 @@
+import Foundation
+import Testing
+import WordPressFlux
+
+@MainActor
+struct StatefulStoreEmissionTests {
+    struct TestState: Equatable {
+        var isLoading = false
+        var items: [Int] = []
+    }
+
+    class TestStore: StatefulStore<TestState> {
+        init(emission: StateChangeEmission<TestState>) {
+            super.init(initialState: TestState(), dispatcher: ActionDispatcher(), emission: emission)
+        }
+
+        /// Mutates the state several times, like the stores handling an action do.
+        func load(_ items: [Int]) {
+            state.isLoading = true
+            state.items = items
+            state.isLoading = false
+        }
+    }
+
+    @Test func testImmediateEmitsEveryChange() {
+        let store = TestStore(emission: .immediate)
+        var changeCount = 0
+        let receipt = store.onChange { changeCount += 1 }
+
+        store.load([1])
+        store.state = store.state
+
+        #expect(changeCount == 4)
+        _ = receipt
+    }
+
+    @Test func testDistinctSkipsUnchangedState() {
+        let store = TestStore(emission: .distinct)
+        var changes = [(TestState, TestState)]()
+        let receipt = store.onStateChange { changes.append($0) }
+
+        store.state = store.state
+        store.state.isLoading = false
+        store.state.items = [1]
+
+        #expect(changes.count == 1)
+        #expect(changes.first?.0.items == [])
+        #expect(changes.first?.1.items == [1])
+        _ = receipt
+    }
+
+    @Test func testCoalescedEmitsOncePerRunLoopTurn() async {
+        let store = TestStore(emission: .coalesced)
+        var changeCount = 0
+        var changes = [(TestState, TestState)]()
+        let receipts = [
+            store.onChange { changeCount += 1 },
+            store.onStateChange { changes.append($0) }
+        ]
+
+        store.load([1, 2])
+        #expect(changes.isEmpty)
+
+        await nextRunLoopTurn()
+        #expect(changeCount == 1)
+        #expect(changes.count == 1)
+        #expect(changes.first?.0 == TestState())
+        #expect(changes.first?.1 == TestState(isLoading: false, items: [1, 2]))
+
+        store.load([3])
+        await nextRunLoopTurn()
+        #expect(changeCount == 2)
+        _ = receipts
+    }
+
+    @Test func testCoalescedDistinctSkipsChangesThatAreUndone() async {
+        let store = TestStore(emission: .coalescedDistinct)
+        var changeCount = 0
+        let receipt = store.onChange { changeCount += 1 }
+
+        store.state.isLoading = true
+        store.state.isLoading = false
+        await nextRunLoopTurn()
+
+        #expect(changeCount == 0)
+        _ = receipt
+    }
+
+    @Test func testFlushEmitsPendingChanges() {
+        let store = TestStore(emission: .coalescedDistinct)
+        var changeCount = 0
+        let receipt = store.onChange { changeCount += 1 }
+
+        store.load([1])
+        store.flushStateChanges()
+        #expect(changeCount == 1)
+
+        // Nothing is left to emit.
+        store.flushStateChanges()
+        #expect(changeCount == 1)
+        _ = receipt
+    }
+
+    @Test func testKeyPathSubscriptionOnlyFiresWhenSliceChanges() {
+        let store = TestStore(emission: .immediate)
+        var itemChanges = [([Int], [Int])]()
+        let receipt = store.onStateChange(of: \.items) { itemChanges.append($0) }
+
+        store.state.isLoading = true
+        store.state.items = [1]
+        store.state.isLoading = false
+        store.state.items = [1]
+
+        #expect(itemChanges.count == 1)
+        #expect(itemChanges.first?.0 == [])
+        #expect(itemChanges.first?.1 == [1])
+        _ = receipt
+    }
+
+    @Test func testQueryStoreEmitsOldState() {
+        class TestQueryStore: QueryStore<Int, Int> {
+            init() {
+                super.init(initialState: 1, dispatcher: ActionDispatcher(), emission: .distinct)
+            }
+        }
+
+        let store = TestQueryStore()
+        var changes = [(Int, Int)]()
+        let receipt = store.onStateChange { changes.append($0) }
+
+        store.state = 2
+        store.state = 2
+
+        #expect(changes.count == 1)
+        #expect(changes.first?.0 == 1)
+        #expect(changes.first?.1 == 2)
+        _ = receipt
+    }
+
+    @Test func testCoalescingRendersOncePerAction() {
+        let actionCount = 1_000
+        let observerCount = 50
+
+        func renderCount(_ emission: StateChangeEmission<TestState>) -> Int {
+            let store = TestStore(emission: emission)
+            var renders = 0
+            let receipts = (0..<observerCount).map { _ in
+                store.onChange { renders += 1 }
+            }
+            for action in 0..<actionCount {
+                store.load([action % 10])
+                // Stands in for the end of the run loop turn.
+                store.flushStateChanges()
+            }
+            _ = receipts
+            return renders
+        }
+
+        #expect(renderCount(.coalescedDistinct) == actionCount * observerCount)
+        #expect(renderCount(.immediate) == 3 * actionCount * observerCount)
+    }
+
+    // MARK: - Helpers
+
+    /// Waits for the blocks already enqueued on the main queue, such as the coalesced emissions.
+    private func nextRunLoopTurn() async {
+        await withCheckedContinuation { continuation in
+            DispatchQueue.main.async {
+                continuation.resume()
+            }
+        }
+    }
+}
@@ -10,6 +10,47 @@
 
 @end
 
+/**
+ The implementation of `stringByReplacingHTMLEmoticonsWithEmoji` before the emoticon matcher,
+ which the matcher must match exactly.
+ */
+static NSString *LegacyStringByReplacingHTMLEmoticonsWithEmoji(NSString *string)
+{
+    NSMutableString *result = [NSMutableString stringWithString:string];
+    NSDictionary *replacements = @{
+        @"icon_arrow": @"➡", @"icon_biggrin": @"😃", @"icon_confused": @"😕", @"icon_cool": @"😎",
+        @"icon_cry": @"😭", @"icon_eek": @"😮", @"icon_evil": @"😈", @"icon_exclaim": @"❗",
+        @"icon_idea": @"💡", @"icon_lol": @"😄", @"icon_mad": @"😠", @"icon_mrgreen": @"🐸",
+        @"icon_neutral": @"😐", @"icon_question": @"❓", @"icon_razz": @"😛", @"icon_redface": @"😊",
+        @"icon_rolleyes": @"😒", @"icon_sad": @"😞", @"icon_smile": @"😊", @"icon_surprised": @"😮",
+        @"icon_twisted": @"👿", @"icon_wink": @"😉", @"frownie": @"😞", @"mrgreen": @"😊",
+        @"rolleyes": @"😒", @"simple-smile": @"😊"
+    };
+    NSRegularExpression *smiliesRegex = [NSRegularExpression regularExpressionWithPattern:@"<img[^>]*?src=['\"][^>]*?wp-includes/images/smilies/(.+?)(?:.gif|.png)[^'\"]*['\"][^//]+/?>" options:NSRegularExpressionCaseInsensitive error:nil];
+    NSRegularExpression *coreEmojiImgRegex = [NSRegularExpression regularExpressionWithPattern:@"<img[^>]*?src=['\"][^>]*?images/core/emoji/[^/]+/.+?.png['\"][^//]+/?>" options:NSRegularExpressionCaseInsensitive error:nil];
+    NSRegularExpression *wpcomSvgSmilies = [NSRegularExpression regularExpressionWithPattern:@"<img[^>]*?src=['\"][^>]*?wp-content/mu-plugins/wpcom-smileys/(.+?).svg['\"][^//]+/?>" options:NSRegularExpressionCaseInsensitive error:nil];
+
+    for (NSRegularExpression *regex in @[smiliesRegex, wpcomSvgSmilies]) {
+        NSArray *matches = [regex matchesInString:result options:0 range:NSMakeRange(0, [result length])];
+        for (NSTextCheckingResult *match in [matches reverseObjectEnumerator]) {
+            NSString *replacement = [replacements objectForKey:[result substringWithRange:[match rangeAtIndex:1]]];
+            if (replacement) {
+                [result replaceCharactersInRange:[match range] withString:replacement];
+            }
+        }
+    }
+
+    NSArray *matches = [coreEmojiImgRegex matchesInString:result options:0 range:NSMakeRange(0, [result length])];
+    for (NSTextCheckingResult *match in [matches reverseObjectEnumerator]) {
+        NSString *replacement = [NSString emojiFromCoreEmojiImageTag:[result substringWithRange:[match range]]];
+        if (replacement) {
+            [result replaceCharactersInRange:[match range] withString:replacement];
+        }
+    }
+
+    return [NSString stringWithString:result];
+}
+
 @implementation NSStringHelpersTest
 
 - (void)testIsWordPressComPathWithValidDotcomRootPaths
@@ -171,4 +212,92 @@
     XCTAssertTrue([expectedString isEqualToString:[sourceString stringByNormalizingWhitespace]]);
 }
 
+- (void)testEmoticonReplacementMatchesTheReferenceImplementation
+{
+    for (NSString *content in [self emoticonCorpus]) {
+        XCTAssertEqualObjects([content stringByReplacingHTMLEmoticonsWithEmoji], LegacyStringByReplacingHTMLEmoticonsWithEmoji(content), @"%@", content);
+    }
+}
+
+- (void)testEmoticonReplacementOfSmilies
+{
+    NSString *content = @"Hi <img src='https://example.com/wp-includes/images/smilies/icon_smile.gif?m=1' alt=':)' class='wp-smiley' /> and "
+        "<IMG SRC=\"https://s0.wp.com/wp-content/mu-plugins/wpcom-smileys/simple-smile.svg\" class=\"wp-smiley\"> and "
+        "<img src=\"https://example.com/wp-includes/images/smilies/unknown.png\" class=\"wp-smiley\" />";
+    NSString *expected = @"Hi 😊 and 😊 and <img src=\"https://example.com/wp-includes/images/smilies/unknown.png\" class=\"wp-smiley\" />";
+
+    XCTAssertEqualObjects([content stringByReplacingHTMLEmoticonsWithEmoji], expected);
+}
+
+#pragma mark - Performance
+
+- (void)testEmoticonReplacementPerformance
+{
+    NSArray<NSString *> *contents = [self emoticonBenchmarkContents];
+    [self measureBlock:^{
+        for (NSString *content in contents) {
+            [content stringByReplacingHTMLEmoticonsWithEmoji];
+        }
+    }];
+}
+
+#pragma mark - Helpers
+
+/// Content built from tags and text that stress the corners of the original patterns.
+- (NSArray<NSString *> *)emoticonCorpus
+{
+    NSArray *openings = @[@"<img", @"<IMG", @"<img class=\"wp-smiley\"", @"<img alt=\"x\"", @"<img>"];
+    NSArray *quotes = @[@"\"", @"'"];
+    NSArray *paths = @[
+        @"http://example.com/wp-includes/images/smilies/",
+        @"https://example.com/WP-INCLUDES/images/smilies/",
+        @"https://s0.wp.com/wp-content/mu-plugins/wpcom-smileys/",
+        @"https://s.w.org/images/core/emoji/72x72/",
+        @"https://s.w.org/images/core/emoji/",
+        @"https://example.com/uploads/"
+    ];
+    NSArray *icons = @[@"icon_smile", @"icon_sad", @"simple-smile", @"1f600", @"1f1fa-1f1f8", @"unknown", @"a.b", @"😀", @""];
+    NSArray *extensions = @[@".gif", @".png", @".svg", @".PNG", @".jpg", @"xgif"];
+    NSArray *queries = @[@"", @"?m=123", @"?ver=1\"x"];
+    NSArray *attributes = @[@"", @" alt=\":)\"", @" alt=\"😜\"", @" class=\"wp-smiley\"", @" style=\"height: 1em;\"", @" data-x=a/b", @"\n"];
+    NSArray *closings = @[@">", @" />", @"/>", @" >", @""];
+    NSArray *fillers = @[@"", @" text ", @"<p>", @"</p>", @"<br/>", @"\n", @"<a href=\"/x\">", @"</a>", @">", @"/", @"é", @"<img src=\"x.png\">"];
+
+    // A fixed linear congruential generator, so that the corpus is the same on every run.
+    __block uint64_t seed = 42;
+    id (^pick)(NSArray *) = ^id(NSArray *array) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return array[(NSUInteger)(seed >> 33) % array.count];
+    };
+
+    NSMutableArray<NSString *> *corpus = [NSMutableArray array];
+    for (NSInteger index = 0; index < 3000; index++) {
+        NSMutableString *content = [NSMutableString string];
+        NSInteger parts = 1 + index % 6;
+        for (NSInteger part = 0; part < parts; part++) {
+            if ((part + index) % 3 == 0) {
+                [content appendString:pick(fillers)];
+                continue;
+            }
+            NSString *quote = pick(quotes);
+            [content appendFormat:@"%@ src=%@%@%@%@%@%@%@%@", pick(openings), quote, pick(paths), pick(icons), pick(extensions), pick(queries), quote, pick(attributes), pick(closings)];
+        }
+        [corpus addObject:content];
+    }
+    return corpus;
+}
+
+/// Comments, most of which have no emoticons, like a comment thread.
+- (NSArray<NSString *> *)emoticonBenchmarkContents
+{
+    NSString *text = @"<p>Thanks for sharing this, it was a great read. I tried the recipe at home and it worked out nicely.</p>";
+    NSString *smiley = @"<p>Loved it <img src=\"https://example.com/wp-includes/images/smilies/icon_smile.gif\" alt=\":)\" class=\"wp-smiley\" /> "
+        "<img src=\"https://s.w.org/images/core/emoji/72x72/1f600.png\" alt=\"😀\" class=\"wp-smiley\" style=\"height: 1em; max-height: 1em;\" /></p>";
+    NSMutableArray<NSString *> *contents = [NSMutableArray array];
+    for (NSInteger index = 0; index < 2000; index++) {
+        [contents addObject:(index % 10 == 0) ? [text stringByAppendingString:smiley] : [text stringByAppendingFormat:@"<p>%ld</p>", (long)index]];
+    }
+    return contents;
+}
+
 @end
@@ -5,6 +5,77 @@
 
 @end
 
+static NSString *LegacyPhotonQueryString(CGSize size, BOOL useSSL, BOOL forceResize, NSUInteger quality)
+{
+    NSString *queryString;
+    if (size.height == 0) {
+        queryString = [NSString stringWithFormat:@"w=%i", (int)size.width];
+    } else {
+        NSString *method = forceResize ? @"resize" : @"fit";
+        queryString = [NSString stringWithFormat:@"%@=%.0f,%.0f", method, size.width, size.height];
+    }
+    if (useSSL) {
+        queryString = [NSString stringWithFormat:@"%@&ssl=1", queryString];
+    }
+    return [NSString stringWithFormat:@"quality=%lu&%@", (unsigned long)quality, queryString];
+}
+
+/**
+ The implementation of `photonURLWithSize:forImageURL:forceResize:imageQuality:` before it
+ used `PhotonImageURLBuilder`, that the builder must match.
+ */
+static NSURL *LegacyPhotonURL(CGSize size, NSURL *url, BOOL forceResize, NSUInteger quality)
+{
+    NSArray *acceptedImageTypes = @[@"gif", @"jpg", @"jpeg", @"png"];
+    if ([acceptedImageTypes indexOfObject:url.pathExtension] == NSNotFound) {
+        if (![url scheme]) {
+            return [NSURL URLWithString:[NSString stringWithFormat:@"http://%@", [url absoluteString]]];
+        }
+        return url;
+    }
+
+    NSString *urlString = [url absoluteString];
+    CGFloat scale = [[UIScreen mainScreen] scale];
+    size.width *= scale;
+    size.height *= scale;
+    quality = MIN(MAX(quality, 1), 100);
+
+    NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:@"i\\d+\\.wp\\.com" options:NSRegularExpressionCaseInsensitive error:nil];
+    NSString *host = [url host];
+    if ([host length] > 0 && [regex numberOfMatchesInString:host options:0 range:NSMakeRange(0, [host length])] > 0) {
+        NSRange range = [urlString rangeOfString:@"?" options:NSBackwardsSearch];
+        if (range.location != NSNotFound) {
+            BOOL useSSL = ([urlString rangeOfString:@"ssl=1"].location != NSNotFound);
+            urlString = [urlString substringToIndex:range.location];
+            return [NSURL URLWithString:[NSString stringWithFormat:@"%@?%@", urlString, LegacyPhotonQueryString(size, useSSL, forceResize, quality)]];
+        }
+        return url;
+    }
+
+    NSRange range = [urlString rangeOfString:@"://"];
+    if (range.location != NSNotFound && range.location < 6) {
+        urlString = [urlString substringFromIndex:(range.location + range.length)];
+    }
+
+    if ([urlString rangeOfString:@"/mshots/"].location != NSNotFound) {
+        if (size.height == 0) {
+            urlString = [urlString stringByAppendingFormat:@"?w=%i", (int)size.width];
+        } else {
+            urlString = [urlString stringByAppendingFormat:@"?w=%i&h=%i", (int)size.width, (int)size.height];
+        }
+        return [NSURL URLWithString:urlString];
+    }
+
+    NSRange imgpressRange = [urlString rangeOfString:@"?w="];
+    if (imgpressRange.location != NSNotFound) {
+        urlString = [urlString substringToIndex:imgpressRange.location];
+    }
+
+    BOOL useSSL = [[url scheme] isEqualToString:@"https"];
+    NSString *queryString = LegacyPhotonQueryString(size, useSSL, forceResize, quality);
+    return [NSURL URLWithString:[NSString stringWithFormat:@"https://i0.wp.com/%@?%@", urlString, queryString]];
+}
+
 @implementation PhotonImageURLHelperTest
 
 - (void)setUp
@@ -48,4 +119,110 @@
     XCTAssertTrue([[photonURL absoluteString] isEqualToString:path]);
 }
 
+- (void)testPhotonURLsMatchTheReferenceImplementation
+{
+    NSArray<NSString *> *paths = @[
+        @"https://blog.example.com/wp-content/images/image-name.jpg",
+        @"http://blog.example.com/wp-content/images/image-name.jpeg?w=1000",
+        @"https://blog.example.com/wp-content/images/image-name.png?w=1000&h=200",
+        @"https://blog.example.com/wp-content/images/image-name.gif?resize=100,100",
+        @"https://blog.example.com/wp-content/images/image-name.pdf",
+        @"https://blog.example.com/wp-content/images/image-name.JPG",
+        @"blog.example.com/wp-content/images/image-name.jpg",
+        @"blog.example.com/wp-content/images/image-name.bmp",
+        @"https://s0.wp.com/mshots/v1/example.com/image.jpg",
+        @"https://i0.wp.com/path/to/image.jpg",
+        @"https://i2.wp.com/path/to/image.jpg?w=200&ssl=1",
+        @"http://I12.WP.COM/path/to/image.png?quality=10&w=200",
+        @"https://ia.wp.com/path/to/image.png?w=200",
+        @"https://i0.wp.co/path/to/image.png?w=200",
+        @"https://cdn.i3.wp.com.example.com/image.jpg?w=200",
+        @"https://blog.example.com/wp-content/images/%C3%A9t%C3%A9.jpg",
+    ];
+    NSArray<NSValue *> *sizes = [self sizes];
+
+    for (NSString *path in paths) {
+        NSURL *url = [NSURL URLWithString:path];
+        for (NSValue *size in sizes) {
+            for (NSNumber *quality in @[@0, @50, @80, @1000]) {
+                for (NSNumber *forceResize in @[@YES, @NO]) {
+                    NSURL *expected = LegacyPhotonURL(size.CGSizeValue, url, forceResize.boolValue, quality.unsignedIntegerValue);
+                    NSURL *photonURL = [PhotonImageURLHelper photonURLWithSize:size.CGSizeValue forImageURL:url forceResize:forceResize.boolValue imageQuality:quality.unsignedIntegerValue];
+                    XCTAssertEqualObjects(photonURL.absoluteString, expected.absoluteString, @"%@ at %@", path, size);
+                }
+            }
+        }
+        NSArray<NSURL *> *photonURLs = [PhotonImageURLHelper photonURLsWithSizes:sizes forImageURL:url forceResize:YES imageQuality:80];
+        XCTAssertEqual(photonURLs.count, sizes.count);
+        [photonURLs enumerateObjectsUsingBlock:^(NSURL *photonURL, NSUInteger index, BOOL *stop) {
+            NSURL *expected = LegacyPhotonURL(sizes[index].CGSizeValue, url, YES, 80);
+            XCTAssertEqualObjects(photonURL.absoluteString, expected.absoluteString, @"%@ at %@", path, sizes[index]);
+        }];
+    }
+}
+
+- (void)testBuilderGrowsItsBufferForLargeSizes
+{
+    NSURL *url = [NSURL URLWithString:@"https://blog.example.com/image.jpg"];
+    PhotonImageURLBuilder *builder = [[PhotonImageURLBuilder alloc] initWithImageURL:url scale:1];
+
+    NSURL *photonURL = [builder URLWithSize:CGSizeMake(1e100, 1e100) forceResize:YES imageQuality:80];
+    NSString *expected = [NSString stringWithFormat:@"https://i0.wp.com/blog.example.com/image.jpg?quality=80&resize=%.0f,%.0f&ssl=1", 1e100, 1e100];
+    XCTAssertEqualObjects(photonURL.absoluteString, expected);
+
+    photonURL = [builder URLWithSize:CGSizeMake(100, 50) forceResize:NO imageQuality:80];
+    XCTAssertEqualObjects(photonURL.absoluteString, @"https://i0.wp.com/blog.example.com/image.jpg?quality=80&fit=100,50&ssl=1");
+}
+
+- (void)testIsPhotonHost
+{
+    XCTAssertTrue([PhotonImageURLBuilder isPhotonHost:@"i0.wp.com"]);
+    XCTAssertTrue([PhotonImageURLBuilder isPhotonHost:@"I123.WP.com"]);
+    XCTAssertTrue([PhotonImageURLBuilder isPhotonHost:@"cdn.ii1.wp.com.example.com"]);
+    XCTAssertFalse([PhotonImageURLBuilder isPhotonHost:@"i.wp.com"]);
+    XCTAssertFalse([PhotonImageURLBuilder isPhotonHost:@"i0.wp.co"]);
+    XCTAssertFalse([PhotonImageURLBuilder isPhotonHost:@"i0-wp.com"]);
+    XCTAssertFalse([PhotonImageURLBuilder isPhotonHost:@""]);
+    XCTAssertFalse([PhotonImageURLBuilder isPhotonHost:nil]);
+}
+
+#pragma mark - Performance
+
+- (void)testPhotonURLPerformance
+{
+    NSArray<NSURL *> *urls = [self benchmarkURLs];
+    NSArray<NSValue *> *sizes = [self sizes];
+
+    [self measureBlock:^{
+        for (NSURL *url in urls) {
+            [PhotonImageURLHelper photonURLsWithSizes:sizes forImageURL:url forceResize:YES imageQuality:80];
+        }
+    }];
+}
+
+#pragma mark - Helpers
+
+- (NSArray<NSValue *> *)sizes
+{
+    return @[
+        [NSValue valueWithCGSize:CGSizeMake(300, 150)],
+        [NSValue valueWithCGSize:CGSizeMake(320, 0)],
+        [NSValue valueWithCGSize:CGSizeMake(40.5, 40.25)],
+        [NSValue valueWithCGSize:CGSizeMake(1024, 768)],
+        [NSValue valueWithCGSize:CGSizeZero],
+    ];
+}
+
+- (NSArray<NSURL *> *)benchmarkURLs
+{
+    NSMutableArray<NSURL *> *urls = [NSMutableArray array];
+    for (NSInteger index = 0; index < 2000; index++) {
+        NSString *path = (index % 4 == 0)
+            ? [NSString stringWithFormat:@"https://i%ld.wp.com/blog.example.com/image-%ld.jpg?w=200&ssl=1", (long)(index % 3), (long)index]
+            : [NSString stringWithFormat:@"https://blog.example.com/wp-content/uploads/2024/05/image-%ld.jpg?w=1000", (long)index];
+        [urls addObject:[NSURL URLWithString:path]];
+    }
+    return urls;
+}
+
 @end
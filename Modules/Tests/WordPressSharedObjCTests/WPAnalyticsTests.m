@@ -0,0 +1,209 @@
+#import <XCTest/XCTest.h>
+#import "WPAnalytics.h"
+
+@interface WPAnalyticsRecordingTracker : NSObject <WPAnalyticsTracker>
+@property (nonatomic, strong, readonly) NSMutableArray<NSString *> *events;
+@property (nonatomic, assign, readonly) NSUInteger mainThreadDeliveries;
+@end
+
+@implementation WPAnalyticsRecordingTracker
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        _events = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (void)record:(NSString *)event
+{
+    // The events are delivered on a serial queue, so no locking is needed.
+    if ([NSThread isMainThread]) {
+        _mainThreadDeliveries += 1;
+    }
+    [_events addObject:event];
+}
+
+- (void)track:(WPAnalyticsStat)stat
+{
+    [self record:[NSString stringWithFormat:@"stat_%@", @(stat)]];
+}
+
+- (void)track:(WPAnalyticsStat)stat withProperties:(NSDictionary *)properties
+{
+    [self record:[NSString stringWithFormat:@"stat_%@_%@", @(stat), properties[@"index"]]];
+}
+
+- (void)trackString:(NSString *)event
+{
+    [self record:event];
+}
+
+- (void)trackString:(NSString *)event withProperties:(NSDictionary *)properties
+{
+    [self record:[NSString stringWithFormat:@"%@_%@", event, properties[@"index"]]];
+}
+
+- (void)refreshMetadata
+{
+    [self record:@"refresh_metadata"];
+}
+
+- (void)clearQueuedEvents
+{
+    [self record:@"clear_queued_events"];
+}
+
+@end
+
+@interface WPAnalyticsNoopTracker : NSObject <WPAnalyticsTracker>
+@end
+
+@implementation WPAnalyticsNoopTracker
+- (void)track:(WPAnalyticsStat)stat {}
+- (void)track:(WPAnalyticsStat)stat withProperties:(NSDictionary *)properties {}
+- (void)trackString:(NSString *)event {}
+- (void)trackString:(NSString *)event withProperties:(NSDictionary *)properties {}
+@end
+
+@interface WPAnalyticsTests : XCTestCase
+@property (nonatomic, strong) WPAnalyticsRecordingTracker *tracker;
+@end
+
+@implementation WPAnalyticsTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.tracker = [WPAnalyticsRecordingTracker new];
+    [WPAnalytics registerTracker:self.tracker];
+}
+
+- (void)tearDown
+{
+    [WPAnalytics clearTrackers];
+    self.tracker = nil;
+    [super tearDown];
+}
+
+- (void)testEventsAreDeliveredInOrder
+{
+    [WPAnalytics track:WPAnalyticsStatAppInstalled];
+    [WPAnalytics trackString:@"first"];
+    [WPAnalytics track:WPAnalyticsStatAppUpgraded withProperties:@{@"index": @1}];
+    [WPAnalytics trackString:@"second" withProperties:@{@"index": @2}];
+
+    [WPAnalytics flush];
+
+    NSArray *expected = @[
+        [NSString stringWithFormat:@"stat_%@", @(WPAnalyticsStatAppInstalled)],
+        @"first",
+        [NSString stringWithFormat:@"stat_%@_1", @(WPAnalyticsStatAppUpgraded)],
+        @"second_2"
+    ];
+    XCTAssertEqualObjects(self.tracker.events, expected);
+}
+
+- (void)testEventsAreDeliveredOffTheMainThread
+{
+    [WPAnalytics trackString:@"event"];
+    [WPAnalytics flush];
+
+    XCTAssertEqual(self.tracker.events.count, 1);
+    XCTAssertEqual(self.tracker.mainThreadDeliveries, 0);
+}
+
+- (void)testSessionCallsAreDeliveredInOrderOffTheMainThread
+{
+    [WPAnalytics trackString:@"first"];
+    [WPAnalytics refreshMetadata];
+    [WPAnalytics trackString:@"second"];
+    [WPAnalytics clearQueuedEvents];
+
+    [WPAnalytics flush];
+
+    NSArray *expected = @[@"first", @"refresh_metadata", @"second", @"clear_queued_events"];
+    XCTAssertEqualObjects(self.tracker.events, expected);
+    XCTAssertEqual(self.tracker.mainThreadDeliveries, 0);
+}
+
+- (void)testPropertiesAreCopiedWhenTracked
+{
+    NSMutableDictionary *properties = [@{@"index": @1} mutableCopy];
+    [WPAnalytics trackString:@"event" withProperties:properties];
+    properties[@"index"] = @2;
+
+    [WPAnalytics flush];
+
+    XCTAssertEqualObjects(self.tracker.events, @[@"event_1"]);
+}
+
+- (void)testBurstLargerThanBufferIsDeliveredInOrder
+{
+    NSUInteger count = 10000;
+    for (NSUInteger index = 0; index < count; index++) {
+        [WPAnalytics trackString:@"event" withProperties:@{@"index": @(index)}];
+    }
+    [WPAnalytics flush];
+
+    XCTAssertEqual(self.tracker.events.count, count);
+    for (NSUInteger index = 0; index < count; index++) {
+        XCTAssertEqualObjects(self.tracker.events[index], ([NSString stringWithFormat:@"event_%@", @(index)]));
+    }
+}
+
+- (void)testConcurrentProducersDeliverAllEventsInPerThreadOrder
+{
+    NSUInteger producerCount = 8;
+    NSUInteger eventsPerProducer = 2000;
+
+    dispatch_apply(producerCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t producer) {
+        for (NSUInteger index = 0; index < eventsPerProducer; index++) {
+            [WPAnalytics trackString:[NSString stringWithFormat:@"producer%zu", producer] withProperties:@{@"index": @(index)}];
+        }
+    });
+    [WPAnalytics flush];
+
+    XCTAssertEqual(self.tracker.events.count, producerCount * eventsPerProducer);
+
+    NSMutableDictionary<NSString *, NSNumber *> *nextIndexes = [NSMutableDictionary new];
+    for (NSString *event in self.tracker.events) {
+        NSArray<NSString *> *components = [event componentsSeparatedByString:@"_"];
+        NSString *producer = components.firstObject;
+        NSInteger index = components.lastObject.integerValue;
+        XCTAssertEqual(index, nextIndexes[producer].integerValue, @"Events from %@ are out of order", producer);
+        nextIndexes[producer] = @(index + 1);
+    }
+}
+
+- (void)testEventsTrackedBeforeClearingTrackersAreDelivered
+{
+    [WPAnalytics trackString:@"event"];
+    [WPAnalytics clearTrackers];
+    [WPAnalytics trackString:@"ignored"];
+    [WPAnalytics flush];
+
+    XCTAssertEqualObjects(self.tracker.events, @[@"event"]);
+}
+
+#pragma mark - Benchmarks
+
+- (void)testMainThreadCostPerTrackCall
+{
+    [WPAnalytics clearTrackers];
+    [WPAnalytics registerTracker:[WPAnalyticsNoopTracker new]];
+    NSDictionary *properties = @{@"source": @"benchmark", @"index": @1};
+
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [self startMeasuring];
+        for (NSUInteger index = 0; index < 1000; index++) {
+            [WPAnalytics trackString:@"benchmark_event" withProperties:properties];
+        }
+        [self stopMeasuring];
+        [WPAnalytics flush];
+    }];
+}
+
+@end
@@ -0,0 +1,197 @@
+import Foundation
+import Testing
+import WordPressShared
+
+final class DirectorySizeLedgerTests {
+    private let rootURL = FileManager.default.temporaryDirectory.appendingPathComponent(
+        "DirectorySizeLedgerTests-\(UUID().uuidString)"
+    )
+    private var directoryURL: URL { rootURL.appendingPathComponent("Media") }
+
+    init() throws {
+        try FileManager.default.createDirectory(at: directoryURL, withIntermediateDirectories: true)
+    }
+
+    deinit {
+        try? FileManager.default.removeItem(at: rootURL)
+    }
+
+    @Test func measuresDirectory() throws {
+        try writeFiles(count: 3, size: 10_000)
+        try FileManager.default.createDirectory(at: directoryURL.appendingPathComponent("nested"), withIntermediateDirectories: true)
+        try Data(count: 10_000).write(to: directoryURL.appendingPathComponent("nested/file"))
+
+        let usage = try DirectorySizeLedger(directoryURL: directoryURL).currentUsage()
+
+        #expect(usage.fileCount == 4)
+        #expect(usage.byteCount == (try FileManager.default.allocatedSizeOf(directoryURL: directoryURL)))
+    }
+
+    @Test func recordsChanges() throws {
+        let ledger = DirectorySizeLedger(directoryURL: directoryURL)
+        try writeFiles(count: 2, size: 10_000)
+        let initial = try ledger.currentUsage()
+
+        let fileURL = directoryURL.appendingPathComponent("recorded")
+        try ledger.recordChanges(at: fileURL) {
+            try Data(count: 50_000).write(to: fileURL)
+        }
+        let sourceURL = rootURL.appendingPathComponent("source")
+        try Data(count: 20_000).write(to: sourceURL)
+        let movedURL = directoryURL.appendingPathComponent("moved")
+        try ledger.recordChanges(at: sourceURL, movedURL) {
+            try FileManager.default.moveItem(at: sourceURL, to: movedURL)
+        }
+        try ledger.recordChanges(at: directoryURL.appendingPathComponent("file-0")) {
+            try FileManager.default.removeItem(at: directoryURL.appendingPathComponent("file-0"))
+        }
+
+        let recorded = try #require(ledger.recordedUsage)
+        #expect(recorded.fileCount == initial.fileCount + 1)
+        #expect(recorded.byteCount == (try FileManager.default.allocatedSizeOf(directoryURL: directoryURL)))
+        #expect(try ledger.currentUsage() == recorded)
+    }
+
+    @Test func reconcilesChangesMadeOutsideOfLedger() throws {
+        let ledger = DirectorySizeLedger(directoryURL: directoryURL)
+        #expect(try ledger.currentUsage() == .zero)
+
+        try writeFiles(count: 3, size: 10_000)
+
+        let usage = try ledger.currentUsage()
+        #expect(usage.fileCount == 3)
+        #expect(usage.byteCount == (try FileManager.default.allocatedSizeOf(directoryURL: directoryURL)))
+    }
+
+    @Test func keepsUsageAcrossLaunches() throws {
+        try writeFiles(count: 3, size: 10_000)
+        let firstLaunch = DirectorySizeLedger(directoryURL: directoryURL)
+        let usage = try firstLaunch.currentUsage()
+        firstLaunch.synchronize()
+
+        let secondLaunch = DirectorySizeLedger(directoryURL: directoryURL)
+        #expect(secondLaunch.recordedUsage == usage)
+    }
+
+    @Test func evictsOldestFilesToFitWithinLimit() throws {
+        let ledger = DirectorySizeLedger(directoryURL: directoryURL)
+        try writeFiles(count: 5, size: 10_000)
+        for index in 0..<5 {
+            let date = Date(timeIntervalSinceNow: TimeInterval(index - 10) * 3600)
+            try FileManager.default.setAttributes([.modificationDate: date], ofItemAtPath: directoryURL.appendingPathComponent("file-\(index)").path)
+        }
+        let fileSize = try ledger.currentUsage().byteCount / 5
+
+        let usage = try ledger.evictFiles(toFitWithin: fileSize * 3)
+
+        #expect(usage.fileCount == 3)
+        #expect(try remainingFiles() == ["file-2", "file-3", "file-4"])
+        #expect(usage == (try DirectorySizeLedger(directoryURL: directoryURL, storeURL: rootURL.appendingPathComponent("other")).currentUsage()))
+    }
+
+    @Test func evictsExpiredFiles() throws {
+        let ledger = DirectorySizeLedger(directoryURL: directoryURL)
+        try writeFiles(count: 3, size: 10_000)
+        try FileManager.default.setAttributes([.modificationDate: Date(timeIntervalSinceNow: -86_400 * 30)], ofItemAtPath: directoryURL.appendingPathComponent("file-1").path)
+
+        let usage = try ledger.evictFiles(modifiedBefore: Date(timeIntervalSinceNow: -86_400 * 7))
+
+        #expect(usage.fileCount == 2)
+        #expect(try remainingFiles() == ["file-0", "file-2"])
+    }
+
+    @Test func detectsChangesMadeOutsideOfLedgerDuringRecordedChange() throws {
+        let ledger = DirectorySizeLedger(directoryURL: directoryURL)
+        try writeFiles(count: 2, size: 10_000)
+        _ = try ledger.currentUsage()
+
+        let fileURL = directoryURL.appendingPathComponent("file-0")
+        try ledger.recordChanges(at: fileURL) {
+            try Data(count: 20_000).write(to: fileURL)
+            try Data(count: 10_000).write(to: directoryURL.appendingPathComponent("unrecorded"))
+        }
+
+        let usage = try ledger.currentUsage()
+        #expect(usage.fileCount == 3)
+        #expect(usage.byteCount == (try FileManager.default.allocatedSizeOf(directoryURL: directoryURL)))
+    }
+
+    @Test func recordsChangesToTheSameURLInstance() throws {
+        let ledger = DirectorySizeLedger(directoryURL: directoryURL)
+        try writeFiles(count: 2, size: 10_000)
+        _ = try ledger.currentUsage()
+
+        // The URL caches the values it reads, which must not be mistaken for the usage after a change.
+        let fileURL = directoryURL.appendingPathComponent("file-0")
+        _ = try fileURL.resourceValues(forKeys: [.isRegularFileKey, .totalFileAllocatedSizeKey, .fileAllocatedSizeKey])
+        try ledger.recordChanges(at: fileURL) {
+            try Data(count: 50_000).write(to: fileURL)
+        }
+        try ledger.recordChanges(at: fileURL) {
+            try Data(count: 100_000).write(to: fileURL)
+        }
+
+        let usage = try ledger.currentUsage()
+        #expect(usage.fileCount == 2)
+        #expect(usage.byteCount == (try FileManager.default.allocatedSizeOf(directoryURL: directoryURL)))
+    }
+
+    @Test func measuresAgainAfterReconciliationInterval() throws {
+        let ledger = DirectorySizeLedger(directoryURL: directoryURL, reconciliationInterval: 0)
+        try writeFiles(count: 2, size: 10_000)
+        _ = try ledger.currentUsage()
+
+        // Overwriting a file in place doesn't change the modification date of the directory.
+        try Data(count: 50_000).write(to: directoryURL.appendingPathComponent("file-0"))
+
+        #expect(try ledger.currentUsage().byteCount == (try FileManager.default.allocatedSizeOf(directoryURL: directoryURL)))
+    }
+
+    @Test func measuresDirectoryOnlyWhenChangedOutsideOfLedger() throws {
+        try writeFiles(count: 500, size: 100)
+        let fileManager = ListingCountingFileManager()
+        let ledger = DirectorySizeLedger(directoryURL: directoryURL, fileManager: fileManager)
+
+        _ = try ledger.currentUsage()
+        for _ in 0..<100 {
+            _ = try ledger.currentUsage()
+        }
+        let fileURL = directoryURL.appendingPathComponent("recorded")
+        try ledger.recordChanges(at: fileURL) {
+            try Data(count: 100).write(to: fileURL)
+        }
+        _ = try ledger.currentUsage()
+        #expect(fileManager.listingCount == 1)
+
+        try Data(count: 100).write(to: directoryURL.appendingPathComponent("unrecorded"))
+        #expect(try ledger.currentUsage().fileCount == 502)
+        #expect(fileManager.listingCount == 2)
+    }
+
+    // MARK: - Helpers
+
+    private func writeFiles(count: Int, size: Int) throws {
+        for index in 0..<count {
+            try Data(count: size).write(to: directoryURL.appendingPathComponent("file-\(index)"))
+        }
+    }
+
+    private func remainingFiles() throws -> [String] {
+        try FileManager.default.contentsOfDirectory(atPath: directoryURL.path).sorted()
+    }
+}
+
+/// Counts the listings of directory contents, which is what measuring the directory costs.
+private final class ListingCountingFileManager: FileManager {
+    private let lock = NSLock()
+    private var _listingCount = 0
+
+    var listingCount: Int {
+        lock.withLock { _listingCount }
+    }
+
+    override func contentsOfDirectory(at url: URL, includingPropertiesForKeys keys: [URLResourceKey]?, options mask: FileManager.DirectoryEnumerationOptions = []) throws -> [URL] {
+        lock.withLock { _listingCount += 1 }
+        return try super.contentsOfDirectory(at: url, includingPropertiesForKeys: keys, options: mask)
+    }
+}
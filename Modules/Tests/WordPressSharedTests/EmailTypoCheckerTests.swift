@@ -1,5 +1,6 @@
 import Testing
-import WordPressShared
+import XCTest
+@testable import WordPressShared
 
 struct EmailTypoCheckerTests {
 
@@ -24,4 +25,132 @@ struct EmailTypoCheckerTests {
         #expect(EmailTypoChecker.guessCorrection(email: "hello@outloo.com") == "hello@outlook.com")
         #expect(EmailTypoChecker.guessCorrection(email: "hello@comcats.com") == "hello@comcast.com")
     }
+
+    @Test func suggestsMostFrequentDomain() {
+        let index = DomainCorrectionIndex(domains: ["aoe.com", "aol.com"])
+        #expect(index.suggestion(for: "aok.com") == "aoe.com")
+
+        let rankedIndex = DomainCorrectionIndex(domains: ["aoe.com", "aol.com"], frequencies: ["aol.com": 10])
+        #expect(rankedIndex.suggestion(for: "aok.com") == "aol.com")
+        #expect(rankedIndex.suggestion(for: "aoe.com") == "aoe.com")
+        #expect(rankedIndex.suggestion(for: "example.com") == nil)
+    }
+
+    @Test func matchesCandidateSearch() {
+        var generator = SplitMix64(seed: 0xE3A1)
+        let characters = Array("abcdefghijklmnopqrstuvwxyz.-0123456789é")
+        var domains = ["", "a", "gmail", "hotmail.com.ar.uk", "gmaail.com", "gmal.com", "yahoo.comm", "yaho.com"]
+        for domain in knownEmailDomains.sorted() {
+            for _ in 0..<10 {
+                var typo = Array(domain)
+                for _ in 0..<Int.random(in: 1...2, using: &generator) {
+                    let position = Int.random(in: 0..<typo.count, using: &generator)
+                    switch Int.random(in: 0..<4, using: &generator) {
+                    case 0: typo.remove(at: position)
+                    case 1 where position + 1 < typo.count: typo.swapAt(position, position + 1)
+                    case 2: typo[position] = characters.randomElement(using: &generator)!
+                    default: typo.insert(characters.randomElement(using: &generator)!, at: position)
+                    }
+                }
+                domains.append(String(typo))
+            }
+        }
+
+        for domain in domains {
+            let email = "hello@" + domain
+            #expect(EmailTypoChecker.guessCorrection(email: email) == CandidateSearch.guessCorrection(email: email), "\(email)")
+        }
+    }
+
+    @Test func findsTyposBehindPrunedBranches() {
+        // Single transpositions whose branch a tree keyed by the optimal string
+        // alignment distance skipped, as it doesn't satisfy the triangle inequality.
+        #expect(EmailTypoChecker.guessCorrection(email: "hello@liv.ecom") == "hello@live.com")
+        #expect(EmailTypoChecker.guessCorrection(email: "hello@live.c.ouk") == "hello@live.co.uk")
+        #expect(EmailTypoChecker.guessCorrection(email: "hello@liv.ecom.mx") == "hello@live.com.mx")
+        #expect(EmailTypoChecker.guessCorrection(email: "hello@liv.ecom.ar") == "hello@live.com.ar")
+        #expect(EmailTypoChecker.guessCorrection(email: "hello@yg.mcom") == "hello@ygm.com")
+    }
+
+    @Test func lookupComparesFewDomains() {
+        let index = DomainCorrectionIndex(domains: knownEmailDomains)
+        for domain in ["gmial.com", "yhoo.com", "outloo.com", "comcats.com", "azdoij.cm", "hotmail.co.u"] {
+            var comparisons = 0
+            _ = index.suggestion(for: domain, comparisons: &comparisons)
+            #expect(comparisons < knownEmailDomains.count / 4, "\(domain)")
+        }
+    }
+}
+
+final class EmailTypoCheckerPerformanceTests: XCTestCase {
+    private let emails = ["hello@gmial.com", "hello@yhoo.com", "hello@outloo.com", "hello@comcats.com", "hello@azdoij.cm", "hello@hotmail.co.u"]
+
+    func testPerformanceOfLookups() {
+        measure {
+            for _ in 0..<200 {
+                emails.forEach { _ = EmailTypoChecker.guessCorrection(email: $0) }
+            }
+        }
+    }
+
+    func testPerformanceOfCandidateSearch() {
+        measure {
+            for _ in 0..<200 {
+                emails.forEach { _ = CandidateSearch.guessCorrection(email: $0) }
+            }
+        }
+    }
+}
+
+/// The previous implementation, which generates every string a single edit away from the
+/// domain and returns the first known one. The index has to return the same suggestions.
+private enum CandidateSearch {
+    static let alphabet = "abcdefghijklmnopqrstuvwxyz"
+
+    static func guessCorrection(email: String) -> String {
+        let components = email.components(separatedBy: "@")
+        guard components.count == 2 else {
+            return email
+        }
+        let (account, domain) = (components[0], components[1])
+        guard !domain.isEmpty, domain.count < (knownEmailDomains.map(\.count).max() ?? 0) + 1 else {
+            return email
+        }
+        if knownEmailDomains.contains(domain) {
+            return email
+        }
+        return account + "@" + (edits(domain).first(where: knownEmailDomains.contains) ?? domain)
+    }
+
+    static func edits(_ word: String) -> [String] {
+        let deleted = word.indices.map { word.removing(at: $0) }
+        let transposed: [String] = word.indices.compactMap { i in
+            let j = word.index(after: i)
+            guard j < word.endIndex else {
+                return nil
+            }
+            var copy = word
+            copy.replaceSubrange(i...j, with: String(word[j]) + String(word[i]))
+            return copy
+        }
+        let replaced = alphabet.flatMap { replaces($0, ys: word) }
+        let inserted = alphabet.flatMap { between($0, ys: word) }
+        return deleted + transposed + replaced + inserted
+    }
+
+    static func replaces(_ x: Character, ys: String) -> [String] {
+        guard let head = ys.first else {
+            return [String(x)]
+        }
+        let tail = ys.dropFirst()
+        return [String(x) + String(tail)] + replaces(x, ys: String(tail)).map { String(head) + $0 }
+    }
+
+    static func between(_ x: Character, ys: String) -> [String] {
+        guard let head = ys.first else {
+            return [String(x)]
+        }
+        let tail = ys.dropFirst()
+        return [String(x) + String(ys)] + between(x, ys: String(tail)).map { String(head) + $0 }
+    }
 }
@@ -1,4 +1,6 @@
+import Foundation
 import Testing
+import XCTest
 @testable import WordPressShared
 
 struct GutenbergPostExcerptGeneratorTests {
@@ -73,4 +75,160 @@ struct GutenbergPostExcerptGeneratorTests {
         let summary = GutenbergExcerptGenerator.firstParagraph(from: content, maxLength: 150)
         #expect(summary == "some contents\u{00A0}go here")
     }
+
+    @Test func stopsAtFirstClosingParagraphTag() {
+        let content = "<p>First</P><p>Second</p>"
+
+        let summary = GutenbergExcerptGenerator.firstParagraph(from: content, maxLength: 150)
+        #expect(summary == "First")
+    }
+
+    @Test func returnsEmptyExcerptForUnclosedParagraph() {
+        let content = "<p>" + String(repeating: "Lorem ipsum dolor sit amet. ", count: 20)
+
+        let summary = GutenbergExcerptGenerator.firstParagraph(from: content, maxLength: 40)
+        #expect(summary == "")
+    }
+
+    @Test func decodesEntities() {
+        let content = "<p>Fish &amp; chips &#8211; &#x1F600; &#55357;&#56832; &bogus; &amp</p>"
+
+        let summary = GutenbergExcerptGenerator.firstParagraph(from: content, maxLength: 150)
+        #expect(summary == "Fish & chips – &#x1F600; 😀 &bogus; &amp")
+    }
+
+    // MARK: - Equivalence
+
+    @Test func matchesReferenceImplementationForEdgeCases() {
+        let contents = [
+            "",
+            "<p>",
+            "<p></p>",
+            "<p>Unclosed",
+            "<pre>Code</pre>",
+            "<p\n class=\"a\">Attributes on a new line</p>",
+            "<P>Uppercase</P>",
+            "<p>a<br>b</p>",
+            "<p>a<brx>b</p>",
+            "<p>a<br</p>b</p>",
+            "<p>a<b<br>c>d</p>",
+            "<p>a[b<br>]c]d</p>",
+            "<p>a<>b[]c</p>",
+            "<p>a<b</p>",
+            "<p>a[b</p>c]</p>",
+            "<p>&am<b>p;</p>",
+            "<p>&a<br>mp;</p>",
+            "<p>&&amp;;</p>",
+            "<p>&#0;&#65535;&#65534;&#x10000;&#xZZ;&# 65;&#x 41;&#+65;</p>",
+            "<p>&#55357;</p>",
+            "<p>&#56832;a</p>",
+            "<p>&verylongname;&a;</p>",
+            "<p>   leading and trailing   </p>",
+            "<p>\u{2028}line\u{2029}separators\u{85}</p>",
+            "<p>e</p>\u{301}</p>",
+            "<p>👩‍👩‍👧 family emoji and e\u{301}</p>",
+            "<p>" + String(repeating: "word ", count: 100) + "</p>",
+            "<p>" + String(repeating: "x", count: 200) + "</p>",
+        ]
+        for content in contents {
+            expectSameExcerpts(for: content)
+        }
+    }
+
+    @Test func matchesReferenceImplementationForRandomContent() {
+        let tokens = [
+            "<p>", "</p>", "</P>", "<p class=\"x\">", "<pre>", "<br>", "<BR />", "<br class=\"a\">", "<brr>",
+            "<b>", "</b>", "<", ">", "[", "]", "[gallery ids=\"1\"]", "<!-- wp:paragraph -->",
+            "&", ";", "#", "x", "&amp;", "&nbsp;", "&lt;", "&#38;", "&#x26;", "&#8212;", "&#55357;", "&#56832;",
+            " ", "  ", "\n", "\t", "\u{A0}", "\u{2003}", "word", "Lorem", "ipsum", "é", "e\u{301}", "😀", "日本語",
+        ]
+        var generator = SplitMix64(seed: 0x5EED)
+        for _ in 0..<2_000 {
+            let count = Int.random(in: 1...40, using: &generator)
+            let content = (0..<count).map { _ in tokens.randomElement(using: &generator)! }.joined()
+            expectSameExcerpts(for: content)
+        }
+    }
+
+    @Test func matchesReferenceImplementationForLongContent() {
+        let sentence = #"Lorem ipsum <strong>dolor</strong> sit amet, [caption]consectetur[/caption] adipiscing&nbsp;elit.<br>"#
+        expectSameExcerpts(for: "<p>" + String(repeating: sentence, count: 2_000) + "</p>")
+
+        let post = "<!-- wp:image --><figure><img src=\"https://example.com/1.jpg\"/></figure><!-- /wp:image -->"
+            + "<p>Lorem ipsum dolor sit amet, <em>consectetur</em> adipiscing elit, sed do eiusmod tempor.</p>"
+            + String(repeating: "<p>Ut enim ad minim veniam, quis nostrud exercitation.</p>", count: 50)
+        expectSameExcerpts(for: post)
+    }
+
+    private func expectSameExcerpts(for content: String) {
+        for maxLength in [5, 40, 150] {
+            let excerpt = GutenbergExcerptGenerator.firstParagraph(from: content, maxLength: maxLength)
+            let expected = ReferenceExcerptGenerator.firstParagraph(from: content, maxLength: maxLength)
+            #expect(excerpt == expected, "\(content.debugDescription), maxLength: \(maxLength)")
+        }
+        let text = GutenbergExcerptGenerator.singleLinePlainText(from: content)
+        #expect(text == ReferenceExcerptGenerator.singleLinePlainText(from: content), "\(content.debugDescription)")
+    }
+}
+
+final class GutenbergExcerptGeneratorPerformanceTests: XCTestCase {
+    func testPerformanceOfLongParagraph() {
+        let sentence = #"Lorem ipsum <strong>dolor</strong> sit amet, [caption]consectetur[/caption] adipiscing&nbsp;elit.<br>"#
+        let content = "<p>" + String(repeating: sentence, count: 2_000) + "</p>"
+        measure {
+            for _ in 0..<100 {
+                _ = GutenbergExcerptGenerator.firstParagraph(from: content, maxLength: 150)
+            }
+        }
+    }
+
+    func testPerformanceOfPostList() {
+        let posts = (0..<500).map { index in
+            "<!-- wp:image --><figure><img src=\"https://example.com/\(index).jpg\"/></figure><!-- /wp:image -->"
+                + "<p>Post \(index): Lorem ipsum dolor sit amet, <em>consectetur</em> adipiscing elit, sed do eiusmod tempor.</p>"
+                + String(repeating: "<p>Ut enim ad minim veniam, quis nostrud exercitation.</p>", count: 50)
+        }
+        measure {
+            for post in posts {
+                _ = GutenbergExcerptGenerator.firstParagraph(from: post, maxLength: 150)
+            }
+        }
+    }
+}
+
+/// The previous, regex-based implementation, which the streaming one has to match.
+private enum ReferenceExcerptGenerator {
+    static let openingParagraphRegex = try! NSRegularExpression(pattern: "<p(\\s[^>]*)?>", options: [.caseInsensitive])
+    static let lineBreakRegex = try! NSRegularExpression(pattern: "(<br\\b[^>]*>)+", options: [.caseInsensitive])
+    static let tagOrShortcodeRegex = try! NSRegularExpression(pattern: "<[^>]+>|\\[[^\\]]+\\]", options: [])
+    static let collapsibleWhitespace = CharacterSet.whitespacesAndNewlines
+        .subtracting(CharacterSet(charactersIn: "\u{00A0}"))
+
+    static func firstParagraph(from content: String, maxLength: Int) -> String {
+        guard let match = openingParagraphRegex.firstMatch(in: content, range: NSRange(content.startIndex..., in: content)),
+              let paragraphTag = Range(match.range, in: content),
+              let pEnd = content.range(of: "</p>", options: .caseInsensitive, range: paragraphTag.upperBound..<content.endIndex) else {
+            return ""
+        }
+
+        let text = singleLinePlainText(from: String(content[paragraphTag.upperBound..<pEnd.lowerBound]))
+        if text.count <= maxLength {
+            return text
+        }
+        let truncated = String(text.prefix(maxLength))
+        if let lastSpace = truncated.lastIndex(of: " ") {
+            return String(truncated[..<lastSpace]) + "…"
+        }
+        return truncated + "…"
+    }
+
+    static func singleLinePlainText(from html: String) -> String {
+        let withoutBreaks = lineBreakRegex.stringByReplacingMatches(in: html, range: NSRange(html.startIndex..., in: html), withTemplate: " ")
+        let stripped = tagOrShortcodeRegex.stringByReplacingMatches(in: withoutBreaks, range: NSRange(withoutBreaks.startIndex..., in: withoutBreaks), withTemplate: "")
+        return stripped
+            .stringByDecodingXMLCharacters()
+            .components(separatedBy: collapsibleWhitespace)
+            .filter { !$0.isEmpty }
+            .joined(separator: " ")
+    }
 }
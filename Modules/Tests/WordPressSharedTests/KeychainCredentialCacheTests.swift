@@ -0,0 +1,236 @@
+import Foundation
+import SFHFKeychainUtils
+import Security
+import Testing
+@testable import WordPressShared
+
+struct KeychainCredentialCacheTests {
+    private let store = InMemoryKeychainCredentialStore()
+
+    @Test func readsLoadEachServiceOnce() throws {
+        for index in 0..<10 {
+            store.seed(service: "https://example.com/xmlrpc.php", username: "user-\(index)", password: "pw-\(index)")
+        }
+        let cache = KeychainCredentialCache(store: store)
+
+        for _ in 0..<10 {
+            for index in 0..<10 {
+                let password = try cache.password(for: "user-\(index)", serviceName: "https://example.com/xmlrpc.php")
+                #expect(password == "pw-\(index)")
+            }
+        }
+
+        #expect(store.readCount == 1)
+        #expect(cache.counters == .init(hits: 99, misses: 1, storeReads: 1, storeWrites: 0))
+    }
+
+    @Test func missingUsernameReturnsNil() throws {
+        store.seed(service: "svc", username: "user", password: "pw")
+        let cache = KeychainCredentialCache(store: store)
+
+        #expect(try cache.password(for: "other", serviceName: "svc") == nil)
+        #expect(try cache.password(for: "other", serviceName: "svc") == nil)
+        #expect(try cache.password(for: "user", serviceName: "missing") == nil)
+        #expect(store.readCount == 2)
+    }
+
+    @Test func writeInvalidatesTheService() throws {
+        store.seed(service: "svc", username: "user", password: "old-pw")
+        let cache = KeychainCredentialCache(store: store)
+        _ = try cache.password(for: "user", serviceName: "svc")
+
+        try cache.setPassword("new-pw", for: "user", serviceName: "svc")
+
+        #expect(try cache.password(for: "user", serviceName: "svc") == "new-pw")
+        #expect(store.readCount == 2)
+        #expect(cache.counters.storeWrites == 1)
+    }
+
+    @Test func deleteInvalidatesTheService() throws {
+        store.seed(service: "svc", username: "user", password: "pw")
+        let cache = KeychainCredentialCache(store: store)
+        _ = try cache.password(for: "user", serviceName: "svc")
+
+        try cache.setPassword(nil, for: "user", serviceName: "svc")
+
+        #expect(try cache.password(for: "user", serviceName: "svc") == nil)
+    }
+
+    @Test func writeOnlyInvalidatesItsService() throws {
+        store.seed(service: "svc-1", username: "user", password: "pw-1")
+        store.seed(service: "svc-2", username: "user", password: "pw-2")
+        let cache = KeychainCredentialCache(store: store)
+        _ = try cache.password(for: "user", serviceName: "svc-1")
+        _ = try cache.password(for: "user", serviceName: "svc-2")
+
+        try cache.setPassword("new-pw", for: "user", serviceName: "svc-2")
+
+        #expect(try cache.password(for: "user", serviceName: "svc-1") == "pw-1")
+        #expect(store.readCount == 2)
+    }
+
+    @Test func accessGroupsAreCachedSeparately() throws {
+        store.seed(service: "svc", username: "user", password: "default-pw")
+        store.seed(service: "svc", username: "user", password: "group-pw", accessGroup: "team.group")
+        let cache = KeychainCredentialCache(store: store)
+
+        #expect(try cache.password(for: "user", serviceName: "svc") == "default-pw")
+        #expect(try cache.password(for: "user", serviceName: "svc", accessGroup: "team.group") == "group-pw")
+    }
+
+    @Test func failedReadsAreNotCached() throws {
+        store.seed(service: "svc", username: "user", password: "pw")
+        store.readError = NSError(domain: sfhfKeychainErrorDomain, code: Int(errSecInteractionNotAllowed))
+        let cache = KeychainCredentialCache(store: store)
+
+        #expect(throws: (any Error).self) {
+            try cache.password(for: "user", serviceName: "svc")
+        }
+
+        store.readError = nil
+        #expect(try cache.password(for: "user", serviceName: "svc") == "pw")
+        #expect(cache.counters.misses == 2)
+    }
+
+    @Test func keychainChangesInvalidateTheService() throws {
+        store.seed(service: "keychain-change-svc", username: "user", password: "old-pw")
+        let cache = KeychainCredentialCache(store: store, observesKeychainChanges: true)
+        _ = try cache.password(for: "user", serviceName: "keychain-change-svc")
+
+        // Written directly through `SFHFKeychainUtils`, bypassing the cache.
+        store.seed(service: "keychain-change-svc", username: "user", password: "new-pw")
+        NotificationCenter.default.post(
+            name: .SFHFKeychainUtilsDidChangeItem,
+            object: nil,
+            userInfo: [SFHFKeychainUtilsServiceNameKey: "keychain-change-svc"]
+        )
+
+        #expect(try cache.password(for: "user", serviceName: "keychain-change-svc") == "new-pw")
+    }
+
+    @Test func enteringForegroundInvalidatesAllServices() throws {
+        store.seed(service: "foreground-svc", username: "user", password: "old-pw")
+        let cache = KeychainCredentialCache(store: store, observesKeychainChanges: true)
+        _ = try cache.password(for: "user", serviceName: "foreground-svc")
+
+        // Written by an extension while the app was in the background.
+        store.seed(service: "foreground-svc", username: "user", password: "new-pw")
+        NotificationCenter.default.post(name: .NSExtensionHostWillEnterForeground, object: nil)
+
+        #expect(try cache.password(for: "user", serviceName: "foreground-svc") == "new-pw")
+    }
+
+    @Test func prefetchLoadsServicesInTheBackground() async throws {
+        let services = (0..<20).map { "https://site-\($0).example.com/xmlrpc.php" }
+        for service in services {
+            store.seed(service: service, username: "user", password: service)
+        }
+        let cache = KeychainCredentialCache(store: store)
+        _ = try cache.password(for: "user", serviceName: services[0])
+
+        await withCheckedContinuation { continuation in
+            cache.prefetchPasswords(forServiceNames: services) {
+                continuation.resume()
+            }
+        }
+
+        for service in services {
+            #expect(try cache.password(for: "user", serviceName: service) == service)
+        }
+        // The service that was already cached isn't loaded again.
+        #expect(store.readCount == 20)
+        #expect(cache.counters.hits == 20)
+    }
+
+    @Test func siteListReadsLoadEachServiceOnce() throws {
+        // Every site's password is read a few times while rendering the list and setting up sync.
+        let services = (0..<50).map { "https://site-\($0).example.com/xmlrpc.php" }
+        for service in services {
+            store.seed(service: service, username: "user", password: "pw")
+        }
+        let readsPerSite = 8
+        let cache = KeychainCredentialCache(store: store)
+
+        for _ in 0..<readsPerSite {
+            for service in services {
+                _ = try cache.password(for: "user", serviceName: service)
+            }
+        }
+
+        // `getPasswordForUsername:` makes two `SecItemCopyMatching` calls per read; the cache makes
+        // a single one for each service.
+        #expect(cache.counters.storeReads == services.count)
+        #expect(cache.counters.hits == services.count * (readsPerSite - 1))
+    }
+}
+
+extension KeychainStubSuites {
+    @Suite(.serialized)
+    struct SFHFKeychainCredentialStoreTests {
+        init() {
+            KeychainStub.reset()
+        }
+
+        @Test func readsAndWritesThroughKeychainUtils() throws {
+            KeychainStub.seed(group: "team.private", service: "svc", username: "user", password: "pw")
+            let cache = KeychainCredentialCache(store: SFHFKeychainCredentialStore(keychainUtils: KeychainStub.self))
+
+            #expect(try cache.password(for: "user", serviceName: "svc", accessGroup: "team.private") == "pw")
+
+            try cache.setPassword("new-pw", for: "user", serviceName: "svc", accessGroup: "team.private")
+            #expect(KeychainStub.password(group: "team.private", service: "svc", username: "user") == "new-pw")
+            #expect(try cache.password(for: "user", serviceName: "svc", accessGroup: "team.private") == "new-pw")
+
+            try cache.setPassword(nil, for: "user", serviceName: "svc", accessGroup: "team.private")
+            #expect(try cache.password(for: "user", serviceName: "svc", accessGroup: "team.private") == nil)
+        }
+    }
+}
+
+// MARK: - InMemoryKeychainCredentialStore
+
+/// A keychain in memory, counting the queries made to it.
+private final class InMemoryKeychainCredentialStore: KeychainCredentialStore, @unchecked Sendable {
+    private let lock = NSLock()
+    /// access group -> service -> username -> password.
+    private var groups: [String: [String: [String: String]]] = [:]
+    private var _readCount = 0
+    private var _readError: Error?
+
+    private static let defaultGroup = "<default>"
+
+    var readCount: Int {
+        lock.withLock { _readCount }
+    }
+
+    var readError: Error? {
+        get { lock.withLock { _readError } }
+        set { lock.withLock { _readError = newValue } }
+    }
+
+    func seed(service: String, username: String, password: String, accessGroup: String? = nil) {
+        lock.withLock {
+            groups[accessGroup ?? Self.defaultGroup, default: [:]][service, default: [:]][username] = password
+        }
+    }
+
+    func passwords(forServiceName serviceName: String, accessGroup: String?) throws -> [String: String] {
+        try lock.withLock {
+            _readCount += 1
+            if let _readError {
+                throw _readError
+            }
+            return groups[accessGroup ?? Self.defaultGroup]?[serviceName] ?? [:]
+        }
+    }
+
+    func storePassword(_ password: String, for username: String, serviceName: String, accessGroup: String?) throws {
+        seed(service: serviceName, username: username, password: password, accessGroup: accessGroup)
+    }
+
+    func deletePassword(for username: String, serviceName: String, accessGroup: String?) throws {
+        lock.withLock {
+            groups[accessGroup ?? Self.defaultGroup]?[serviceName]?[username] = nil
+        }
+    }
+}
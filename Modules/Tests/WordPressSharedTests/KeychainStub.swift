@@ -57,6 +57,15 @@ final class KeychainStub: SFHFKeychainUtils {
         return value
     }
 
+    override class func getPasswords(
+        forServiceName serviceName: String!,
+        accessGroup: String!
+    ) throws -> [String: String] {
+        let group = accessGroup ?? defaultGroup
+        if let error = readErrors[group] { throw error }
+        return groups[group]?[serviceName] ?? [:]
+    }
+
     override class func storeUsername(
         _ username: String!,
         andPassword password: String!,
@@ -1,4 +1,6 @@
+import Foundation
 import Testing
+import XCTest
 @testable import WordPressShared
 
 @Suite("Languages Tests")
@@ -93,4 +95,112 @@ struct LanguagesTests {
         let languages = WordPressComLanguageDatabase(deviceLanguageCode: "zh-Hant-ES")
         #expect(languages.deviceLanguage.id == zhTW)
     }
+
+    // MARK: - Catalogue
+
+    @Test func testCompactCatalogueMatchesJsonFile() throws {
+        let json = try jsonCatalogue()
+        let compact = try compactCatalogue()
+
+        #expect(compact.all == json.all)
+        #expect(compact.popular == json.popular)
+        #expect(try json.encoded() == compactData(), "Run Scripts/generate-language-catalogue.rb after changing Languages.json")
+    }
+
+    @Test func testCatalogueLookupsMatchSearchingTheList() throws {
+        for catalogue in [try jsonCatalogue(), try compactCatalogue()] {
+            for language in catalogue.all {
+                #expect(catalogue.language(id: language.id) == catalogue.all.first { $0.id == language.id })
+                #expect(catalogue.language(slug: language.slug) == catalogue.all.first { $0.slug == language.slug })
+            }
+            #expect(catalogue.language(id: -1) == nil)
+            #expect(catalogue.language(id: 100_000) == nil)
+            #expect(catalogue.language(id: Int(UInt32.max) + 1 + en) == nil)
+            #expect(catalogue.language(slug: "") == nil)
+            #expect(catalogue.language(slug: "not-a-language") == nil)
+        }
+    }
+
+    @Test func testCompactCatalogueRejectsInvalidData() throws {
+        let data = try compactData()
+
+        #expect(throws: LanguageCatalogue.Error.self) { try LanguageCatalogue(compactData: Data()) }
+        #expect(throws: LanguageCatalogue.Error.self) { try LanguageCatalogue(compactData: data.dropLast()) }
+        #expect(throws: LanguageCatalogue.Error.self) { try LanguageCatalogue(compactData: Data("XXXX".utf8) + data.dropFirst(4)) }
+    }
+
+    @Test func testCompactCatalogueReadsSlicedData() throws {
+        let data = Data([0, 0, 0]) + (try compactData())
+        let catalogue = try LanguageCatalogue(compactData: data.dropFirst(3))
+
+        #expect(catalogue.language(slug: "es")?.id == es)
+        #expect(catalogue.all == (try jsonCatalogue()).all)
+    }
+
+    @Test func testDeviceLanguageIsResolvedOncePerLanguageCode() throws {
+        let catalogue = try jsonCatalogue()
+        var resolutions = 0
+        let resolve = { (code: String) -> WPComLanguage in
+            resolutions += 1
+            return catalogue.language(slug: code)!
+        }
+
+        #expect(catalogue.deviceLanguage(for: "es", resolve: resolve).id == es)
+        #expect(catalogue.deviceLanguage(for: "es", resolve: resolve).id == es)
+        #expect(catalogue.deviceLanguage(for: "en", resolve: resolve).id == en)
+        #expect(resolutions == 2)
+    }
+
+    @Test func testDeviceLanguageWithCompactCatalogue() throws {
+        let languages = WordPressComLanguageDatabase(deviceLanguageCode: "zh-Hant-ES", catalogue: try compactCatalogue())
+        #expect(languages.deviceLanguage.id == zhTW)
+        #expect(languages.nameForLanguageWithId(es) == "Español")
+    }
+
+    @Test func compactCatalogueIsSmallerThanJsonFile() throws {
+        #expect(try compactData().count < resourceData(withExtension: "json").count / 2)
+    }
+
+    // MARK: - Helpers
+
+    private func resourceData(withExtension fileExtension: String) throws -> Data {
+        let url = try #require(Bundle.wordPressSharedBundle.url(forResource: "Languages", withExtension: fileExtension))
+        return try Data(contentsOf: url)
+    }
+
+    private func compactData() throws -> Data {
+        try resourceData(withExtension: "catalogue")
+    }
+
+    private func jsonCatalogue() throws -> LanguageCatalogue {
+        try LanguageCatalogue(jsonData: resourceData(withExtension: "json"))
+    }
+
+    private func compactCatalogue() throws -> LanguageCatalogue {
+        try LanguageCatalogue(compactData: compactData())
+    }
+}
+
+final class LanguageCataloguePerformanceTests: XCTestCase {
+    func testPerformanceOfLoadingCompactCatalogue() throws {
+        let url = try XCTUnwrap(Bundle.wordPressSharedBundle.url(forResource: "Languages", withExtension: "catalogue"))
+        let data = try Data(contentsOf: url)
+        measure {
+            _ = try? LanguageCatalogue(compactData: data)
+        }
+    }
+
+    func testPerformanceOfLookups() throws {
+        let url = try XCTUnwrap(Bundle.wordPressSharedBundle.url(forResource: "Languages", withExtension: "catalogue"))
+        let catalogue = try LanguageCatalogue(compactData: Data(contentsOf: url))
+        let languages = catalogue.all
+        measure {
+            for _ in 0..<100 {
+                for language in languages {
+                    _ = catalogue.language(id: language.id)
+                    _ = catalogue.language(slug: language.slug)
+                }
+            }
+        }
+    }
 }
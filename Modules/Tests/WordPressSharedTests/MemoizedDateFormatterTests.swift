@@ -0,0 +1,93 @@
+import Foundation
+import Testing
+@testable import WordPressShared
+
+struct MemoizedDateFormatterTests {
+    private let now = Date(timeIntervalSinceReferenceDate: 700_000_000)
+
+    @Test func formatsRelativeDatesInLocale() {
+        let locale = Locale(identifier: "fr_FR")
+        let formatter = MemoizedDateFormatter(locale: locale)
+
+        let relativeFormatter = RelativeDateTimeFormatter()
+        relativeFormatter.dateTimeStyle = .named
+        relativeFormatter.locale = locale
+
+        for interval in [-60.0 * 5, -3600 * 2, -86_400, 86_400 * 6] {
+            let date = now.addingTimeInterval(interval)
+            #expect(formatter.mediumString(from: date, now: now) == relativeFormatter.localizedString(fromTimeInterval: interval))
+        }
+    }
+
+    @Test func formatsAbsoluteDatesInLocaleAndTimeZone() throws {
+        let locale = Locale(identifier: "de_DE")
+        let formatter = MemoizedDateFormatter(locale: locale)
+        // Late in the day in UTC, so the day depends on the time zone.
+        let date = now.addingTimeInterval(-86_400 * 30)
+
+        for identifier in ["UTC", "Pacific/Auckland", "America/Los_Angeles"] {
+            let timeZone = try #require(TimeZone(identifier: identifier))
+            let expected = DateFormatter()
+            expected.locale = locale
+            expected.timeZone = timeZone
+            expected.dateStyle = .medium
+            expected.timeStyle = .none
+            #expect(formatter.mediumString(from: date, timeZone: timeZone, now: now) == expected.string(from: date))
+        }
+    }
+
+    @Test func explicitTimeZoneDoesNotChangeDefault() throws {
+        let formatter = MemoizedDateFormatter(locale: Locale(identifier: "en_US"))
+        let date = now.addingTimeInterval(-86_400 * 30)
+        let defaultString = formatter.mediumStringWithTime(from: date, now: now)
+
+        _ = formatter.mediumStringWithTime(from: date, timeZone: try #require(TimeZone(identifier: "Asia/Kolkata")), now: now)
+
+        #expect(formatter.mediumStringWithTime(from: date, now: now) == defaultString)
+    }
+
+    @Test func memoizedStringsExpireOnMinuteBoundaries() {
+        let formatter = MemoizedDateFormatter(locale: Locale(identifier: "en_US"))
+        let date = now.addingTimeInterval(-60 * 5)
+
+        #expect(formatter.mediumString(from: date, now: now) == "5 minutes ago")
+        #expect(formatter.mediumString(from: date, now: now.addingTimeInterval(60)) == "6 minutes ago")
+    }
+
+    @Test func recentDatesAreNotMemoized() {
+        let formatter = MemoizedDateFormatter(locale: Locale(identifier: "en_US"))
+
+        #expect(formatter.mediumString(from: now, now: now) == "now")
+        #expect(formatter.mediumString(from: now, now: now.addingTimeInterval(10)) == "10 seconds ago")
+    }
+
+    @Test func isSafeToUseFromMultipleThreads() throws {
+        let formatter = MemoizedDateFormatter(locale: Locale(identifier: "en_US"))
+        let timeZones = try ["UTC", "Europe/Paris", "Asia/Tokyo"].map { try #require(TimeZone(identifier: $0)) }
+        let dates = (0..<50).map { now.addingTimeInterval(-86_400 * 10 - Double($0) * 3_600) }
+        let expected = timeZones.map { timeZone in
+            dates.map { MemoizedDateFormatter(locale: Locale(identifier: "en_US")).mediumStringWithTime(from: $0, timeZone: timeZone, now: now) }
+        }
+
+        DispatchQueue.concurrentPerform(iterations: 300) { iteration in
+            let zoneIndex = iteration % timeZones.count
+            let dateIndex = iteration % dates.count
+            let string = formatter.mediumStringWithTime(from: dates[dateIndex], timeZone: timeZones[zoneIndex], now: now)
+            #expect(string == expected[zoneIndex][dateIndex])
+        }
+    }
+
+    @Test func listReloadsWithinMinuteAreMemoized() {
+        let formatter = MemoizedDateFormatter(locale: Locale(identifier: "en_US"))
+        let dates = (0..<100).map { now.addingTimeInterval(-Double($0 + 1) * 7_200) }
+        let strings = dates.map { formatter.mediumString(from: $0, now: now) }
+
+        for _ in 0..<50 {
+            #expect(dates.map { formatter.mediumString(from: $0, now: now.addingTimeInterval(10)) } == strings)
+        }
+        #expect(formatter.formattedCount == dates.count)
+
+        _ = dates.map { formatter.mediumString(from: $0, now: now.addingTimeInterval(60)) }
+        #expect(formatter.formattedCount == dates.count * 2)
+    }
+}
@@ -71,4 +71,21 @@ struct StringHelperTests {
         #expect("X-Post: This is" == (try! string.removingSuffix(pattern: "( a)? +test")))
         #expect(string == (try! string.removingSuffix(pattern: "Th.* ")))
     }
+
+    @Test func testRemoveLiteralPrefixPattern() {
+        #expect("+02:00" == (try! "UTC+02:00".removingPrefix(pattern: "UTC")))
+        #expect("utc+02:00" == (try! "utc+02:00".removingPrefix(pattern: "UTC")))
+        #expect("+02:00" == (try! "utc+02:00".removingPrefix(pattern: "UTC", options: .caseInsensitive)))
+        #expect("GMT UTC" == (try! "GMT UTC".removingPrefix(pattern: "UTC")))
+        // Compared by code units, not by canonical equivalence.
+        #expect("e\u{301}tude" == (try! "e\u{301}tude".removingPrefix(pattern: "\u{E9}")))
+    }
+
+    @Test func testRemoveLiteralSuffixPattern() {
+        #expect("http://example" == (try! "http://example.com".removingSuffix(pattern: ".com")))
+        #expect("http://example" == (try! "http://example.com".removingSuffix(pattern: "\\.com")))
+        #expect("http://example.org" == (try! "http://example.org".removingSuffix(pattern: "com")))
+        // `$` also matches before a final line terminator.
+        #expect("http://example.\n" == (try! "http://example.com\n".removingSuffix(pattern: "com")))
+    }
 }
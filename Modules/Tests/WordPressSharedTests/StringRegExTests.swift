@@ -0,0 +1,91 @@
+import Foundation
+import Testing
+import XCTest
+
+@testable import WordPressShared
+
+struct StringRegExTests {
+
+    @Test func testReplacingMatchesUsingBlock() {
+        let string = "Visit <a>one</a> and <a>two</a>"
+        let replaced = string.replacingMatches(of: "<a>(.*?)</a>") { _, submatches in
+            submatches[1].uppercased()
+        }
+        #expect(replaced == "Visit ONE and TWO")
+    }
+
+    @Test func testMatches() {
+        #expect("a1b22c333".matches(regex: "\\d+").count == 3)
+        #expect("ABC".matches(regex: "b", options: .caseInsensitive).count == 1)
+    }
+
+    @Test func testReplacingMatchesWithTemplate() {
+        #expect("2024-01-02".replacingMatches(of: "(\\d+)-(\\d+)-(\\d+)", with: "$3/$2/$1") == "02/01/2024")
+    }
+
+    @Test func testCacheReturnsCompiledExpression() throws {
+        let cache = RegularExpressionCache(countLimit: 2)
+        let regex = try cache.regularExpression(pattern: "a+")
+        #expect(try cache.regularExpression(pattern: "a+") === regex)
+        #expect(try cache.regularExpression(pattern: "a+", options: .caseInsensitive) !== regex)
+        #expect(throws: (any Error).self) {
+            try cache.regularExpression(pattern: "(")
+        }
+    }
+
+    @Test func testLiteralPatterns() {
+        #expect(NSRegularExpression.literalText(ofPattern: "UTC", options: []) == "UTC")
+        #expect(NSRegularExpression.literalText(ofPattern: "X-Post: ", options: []) == "X-Post: ")
+        #expect(NSRegularExpression.literalText(ofPattern: "AppRatings?", options: []) == nil)
+        #expect(NSRegularExpression.literalText(ofPattern: "\\.com", options: []) == nil)
+        #expect(NSRegularExpression.literalText(ofPattern: "UTC", options: .caseInsensitive) == nil)
+    }
+
+    @Test func hotPathsMatchUncompiledExpressions() throws {
+        // `WPTimeZone` and `AppRatingsUtility`
+        for string in ["UTC+2", "UTC-10.5", "Europe/London", "AppRating", "AppRatings-Key"] {
+            for pattern in ["UTC", "AppRatings?"] {
+                let regex = try NSRegularExpression(pattern: "^\(pattern)")
+                let range = NSRange(location: 0, length: (string as NSString).length)
+                let expected = regex.stringByReplacingMatches(in: string, range: range, withTemplate: "")
+                #expect(try string.removingPrefix(pattern: pattern) == expected, "\(string), \(pattern)")
+            }
+        }
+
+        // Content formatting
+        let content = "Hello <strong>world</strong>, see <a href=\"https://example.com\">this</a>."
+        let regex = try NSRegularExpression(pattern: "<[^>]+>")
+        let expected = regex.stringByReplacingMatches(in: content, range: NSRange(location: 0, length: content.utf16.count), withTemplate: "")
+        #expect(content.replacingMatches(of: "<[^>]+>", with: "") == expected)
+    }
+}
+
+final class StringRegExPerformanceTests: XCTestCase {
+    /// `WPTimeZone` and `AppRatingsUtility`
+    private let timeZones = ["UTC+2", "UTC-10.5", "Europe/London"]
+
+    func testPerformanceOfRemovingLiteralPrefix() {
+        measure {
+            for index in 0..<10_000 {
+                _ = try? timeZones[index % timeZones.count].removingPrefix(pattern: "UTC")
+            }
+        }
+    }
+
+    func testPerformanceOfRemovingPatternPrefix() {
+        measure {
+            for index in 0..<10_000 {
+                _ = try? timeZones[index % timeZones.count].removingPrefix(pattern: "AppRatings?")
+            }
+        }
+    }
+
+    func testPerformanceOfReplacingMatches() {
+        let content = "Hello <strong>world</strong>, see <a href=\"https://example.com\">this</a>."
+        measure {
+            for _ in 0..<10_000 {
+                _ = content.replacingMatches(of: "<[^>]+>", with: "")
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#!/usr/bin/env ruby
+# frozen_string_literal: true
+
+# Generates `Languages.catalogue`, the compact representation of `Languages.json`
+# loaded by `WordPressComLanguageDatabase`. Run it whenever `Languages.json` changes.
+#
+# The output must match `LanguageCatalogue.encoded()`, which documents the format,
+# and `LanguagesTests` checks that it does.
+
+require 'json'
+
+RESOURCES = File.expand_path('../Modules/Sources/WordPressShared/Resources', __dir__)
+
+json = File.binread(File.join(RESOURCES, 'Languages.json'))
+json = json.force_encoding('UTF-16').encode('UTF-8') if json.start_with?("\xFF\xFE".b, "\xFE\xFF".b)
+bundle = JSON.parse(json.sub(/\A\xEF\xBB\xBF/, ''))
+
+popular = bundle['popular']
+# Sorted by name, keeping the order of the languages with the same name, like `WPComLanguageBundle.all`.
+all = (popular + bundle['all']).each_with_index.sort_by { |language, index| [language['n'], index] }.map(&:first)
+
+table_size = 2
+table_size *= 2 while table_size < all.count * 2
+mask = table_size - 1
+
+def insert(table, index, hash, mask)
+  slot = hash & mask
+  until table[slot].zero?
+    return if yield(table[slot] - 1)
+
+    slot = (slot + 1) & mask
+  end
+  table[slot] = index + 1
+end
+
+records = +''.b
+strings = +''.b
+id_table = Array.new(table_size, 0)
+slug_table = Array.new(table_size, 0)
+all.each_with_index do |language, index|
+  slug = language['s'].b
+  name = language['n'].b
+  records << [language['i'], strings.bytesize, slug.bytesize, name.bytesize].pack('VVvv')
+  strings << slug << name
+
+  id_hash = (language['i'] * 2_654_435_761) & 0xFFFFFFFF
+  insert(id_table, index, id_hash, mask) { |other| all[other]['i'] == language['i'] }
+  slug_hash = slug.each_byte.reduce(2_166_136_261) { |hash, byte| ((hash ^ byte) * 16_777_619) & 0xFFFFFFFF }
+  insert(slug_table, index, slug_hash, mask) { |other| all[other]['s'] == language['s'] }
+end
+
+data = +'WPLC'.b
+data << [1, all.count, popular.count, table_size, strings.bytesize].pack('vvvvV')
+data << records
+data << popular.map { |language| all.index(language) }.pack('v*')
+data << id_table.pack('v*') << slug_table.pack('v*')
+data << strings
+
+File.binwrite(File.join(RESOURCES, 'Languages.catalogue'), data)
+puts "✅ Wrote #{data.bytesize} bytes for #{all.count} languages"
@@ -0,0 +1,186 @@
+import XCTest
+import WordPressData
+@testable import WordPress
+@testable import FormattableContentKit
+
+final class FormattableContentRenderPlanTests: CoreDataTestCase {
+    private let fixtures = [
+        "notifications-badge.json",
+        "notifications-like.json",
+        "notifications-like-multiple-avatar.json",
+        "notifications-new-follower.json",
+        "notifications-pingback.json",
+        "notifications-replied-comment.json",
+        "notifications-unapproved-comment.json"
+    ]
+
+    private var styles: [FormattableContentStyles] {
+        [
+            RichTextContentStyles(),
+            SubjectContentStyles(linkColor: .blue),
+            SnippetsContentStyles(
+                quoteStyles: [.foregroundColor: UIColor.red],
+                rangeStylesMap: [.user: [.backgroundColor: UIColor.yellow], .noticon: [.foregroundColor: UIColor.gray]],
+                linksColor: .green
+            )
+        ]
+    }
+
+    func testPlansMatchSequentialRenderingOfRecordedNotifications() throws {
+        for content in try recordedContent() {
+            XCTAssertNotNil(FormattableContentRenderPlan.compile(content), content.text ?? "")
+            for styles in styles {
+                assertPlanMatchesSequentialRendering(of: content, with: styles)
+            }
+        }
+    }
+
+    func testNoticonsShiftQuotesAndRanges() {
+        let text = "Someone said \"Hello\" on \"A Post\""
+        let userProperties = NotificationContentRange.Properties(range: NSRange(location: 0, length: 7))
+        var postProperties = NotificationContentRange.Properties(range: NSRange(location: 24, length: 8))
+        postProperties.url = URL(string: "https://example.com/a-post")
+        let content = FormattableTextContent(text: text, ranges: [
+            FormattableNoticonRange(value: "\u{f442}", range: NSRange(location: 0, length: 0)),
+            NotificationContentRange(kind: .user, properties: userProperties),
+            FormattableNoticonRange(value: "\u{f814}", range: NSRange(location: 13, length: 0)),
+            NotificationContentRange(kind: .post, properties: postProperties),
+            FormattableNoticonRange(value: "\u{f300}", range: NSRange(location: 32, length: 0))
+        ])
+
+        for styles in styles {
+            assertPlanMatchesSequentialRendering(of: content, with: styles)
+        }
+    }
+
+    func testRangesPastTheEndAreIgnored() {
+        let properties = NotificationContentRange.Properties(range: NSRange(location: 3, length: 20))
+        let content = FormattableTextContent(text: "Hello", ranges: [
+            NotificationContentRange(kind: .post, properties: properties)
+        ])
+
+        assertPlanMatchesSequentialRendering(of: content, with: SubjectContentStyles())
+    }
+
+    func testUnknownRangesAreAppliedSequentially() {
+        let content = FormattableTextContent(text: "Hello world", ranges: [
+            UppercasingRange(range: NSRange(location: 0, length: 5))
+        ])
+
+        XCTAssertNil(FormattableContentRenderPlan.compile(content))
+        let formattedText = FormattableContentFormatter().render(content: content, with: SubjectContentStyles())
+        XCTAssertEqual(formattedText.string, "HELLO world")
+    }
+
+    func testPlansSurviveResettingTheFormatter() {
+        let cache = FormattableContentRenderPlanCache()
+        let formatter = FormattableContentFormatter(planCache: cache)
+        let content = FormattableTextContent(text: "Hello world", ranges: [
+            FormattableNoticonRange(value: "\u{f442}", range: NSRange(location: 0, length: 0))
+        ])
+
+        _ = formatter.render(content: content, with: SubjectContentStyles())
+        formatter.resetCache()
+
+        XCTAssertTrue(cache.containsResult(for: content))
+        XCTAssertFalse(cache.containsResult(for: FormattableTextContent(text: "Hello", ranges: content.ranges)))
+    }
+
+    func testContentThatCanNotBeCompiledIsCached() {
+        let cache = FormattableContentRenderPlanCache()
+        let formatter = FormattableContentFormatter(planCache: cache)
+        let content = FormattableTextContent(text: "Hello world", ranges: [
+            UppercasingRange(range: NSRange(location: 0, length: 5))
+        ])
+
+        _ = formatter.render(content: content, with: SubjectContentStyles())
+
+        XCTAssertTrue(cache.containsResult(for: content))
+        XCTAssertNil(cache.plan(for: content))
+    }
+
+    func testGroupsOfTheAppNotificationsCompile() throws {
+        let utility = NotificationUtility(coreDataStack: contextManager)
+        let notifications = [
+            try utility.loadBadgeNotification(),
+            try utility.loadLikeNotification(),
+            try utility.loadFollowerNotification(),
+            try utility.loadCommentNotification(),
+            try utility.loadPingbackNotification()
+        ]
+
+        for notification in notifications {
+            let groups = [notification.subjectContentGroup].compactMap { $0 } + notification.headerAndBodyContentGroups
+            for block in groups.flatMap(\.blocks) where block.text != nil {
+                XCTAssertTrue(block.ranges.allSatisfy { $0 is PlannableContentRange }, block.text ?? "")
+                XCTAssertNotNil(FormattableContentRenderPlan.compile(block), block.text ?? "")
+            }
+        }
+    }
+
+    // MARK: - Performance
+
+    func testSequentialRenderingPerformance() throws {
+        let contents = try recordedContent()
+        let formatter = FormattableContentFormatter()
+
+        measure {
+            for _ in 0..<100 {
+                for content in contents {
+                    _ = formatter.sequentialText(from: content, with: RichTextContentStyles())
+                }
+            }
+        }
+    }
+
+    func testPlannedRenderingPerformance() throws {
+        let contents = try recordedContent()
+        let formatter = FormattableContentFormatter(planCache: FormattableContentRenderPlanCache())
+
+        measure {
+            for _ in 0..<100 {
+                for content in contents {
+                    // Resetting the cache, like a Dynamic Type change does, keeps the plans.
+                    formatter.resetCache()
+                    _ = formatter.render(content: content, with: RichTextContentStyles())
+                }
+            }
+        }
+    }
+
+    // MARK: - Helpers
+
+    private func recordedContent() throws -> [FormattableContent] {
+        try fixtures.flatMap { fixture -> [FormattableContent] in
+            let dictionary = try JSONObject(fromFileNamed: fixture)
+            let blocks = ["subject", "body"].flatMap { dictionary[$0] as? [[String: AnyObject]] ?? [] }
+            return NotificationContentFactory.content(
+                from: blocks,
+                actionsParser: NotificationActionParser(),
+                parent: WordPressData.Notification(context: mainContext)
+            )
+        }
+        .filter { $0.text != nil }
+    }
+
+    private func assertPlanMatchesSequentialRendering(of content: FormattableContent, with styles: FormattableContentStyles, file: StaticString = #file, line: UInt = #line) {
+        let formatter = FormattableContentFormatter(planCache: FormattableContentRenderPlanCache())
+        let planned = formatter.render(content: content, with: styles)
+        let sequential = formatter.sequentialText(from: content, with: styles).trimNewlines()
+
+        XCTAssertEqual(planned.string, sequential.string, file: file, line: line)
+        XCTAssertTrue(planned.isEqual(to: sequential), "Attributes differ for \(styles.key): \(planned) vs \(sequential)", file: file, line: line)
+    }
+}
+
+/// A range the render plans don't know about.
+private struct UppercasingRange: FormattableContentRange {
+    let kind = FormattableRangeKind("uppercase")
+    let range: NSRange
+
+    func apply(_ styles: FormattableContentStyles, to string: NSMutableAttributedString, withShift shift: Int) -> Shift {
+        let shiftedRange = NSRange(location: range.location + shift, length: range.length)
+        string.replaceCharacters(in: shiftedRange, with: string.attributedSubstring(from: shiftedRange).string.uppercased())
+        return 0
+    }
+}
@@ -1,5 +1,7 @@
 import Foundation
 import XCTest
+import WordPressData
+import WordPressKit
 @testable import WordPress
 @testable import FormattableContentKit
 
@@ -263,8 +265,41 @@ class NotificationTests: CoreDataTestCase {
         }
     }
 
+    func testUpdatingWithUnchangedRemoteNotificationLeavesItClean() throws {
+        let note = WordPressData.Notification(context: mainContext)
+        note.update(with: try makeRemoteCommentNotification())
+        contextManager.saveContextAndWait(mainContext)
+
+        // When the same note is received again
+        note.update(with: try makeRemoteCommentNotification())
+
+        // Then
+        XCTAssertFalse(mainContext.hasChanges)
+        XCTAssertEqual(ContextChangeStatistics(pendingChangesIn: mainContext), ContextChangeStatistics())
+    }
+
+    func testUpdatingWithChangedRemoteNotificationOnlyWritesChanges() throws {
+        let note = WordPressData.Notification(context: mainContext)
+        note.update(with: try makeRemoteCommentNotification())
+        contextManager.saveContextAndWait(mainContext)
+
+        note.update(with: try makeRemoteCommentNotification(read: true))
+
+        XCTAssertTrue(note.read)
+        XCTAssertEqual(Array(note.changedValues().keys), ["read"])
+    }
+
     // MARK: - Helpers
 
+    func makeRemoteCommentNotification(read: Bool = false) throws -> RemoteNotification {
+        // The fixture uses the local attribute names
+        var document = try JSONObject(fromFileNamed: "notifications-replied-comment.json")
+        document["id"] = document.removeValue(forKey: "notificationId")
+        document["note_hash"] = "1234" as AnyObject
+        document["read"] = read as AnyObject
+        return try XCTUnwrap(RemoteNotification(document: document))
+    }
+
     func loadBadgeNotification() throws -> WordPressData.Notification {
         return try utility.loadBadgeNotification()
     }
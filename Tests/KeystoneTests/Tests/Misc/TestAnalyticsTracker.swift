@@ -15,6 +15,8 @@ class TestAnalyticsTracker: NSObject {
 
     private static var _tracked: [Tracked] = []
     static var tracked: [Tracked] {
+        // The events are delivered to the trackers asynchronously
+        WPAnalytics.flush()
         return _tracked
     }
 
@@ -23,8 +25,8 @@ class TestAnalyticsTracker: NSObject {
     }
 
     static func tearDown() {
-        _tracked.removeAll()
         WPAnalytics.clearTrackers()
+        _tracked.removeAll()
     }
 
     static func trackedEventsCount() -> Int {
@@ -286,6 +286,45 @@ final class CommentService_RepliesTests: CoreDataTestCase {
         XCTAssertEqual(post.comments?.count, 24)
         XCTAssertEqual(post.comments?.filter({ ($0 as! Comment).visibleOnReader }).count, 21)
     }
+
+    func test_resyncingUnchangedCommentsDoesNotUpdateThem() throws {
+        let post = ReaderPost(context: mainContext)
+        post.siteID = 3584907
+        post.postID = 51399
+        contextManager.saveContextAndWait(mainContext)
+
+        HTTPStubs.stubRequest(forEndpoint: "rest/v1.1/sites/3584907/posts/51399/replies", withFileAtPath: stubFilePath("reader-post-comments-success.json"))
+        let sync = {
+            let syncExp = self.expectation(description: "Sync comments should complete")
+            self.commentService.syncHierarchicalComments(for: post, page: 1) { _, _ in
+                syncExp.fulfill()
+            } failure: { error in
+                XCTFail("Unexpected error: \(String(describing: error))")
+                syncExp.fulfill()
+            }
+            self.wait(for: [syncExp], timeout: 5)
+        }
+        sync()
+        XCTAssertEqual(post.comments?.count, 24)
+
+        // Record the objects written by the next sync
+        var updatedObjects: [NSManagedObject] = []
+        let observer = NotificationCenter.default.addObserver(forName: .NSManagedObjectContextDidSave, object: nil, queue: nil) { [mainContext] notification in
+            guard let context = notification.object as? NSManagedObjectContext,
+                  context.persistentStoreCoordinator === mainContext.persistentStoreCoordinator else {
+                return
+            }
+            updatedObjects += notification.userInfo?[NSUpdatedObjectsKey] as? Set<NSManagedObject> ?? []
+        }
+        defer { NotificationCenter.default.removeObserver(observer) }
+
+        // When the same comments are synced again
+        sync()
+
+        // Then none of them are written
+        XCTAssertEqual(post.comments?.count, 24)
+        XCTAssertEqual(updatedObjects.count, 0)
+    }
 }
 
 // MARK: - Test Helpers
@@ -0,0 +1,175 @@
+import XCTest
+import WordPressData
+import WordPressKitModels
+@testable import WordPress
+
+final class MenuItemTreeTests: CoreDataTestCase {
+
+    func testWideMenuRoundTrip() {
+        let remoteItems = (0..<300).map { index in
+            makeRemoteItem(id: index * 10, children: (1...3).map { makeRemoteItem(id: index * 10 + $0) })
+        }
+        let menu = makeMenu(with: remoteItems)
+
+        XCTAssertEqual(menu.items?.count, 1_200)
+        XCTAssertEqual(itemIDs(of: menu).prefix(5), [0, 1, 2, 3, 10])
+        XCTAssertEqual(describe(MenuItemTree(items: menu.items).remoteItems()), describe(remoteItems))
+    }
+
+    func testDeepMenuRoundTrip() {
+        var remoteItem = makeRemoteItem(id: 500)
+        for id in stride(from: 499, through: 0, by: -1) {
+            remoteItem = makeRemoteItem(id: id, children: [remoteItem])
+        }
+        let menu = makeMenu(with: [remoteItem])
+
+        XCTAssertEqual(itemIDs(of: menu), Array(0...500))
+        let items = menu.items?.array as? [MenuItem] ?? []
+        XCTAssertTrue(items.last?.isDescendant(of: items[0]) ?? false)
+        XCTAssertEqual(describe(MenuItemTree(items: menu.items).remoteItems()), describe([remoteItem]))
+    }
+
+    func testSerializationOverridesTypeFamily() {
+        let remoteItem = makeRemoteItem(id: 1)
+        remoteItem.type = MenuItemType.tag
+        let menu = makeMenu(with: [remoteItem])
+
+        XCTAssertEqual(MenuItemTree(items: menu.items).remoteItems().first?.typeFamily, "taxonomy")
+    }
+
+    func testUpdateReusesItemsAndDeletesMissingOnes() throws {
+        let menu = makeMenu(with: [
+            makeRemoteItem(id: 1, children: [makeRemoteItem(id: 2)]),
+            makeRemoteItem(id: 3)
+        ])
+        try mainContext.save()
+        let items = menu.items?.array as? [MenuItem] ?? []
+
+        let renamed = makeRemoteItem(id: 3)
+        renamed.name = "Renamed"
+        MenuItemTree.updateItems(of: menu, with: [makeRemoteItem(id: 1), renamed], in: mainContext)
+
+        XCTAssertEqual(itemIDs(of: menu), [1, 3])
+        XCTAssertTrue(menu.items?.firstObject as? MenuItem === items[0])
+        XCTAssertTrue(items[1].isDeleted)
+        mainContext.processPendingChanges()
+        let updatedItemIDs = mainContext.updatedObjects.compactMap { ($0 as? MenuItem)?.itemID?.intValue }
+        // The first item lost its child, the second one was renamed.
+        XCTAssertEqual(Set(updatedItemIDs), [1, 3])
+    }
+
+    func testUpdateKeepsItemsCreatedLocally() throws {
+        let menu = makeMenu(with: [makeRemoteItem(id: 1)])
+        let localItems = (0..<2).map { _ in
+            NSEntityDescription.insertNewObject(forEntityName: MenuItem.entityName(), into: mainContext) as! MenuItem
+        }
+        menu.mutableOrderedSetValue(forKey: "items").addObjects(from: localItems)
+        try mainContext.save()
+
+        MenuItemTree.updateItems(of: menu, with: [makeRemoteItem(id: 1), makeRemoteItem(id: 4), makeRemoteItem(id: 5)], in: mainContext)
+
+        XCTAssertEqual(itemIDs(of: menu), [1, 4, 5])
+        XCTAssertEqual(localItems.map(\.itemID), [4, 5])
+        XCTAssertFalse(localItems.contains(where: \.isDeleted))
+        XCTAssertTrue(mainContext.insertedObjects.isEmpty)
+    }
+
+    func testUpdateMovesChildren() {
+        let menu = makeMenu(with: [
+            makeRemoteItem(id: 1, children: [makeRemoteItem(id: 2)]),
+            makeRemoteItem(id: 3)
+        ])
+
+        MenuItemTree.updateItems(of: menu, with: [
+            makeRemoteItem(id: 3, children: [makeRemoteItem(id: 2)]),
+            makeRemoteItem(id: 1)
+        ], in: mainContext)
+
+        XCTAssertEqual(itemIDs(of: menu), [3, 2, 1])
+        let items = menu.items?.array as? [MenuItem] ?? []
+        XCTAssertTrue(items[1].parent === items[0])
+        XCTAssertNil(items[2].parent)
+    }
+
+    func testReorderOnlyMovesDisplacedItems() {
+        let menu = makeMenu(with: (0..<6).map { makeRemoteItem(id: $0) })
+        let items = menu.items?.array as? [MenuItem] ?? []
+        var movedItems = [MenuItem]()
+        let observer = MenuItemsObserver { movedItems.append(contentsOf: $0) }
+        menu.addObserver(observer, forKeyPath: "items", options: [.old, .new], context: nil)
+
+        // Moving the last item to the top: a single removal and insertion.
+        MenuItemTree.reorder(menu, to: [items[5]] + items[0..<5])
+        menu.removeObserver(observer, forKeyPath: "items")
+
+        XCTAssertEqual(itemIDs(of: menu), [5, 0, 1, 2, 3, 4])
+        XCTAssertEqual(movedItems.compactMap { $0.itemID?.intValue }, [5, 5])
+    }
+
+    func testLongestIncreasingSubsequence() {
+        XCTAssertEqual(MenuItemTree.longestIncreasingSubsequence(of: []), [])
+        XCTAssertEqual(MenuItemTree.longestIncreasingSubsequence(of: [0, 1, 2]), [0, 1, 2])
+        XCTAssertEqual(MenuItemTree.longestIncreasingSubsequence(of: [5, 0, 1, 2, 3, 4]), [1, 2, 3, 4, 5])
+        XCTAssertEqual(MenuItemTree.longestIncreasingSubsequence(of: [2, -1, 0, 1, -1, 3]), [2, 3, 5])
+    }
+
+    // MARK: - Performance
+
+    func testMegaMenuSavePerformance() {
+        let remoteItems = (0..<50).map { column in
+            makeRemoteItem(id: column * 100, children: (1...12).map { makeRemoteItem(id: column * 100 + $0) })
+        }
+        let menu = makeMenu(with: remoteItems)
+        XCTAssertEqual(menu.items?.count, 650)
+
+        measure {
+            let serialized = MenuItemTree(items: menu.items).remoteItems()
+            MenuItemTree.updateItems(of: menu, with: serialized.reversed(), in: mainContext)
+        }
+    }
+
+    // MARK: - Helpers
+
+    private func makeMenu(with remoteItems: [RemoteMenuItem]) -> Menu {
+        let menu = NSEntityDescription.insertNewObject(forEntityName: Menu.entityName(), into: mainContext) as! Menu
+        MenuItemTree.updateItems(of: menu, with: remoteItems, in: mainContext)
+        return menu
+    }
+
+    private func makeRemoteItem(id: Int, children: [RemoteMenuItem]? = nil) -> RemoteMenuItem {
+        let item = RemoteMenuItem()
+        item.itemID = NSNumber(value: id)
+        item.name = "Item \(id)"
+        item.type = MenuItemType.custom
+        item.typeFamily = "custom"
+        item.urlStr = "https://example.com/\(id)"
+        item.children = children
+        return item
+    }
+
+    private func itemIDs(of menu: Menu) -> [Int] {
+        (menu.items?.array as? [MenuItem] ?? []).compactMap { $0.itemID?.intValue }
+    }
+
+    private func describe(_ remoteItems: [RemoteMenuItem]) -> String {
+        remoteItems.map { item in
+            let children = item.children.map { "(\(describe($0)))" } ?? ""
+            return "\(item.itemID ?? 0):\(item.name ?? ""):\(item.typeFamily ?? "")\(children)"
+        }
+        .joined(separator: ",")
+    }
+}
+
+/// Collects the items removed from and inserted into the menu.
+private final class MenuItemsObserver: NSObject {
+    private let onChange: ([MenuItem]) -> Void
+
+    init(onChange: @escaping ([MenuItem]) -> Void) {
+        self.onChange = onChange
+    }
+
+    override func observeValue(forKeyPath keyPath: String?, of object: Any?, change: [NSKeyValueChangeKey: Any]?, context: UnsafeMutableRawPointer?) {
+        let changedItems = (change?[.oldKey] as? [MenuItem] ?? []) + (change?[.newKey] as? [MenuItem] ?? [])
+        onChange(changedItems)
+    }
+}
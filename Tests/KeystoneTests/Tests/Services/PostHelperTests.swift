@@ -0,0 +1,69 @@
+import XCTest
+import WordPressKit
+
+@testable import WordPress
+@testable import WordPressData
+
+class PostHelperTests: CoreDataTestCase {
+
+    func testUpdatingWithUnchangedRemotePostLeavesPostClean() throws {
+        // Given a synced post
+        let post = PostBuilder(mainContext).build()
+        PostHelper.update(post, with: try makeRemotePost(), in: mainContext)
+        try mainContext.save()
+        XCTAssertEqual(post.categories?.count, 2)
+
+        // When the same post is received again
+        PostHelper.update(post, with: try makeRemotePost(), in: mainContext)
+
+        // Then nothing is written
+        XCTAssertFalse(mainContext.hasChanges)
+        XCTAssertEqual(ContextChangeStatistics(pendingChangesIn: mainContext), ContextChangeStatistics())
+    }
+
+    func testUpdatingWithChangedRemotePostOnlyWritesChanges() throws {
+        let post = PostBuilder(mainContext).build()
+        PostHelper.update(post, with: try makeRemotePost(), in: mainContext)
+        try mainContext.save()
+
+        let remotePost = try makeRemotePost()
+        remotePost.likeCount = 5
+        remotePost.categories = [makeRemoteCategory(id: 1)]
+        PostHelper.update(post, with: remotePost, in: mainContext)
+
+        XCTAssertEqual(post.likeCount, 5)
+        XCTAssertEqual(post.categories?.map(\.categoryID), [1])
+        XCTAssertEqual(Set(post.changedValues().keys), ["likeCount", "categories"])
+    }
+
+    // MARK: - Helpers
+
+    private func makeRemotePost() throws -> RemotePost {
+        let remotePost = try XCTUnwrap(RemotePost(siteID: 1, status: "publish", title: "Title", content: "<p>Content</p>"))
+        remotePost.postID = 10
+        remotePost.authorID = 2
+        remotePost.authorDisplayName = "Author"
+        remotePost.date = Date(timeIntervalSinceReferenceDate: 700_000_000)
+        remotePost.dateModified = Date(timeIntervalSinceReferenceDate: 700_000_100)
+        remotePost.url = URL(string: "https://example.com/post")
+        remotePost.excerpt = "Excerpt"
+        remotePost.slug = "title"
+        remotePost.type = "post"
+        remotePost.format = "standard"
+        remotePost.commentCount = 3
+        remotePost.likeCount = 4
+        remotePost.tags = ["swift", "ios"]
+        remotePost.categories = [makeRemoteCategory(id: 1), makeRemoteCategory(id: 2)]
+        remotePost.otherTerms = ["genre": ["fiction"]]
+        remotePost.metadata = [["id": "1", "key": "geo_public", "value": "0"]]
+        return remotePost
+    }
+
+    private func makeRemoteCategory(id: Int) -> RemotePostCategory {
+        let category = RemotePostCategory()
+        category.categoryID = NSNumber(value: id)
+        category.name = "Category \(id)"
+        category.parentID = 0
+        return category
+    }
+}
@@ -0,0 +1,240 @@
+import XCTest
+import WordPressData
+import WordPressKit
+
+@testable import WordPress
+
+final class ReaderPostMergerTests: CoreDataTestCase {
+    private let now = Date(timeIntervalSinceReferenceDate: 700_000_000)
+
+    func testMergeIntoEmptyTopicDropsExtraPost() throws {
+        // GIVEN
+        let topic = try makeTopic()
+        let merger = makeMerger(topic: topic, numberToSync: 7)
+
+        // WHEN a full page is merged
+        merger.merge(makeRemotePosts(0..<7), rankedLessThan: rank(offset: -1), deletingEarlier: false)
+
+        // THEN the extra post used for gap detection is dropped
+        XCTAssertEqual(merger.postsCount, 6)
+        XCTAssertTrue(merger.hasSpaceAvailable)
+        XCTAssertEqual(try posts(in: topic).map(\.globalID), (0..<6).map { "post-\($0)" })
+    }
+
+    func testMergeUpdatesExistingPostsInPlace() throws {
+        // GIVEN
+        let topic = try makeTopic()
+        makeMerger(topic: topic).merge(makeRemotePosts(0..<5), rankedLessThan: rank(offset: -1), deletingEarlier: false)
+        try mainContext.save()
+
+        // GIVEN a post was detached from the topic, e.g. saved for later
+        let detached = try XCTUnwrap(posts(in: topic).first)
+        detached.topic = nil
+        detached.isSavedForLater = true
+        try mainContext.save()
+
+        // WHEN
+        let remotePosts = makeRemotePosts(0..<5)
+        remotePosts[1].postTitle = "Updated"
+        makeMerger(topic: topic).merge(remotePosts, rankedLessThan: rank(offset: -1), deletingEarlier: false)
+
+        // THEN no duplicates are created and the detached post is re-attached
+        let cachedPosts = try posts(in: topic)
+        XCTAssertEqual(cachedPosts.count, 5)
+        XCTAssertEqual(cachedPosts[1].postTitle, "Updated")
+        XCTAssertTrue(cachedPosts.contains(detached))
+    }
+
+    func testMergeRemovesPostsMissingFromBatch() throws {
+        // GIVEN
+        let topic = try makeTopic()
+        makeMerger(topic: topic).merge(makeRemotePosts(0..<5), rankedLessThan: rank(offset: -1), deletingEarlier: false)
+        try mainContext.save()
+
+        // WHEN the refreshed page no longer contains post 2
+        let merger = makeMerger(topic: topic)
+        merger.merge(makeRemotePosts([0, 1, 3, 4]), rankedLessThan: rank(offset: -1), deletingEarlier: false)
+        try commit(merger)
+
+        // THEN
+        XCTAssertEqual(try posts(in: topic).map(\.globalID), ["post-0", "post-1", "post-3", "post-4"])
+    }
+
+    func testMergeInsertsGapMarkerWhenPagesDoNotOverlap() throws {
+        // GIVEN older posts are cached
+        let topic = try makeTopic()
+        makeMerger(topic: topic).merge(makeRemotePosts(100..<105), rankedLessThan: rank(offset: 99), deletingEarlier: false)
+        try mainContext.save()
+
+        // WHEN a newer page that doesn't overlap is merged
+        makeMerger(topic: topic).merge(makeRemotePosts(0..<5), rankedLessThan: rank(offset: -1), deletingEarlier: false)
+        try mainContext.save()
+
+        // THEN a gap marker is inserted after the newest page
+        let markers = try gapMarkers(in: topic)
+        XCTAssertEqual(markers.count, 1)
+        XCTAssertLessThanOrEqual(try XCTUnwrap(markers.first).sortRank.doubleValue, rank(offset: 4).doubleValue)
+
+        // WHEN the gap is filled
+        let merger = makeMerger(topic: topic)
+        merger.merge(makeRemotePosts(3..<101), rankedLessThan: rank(offset: 2), deletingEarlier: false)
+        try commit(merger)
+
+        // THEN the gap marker is removed
+        XCTAssertEqual(try gapMarkers(in: topic).count, 0)
+    }
+
+    func testTrimsExcessPostsKeepingUsedOnes() throws {
+        // GIVEN
+        let topic = try makeTopic()
+        makeMerger(topic: topic, maxPosts: 20).merge(makeRemotePosts(0..<15), rankedLessThan: rank(offset: -1), deletingEarlier: false)
+        let cachedPosts = try posts(in: topic)
+        cachedPosts[14].isSavedForLater = true
+        cachedPosts[13].inUse = true
+        try mainContext.save()
+
+        // WHEN
+        let merger = makeMerger(topic: topic, maxPosts: 10)
+        merger.deletePostsInExcessOfMaxAllowed()
+        try commit(merger)
+
+        // THEN the lowest ranked posts are removed, but the used ones are only detached
+        XCTAssertEqual(try posts(in: topic).map(\.globalID), (0..<10).map { "post-\($0)" })
+        XCTAssertNil(cachedPosts[14].topic)
+        XCTAssertNil(cachedPosts[13].topic)
+        XCTAssertEqual(try mainContext.count(for: NSFetchRequest<ReaderPost>(entityName: ReaderPost.entityName())), 12)
+    }
+
+    func testMergeDeletesPostsFromBlockedSites() throws {
+        // GIVEN
+        let topic = try makeTopic()
+        let otherTopic = try makeTopic(slug: "other")
+        makeMerger(topic: otherTopic).merge(makeRemotePosts(100..<103), rankedLessThan: rank(offset: 99), deletingEarlier: false)
+        for post in try posts(in: otherTopic) {
+            post.isSiteBlocked = true
+        }
+        try mainContext.save()
+
+        // WHEN
+        let merger = makeMerger(topic: topic)
+        merger.merge(makeRemotePosts(0..<3), rankedLessThan: rank(offset: -1), deletingEarlier: false)
+        try commit(merger)
+
+        // THEN the posts are deleted from all topics and the view context reflects it
+        XCTAssertEqual(try posts(in: otherTopic).count, 0)
+        XCTAssertEqual(try posts(in: topic).count, 3)
+    }
+
+    func testDeletionsAreMergedIntoTheViewContextWithTheirRelatedObjects() throws {
+        // GIVEN a cached post with a cross-post meta, a comment, and a card
+        let topic = try makeTopic()
+        makeMerger(topic: topic).merge(makeRemotePosts(0..<3), rankedLessThan: rank(offset: -1), deletingEarlier: false)
+        let post = try XCTUnwrap(posts(in: topic).first { $0.globalID == "post-1" })
+        let comment = Comment(context: mainContext)
+        comment.commentID = 1
+        comment.post = post
+        let meta = ReaderCrossPostMeta(context: mainContext)
+        meta.siteURL = "https://example.com"
+        meta.postURL = "https://example.com/post"
+        meta.commentURL = ""
+        meta.siteID = 1
+        meta.postID = 1
+        meta.post = post
+        let card = ReaderCard(context: mainContext)
+        card.post = post
+        try mainContext.save()
+
+        // WHEN the post is deleted by a merge made in a background context
+        let context = contextManager.newDerivedContext()
+        context.performAndWait {
+            let topic = context.object(with: topic.objectID) as! ReaderAbstractTopic
+            let merger = ReaderPostMerger(topic: topic, context: context, viewContext: mainContext, maxPosts: 300, numberToSync: 7)
+            merger.merge(makeRemotePosts([0, 2]), rankedLessThan: rank(offset: -1), deletingEarlier: false)
+            try? context.save()
+            merger.commitDeletions()
+        }
+
+        // THEN the view context doesn't keep the deleted objects around
+        XCTAssertEqual(try posts(in: topic).map(\.globalID), ["post-0", "post-2"])
+        XCTAssertTrue(meta.isDeleted || meta.managedObjectContext == nil)
+        XCTAssertTrue(comment.isDeleted || comment.managedObjectContext == nil)
+        XCTAssertNil(card.post)
+        XCTAssertEqual(try mainContext.count(for: NSFetchRequest<ReaderCrossPostMeta>(entityName: ReaderCrossPostMeta.entityName())), 0)
+        XCTAssertEqual(try mainContext.count(for: NSFetchRequest<Comment>(entityName: Comment.entityName())), 0)
+    }
+
+    // MARK: - Benchmarks
+
+    func testMergePerformanceInLargeTopic() throws {
+        let topic = try makeTopic()
+        let seed = makeRemotePosts(0..<2_000)
+        makeMerger(topic: topic, maxPosts: 2_000).merge(seed, rankedLessThan: rank(offset: -1), deletingEarlier: false)
+        try mainContext.save()
+
+        // Pages overlapping with the cached posts, as when infinite-scrolling a busy tag stream
+        let pages = stride(from: 0, to: 1_400, by: 7).map { makeRemotePosts($0..<($0 + 8)) }
+
+        measure {
+            for (index, page) in pages.enumerated() {
+                makeMerger(topic: topic, maxPosts: 2_000, numberToSync: 8)
+                    .merge(page, rankedLessThan: rank(offset: index * 7 - 1), deletingEarlier: false)
+            }
+            mainContext.rollback()
+        }
+    }
+
+    // MARK: - Helpers
+
+    private func makeMerger(topic: ReaderAbstractTopic, maxPosts: Int = 300, numberToSync: Int = 7) -> ReaderPostMerger {
+        ReaderPostMerger(topic: topic, context: mainContext, viewContext: mainContext, maxPosts: maxPosts, numberToSync: numberToSync)
+    }
+
+    /// Saves the changes and deletes the posts queued for deletion, like `ReaderPostService` does.
+    private func commit(_ merger: ReaderPostMerger) throws {
+        try mainContext.save()
+        merger.commitDeletions()
+    }
+
+    private func makeTopic(slug: String = "test") throws -> ReaderTagTopic {
+        let topic = ReaderTagTopic(context: mainContext)
+        topic.title = slug
+        topic.slug = slug
+        topic.path = "/tags/\(slug)"
+        topic.type = ReaderTagTopic.TopicType
+        try mainContext.save()
+        return topic
+    }
+
+    /// Returns posts ranked by their index: the higher the index, the older the post.
+    private func makeRemotePosts<S: Sequence<Int>>(_ indices: S) -> [RemoteReaderPost] {
+        indices.map { index in
+            let post = RemoteReaderPost()
+            post.postID = NSNumber(value: index)
+            post.siteID = 1
+            post.globalID = "post-\(index)"
+            post.postTitle = "Post \(index)"
+            post.content = ""
+            post.sortDate = now.addingTimeInterval(-Double(index))
+            post.sortRank = rank(offset: index)
+            return post
+        }
+    }
+
+    private func rank(offset: Int) -> NSNumber {
+        NSNumber(value: now.timeIntervalSinceReferenceDate - Double(offset))
+    }
+
+    private func posts(in topic: ReaderAbstractTopic) throws -> [ReaderPost] {
+        let request = NSFetchRequest<ReaderPost>(entityName: ReaderPost.entityName())
+        request.includesSubentities = false
+        request.predicate = NSPredicate(format: "topic = %@", topic)
+        request.sortDescriptors = [NSSortDescriptor(key: "sortRank", ascending: false)]
+        return try mainContext.fetch(request)
+    }
+
+    private func gapMarkers(in topic: ReaderAbstractTopic) throws -> [ReaderGapMarker] {
+        let request = NSFetchRequest<ReaderGapMarker>(entityName: ReaderGapMarker.entityName())
+        request.predicate = NSPredicate(format: "topic = %@", topic)
+        return try mainContext.fetch(request)
+    }
+}
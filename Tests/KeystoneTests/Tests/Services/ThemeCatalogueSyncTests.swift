@@ -0,0 +1,147 @@
+import XCTest
+import WordPressData
+import WordPressKit
+@testable import WordPress
+
+final class ThemeCatalogueSyncTests: CoreDataTestCase {
+    private var blog: Blog!
+
+    override func setUp() {
+        super.setUp()
+        blog = BlogBuilder(mainContext).build()
+    }
+
+    override func tearDown() {
+        blog = nil
+        super.tearDown()
+    }
+
+    func testMergeCreatesAndUpdatesThemes() {
+        let sync = ThemeCatalogueSync(scope: .all)
+        _ = sync.merge(makeRemoteThemes(0..<3), blog: blog, in: mainContext)
+
+        let updated = makeRemoteThemes(1..<5)
+        updated[0].name = "Renamed"
+        let themes = sync.merge(updated, blog: blog, in: mainContext)
+
+        XCTAssertEqual(themes.map(\.themeId), ["theme-1", "theme-2", "theme-3", "theme-4"])
+        XCTAssertEqual(themes.first?.name, "Renamed")
+        XCTAssertEqual(storedThemeIDs(), (0..<5).map { "theme-\($0)" })
+    }
+
+    func testMergeLeavesUnchangedThemesUntouched() throws {
+        let sync = ThemeCatalogueSync(scope: .all)
+        _ = sync.merge(makeRemoteThemes(0..<10), blog: blog, in: mainContext)
+        try mainContext.save()
+
+        let updated = makeRemoteThemes(0..<10)
+        updated[3].version = "2.0"
+        _ = sync.merge(updated, blog: blog, in: mainContext)
+
+        XCTAssertEqual(mainContext.updatedObjects.compactMap { ($0 as? Theme)?.themeId }, ["theme-3"])
+    }
+
+    func testMergeKeepsActiveTheme() {
+        let remoteThemes = makeRemoteThemes(0..<3)
+        remoteThemes[2].active = true
+
+        _ = ThemeCatalogueSync(scope: .all).merge(remoteThemes, blog: blog, in: mainContext)
+
+        XCTAssertEqual(blog.currentThemeId, "theme-2")
+    }
+
+    func testDeletionRemovesUnmergedThemes() throws {
+        let sync = ThemeCatalogueSync(scope: .all)
+        makeStoredTheme(id: "removed")
+        makeStoredTheme(id: nil)
+        _ = sync.merge(makeRemoteThemes(0..<5), blog: blog, in: mainContext)
+
+        sync.deleteUnmergedThemes(for: blog, in: mainContext)
+
+        XCTAssertEqual(storedThemeIDs(), (0..<5).map { "theme-\($0)" })
+        let request = NSFetchRequest<Theme>(entityName: Theme.entityName())
+        request.predicate = NSPredicate(format: "blog == %@ AND themeId == nil", blog)
+        XCTAssertEqual(try mainContext.count(for: request), 0)
+    }
+
+    func testDeletionKeepsCurrentThemeAndThemesOutOfScope() {
+        makeStoredTheme(id: "current")
+        makeStoredTheme(id: "uploaded", custom: true)
+        makeStoredTheme(id: "removed")
+        blog.currentThemeId = "current"
+        let sync = ThemeCatalogueSync(scope: .wordPressCom)
+        _ = sync.merge(makeRemoteThemes(0..<2), blog: blog, in: mainContext)
+
+        sync.deleteUnmergedThemes(for: blog, in: mainContext)
+
+        XCTAssertEqual(storedThemeIDs(), ["current", "theme-0", "theme-1", "uploaded"])
+    }
+
+    func testCustomScopeOnlyDeletesCustomThemes() {
+        makeStoredTheme(id: "wpcom")
+        makeStoredTheme(id: "uploaded", custom: true)
+        let sync = ThemeCatalogueSync(scope: .custom)
+        let themes = sync.merge(makeRemoteThemes(0..<1), blog: blog, in: mainContext)
+
+        sync.deleteUnmergedThemes(for: blog, in: mainContext)
+
+        XCTAssertEqual(themes.first?.custom, true)
+        XCTAssertEqual(storedThemeIDs(), ["theme-0", "wpcom"])
+    }
+
+    func testMergingSingleThemeKeepsItCustom() {
+        makeStoredTheme(id: "theme-0", custom: true)
+        let remoteThemes = makeRemoteThemes(0..<1)
+        remoteThemes[0].active = true
+
+        let theme = ThemeCatalogueSync.merge(remoteThemes, blog: blog, in: mainContext).first
+
+        XCTAssertEqual(theme?.custom, true)
+        XCTAssertEqual(blog.currentThemeId, "theme-0")
+    }
+
+    // MARK: - Performance
+
+    func testMergePerformance() throws {
+        let remoteThemes = makeRemoteThemes(0..<1_000)
+        _ = ThemeCatalogueSync(scope: .all).merge(remoteThemes, blog: blog, in: mainContext)
+        try mainContext.save()
+
+        measure {
+            let sync = ThemeCatalogueSync(scope: .all)
+            _ = sync.merge(remoteThemes, blog: blog, in: mainContext)
+            sync.deleteUnmergedThemes(for: blog, in: mainContext)
+            XCTAssertEqual(blog.themes?.count, 1_000)
+        }
+    }
+
+    // MARK: - Helpers
+
+    private func makeRemoteThemes(_ range: Range<Int>) -> [RemoteTheme] {
+        range.map { index in
+            let theme = RemoteTheme()
+            theme.themeId = "theme-\(index)"
+            theme.name = "Theme \(index)"
+            theme.order = index + 1
+            theme.type = "free"
+            theme.version = "1.0"
+            return theme
+        }
+    }
+
+    @discardableResult
+    private func makeStoredTheme(id: String?, custom: Bool = false) -> Theme {
+        let theme = NSEntityDescription.insertNewObject(forEntityName: Theme.entityName(), into: mainContext) as! Theme
+        theme.themeId = id
+        theme.custom = custom
+        theme.blog = blog
+        return theme
+    }
+
+    private func storedThemeIDs() -> [String] {
+        let request = NSFetchRequest<Theme>(entityName: Theme.entityName())
+        request.predicate = NSPredicate(format: "blog == %@", blog)
+        let themes = (try? mainContext.fetch(request)) ?? []
+        return themes.compactMap(\.themeId).sorted()
+    }
+}
@@ -6,7 +6,6 @@
 #import "WordPress-Swift.h"
 #endif
 
-@import SFHFKeychainUtils;
 @import WordPressShared;
 @import NSObject_SafeExpectations;
 @import NSURL_IDN;
@@ -496,26 +495,14 @@ NSString * const OptionsKeyIsWPForTeams = @"is_wpforteams_site";
 
 - (NSString *)password
 {
-    return [SFHFKeychainUtils getPasswordForUsername:self.username andServiceName:self.xmlrpc accessGroup:nil error:nil];
+    return [[KeychainCredentialCache shared] passwordForUsername:self.username serviceName:self.xmlrpc error:nil];
 }
 
 - (void)setPassword:(NSString *)password
 {
     NSAssert(self.username != nil, @"Can't set password if we don't know the username yet");
     NSAssert(self.xmlrpc != nil, @"Can't set password if we don't know the XML-RPC endpoint yet");
-    if (password) {
-        [SFHFKeychainUtils storeUsername:self.username
-                             andPassword:password
-                          forServiceName:self.xmlrpc
-                             accessGroup:nil
-                          updateExisting:YES
-                                   error:nil];
-    } else {
-        [SFHFKeychainUtils deleteItemForUsername:self.username
-                                  andServiceName:self.xmlrpc
-                                     accessGroup:nil
-                                           error:nil];
-    }
+    [[KeychainCredentialCache shared] setPassword:password forUsername:self.username serviceName:self.xmlrpc error:nil];
 }
 
 - (NSString *)authToken
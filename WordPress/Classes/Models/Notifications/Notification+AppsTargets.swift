@@ -312,20 +312,23 @@ extension WordPressData.Notification {
 extension WordPressData.Notification {
     /// Updates the local fields with the new values stored in a given Remote Notification
     ///
+    /// Only the fields that differ are assigned: an unchanged note stays clean, and
+    /// keeps its cached (parsed) attributes.
+    ///
     func update(with remote: RemoteNotification) {
-        notificationId = remote.notificationId
-        notificationHash = remote.notificationHash
-        read = remote.read
-        icon = remote.icon
-        noticon = remote.noticon
-        timestamp = remote.timestamp
-        type = remote.type
-        url = remote.url
-        title = remote.title
-        subject = remote.subject
-        header = remote.header
-        body = remote.body
-        meta = remote.meta
+        setIfChanged(\.notificationId, remote.notificationId)
+        setIfChanged(\.notificationHash, remote.notificationHash)
+        setIfChanged(\.read, remote.read)
+        setIfChanged(\.icon, remote.icon)
+        setIfChanged(\.noticon, remote.noticon)
+        setIfChanged(\.timestamp, remote.timestamp)
+        setIfChanged(\.type, remote.type)
+        setIfChanged(\.url, remote.url)
+        setIfChanged(\.title, remote.title)
+        setValueIfChanged(remote.subject, forKey: "subject")
+        setValueIfChanged(remote.header, forKey: "header")
+        setValueIfChanged(remote.body, forKey: "body")
+        setValueIfChanged(remote.meta, forKey: "meta")
     }
 }
 
@@ -1,4 +1,4 @@
-@import SFHFKeychainUtils;
+@import WordPressShared;
 #import "WPAccount.h"
 #ifdef KEYSTONE
 #import "Keystone-Swift.h"
@@ -95,12 +95,10 @@
 
     if (authToken) {
         NSError *error = nil;
-        [SFHFKeychainUtils storeUsername:self.username
-                             andPassword:authToken
-                          forServiceName:[WPAccount authKeychainServiceName]
-                             accessGroup:nil
-                          updateExisting:YES
-                                   error:&error];
+        [[KeychainCredentialCache shared] setPassword:authToken
+                                          forUsername:self.username
+                                          serviceName:[WPAccount authKeychainServiceName]
+                                                error:&error];
 
         if (error) {
             DDLogError(@"Error while updating WordPressComOAuthKeychainServiceName token: %@", error);
@@ -108,10 +106,10 @@
 
     } else {
         NSError *error = nil;
-        [SFHFKeychainUtils deleteItemForUsername:self.username
-                                  andServiceName:[WPAccount authKeychainServiceName]
-                                     accessGroup:nil
-                                           error:&error];
+        [[KeychainCredentialCache shared] setPassword:nil
+                                          forUsername:self.username
+                                          serviceName:[WPAccount authKeychainServiceName]
+                                                error:&error];
         if (error) {
             DDLogError(@"Error while deleting WordPressComOAuthKeychainServiceName token: %@", error);
         }
@@ -139,10 +137,9 @@
     }
 
     NSError *error = nil;
-    NSString *authToken = [SFHFKeychainUtils getPasswordForUsername:username
-                                                     andServiceName:[WPAccount authKeychainServiceName]
-                                                        accessGroup:nil
-                                                              error:&error];
+    NSString *authToken = [[KeychainCredentialCache shared] passwordForUsername:username
+                                                                    serviceName:[WPAccount authKeychainServiceName]
+                                                                          error:&error];
     if (error) {
         DDLogError(@"Error while retrieving WordPressComOAuthKeychainServiceName token: %@", error);
 
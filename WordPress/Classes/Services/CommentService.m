@@ -1216,11 +1216,13 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
             comment = [NSEntityDescription insertNewObjectForEntityForName:entityName inManagedObjectContext:post.managedObjectContext];
         }
 
+        // Sanitize before updating to compare the content to the stored (sanitized) one.
+        remoteComment.content = [self sanitizeCommentContent:remoteComment.content isPrivateSite:post.isBlogPrivate];
         [self updateComment:comment withRemoteComment:remoteComment];
 
         // Calculate hierarchy and depth.
         ancestors = [self ancestorsForCommentWithParentID:[NSNumber numberWithInt:comment.parentID] andCurrentAncestors:ancestors];
-        comment.hierarchy = [self hierarchyFromAncestors:ancestors andCommentID:[NSNumber numberWithInt:comment.commentID]];
+        [comment setValueIfChanged:[self hierarchyFromAncestors:ancestors andCommentID:[NSNumber numberWithInt:comment.commentID]] forKey:@"hierarchy"];
 
         // Comments are shown on the thread when (1) it is approved, and (2) its ancestors are approved.
         // Having the comments sorted hierarchically ascending ensures that each comment's predecessors will be visited first.
@@ -1230,11 +1232,17 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
         if ([comment isApproved] && ([comment isTopLevelComment] || hasValidParent)) {
             [visibleCommentIds addObject:@(comment.commentID)];
         }
-        comment.visibleOnReader = [visibleCommentIds containsObject:@(comment.commentID)];
+        BOOL visibleOnReader = [visibleCommentIds containsObject:@(comment.commentID)];
+        if (comment.visibleOnReader != visibleOnReader) {
+            comment.visibleOnReader = visibleOnReader;
+        }
 
-        comment.depth = ancestors.count;
-        comment.post = post;
-        comment.content = [self sanitizeCommentContent:comment.content isPrivateSite:post.isBlogPrivate];
+        if (comment.depth != ancestors.count) {
+            comment.depth = ancestors.count;
+        }
+        if (comment.post != post) {
+            comment.post = post;
+        }
         [commentsToKeep addObject:comment];
     }
 
@@ -1304,25 +1312,46 @@ static NSTimeInterval const CommentsRefreshTimeoutInSeconds = 60 * 5; // 5 minut
 {
     NSParameterAssert(comment.managedObjectContext != nil);
 
-    comment.commentID = [remoteComment.commentID intValue];
-    comment.authorID = [remoteComment.authorID intValue];
-    comment.author = remoteComment.author;
-    comment.author_email = remoteComment.authorEmail;
-    comment.author_url = remoteComment.authorUrl;
-    comment.authorAvatarURL = remoteComment.authorAvatarURL;
-    comment.author_ip = remoteComment.authorIP;
-    comment.content = remoteComment.content;
-    comment.rawContent = remoteComment.rawContent;
-    comment.dateCreated = remoteComment.date;
-    comment.link = remoteComment.link;
-    comment.parentID = [remoteComment.parentID intValue];
-    comment.postID = [remoteComment.postID intValue];
-    comment.postTitle = remoteComment.postTitle;
-    comment.status = remoteComment.status;
-    comment.type = remoteComment.type;
-    comment.isLiked = remoteComment.isLiked;
-    comment.likeCount = [remoteComment.likeCount intValue];
-    comment.canModerate = remoteComment.canModerate;
+    // Only assign the values that changed, so that refreshing a comment that
+    // didn't change on the server leaves it clean.
+    int32_t commentID = [remoteComment.commentID intValue];
+    if (comment.commentID != commentID) {
+        comment.commentID = commentID;
+    }
+    int32_t authorID = [remoteComment.authorID intValue];
+    if (comment.authorID != authorID) {
+        comment.authorID = authorID;
+    }
+    [comment setValueIfChanged:remoteComment.author forKey:@"author"];
+    [comment setValueIfChanged:remoteComment.authorEmail forKey:@"author_email"];
+    [comment setValueIfChanged:remoteComment.authorUrl forKey:@"author_url"];
+    [comment setValueIfChanged:remoteComment.authorAvatarURL forKey:@"authorAvatarURL"];
+    [comment setValueIfChanged:remoteComment.authorIP forKey:@"author_ip"];
+    [comment setValueIfChanged:remoteComment.content forKey:@"content"];
+    [comment setValueIfChanged:remoteComment.rawContent forKey:@"rawContent"];
+    [comment setValueIfChanged:remoteComment.date forKey:@"dateCreated"];
+    [comment setValueIfChanged:remoteComment.link forKey:@"link"];
+    int32_t parentID = [remoteComment.parentID intValue];
+    if (comment.parentID != parentID) {
+        comment.parentID = parentID;
+    }
+    int32_t postID = [remoteComment.postID intValue];
+    if (comment.postID != postID) {
+        comment.postID = postID;
+    }
+    [comment setValueIfChanged:remoteComment.postTitle forKey:@"postTitle"];
+    [comment setValueIfChanged:remoteComment.status forKey:@"status"];
+    [comment setValueIfChanged:remoteComment.type forKey:@"type"];
+    if (comment.isLiked != remoteComment.isLiked) {
+        comment.isLiked = remoteComment.isLiked;
+    }
+    int16_t likeCount = [remoteComment.likeCount intValue];
+    if (comment.likeCount != likeCount) {
+        comment.likeCount = likeCount;
+    }
+    if (comment.canModerate != remoteComment.canModerate) {
+        comment.canModerate = remoteComment.canModerate;
+    }
 
     // if the post for the comment is not set, check if that post is already stored and associate them
     if (!comment.post) {
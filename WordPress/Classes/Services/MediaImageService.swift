@@ -51,7 +51,8 @@ final class MediaImageService {
     /// a lot of space or memory and are used often. The app often displays
     /// multiple thumbnails on the screen at the same time. This is why the
     /// thumbnails are stored in both disk and memory cache. The disk cache
-    /// has no size or time limit.
+    /// is trimmed by age and size on launch (see
+    /// ``MediaFileManager/evictExpiredMediaCacheFiles()``).
     ///
     /// The original images (``ImageSize/original``) are rarely displayed by the
     /// app and you usually preview only one image at a time. The original images
@@ -198,7 +199,7 @@ final class MediaImageService {
         else {
             return nil
         }
-        try? FileManager.default.moveItem(at: export.url, to: thumbnailURL)
+        try? mediaFileManager.moveItem(at: export.url, to: thumbnailURL)
         return (thumbnailURL, export)
     }
 
@@ -254,7 +255,7 @@ final class MediaImageService {
         let data = try await data(for: info, isCached: false)
         let image = try await ImageDecoder.makeImage(from: data)
         if let fileURL = getCachedThumbnailURL(for: media.mediaID, size: size) {
-            try? data.write(to: fileURL)
+            try? mediaFileManager.write(data, to: fileURL)
         }
         return image
     }
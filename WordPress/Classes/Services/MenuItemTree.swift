@@ -0,0 +1,205 @@
+import Foundation
+import CoreData
+import WordPressData
+import WordPressKitModels
+
+/// The items of a menu as a tree.
+///
+/// A menu stores its items as a flat ordered set, where the children of an item follow it. The tree
+/// indexes the children of every item with a single pass over the set, so that the menu can be
+/// converted to and from the nested remote items in linear time, however wide or deep it is.
+@objc final class MenuItemTree: NSObject {
+    /// The top-level items, in menu order.
+    let roots: [MenuItem]
+
+    private let childrenByParent: [ObjectIdentifier: [MenuItem]]
+
+    @objc init(items: NSOrderedSet?) {
+        var roots = [MenuItem]()
+        var childrenByParent = [ObjectIdentifier: [MenuItem]]()
+        for case let item as MenuItem in items ?? [] {
+            if let parent = item.parent {
+                childrenByParent[ObjectIdentifier(parent), default: []].append(item)
+            } else {
+                roots.append(item)
+            }
+        }
+        self.roots = roots
+        self.childrenByParent = childrenByParent
+    }
+
+    /// The children of the item, in menu order.
+    func children(of item: MenuItem) -> [MenuItem] {
+        childrenByParent[ObjectIdentifier(item)] ?? []
+    }
+
+    // MARK: - Remote Items
+
+    /// The remote items to send when saving the menu, with the children nested under their parent.
+    @objc func remoteItems() -> [RemoteMenuItem] {
+        roots.map(remoteItem(from:))
+    }
+
+    private func remoteItem(from item: MenuItem) -> RemoteMenuItem {
+        let remoteItem = RemoteMenuItem()
+        remoteItem.itemID = item.itemID
+        remoteItem.contentID = item.contentID
+        remoteItem.details = item.details
+        remoteItem.linkTarget = item.linkTarget
+        remoteItem.linkTitle = item.linkTitle
+        remoteItem.name = item.name
+        remoteItem.type = item.type
+        remoteItem.classes = item.classes
+        if let type = item.type {
+            // Override the type_family param based on the type.
+            // This is a weird behavior of the API and is not documented.
+            switch type {
+            case MenuItemType.custom:
+                remoteItem.typeFamily = "custom"
+            case MenuItemType.tag, MenuItemType.category:
+                remoteItem.typeFamily = "taxonomy"
+            default:
+                remoteItem.typeFamily = "post_type"
+            }
+        }
+        remoteItem.typeLabel = item.typeLabel
+        remoteItem.urlStr = item.urlStr
+
+        let children = children(of: item)
+        if !children.isEmpty {
+            remoteItem.children = children.map(remoteItem(from:))
+        }
+        return remoteItem
+    }
+
+    // MARK: - Updating Menus
+
+    /// Updates the items of the menu to match the remote items.
+    ///
+    /// The items are matched by ID: the matching items are only modified where they differ from the
+    /// remote items, the missing ones are inserted, and the ones that are no longer in the menu are
+    /// deleted. The order of the menu is then updated by moving the items that changed position.
+    ///
+    /// The items created locally and never synced don't have an ID yet: they take the remote items
+    /// that match no other item, in menu order, which is the order they were sent in. This way the
+    /// menu editor keeps working with the same objects after saving the menu.
+    @objc(updateItemsOfMenu:withRemoteItems:inContext:)
+    static func updateItems(of menu: Menu, with remoteItems: [RemoteMenuItem]?, in context: NSManagedObjectContext) {
+        let currentItems = menu.items?.array as? [MenuItem] ?? []
+        var unmatchedItems = [NSNumber: MenuItem](minimumCapacity: currentItems.count)
+        for item in currentItems {
+            if let itemID = item.itemID, unmatchedItems[itemID] == nil {
+                unmatchedItems[itemID] = item
+            }
+        }
+
+        var unsyncedItems = currentItems.filter { $0.itemID == nil }[...]
+
+        var orderedItems = [MenuItem]()
+        // Depth-first, so that the children follow their parent.
+        var pending: [(RemoteMenuItem, MenuItem?)] = (remoteItems ?? []).reversed().map { ($0, nil) }
+        while let (remoteItem, parent) = pending.popLast() {
+            let item = remoteItem.itemID.flatMap { unmatchedItems.removeValue(forKey: $0) }
+                ?? unsyncedItems.popFirst()
+                ?? NSEntityDescription.insertNewObject(forEntityName: MenuItem.entityName(), into: context) as! MenuItem
+            item.update(from: remoteItem)
+            if item.parent != parent {
+                item.parent = parent
+            }
+            orderedItems.append(item)
+            for child in (remoteItem.children ?? []).reversed() {
+                pending.append((child, item))
+            }
+        }
+
+        let keptItems = Set(orderedItems.map(ObjectIdentifier.init))
+        for item in currentItems where !keptItems.contains(ObjectIdentifier(item)) {
+            context.delete(item)
+        }
+        reorder(menu, to: orderedItems)
+    }
+
+    /// Sets the items of the menu to `orderedItems`, only moving the items that changed position.
+    ///
+    /// The items that keep their relative order are the longest increasing subsequence of their
+    /// current positions; every other item is removed and inserted at its new position.
+    @objc(reorderMenu:toItems:)
+    static func reorder(_ menu: Menu, to orderedItems: [MenuItem]) {
+        let currentItems = menu.items?.array as? [MenuItem] ?? []
+        guard currentItems != orderedItems else {
+            return
+        }
+
+        let targetItems = Set(orderedItems.map(ObjectIdentifier.init))
+        var currentPositions = [ObjectIdentifier: Int](minimumCapacity: currentItems.count)
+        for (position, item) in currentItems.enumerated() where targetItems.contains(ObjectIdentifier(item)) {
+            currentPositions[ObjectIdentifier(item)] = position
+        }
+        let positions = orderedItems.map { currentPositions[ObjectIdentifier($0)] ?? -1 }
+        let stableIndexes = longestIncreasingSubsequence(of: positions)
+
+        let items = menu.mutableOrderedSetValue(forKey: "items")
+        let stableItems = Set(stableIndexes.map { ObjectIdentifier(orderedItems[$0]) })
+        let removedIndexes = IndexSet(currentItems.indices.filter { !stableItems.contains(ObjectIdentifier(currentItems[$0])) })
+        if !removedIndexes.isEmpty {
+            items.removeObjects(at: removedIndexes)
+        }
+        let stableIndexSet = IndexSet(stableIndexes)
+        let insertedIndexes = IndexSet(orderedItems.indices.filter { !stableIndexSet.contains($0) })
+        if !insertedIndexes.isEmpty {
+            items.insert(insertedIndexes.map { orderedItems[$0] }, at: insertedIndexes)
+        }
+    }
+
+    /// Returns the indexes of a longest strictly increasing subsequence of `values`, ignoring the
+    /// negative values, in O(n log n).
+    static func longestIncreasingSubsequence(of values: [Int]) -> [Int] {
+        // The index of the smallest tail of the increasing subsequences of each length.
+        var tails = [Int]()
+        var predecessors = [Int](repeating: -1, count: values.count)
+        for (index, value) in values.enumerated() where value >= 0 {
+            var low = 0
+            var high = tails.count
+            while low < high {
+                let middle = (low + high) / 2
+                if values[tails[middle]] < value {
+                    low = middle + 1
+                } else {
+                    high = middle
+                }
+            }
+            if low > 0 {
+                predecessors[index] = tails[low - 1]
+            }
+            if low == tails.count {
+                tails.append(index)
+            } else {
+                tails[low] = index
+            }
+        }
+
+        var subsequence = [Int]()
+        var index = tails.last ?? -1
+        while index >= 0 {
+            subsequence.append(index)
+            index = predecessors[index]
+        }
+        return subsequence.reversed()
+    }
+}
+
+private extension MenuItem {
+    func update(from remoteItem: RemoteMenuItem) {
+        setIfChanged(\.itemID, remoteItem.itemID)
+        setIfChanged(\.contentID, remoteItem.contentID)
+        setIfChanged(\.details, remoteItem.details)
+        setIfChanged(\.linkTarget, remoteItem.linkTarget)
+        setIfChanged(\.linkTitle, remoteItem.linkTitle)
+        setIfChanged(\.name, remoteItem.name)
+        setIfChanged(\.type, remoteItem.type)
+        setIfChanged(\.typeFamily, remoteItem.typeFamily)
+        setIfChanged(\.typeLabel, remoteItem.typeLabel)
+        setIfChanged(\.urlStr, remoteItem.urlStr)
+        setIfChanged(\.classes, remoteItem.classes)
+    }
+}
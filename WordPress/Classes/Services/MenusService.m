@@ -217,7 +217,7 @@
     
     NSArray *remoteItems = nil;
     if (menu.items.count) {
-        remoteItems = [self remoteItemsFromMenuItems:menu.items];
+        remoteItems = [[[MenuItemTree alloc] initWithItems:menu.items] remoteItems];
     }
     
     MenusServiceRemote *remote = [[MenusServiceRemote alloc] initWithWordPressComRestApi:blog.wordPressComRestApi];
@@ -230,13 +230,12 @@
                         [self.managedObjectContext performBlock:^{
                             /*
                              Update the local menu with the fresh MenuItems from remote.
-                             We need to replace the MenuItems as it's difficult to keep track of
-                             which items are equal to one another, especially when a menuID is unknown.
+                             The items are matched by ID, the items created locally take the IDs
+                             of the new remote ones.
                              */
-                            menu.items = nil;
-                            for (RemoteMenuItem *remoteItem in remoteMenu.items) {
-                                [self addMenuItemFromRemoteMenuItem:remoteItem forMenu:menu];
-                            }
+                            [MenuItemTree updateItemsOfMenu:menu
+                                            withRemoteItems:remoteMenu.items
+                                                  inContext:self.managedObjectContext];
                             [[ContextManager sharedInstance] saveContext:self.managedObjectContext
                                                      withCompletionBlock:success
                                                                  onQueue:dispatch_get_main_queue()];
@@ -261,44 +260,13 @@
     menu.name = remoteMenu.name;
     menu.details = remoteMenu.details;
     menu.menuID = remoteMenu.menuID;
-    for (RemoteMenuItem *remoteItem in remoteMenu.items) {
-        [self addMenuItemFromRemoteMenuItem:remoteItem forMenu:menu];
-    }
+    [MenuItemTree updateItemsOfMenu:menu
+                    withRemoteItems:remoteMenu.items
+                          inContext:self.managedObjectContext];
     
     return menu;
 }
 
-#pragma mark - MenuItem managed objects via RemoteMenuItem objects
-
-- (MenuItem *)addMenuItemFromRemoteMenuItem:(RemoteMenuItem *)remoteMenuItem forMenu:(Menu *)menu
-{
-    NSEntityDescription *entityDescription = [NSEntityDescription entityForName:[MenuItem entityName]
-                                                         inManagedObjectContext:self.managedObjectContext];
-    
-    MenuItem *item = [[MenuItem alloc] initWithEntity:entityDescription insertIntoManagedObjectContext:self.managedObjectContext];
-    item.itemID = remoteMenuItem.itemID;
-    item.contentID = remoteMenuItem.contentID;
-    item.details = remoteMenuItem.details;
-    item.linkTarget = remoteMenuItem.linkTarget;
-    item.linkTitle = remoteMenuItem.linkTitle;
-    item.name = remoteMenuItem.name;
-    item.type = remoteMenuItem.type;
-    item.typeFamily = remoteMenuItem.typeFamily;
-    item.typeLabel = remoteMenuItem.typeLabel;
-    item.urlStr = remoteMenuItem.urlStr;
-    item.menu = menu;
-    item.classes = remoteMenuItem.classes;
-
-    if (remoteMenuItem.children) {
-        for (RemoteMenuItem *childRemoteItem in remoteMenuItem.children) {
-            MenuItem *childItem = [self addMenuItemFromRemoteMenuItem:childRemoteItem forMenu:menu];
-            childItem.parent = item;
-        }
-    }
-    
-    return item;
-}
-
 #pragma mark - MenuLocations managed objects from RemoteMenuLocation objects
 
 - (NSArray *)menuLocationsFromRemoteMenuLocations:(NSArray<RemoteMenuLocation *> *)remoteMenuLocations
@@ -344,70 +312,4 @@
     }
 }
 
-#pragma mark - RemoteMenu objects from Menu objects
-
-- (NSArray *)remoteItemsFromMenuItems:(NSOrderedSet<MenuItem *> *)menuItems
-{
-    NSMutableArray *remoteItems = [NSMutableArray arrayWithCapacity:menuItems.count];
-    for (MenuItem *item in menuItems) {
-        // Only add top-level items since MenuItem keeps all associated items under it's children relationship.
-        if (item.parent) {
-            continue;
-        }
-        // Children of item will be added as remoteItem.children.
-        RemoteMenuItem *remoteItem = [self remoteItemFromItem:item withItems:menuItems];
-        [remoteItems addObject:remoteItem];
-    }
-    
-    return [NSArray arrayWithArray:remoteItems];
-}
-
-- (RemoteMenuItem *)remoteItemFromItem:(MenuItem *)item withItems:(NSOrderedSet<MenuItem *> *)items
-{
-    RemoteMenuItem *remoteItem = [[RemoteMenuItem alloc] init];
-    remoteItem.itemID = item.itemID;
-    remoteItem.contentID = item.contentID;
-    remoteItem.details = item.details;
-    remoteItem.linkTarget = item.linkTarget;
-    remoteItem.linkTitle = item.linkTitle;
-    remoteItem.name = item.name;
-    remoteItem.type = item.type;
-    remoteItem.classes = item.classes;
-
-    if (remoteItem.type) {
-        // Override the type_family param based on the type.
-        // This is a weird behavior of the API and is not documented.
-        NSString *typeFamily;
-        if ([remoteItem.type isEqualToString:MenuItemType.custom]) {
-            typeFamily = @"custom";
-        } else if ([remoteItem.type isEqualToString:MenuItemType.tag] || [remoteItem.type isEqualToString:MenuItemType.category]){
-            typeFamily = @"taxonomy";
-        } else {
-            typeFamily = @"post_type";
-        }
-        if (typeFamily.length) {
-            remoteItem.typeFamily = typeFamily;
-        }
-    }
-    
-    remoteItem.typeLabel = item.typeLabel;
-    remoteItem.urlStr = item.urlStr;
-    
-    if (item.children.count) {
-        // Find the children of the item and them to remoteItem.children.
-        NSMutableArray *children = [NSMutableArray arrayWithCapacity:item.children.count];
-        for (MenuItem *anItem in items) {
-            if (!anItem.parent) {
-                continue;
-            }
-            if (anItem.parent == item) {
-                [children addObject:[self remoteItemFromItem:anItem withItems:items]];
-            }
-            remoteItem.children = children;
-        }
-    }
-    
-    return remoteItem;
-}
-
 @end
@@ -26,7 +26,8 @@ extension PostHelper {
             return nil
         }
         do {
-            return try JSONSerialization.data(withJSONObject: metadata)
+            // Sort the keys to get the same data for the same metadata
+            return try JSONSerialization.data(withJSONObject: metadata, options: [.sortedKeys])
         } catch {
             wpAssertionFailure("failed to convert metadata to JSON", userInfo: ["error": "\(error)"])
             return nil
@@ -23,69 +23,82 @@ PostServiceType const PostServiceTypeAny = @"any";
         return;
     }
 
+    // The values are only assigned if they differ from the current ones, so that
+    // syncing a post that didn't change on the server leaves it clean.
     NSNumber *previousPostID = post.postID;
-    post.postID = remotePost.postID;
+    [post setValueIfChanged:remotePost.postID forKey:@"postID"];
     // Used to populate author information for self-hosted sites.
     BlogAuthor *author = [post.blog getAuthorWithId:remotePost.authorID];
 
-    post.author = remotePost.authorDisplayName ?: author.displayName;
-    post.authorID = remotePost.authorID;
-    post.date_created_gmt = remotePost.date;
-    post.dateModified = remotePost.dateModified;
-    post.postTitle = remotePost.title;
-    post.permaLink = [remotePost.URL absoluteString];
-    post.content = remotePost.content;
-    post.status = remotePost.status;
-    post.password = remotePost.password;
-    post.order = remotePost.order;
+    [post setValueIfChanged:(remotePost.authorDisplayName ?: author.displayName) forKey:@"author"];
+    [post setValueIfChanged:remotePost.authorID forKey:@"authorID"];
+    [post setValueIfChanged:remotePost.date forKey:@"date_created_gmt"];
+    [post setValueIfChanged:remotePost.dateModified forKey:@"dateModified"];
+    [post setValueIfChanged:remotePost.title forKey:@"postTitle"];
+    [post setValueIfChanged:[remotePost.URL absoluteString] forKey:@"permaLink"];
+    [post setValueIfChanged:remotePost.content forKey:@"content"];
+    [post setValueIfChanged:remotePost.status forKey:@"status"];
+    [post setValueIfChanged:remotePost.password forKey:@"password"];
+    if (post.order != remotePost.order) {
+        post.order = remotePost.order;
+    }
 
     if (remotePost.postThumbnailID != nil) {
-        post.featuredImage = [Media existingOrStubMediaWithMediaID: remotePost.postThumbnailID inBlog:post.blog];
-    } else {
+        if (![post.featuredImage.mediaID isEqual:remotePost.postThumbnailID]) {
+            post.featuredImage = [Media existingOrStubMediaWithMediaID: remotePost.postThumbnailID inBlog:post.blog];
+        }
+    } else if (post.featuredImage != nil) {
         post.featuredImage = nil;
     }
 
-    post.pathForDisplayImage = remotePost.pathForDisplayImage;
-    if (post.pathForDisplayImage.length == 0) {
-        [post updatePathForDisplayImageBasedOnContent];
+    NSString *pathForDisplayImage = remotePost.pathForDisplayImage;
+    if (pathForDisplayImage.length == 0) {
+        pathForDisplayImage = [post pathForDisplayImageBasedOnContent] ?: pathForDisplayImage;
     }
-    post.authorAvatarURL = remotePost.authorAvatarURL ?: author.avatarURL;
-    post.mt_excerpt = remotePost.excerpt;
-    post.wp_slug = remotePost.slug;
-    post.suggested_slug = remotePost.suggestedSlug;
-    post.permalinkTemplateURL = remotePost.permalinkTemplateURL;
+    [post setValueIfChanged:pathForDisplayImage forKey:@"pathForDisplayImage"];
+    [post setValueIfChanged:(remotePost.authorAvatarURL ?: author.avatarURL) forKey:@"authorAvatarURL"];
+    [post setValueIfChanged:remotePost.excerpt forKey:@"mt_excerpt"];
+    [post setValueIfChanged:remotePost.slug forKey:@"wp_slug"];
+    [post setValueIfChanged:remotePost.suggestedSlug forKey:@"suggested_slug"];
+    [post setValueIfChanged:remotePost.permalinkTemplateURL forKey:@"permalinkTemplateURL"];
 
     if ([remotePost.revisions wp_isValidObject]) {
-        post.revisions = [remotePost.revisions copy];
+        [post setValueIfChanged:[remotePost.revisions copy] forKey:@"revisions"];
     }
 
-    if (remotePost.postID != previousPostID) {
+    if (![remotePost.postID isEqual:previousPostID]) {
         [self updateCommentsForPost:post];
     }
 
-    post.rawMetadata = [PostHelper makeRawMetadataFrom:remotePost];
-    post.foreignID = [PostHelper getForeignIDFor:remotePost];
-    [post setParsedOtherTerms:remotePost.otherTerms];
+    [post setValueIfChanged:[PostHelper makeRawMetadataFrom:remotePost] forKey:@"rawMetadata"];
+    [post setValueIfChanged:[PostHelper getForeignIDFor:remotePost] forKey:@"foreignID"];
+    NSDictionary *otherTerms = remotePost.otherTerms ?: @{};
+    if (![post.parsedOtherTerms isEqualToDictionary:otherTerms]) {
+        [post setParsedOtherTerms:otherTerms];
+    }
 
-    post.autosaveTitle = remotePost.autosave.title;
-    post.autosaveExcerpt = remotePost.autosave.excerpt;
-    post.autosaveContent = remotePost.autosave.content;
-    post.autosaveModifiedDate = remotePost.autosave.modifiedDate;
-    post.autosaveIdentifier = remotePost.autosave.identifier;
+    [post setValueIfChanged:remotePost.autosave.title forKey:@"autosaveTitle"];
+    [post setValueIfChanged:remotePost.autosave.excerpt forKey:@"autosaveExcerpt"];
+    [post setValueIfChanged:remotePost.autosave.content forKey:@"autosaveContent"];
+    [post setValueIfChanged:remotePost.autosave.modifiedDate forKey:@"autosaveModifiedDate"];
+    [post setValueIfChanged:remotePost.autosave.identifier forKey:@"autosaveIdentifier"];
 
     if ([post isKindOfClass:[Page class]]) {
         Page *pagePost = (Page *)post;
-        pagePost.parentID = remotePost.parentID;
+        [pagePost setValueIfChanged:remotePost.parentID forKey:@"parentID"];
     } else if ([post isKindOfClass:[Post class]]) {
         Post *postPost = (Post *)post;
-        postPost.commentsStatus = remotePost.commentsStatus;
-        postPost.pingsStatus = remotePost.pingsStatus;
-        postPost.commentCount = remotePost.commentCount;
-        postPost.likeCount = remotePost.likeCount;
-        postPost.postFormat = remotePost.format;
-        postPost.tags = [remotePost.tags componentsJoinedByString:@","];
-        postPost.postType = remotePost.type;
-        postPost.isStickyPost = (remotePost.isStickyPost != nil) ? remotePost.isStickyPost.boolValue : NO;
+        [postPost setValueIfChanged:remotePost.commentsStatus forKey:@"commentsStatus"];
+        [postPost setValueIfChanged:remotePost.pingsStatus forKey:@"pingsStatus"];
+        [postPost setValueIfChanged:remotePost.commentCount forKey:@"commentCount"];
+        [postPost setValueIfChanged:remotePost.likeCount forKey:@"likeCount"];
+        [postPost setValueIfChanged:remotePost.format forKey:@"postFormat"];
+        [postPost setValueIfChanged:[remotePost.tags componentsJoinedByString:@","] forKey:@"tags"];
+        [postPost setValueIfChanged:remotePost.type forKey:@"postType"];
+        BOOL isStickyPost = (remotePost.isStickyPost != nil) ? remotePost.isStickyPost.boolValue : NO;
+        if (postPost.isStickyPost != isStickyPost) {
+            postPost.isStickyPost = isStickyPost;
+        }
         [self updatePost:postPost withRemoteCategories:remotePost.categories inContext:managedObjectContext];
 
         NSString *publicID = nil;
@@ -102,19 +115,19 @@ PostServiceType const PostServiceTypeAny = @"any";
                 publicID = [geoPublicDictionary stringForKey:@"id"];
             }
         }
-        postPost.publicID = publicID;
+        [postPost setValueIfChanged:publicID forKey:@"publicID"];
     }
 }
 
 + (void)updatePost:(Post *)post withRemoteCategories:(NSArray *)remoteCategories inContext:(NSManagedObjectContext *)managedObjectContext {
-    NSMutableSet *categories = [post mutableSetValueForKey:@"categories"];
-    [categories removeAllObjects];
+    NSMutableSet *categories = [NSMutableSet setWithCapacity:remoteCategories.count];
     for (RemotePostCategory *remoteCategory in remoteCategories) {
         PostCategory *category = [PostHelper createOrUpdateCategoryForRemoteCategory:remoteCategory blog:post.blog context:managedObjectContext];
         if (category) {
             [categories addObject:category];
         }
     }
+    [post setObjectsIfChanged:categories forRelationship:@"categories"];
 }
 
 + (void)updateCommentsForPost:(AbstractPost *)post
@@ -604,7 +604,7 @@ extension PostRepository {
                     statuses.isEmpty ? nil : NSPredicate(format: "status IN %@", statuses),
                 ].compactMap { $0 })
 
-                try context.execute(NSBatchDeleteRequest(fetchRequest: request))
+                try context.executeBatchRequest(NSBatchDeleteRequest(fetchRequest: request))
             }
 
             return allPages
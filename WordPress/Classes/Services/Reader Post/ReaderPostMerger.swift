@@ -0,0 +1,463 @@
+import Foundation
+import CoreData
+import WordPressData
+import WordPressKit
+
+/// Merges a page of remote posts into the posts cached for a Reader topic.
+///
+/// All the posts the merge can touch are loaded with a single fetch: the
+/// posts (and the gap marker) of the topic, and the topic-less posts matching
+/// the page by `globalID`. Overlap and gap detection, missing post cleanup,
+/// and trimming are then resolved in memory. Posts that need to be deleted
+/// and have no pending changes are collected in ``pendingDeletions`` and
+/// removed with a single `NSBatchDeleteRequest` once the other changes are
+/// saved, and the deletions are merged into both the working and the view
+/// context.
+///
+/// - warning: Create and use the merger on the queue of `context`.
+@objc final class ReaderPostMerger: NSObject {
+    private let topic: ReaderAbstractTopic
+    private let context: NSManagedObjectContext
+    private let viewContext: NSManagedObjectContext?
+    private let maxPosts: Int
+    private let numberToSync: Int
+
+    /// The posts and the gap markers currently assigned to the topic.
+    private var posts: [ReaderPost] = []
+    /// The topic-less posts that can be re-attached to the topic, by `globalID`.
+    private var detachedPosts: [String: ReaderPost] = [:]
+    /// Persisted posts with no pending changes, to delete with a batch request
+    /// once `context` is saved.
+    @objc private(set) var pendingDeletions: [NSManagedObjectID] = []
+    private var isPrefetched = false
+
+    /// The number of remote posts merged by the last call to ``merge(_:rankedLessThan:deletingEarlier:)``.
+    @objc private(set) var postsCount = 0
+
+    /// `true` if there is room left in the topic for more posts.
+    @objc var hasSpaceAvailable: Bool {
+        posts.lazy.filter { !($0 is ReaderGapMarker) }.count < maxPosts
+    }
+
+    @objc init(
+        topic: ReaderAbstractTopic,
+        context: NSManagedObjectContext,
+        viewContext: NSManagedObjectContext?,
+        maxPosts: Int,
+        numberToSync: Int
+    ) {
+        self.topic = topic
+        self.context = context
+        self.viewContext = viewContext
+        self.maxPosts = maxPosts
+        self.numberToSync = numberToSync
+    }
+
+    // MARK: - Merging
+
+    /// Merges a freshly fetched batch of posts into the existing set of posts
+    /// for the topic. The managed object context is not saved, and the posts
+    /// to delete with a batch request are added to ``pendingDeletions``.
+    ///
+    /// - parameters:
+    ///   - remotePosts: The fetched posts.
+    ///   - rank: The rank of the `before` date the posts were requested for.
+    ///   - deleteEarlier: Delete every post ranked lower than the batch.
+    @objc func merge(_ remotePosts: [RemoteReaderPost], rankedLessThan rank: NSNumber, deletingEarlier deleteEarlier: Bool) {
+        prefetch(globalIDs: remotePosts.compactMap(\.globalID))
+
+        postsCount = remotePosts.count
+        if remotePosts.isEmpty {
+            deletePosts(rankedLessThan: rank.doubleValue)
+        } else {
+            var remotePosts = remotePosts
+            var overlap = false
+
+            if !deleteEarlier {
+                // Before processing the new posts, check if there is an overlap between
+                // what is currently cached, and what is being synced.
+                overlap = hasOverlap(with: remotePosts)
+
+                // A strategy to avoid false positives in gap detection is to sync
+                // one extra post. Only remove the extra post if we received a
+                // full set of results. A partial set means we've reached
+                // the end of syncable content.
+                if remotePosts.count == numberToSync && !ReaderHelpers.isTopicSearchTopic(topic) {
+                    remotePosts.removeLast()
+                    postsCount = remotePosts.count
+                }
+            }
+
+            let newPosts = makePosts(from: remotePosts)
+
+            // When refreshing, some content previously synced may have been deleted remotely.
+            // Remove anything we've synced that is missing.
+            // NOTE that this approach leaves the possibility for older posts to not be cleaned up.
+            deletePosts(missingFrom: newPosts, startingRank: rank.doubleValue)
+
+            if let lastPost = newPosts.last {
+                let lastRank = lastPost.sortRank.doubleValue
+                if deleteEarlier {
+                    deletePosts(rankedLessThan: lastRank)
+                    removeGapMarkers() // Paranoia
+                } else if overlap {
+                    removeGapMarker(ifOverlappedBy: newPosts)
+                } else if posts.contains(where: { $0.sortRank.doubleValue < lastRank }) {
+                    // If there are existing posts older than the oldest of the
+                    // new posts then append a gap placeholder to the end of the
+                    // new posts
+                    insertGapMarker(before: lastPost)
+                }
+            }
+        }
+
+        // Clean up
+        deletePostsInExcessOfMaxAllowed()
+        deletePostsFromBlockedSites()
+    }
+
+    // MARK: - Clean Up
+
+    /// Deletes all posts beyond the max number of posts to be retained.
+    /// The managed object context is not saved.
+    @objc func deletePostsInExcessOfMaxAllowed() {
+        prefetch(globalIDs: [])
+
+        guard posts.count > maxPosts else {
+            return
+        }
+        sortPosts()
+        for post in posts[maxPosts...] {
+            retire(post, keepingIfUsed: true)
+        }
+        posts.removeSubrange(maxPosts...)
+
+        // If the last remaining post is a gap marker, remove it.
+        if let lastPost = posts.last as? ReaderGapMarker {
+            DDLogInfo("Deleting Last GapMarker: \(lastPost)")
+            delete(lastPost)
+            posts.removeLast()
+        }
+    }
+
+    /// Deletes the posts flagged as belonging to a blocked site across all
+    /// topics. The managed object context is not saved, and the posts to
+    /// delete with a batch request are added to ``pendingDeletions``.
+    @objc func deletePostsFromBlockedSites() {
+        prefetch(globalIDs: [])
+
+        // The topic posts might have been updated in memory and be out of sync
+        // with the store, so they are processed here, not by the batch request.
+        posts.removeAll { post in
+            guard post.isSiteBlocked else { return false }
+            retire(post, keepingIfUsed: true)
+            return true
+        }
+
+        let pendingObjectIDs = context.updatedObjects.union(context.deletedObjects).compactMap { object -> NSManagedObjectID? in
+            guard object is ReaderPost else { return nil }
+            return object.objectID
+        }
+        let objectIDs = ReaderPostMerger.postsFromBlockedSites(in: context, excluding: pendingObjectIDs + pendingDeletions)
+        pendingDeletions.append(contentsOf: objectIDs)
+    }
+
+    /// Detaches the posts flagged as belonging to a blocked site that are in
+    /// use or saved from their topics, and returns the other ones, to delete
+    /// with a batch request once `context` is saved.
+    ///
+    /// - parameter excludedObjectIDs: The posts that might have pending
+    /// changes in `context` and must not be touched by the batch request.
+    @objc static func postsFromBlockedSites(
+        in context: NSManagedObjectContext,
+        excluding excludedObjectIDs: [NSManagedObjectID] = []
+    ) -> [NSManagedObjectID] {
+        let usedRequest = NSFetchRequest<ReaderPost>(entityName: ReaderPost.entityName())
+        usedRequest.predicate = NSPredicate(
+            format: "isSiteBlocked = YES AND topic != NULL AND (inUse = YES OR isSavedForLater = YES) AND NOT (SELF IN %@)",
+            excludedObjectIDs
+        )
+        do {
+            for post in try context.fetch(usedRequest) {
+                post.topic = nil
+            }
+        } catch {
+            DDLogError("Error fetching posts from blocked sites: \(error)")
+        }
+
+        let request = NSFetchRequest<NSManagedObjectID>(entityName: ReaderPost.entityName())
+        request.resultType = .managedObjectIDResultType
+        request.predicate = NSPredicate(
+            format: "isSiteBlocked = YES AND inUse = NO AND isSavedForLater = NO AND NOT (SELF IN %@)",
+            excludedObjectIDs
+        )
+        do {
+            return try context.fetch(request)
+        } catch {
+            DDLogError("Error fetching posts from blocked sites: \(error)")
+            return []
+        }
+    }
+
+    /// Deletes the ``pendingDeletions`` with a single batch request.
+    ///
+    /// - warning: Call it once `context` is saved.
+    @objc func commitDeletions() {
+        ReaderPostMerger.batchDeletePosts(pendingDeletions, in: context, viewContext: viewContext)
+        pendingDeletions = []
+    }
+
+    /// Runs `block` in a write and deletes the posts it returns with a batch
+    /// request in the next one, once the changes made by `block` are saved.
+    ///
+    /// The batch request writes to the store right away, so running it in
+    /// the same write would save the changes made by `block` in a separate
+    /// transaction.
+    ///
+    /// - parameter completion: Called on the main queue once the posts are
+    /// deleted and the deletions are merged into the main context.
+    @objc(performAndSaveWithCoreDataStack:usingBlock:completion:)
+    static func performAndSave(
+        with coreDataStack: CoreDataStack,
+        _ block: @escaping (NSManagedObjectContext) -> [NSManagedObjectID],
+        completion: (() -> Void)?
+    ) {
+        var objectIDs: [NSManagedObjectID] = []
+        coreDataStack.performAndSave({ context in
+            objectIDs = block(context)
+        }, completion: {
+            guard !objectIDs.isEmpty else {
+                completion?()
+                return
+            }
+            coreDataStack.performAndSave({ context in
+                batchDeletePosts(objectIDs, in: context, viewContext: coreDataStack.mainContext)
+            }, completion: completion, on: .main)
+        }, on: .main)
+    }
+
+    // MARK: - Private
+
+    private func prefetch(globalIDs: [String]) {
+        guard !isPrefetched else {
+            return
+        }
+        isPrefetched = true
+
+        // The topic is indexed by its foreign key and `globalID` has its own
+        // index, so SQLite resolves each branch of the `OR` with an index.
+        let request = NSFetchRequest<ReaderPost>(entityName: ReaderPost.entityName())
+        request.predicate = NSPredicate(format: "topic = %@ OR (topic = NULL AND globalID IN %@)", topic, globalIDs)
+        request.returnsObjectsAsFaults = false
+        do {
+            for post in try context.fetch(request) {
+                if post.topic == topic {
+                    posts.append(post)
+                } else if let globalID = post.globalID {
+                    detachedPosts[globalID] = post
+                }
+            }
+        } catch {
+            DDLogError("Error fetching posts for topic: \(error)")
+        }
+    }
+
+    private func hasOverlap(with remotePosts: [RemoteReaderPost]) -> Bool {
+        var sortDates: [String: Date] = [:]
+        for post in posts where !(post is ReaderGapMarker) {
+            if let globalID = post.globalID, let sortDate = post.sortDate {
+                sortDates[globalID] = sortDate
+            }
+        }
+        // If at least one date is the same then there is an overlap. If the dates are
+        // different then the existing cached post will be updated. Don't treat this as overlap.
+        return remotePosts.contains { remotePost in
+            guard let globalID = remotePost.globalID, let sortDate = remotePost.sortDate else {
+                return false
+            }
+            return sortDates[globalID] == sortDate
+        }
+    }
+
+    private func makePosts(from remotePosts: [RemoteReaderPost]) -> [ReaderPost] {
+        var existingPosts: [String: ReaderPost] = detachedPosts
+        for post in posts where !(post is ReaderGapMarker) {
+            if let globalID = post.globalID {
+                existingPosts[globalID] = post
+            }
+        }
+        var topicPosts = Set(posts.map(\.objectID))
+        var newPosts: [ReaderPost] = []
+        newPosts.reserveCapacity(remotePosts.count)
+        for remotePost in remotePosts {
+            let existing = remotePost.globalID.flatMap { existingPosts[$0] }
+            let post = ReaderPost.createOrUpdate(with: remotePost, existing: existing, topic: topic, context: context)
+            if let globalID = post.globalID {
+                existingPosts[globalID] = post
+            }
+            if topicPosts.insert(post.objectID).inserted {
+                posts.append(post)
+            }
+            newPosts.append(post)
+        }
+        return newPosts
+    }
+
+    /// Deletes the posts whose rank falls within the range of the given batch
+    /// of posts, but are not included in it.
+    ///
+    /// This lets us remove unliked posts from /read/liked, posts from blogs that are
+    /// unfollowed from /read/following, or posts that were otherwise removed.
+    private func deletePosts(missingFrom batch: [ReaderPost], startingRank highestRank: Double) {
+        guard let lowestRank = batch.last?.sortRank.doubleValue else {
+            return
+        }
+        let batch = Set(batch.map(\.objectID))
+        posts.removeAll { post in
+            let rank = post.sortRank.doubleValue
+            guard rank > lowestRank && rank < highestRank && !batch.contains(post.objectID) else {
+                return false
+            }
+            retire(post, keepingIfUsed: true)
+            return true
+        }
+    }
+
+    /// Deletes the posts ranked lower than the given rank. This handles the
+    /// posts that have been synced but were subsequently removed from the
+    /// result set (deleted, unliked, etc.) rendering the result set empty.
+    private func deletePosts(rankedLessThan rank: Double) {
+        posts.removeAll { post in
+            guard post.sortRank.doubleValue < rank else {
+                return false
+            }
+            retire(post, keepingIfUsed: false)
+            return true
+        }
+    }
+
+    private func removeGapMarker(ifOverlappedBy newPosts: [ReaderPost]) {
+        guard let gapMarker = posts.first(where: { $0 is ReaderGapMarker }),
+              let highestRank = newPosts.first?.sortRank.doubleValue,
+              let lowestRank = newPosts.last?.sortRank.doubleValue else {
+            return
+        }
+        // Confirm the overlap includes the gap marker.
+        let gapRank = gapMarker.sortRank.doubleValue
+        if lowestRank < gapRank && gapRank < highestRank {
+            // No need for a gap placeholder. Remove any that existed
+            removeGapMarkers()
+        }
+    }
+
+    private func insertGapMarker(before post: ReaderPost) {
+        removeGapMarkers()
+
+        let marker = ReaderGapMarker(context: context)
+
+        // Synced posts do not use millisecond precision for their dates. We can take
+        // advantage of this and make our marker post a fraction of a second earlier
+        // than the last post.
+        // We'll store the unmodifed sort date as date_create_gmt so we have a convenient
+        // and accurate date reference should we need it.
+        marker.sortDate = post.sortDate?.addingTimeInterval(-0.1)
+        marker.date_created_gmt = post.sortDate
+
+        // For compatibility with posts that are sorted by score
+        marker.sortRank = NSNumber(value: post.sortRank.doubleValue - Double(CGFloat.leastNormalMagnitude))
+        marker.score = post.score
+
+        marker.topic = topic
+        posts.append(marker)
+    }
+
+    private func removeGapMarkers() {
+        posts.removeAll { post in
+            guard post is ReaderGapMarker else {
+                return false
+            }
+            DDLogInfo("Deleting Gap Marker: \(post)")
+            delete(post)
+            return true
+        }
+    }
+
+    /// Deletes the post, or detaches it from the topic if it is in use or
+    /// saved for later.
+    private func retire(_ post: ReaderPost, keepingIfUsed: Bool) {
+        if post.isSavedForLater || (keepingIfUsed && post.inUse) {
+            post.topic = nil
+        } else {
+            delete(post)
+        }
+    }
+
+    private func delete(_ post: ReaderPost) {
+        if post.objectID.isTemporaryID || post.hasChanges {
+            context.delete(post)
+        } else {
+            pendingDeletions.append(post.objectID)
+        }
+    }
+
+    private func sortPosts() {
+        posts.sort { $0.sortRank.doubleValue > $1.sortRank.doubleValue }
+    }
+
+    /// Deletes the posts with a batch request and merges the deletions into
+    /// the contexts.
+    ///
+    /// The batch request writes to the store right away, so the posts aren't
+    /// deleted if `context` has unsaved changes.
+    private static func batchDeletePosts(_ objectIDs: [NSManagedObjectID], in context: NSManagedObjectContext, viewContext: NSManagedObjectContext?) {
+        guard !objectIDs.isEmpty else {
+            return
+        }
+        guard !context.hasChanges else {
+            wpAssertionFailure("Reader posts batch-deleted before saving the context")
+            return
+        }
+        do {
+            // The result only lists the posts, not the objects the delete rules
+            // of their relationships delete or update in the store.
+            let commentIDs = try fetchObjectIDs(ofEntityNamed: Comment.entityName(), referencing: objectIDs, in: context)
+            let cascadedObjectIDs = try fetchObjectIDs(ofEntityNamed: ReaderCrossPostMeta.entityName(), referencing: objectIDs, in: context)
+                + fetchObjectIDs(ofEntityNamed: SourcePostAttribution.entityName(), referencing: objectIDs, in: context)
+                + commentIDs
+            var nullifiedObjectIDs = try fetchObjectIDs(ofEntityNamed: ReaderCard.entityName(), referencing: objectIDs, in: context)
+            if !commentIDs.isEmpty {
+                // The deleted comments are removed from their blogs too.
+                let request = NSFetchRequest<NSManagedObjectID>(entityName: Blog.entityName())
+                request.resultType = .managedObjectIDResultType
+                request.predicate = NSPredicate(format: "ANY comments IN %@", commentIDs)
+                nullifiedObjectIDs += try context.fetch(request)
+            }
+
+            let request = NSBatchDeleteRequest(objectIDs: objectIDs)
+            request.resultType = .resultTypeObjectIDs
+            let result = try context.executeBatchRequest(request) as? NSBatchDeleteResult
+            let deletedObjectIDs = result?.result as? [NSManagedObjectID] ?? []
+
+            // `executeBatchRequest` lets the persistent history merge the changes into the main
+            // context too, but the merger and its callers rely on them being visible right away.
+            let contexts = [context] + [viewContext].compactMap { $0 }.filter { $0 !== context }
+            NSManagedObjectContext.mergeChanges(
+                fromRemoteContextSave: [
+                    NSDeletedObjectsKey: deletedObjectIDs + cascadedObjectIDs,
+                    NSUpdatedObjectsKey: nullifiedObjectIDs
+                ],
+                into: contexts
+            )
+        } catch {
+            DDLogError("Error deleting Reader posts: \(error)")
+        }
+    }
+
+    /// Returns the objects of the entity whose `post` is one of the given posts.
+    private static func fetchObjectIDs(ofEntityNamed entityName: String, referencing postIDs: [NSManagedObjectID], in context: NSManagedObjectContext) throws -> [NSManagedObjectID] {
+        let request = NSFetchRequest<NSManagedObjectID>(entityName: entityName)
+        request.resultType = .managedObjectIDResultType
+        request.predicate = NSPredicate(format: "post IN %@", postIDs)
+        return try context.fetch(request)
+    }
+}
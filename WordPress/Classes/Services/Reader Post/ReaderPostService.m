@@ -20,8 +20,6 @@ NSUInteger const ReaderPostServiceMaxPosts = 300;
 NSString * const ReaderPostServiceErrorDomain = @"ReaderPostServiceErrorDomain";
 NSString * const ReaderPostServiceToggleSiteFollowingState = @"ReaderPostServiceToggleSiteFollowingState";
 
-static NSString * const ReaderPostGlobalIDKey = @"globalID";
-
 @implementation ReaderPostService
 
 - (instancetype)initWithCoreDataStack:(id<CoreDataStack>)coreDataStack
@@ -605,18 +603,6 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
     return [topic isKindOfClass:[ReaderSearchTopic class]] ? ReaderPostServiceMaxSearchPosts : ReaderPostServiceMaxPosts;
 }
 
-- (NSUInteger)numberOfPostsForTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
-{
-    NSError *error;
-    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:@"ReaderPost"];
-    fetchRequest.includesSubentities = NO; // Exclude gap markers when counting.
-    NSPredicate *pred = [NSPredicate predicateWithFormat:@"topic = %@", topic];
-    [fetchRequest setPredicate:pred];
-
-    NSUInteger count = [context countForFetchRequest:fetchRequest error:&error];
-    return count;
-}
-
 - (NSNumber *)rankForPostAtOffset:(NSUInteger)offset forTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
 {
     NSError *error;
@@ -691,309 +677,38 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
     NSUInteger __block postsCount = 0;
     BOOL __block hasMore = NO;
 
-    [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
+    [ReaderPostMerger performAndSaveWithCoreDataStack:self.coreDataStack usingBlock:^NSArray<NSManagedObjectID *> *(NSManagedObjectContext *context) {
         NSError *error;
         ReaderAbstractTopic *readerTopic = (ReaderAbstractTopic *)[context existingObjectWithID:topicObjectID error:&error];
         if (error || !readerTopic) {
             // if there was an error or the topic was deleted just bail.
-            if (success) {
-                success(0, NO);
-            }
-            return;
-        }
-
-        postsCount = [remotePosts count];
-        if (postsCount == 0) {
-            [self deletePostsRankedLessThan:rank forTopic:readerTopic inContext:context];
-        } else {
-            NSArray *posts = remotePosts;
-            BOOL overlap = NO;
-
-            if (!deleteEarlier) {
-                // Before processing the new posts, check if there is an overlap between
-                // what is currently cached, and what is being synced.
-                overlap = [self checkIfRemotePosts:posts overlapExistingPostsinTopic:readerTopic inContext:context];
-
-                // A strategy to avoid false positives in gap detection is to sync
-                // one extra post. Only remove the extra post if we received a
-                // full set of results. A partial set means we've reached
-                // the end of syncable content.
-                if ([posts count] == [self numberToSyncForTopic:readerTopic] && ![ReaderHelpers isTopicSearchTopic:readerTopic]) {
-                    posts = [posts subarrayWithRange:NSMakeRange(0, [posts count] - 1)];
-                    postsCount = [posts count];
-                }
-
-            }
-
-            // Create or update the synced posts.
-            NSMutableArray *newPosts = [self makeNewPostsFromRemotePosts:posts forTopic:readerTopic inContext:context];
-
-            // When refreshing, some content previously synced may have been deleted remotely.
-            // Remove anything we've synced that is missing.
-            // NOTE that this approach leaves the possibility for older posts to not be cleaned up.
-            [self deletePostsForTopic:readerTopic missingFromBatch:newPosts withStartingRank:rank inContext:context];
-
-            // If deleting earlier, delete every post older than the last post in this batch.
-            if (deleteEarlier) {
-                ReaderPost *lastPost = [newPosts lastObject];
-                [self deletePostsRankedLessThan:lastPost.sortRank forTopic:readerTopic inContext:context];
-                [self removeGapMarkerForTopic:readerTopic inContext:context]; // Paranoia
-
-            } else {
-
-                // Handle an overlap in posts that were synced
-                if (overlap) {
-                    [self removeGapMarkerForTopic:readerTopic ifNewPostsOverlapMarker:newPosts inContext:context];
-
-                } else {
-                    // If there are existing posts older than the oldest of the
-                    // new posts then append a gap placeholder to the end of the
-                    // new posts
-                    ReaderPost *lastPost = [newPosts lastObject];
-                    if ([self topic:readerTopic hasPostsRankedLessThan:lastPost.sortRank inContext:context]) {
-                        [self insertGapMarkerBeforePost:lastPost forTopic:readerTopic inContext:context];
-                    }
-                }
-            }
+            return @[];
         }
 
-        // Clean up
-        [self deletePostsInExcessOfMaxAllowedForTopic:readerTopic inContext:context];
-        [self deletePostsFromBlockedSitesInContext:context];
+        ReaderPostMerger *merger = [self mergerForTopic:readerTopic inContext:context];
+        [merger merge:remotePosts rankedLessThan:rank deletingEarlier:deleteEarlier];
 
-        BOOL spaceAvailable = ([self numberOfPostsForTopic:readerTopic inContext:context] < [self maxPostsToSaveForTopic:readerTopic]);
-        hasMore = postsCount > 0 && spaceAvailable;
+        postsCount = merger.postsCount;
+        hasMore = postsCount > 0 && merger.hasSpaceAvailable;
+        return merger.pendingDeletions;
     } completion:^{
         if (success) {
             success(postsCount, hasMore);
         }
-    } onQueue:dispatch_get_main_queue()];
-}
-
-- (BOOL)checkIfRemotePosts:(NSArray *)remotePosts overlapExistingPostsinTopic:(ReaderAbstractTopic *)readerTopic inContext:(NSManagedObjectContext *)context
-{
-    // Get global IDs of new posts to use as part of the predicate.
-    NSSet *remoteGlobalIDs = [self globalIDsOfRemotePosts:remotePosts];
-
-    // Fetch matching existing posts.
-    NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:NSStringFromClass([ReaderPost class])];
-    fetchRequest.predicate = [NSPredicate predicateWithFormat:@"topic = %@ AND globalID in %@", readerTopic, remoteGlobalIDs];
-
-    NSError *error;
-    NSArray *results = [context executeFetchRequest:fetchRequest error:&error];
-    if (error) {
-        DDLogError(error.localizedDescription);
-        return NO;
-    }
-
-    // For each match, check that the dates are the same.  If at least one date is the same then there is an overlap so return true.
-    // If the dates are different then the existing cached post will be updated. Don't treat this as overlap.
-    for (ReaderPost *post in results) {
-        for (RemoteReaderPost *remotePost in remotePosts) {
-            if (![remotePost.globalID isEqualToString:post.globalID]) {
-                continue;
-            }
-            if ([post.sortDate isEqualToDate:remotePost.sortDate]) {
-                return YES;
-            }
-        }
-    }
-
-    return NO;
-}
-
-#pragma mark Gap Detection Methods
-
-- (void)removeGapMarkerForTopic:(ReaderAbstractTopic *)topic ifNewPostsOverlapMarker:(NSArray *)newPosts inContext:(NSManagedObjectContext *)context
-{
-    ReaderGapMarker *gapMarker = [self gapMarkerForTopic:topic inContext:context];
-    if (gapMarker) {
-        double highestRank = [((ReaderPost *)newPosts.firstObject).sortRank doubleValue];
-        double lowestRank = [((ReaderPost *)newPosts.lastObject).sortRank doubleValue];
-        double gapRank = [gapMarker.sortRank doubleValue];
-        // Confirm the overlap includes the gap marker.
-        if (lowestRank < gapRank && gapRank < highestRank) {
-            // No need for a gap placeholder. Remove any that existed
-            [self removeGapMarkerForTopic:topic inContext:context];
-        }
-    }
-}
-
-- (ReaderGapMarker *)gapMarkerForTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
-{
-    NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:NSStringFromClass([ReaderGapMarker class])];
-    fetchRequest.predicate = [NSPredicate predicateWithFormat:@"topic = %@", topic];
-
-    NSError *error;
-    NSArray *results = [context executeFetchRequest:fetchRequest error:&error];
-    if (error) {
-        DDLogError(error.localizedDescription);
-        return nil;
-    }
-
-    // Assume there will ever only be one and return the first result.
-    return results.firstObject;
-}
-
-- (void)insertGapMarkerBeforePost:(ReaderPost *)post forTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
-{
-    [self removeGapMarkerForTopic:topic inContext:context];
-
-    ReaderGapMarker *marker = [NSEntityDescription insertNewObjectForEntityForName:NSStringFromClass([ReaderGapMarker class])
-                                                            inManagedObjectContext:context];
-
-    // Synced posts do not use millisecond precision for their dates. We can take
-    // advantage of this and make our marker post a fraction of a second earlier
-    // than the last post.
-    // We'll store the unmodifed sort date as date_create_gmt so we have a convenient
-    // and accurate date reference should we need it.
-    marker.sortDate = [post.sortDate dateByAddingTimeInterval:-0.1];
-    marker.date_created_gmt = post.sortDate;
-
-    // For compatibility with posts that are sorted by score
-    marker.sortRank = @([post.sortRank doubleValue] - CGFLOAT_MIN);
-    marker.score = post.score;
-
-    marker.topic = topic;
-}
-
-
-- (void)removeGapMarkerForTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
-{
-    NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:NSStringFromClass([ReaderGapMarker class])];
-    fetchRequest.predicate = [NSPredicate predicateWithFormat:@"topic = %@", topic];
-
-    NSError *error;
-    NSArray *results = [context executeFetchRequest:fetchRequest error:&error];
-    if (error) {
-        DDLogError(error.localizedDescription);
-        return;
-    }
-
-    // There should only ever be one, but loop over all results just in case.
-    for (ReaderGapMarker *marker in results) {
-        DDLogInfo(@"Deleting Gap Marker: %@", marker);
-        [context deleteObject:marker];
-    }
-}
-
-- (BOOL)topic:(ReaderAbstractTopic *)topic hasPostsRankedLessThan:(NSNumber *)rank inContext:(NSManagedObjectContext *)context
-{
-    NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:NSStringFromClass([ReaderPost class])];
-    fetchRequest.predicate = [NSPredicate predicateWithFormat:@"topic = %@ AND sortRank < %@", topic, rank];
-
-    NSError *error;
-    NSInteger count = [context countForFetchRequest:fetchRequest error:&error];
-    if (error) {
-        DDLogError(error.localizedDescription);
-        return NO;
-    }
-    return (count > 0);
+    }];
 }
 
-- (NSSet *)globalIDsOfRemotePosts:(NSArray *)remotePosts
+- (ReaderPostMerger *)mergerForTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
 {
-    NSMutableArray *arr = [NSMutableArray array];
-    for (RemoteReaderPost *post in remotePosts) {
-        [arr addObject:post.globalID];
-    }
-    // return non-mutable array
-    return [NSSet setWithArray:arr];
+    return [[ReaderPostMerger alloc] initWithTopic:topic
+                                           context:context
+                                       viewContext:self.coreDataStack.mainContext
+                                          maxPosts:[self maxPostsToSaveForTopic:topic]
+                                      numberToSync:[self numberToSyncForTopic:topic]];
 }
 
-
 #pragma mark Deletion and Clean up
 
-/**
- Deletes any existing post whose sortRank is less than the passed rank. This
- is to handle situations where posts have been synced but were subsequently removed
- from the result set (deleted, unliked, etc.) rendering the result set empty.
-
- @param rank The sortRank to delete posts less than.
- @param topic The `ReaderAbstractTopic` to delete posts from.
- */
-- (void)deletePostsRankedLessThan:(NSNumber *)rank forTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
-{
-    // Don't trust the relationships on the topic to be current or correct.
-    NSError *error;
-    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:@"ReaderPost"];
-
-    NSPredicate *pred = [NSPredicate predicateWithFormat:@"topic = %@ AND sortRank < %@", topic, rank];
-    [fetchRequest setPredicate:pred];
-
-    NSSortDescriptor *sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"sortRank" ascending:NO];
-    [fetchRequest setSortDescriptors:@[sortDescriptor]];
-
-    NSArray *currentPosts = [context executeFetchRequest:fetchRequest error:&error];
-    if (error) {
-        DDLogError(@"%@ error fetching posts: %@", NSStringFromSelector(_cmd), error);
-        return;
-    }
-
-    for (ReaderPost *post in currentPosts) {
-        if (post.isSavedForLater) {
-            // If the missing post is currently being used or has been saved, just remove its topic.
-            post.topic = nil;
-        } else {
-            DDLogInfo(@"Deleting ReaderPost: %@", post);
-            [context deleteObject:post];
-        }
-    }
-}
-
-/**
- Using an array of post as a filter, deletes any existing post whose sortRank falls
- within the range of the filter posts, but is not included in the filter posts.
-
- This let's us remove unliked posts from /read/liked, posts from blogs that are
- unfollowed from /read/following, or posts that were otherwise removed.
-
- The managed object context is not saved.
-
- @param topic The ReaderAbstractTopic to delete posts from.
- @param posts The batch of posts to use as a filter.
- @param startingRank The starting rank of the batch of posts. May be less than the highest ranked post in the batch.
- */
-- (void)deletePostsForTopic:(ReaderAbstractTopic *)topic
-           missingFromBatch:(NSArray *)posts
-           withStartingRank:(NSNumber *)startingRank
-                  inContext:(NSManagedObjectContext *)context
-{
-    // Don't trust the relationships on the topic to be current or correct.
-    NSError *error;
-    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:@"ReaderPost"];
-
-    NSNumber *highestRank = startingRank;
-
-    NSNumber *lowestRank = ((ReaderPost *)[posts lastObject]).sortRank;
-    NSPredicate *pred = [NSPredicate predicateWithFormat:@"topic == %@ AND sortRank > %@ AND sortRank < %@", topic, lowestRank, highestRank];
-
-    [fetchRequest setPredicate:pred];
-
-    NSSortDescriptor *sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"sortRank" ascending:NO];
-    [fetchRequest setSortDescriptors:@[sortDescriptor]];
-
-    NSArray *currentPosts = [context executeFetchRequest:fetchRequest error:&error];
-    if (error) {
-        DDLogError(@"%@ error fetching posts: %@", NSStringFromSelector(_cmd), error);
-        return;
-    }
-
-    for (ReaderPost *post in currentPosts) {
-        if ([posts containsObject:post]) {
-            continue;
-        }
-        // The post was missing from the batch and needs to be cleaned up.
-        if ([self topicShouldBeClearedFor:post]) {
-            // If the missing post is currently being used or has been saved, just remove its topic.
-            post.topic = nil;
-        } else {
-            DDLogInfo(@"Deleting ReaderPost: %@", post);
-            [context deleteObject:post];
-        }
-    }
-}
-
 /**
  Delete all `ReaderPosts` beyond the max number to be retained.
 
@@ -1003,55 +718,16 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
  */
 - (void)deletePostsInExcessOfMaxAllowedForTopic:(ReaderAbstractTopic *)topic
 {
-    [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
-        [self deletePostsInExcessOfMaxAllowedForTopic:topic inContext:context];
-    }];
-}
-
-- (void)deletePostsInExcessOfMaxAllowedForTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
-{
-    // Don't trust the relationships on the topic to be current or correct.
-    NSError *error;
-    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] initWithEntityName:@"ReaderPost"];
-
-    NSPredicate *pred = [NSPredicate predicateWithFormat:@"topic = %@", topic];
-    [fetchRequest setPredicate:pred];
-
-    NSSortDescriptor *sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"sortRank" ascending:NO];
-    [fetchRequest setSortDescriptors:@[sortDescriptor]];
-
-    NSUInteger maxPosts = [self maxPostsToSaveForTopic:topic];
-
-    // Specifying a fetchOffset to just get the posts in range doesn't seem to work very well.
-    // Just perform the fetch and remove the excess.
-    NSUInteger count = [context countForFetchRequest:fetchRequest error:&error];
-    if (count <= maxPosts) {
-        return;
-    }
-
-    NSArray *posts = [context executeFetchRequest:fetchRequest error:&error];
-    if (error) {
-        DDLogError(@"%@ error fetching posts: %@", NSStringFromSelector(_cmd), error);
-        return;
-    }
-
-    NSRange range = NSMakeRange(maxPosts, [posts count] - maxPosts);
-    NSArray *postsToDelete = [posts subarrayWithRange:range];
-    for (ReaderPost *post in postsToDelete) {
-        if ([self topicShouldBeClearedFor:post]) {
-            post.topic = nil;
-        } else {
-            DDLogInfo(@"Deleting ReaderPost: %@", post.postTitle);
-            [context deleteObject:post];
+    NSManagedObjectID *topicObjectID = topic.objectID;
+    [ReaderPostMerger performAndSaveWithCoreDataStack:self.coreDataStack usingBlock:^NSArray<NSManagedObjectID *> *(NSManagedObjectContext *context) {
+        ReaderAbstractTopic *readerTopic = (ReaderAbstractTopic *)[context existingObjectWithID:topicObjectID error:nil];
+        if (!readerTopic) {
+            return @[];
         }
-    }
-
-    // If the last remaining post is a gap marker, remove it.
-    ReaderPost *lastPost = [posts objectAtIndex:maxPosts - 1];
-    if ([lastPost isKindOfClass:[ReaderGapMarker class]]) {
-        DDLogInfo(@"Deleting Last GapMarker: %@", lastPost);
-        [context deleteObject:lastPost];
-    }
+        ReaderPostMerger *merger = [self mergerForTopic:readerTopic inContext:context];
+        [merger deletePostsInExcessOfMaxAllowed];
+        return merger.pendingDeletions;
+    } completion:nil];
 }
 
 /**
@@ -1061,72 +737,9 @@ static NSString * const ReaderPostGlobalIDKey = @"globalID";
  */
 - (void)deletePostsFromBlockedSites
 {
-    [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
-        [self deletePostsFromBlockedSitesInContext:context];
-    }];
-}
-
-- (void)deletePostsFromBlockedSitesInContext:(NSManagedObjectContext *)context
-{
-    NSError *error;
-    NSFetchRequest *request = [[NSFetchRequest alloc] initWithEntityName:@"ReaderPost"];
-    request.predicate = [NSPredicate predicateWithFormat:@"isSiteBlocked = YES"];
-    NSArray *results = [context executeFetchRequest:request error:&error];
-    if (error) {
-        DDLogError(@"%@, error deleting deleting posts from blocked sites: %@", NSStringFromSelector(_cmd), error);
-        return;
-    }
-
-    if ([results count] == 0) {
-        return;
-    }
-
-    for (ReaderPost *post in results) {
-        if ([self topicShouldBeClearedFor:post]) {
-            // If the missing post is currenty being used just remove its topic.
-            post.topic = nil;
-        } else {
-            DDLogInfo(@"Deleting ReaderPost: %@", post.postTitle);
-            [context deleteObject:post];
-        }
-    }
-}
-
-- (BOOL)topicShouldBeClearedFor:(ReaderPost *)post
-{
-    return (post.inUse || post.isSavedForLater);
-}
-
-
-#pragma mark Entity Creation
-
-/**
- Accepts an array of `RemoteReaderPost` objects and creates model objects
- for each one.
-
- @param posts An array of `RemoteReaderPost` objects.
- @param topic The `ReaderAbsractTopic` to assign to the created posts.
- @return An array of `ReaderPost` objects
- */
-- (NSMutableArray *)makeNewPostsFromRemotePosts:(NSArray *)posts forTopic:(ReaderAbstractTopic *)topic inContext:(NSManagedObjectContext *)context
-{
-    NSMutableArray *newPosts = [NSMutableArray array];
-    for (RemoteReaderPost *post in posts) {
-        ReaderPost *newPost = [ReaderPost createOrUpdateWithRemotePost:post topic:topic context:context];
-        if (newPost != nil) {
-            [newPosts addObject:newPost];
-        } else {
-            DDLogInfo(@"%@ returned a nil post: %@", NSStringFromSelector(_cmd), post);
-        }
-    }
-    return newPosts;
-}
-
-#pragma mark Internal
-
-- (BOOL)canLoadMorePostsForTopic:(ReaderAbstractTopic * _Nonnull)readerTopic remotePosts:(NSArray * _Nonnull)remotePosts inContext: (NSManagedObjectContext * _Nonnull)context {
-    BOOL spaceAvailable = ([self numberOfPostsForTopic:readerTopic inContext:context] < [self maxPostsToSaveForTopic:readerTopic]);
-    return [remotePosts count] > 0 && spaceAvailable;
+    [ReaderPostMerger performAndSaveWithCoreDataStack:self.coreDataStack usingBlock:^NSArray<NSManagedObjectID *> *(NSManagedObjectContext *context) {
+        return [ReaderPostMerger postsFromBlockedSitesIn:context excluding:@[]];
+    } completion:nil];
 }
 
 @end
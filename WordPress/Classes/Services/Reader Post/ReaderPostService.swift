@@ -109,10 +109,6 @@ extension ReaderPostService {
         let filteredPosts = self.coreDataStack.performQuery { context in
             self.remotePostsByFilteringOutBlockedPosts(posts, in: context)
         }
-        let hasMore = self.coreDataStack.performQuery { context in
-            guard let topic = try? context.existingObject(with: topicObjectID) as? ReaderAbstractTopic else { return false }
-            return self.canLoadMorePosts(for: topic, remotePosts: posts, in: context)
-        }
 
         // Persist filtered posts locally.
         self.persistRemotePosts(
@@ -121,7 +117,6 @@ extension ReaderPostService {
             topicObjectID: topicObjectID,
             beforeDate: date,
             deletingEarlier: deletingEarlier,
-            hasMoreContent: hasMore,
             success: success
         )
 
@@ -136,7 +131,6 @@ extension ReaderPostService {
         topicObjectID: NSManagedObjectID,
         beforeDate date: Date,
         deletingEarlier: Bool,
-        hasMoreContent hasMore: Bool,
         success: SuccessCallback? = nil
     ) {
         // We don't want to call `mergePosts` if all posts are blocked, henced filtered out.
@@ -144,11 +138,12 @@ extension ReaderPostService {
         let allPostsAreFilteredOut = filteredPosts.isEmpty && !posts.isEmpty
         if !allPostsAreFilteredOut {
             let rank = date.timeIntervalSinceReferenceDate as NSNumber
-            self.mergePosts(filteredPosts, rankedLessThan: rank, forTopic: topicObjectID, deletingEarlier: deletingEarlier) { count, _ in
+            self.mergePosts(filteredPosts, rankedLessThan: rank, forTopic: topicObjectID, deletingEarlier: deletingEarlier) { count, hasMore in
                 success?(count, hasMore)
             }
         } else {
-            success?(filteredPosts.count, hasMore)
+            // The stream returned posts, so there may be more of them.
+            success?(filteredPosts.count, true)
         }
     }
 
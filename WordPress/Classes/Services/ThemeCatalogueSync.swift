@@ -0,0 +1,171 @@
+import Foundation
+import CoreData
+import WordPressData
+import WordPressKit
+
+/// Merges a theme listing into the themes stored for a blog.
+///
+/// - The listing is merged with a single keyed fetch of the stored themes it contains, and the
+///   stored themes are only modified when a value changed, so unchanged themes aren't saved again.
+/// - The identifiers of the merged themes are remembered, so the themes that are no longer
+///   available are found by comparing identifiers.
+///
+/// A sync covers a single listing: create a new one for each listing to merge.
+@objc final class ThemeCatalogueSync: NSObject {
+    /// The stored themes of a blog that a listing replaces.
+    @objc enum Scope: Int {
+        /// All the themes of the blog.
+        case all
+        /// The WordPress.com themes, leaving the custom themes alone.
+        case wordPressCom
+        /// The custom themes, leaving the WordPress.com themes alone.
+        case custom
+    }
+
+    /// The order of a theme loaded without one: after the themes of the loaded pages.
+    static let trailingOrder = 9999
+
+    private let scope: Scope
+    private var mergedThemeIDs = Set<String>()
+
+    @objc init(scope: Scope) {
+        self.scope = scope
+    }
+
+    /// Merges the listing, and returns the stored themes in the order of `remoteThemes`.
+    ///
+    @objc(mergeRemoteThemes:forBlog:inContext:)
+    func merge(_ remoteThemes: [RemoteTheme], blog: Blog?, in context: NSManagedObjectContext) -> [Theme] {
+        let themes = Self.merge(remoteThemes, custom: scope == .custom, blog: blog, in: context)
+        mergedThemeIDs.formUnion(themes.compactMap(\.themeId))
+        return themes
+    }
+
+    /// Deletes the stored themes in the scope of the listing that it didn't contain, including the
+    /// themes without an identifier, except the blog's current theme.
+    ///
+    @objc(deleteUnmergedThemesForBlog:inContext:)
+    func deleteUnmergedThemes(for blog: Blog, in context: NSManagedObjectContext) {
+        var unmerged = NSPredicate(format: "NOT (themeId IN %@)", Array(mergedThemeIDs))
+        if let currentThemeId = blog.currentThemeId {
+            unmerged = NSCompoundPredicate(andPredicateWithSubpredicates: [
+                unmerged,
+                NSPredicate(format: "themeId != %@", currentThemeId)
+            ])
+        }
+        var predicates = [
+            NSPredicate(format: "blog == %@", blog),
+            // `themeId IN` and `themeId !=` are both false for a nil identifier.
+            NSCompoundPredicate(orPredicateWithSubpredicates: [NSPredicate(format: "themeId == nil"), unmerged])
+        ]
+        switch scope {
+        case .all:
+            break
+        case .wordPressCom:
+            predicates.append(NSPredicate(format: "custom == NO"))
+        case .custom:
+            predicates.append(NSPredicate(format: "custom == YES"))
+        }
+
+        let request = NSFetchRequest<Theme>(entityName: Theme.entityName())
+        request.predicate = NSCompoundPredicate(andPredicateWithSubpredicates: predicates)
+        request.includesPropertyValues = false
+        let unmergedThemes = (try? context.fetch(request)) ?? []
+        for theme in unmergedThemes {
+            context.delete(theme)
+        }
+    }
+
+    // MARK: - Merging
+
+    /// Creates or updates the stored themes matching `remoteThemes`, leaving whether they are custom
+    /// alone: unlike a listing, a single theme doesn't tell.
+    ///
+    @objc(themesFromRemoteThemes:forBlog:inContext:)
+    static func merge(_ remoteThemes: [RemoteTheme], blog: Blog?, in context: NSManagedObjectContext) -> [Theme] {
+        merge(remoteThemes, custom: nil, blog: blog, in: context)
+    }
+
+    /// Creates or updates the stored themes matching `remoteThemes`, with a single fetch.
+    ///
+    /// - Parameter custom: Whether the themes are custom, or `nil` to leave it unchanged.
+    static func merge(_ remoteThemes: [RemoteTheme], custom: Bool?, blog: Blog?, in context: NSManagedObjectContext) -> [Theme] {
+        let themeIDs = remoteThemes.compactMap(\.themeId)
+        var storedThemes = fetchThemes(withIDs: themeIDs, blog: blog, in: context)
+
+        return remoteThemes.map { remoteTheme in
+            let theme: Theme
+            if let themeId = remoteTheme.themeId, let storedTheme = storedThemes[themeId] {
+                theme = storedTheme
+            } else {
+                theme = NSEntityDescription.insertNewObject(forEntityName: Theme.entityName(), into: context) as! Theme
+                if let blog {
+                    theme.blog = blog
+                }
+                if let themeId = remoteTheme.themeId {
+                    // The listings can contain the same theme twice.
+                    storedThemes[themeId] = theme
+                }
+            }
+            update(theme, from: remoteTheme, custom: custom)
+            if let blog, remoteTheme.active, blog.currentThemeId != theme.themeId {
+                blog.currentThemeId = theme.themeId
+            }
+            return theme
+        }
+    }
+
+    private static func fetchThemes(withIDs themeIDs: [String], blog: Blog?, in context: NSManagedObjectContext) -> [String: Theme] {
+        guard !themeIDs.isEmpty else {
+            return [:]
+        }
+        let request = NSFetchRequest<Theme>(entityName: Theme.entityName())
+        if let blog {
+            request.predicate = NSPredicate(format: "themeId IN %@ AND blog == %@", themeIDs, blog)
+        } else {
+            request.predicate = NSPredicate(format: "themeId IN %@ AND blog.@count == 0", themeIDs)
+        }
+        request.returnsObjectsAsFaults = false
+
+        let themes = (try? context.fetch(request)) ?? []
+        var themesByID = [String: Theme](minimumCapacity: themes.count)
+        for theme in themes {
+            guard let themeId = theme.themeId, themesByID[themeId] == nil else {
+                continue
+            }
+            themesByID[themeId] = theme
+        }
+        return themesByID
+    }
+
+    private static func update(_ theme: Theme, from remoteTheme: RemoteTheme, custom: Bool?) {
+        if remoteTheme.author != nil {
+            theme.setIfChanged(\.author, remoteTheme.author)
+            theme.setIfChanged(\.authorUrl, remoteTheme.authorUrl)
+        }
+        theme.setIfChanged(\.demoUrl, remoteTheme.demoUrl)
+        theme.setIfChanged(\.themeUrl, remoteTheme.themeUrl)
+        theme.setIfChanged(\.details, remoteTheme.desc)
+        theme.setIfChanged(\.launchDate, remoteTheme.launchDate)
+        theme.setIfChanged(\.name, remoteTheme.name)
+        if remoteTheme.order != 0 {
+            theme.setIfChanged(\.order, NSNumber(value: remoteTheme.order))
+        } else if theme.order?.intValue ?? 0 == 0 {
+            theme.setIfChanged(\.order, NSNumber(value: trailingOrder))
+        }
+        theme.setIfChanged(\.popularityRank, remoteTheme.popularityRank)
+        theme.setIfChanged(\.previewUrl, remoteTheme.previewUrl)
+        let availableFree = remoteTheme.purchased?.boolValue == true || remoteTheme.type != "managed-external"
+        theme.setIfChanged(\.premium, NSNumber(value: !availableFree))
+        theme.setIfChanged(\.price, remoteTheme.price)
+        theme.setIfChanged(\.purchased, remoteTheme.purchased)
+        theme.setIfChanged(\.screenshotUrl, remoteTheme.screenshotUrl)
+        theme.setIfChanged(\.stylesheet, remoteTheme.stylesheet)
+        theme.setIfChanged(\.themeId, remoteTheme.themeId)
+        theme.setIfChanged(\.trendingRank, remoteTheme.trendingRank)
+        theme.setIfChanged(\.version, remoteTheme.version)
+        if let custom {
+            theme.setIfChanged(\.custom, custom)
+        }
+    }
+}
@@ -4,12 +4,6 @@
 @import WordPressData;
 @import WordPressKit;
 
-/**
- *  @brief      Place unordered themes after loaded pages
- */
-const NSInteger ThemeOrderUnspecified = 0;
-const NSInteger ThemeOrderTrailing = 9999;
-
 @implementation ThemeService
 
 - (instancetype)initWithCoreDataStack:(id<CoreDataStack>)coreDataStack
@@ -30,95 +24,6 @@ const NSInteger ThemeOrderTrailing = 9999;
     return [blog supports:BlogFeatureWpComRESTAPI];
 }
 
-#pragma mark - Local queries: Creating themes
-
-/**
- *  @brief      Creates and initializes a new theme with the specified theme Id in the specified
- *              context.
- *  @details    You should probably not call this method directly.  Please read the documentation
- *              for findOrCreateThemeWithId: first.
- *
- *  @param      themeId     The ID of the new theme.  Cannot be nil.
- *  @param      blog        Blog being updated. May be nil for account.
- *
- *  @returns    The newly created and initialized object.
- */
-- (Theme *)newThemeWithId:(NSString *)themeId
-                  forBlog:(nullable Blog *)blog
-                inContext:(NSManagedObjectContext *)context
-{
-    NSParameterAssert([themeId isKindOfClass:[NSString class]]);
-    
-    NSEntityDescription *entityDescription = [NSEntityDescription entityForName:[Theme entityName]
-                                                         inManagedObjectContext:context];
-    
-    Theme *theme = [[Theme alloc] initWithEntity:entityDescription
-                          insertIntoManagedObjectContext:context];
-    if (blog) {
-       theme.blog = blog;
-    }
-
-    return theme;
-}
-
-/**
- *  @brief      Obtains the theme with the specified ID if it exists, otherwise a new theme is
- *              created and returned.
- *
- *  @param      themeId     The ID of the theme to retrieve.  Cannot be nil.
- *  @param      blog        Blog being updated. May be nil for account.
- *
- *  @returns    The stored theme matching the specified ID if found, or nil if it's not found.
- */
-- (Theme *)findOrCreateThemeWithId:(NSString *)themeId
-                           forBlog:(nullable Blog *)blog
-                         inContext:(NSManagedObjectContext *)context
-{
-    NSParameterAssert([themeId isKindOfClass:[NSString class]]);
-    
-    Theme *theme = [self findThemeWithId:themeId forBlog:blog inContext:context];
-    
-    if (!theme) {
-        theme = [self newThemeWithId:themeId forBlog:blog inContext:context];
-    }
-    
-    return theme;
-}
-
-#pragma mark - Local queries: finding themes
-
-- (Theme *)findThemeWithId:(NSString *)themeId
-                   forBlog:(nullable Blog *)blog
-                 inContext:(NSManagedObjectContext *)context
-{
-    NSParameterAssert([themeId isKindOfClass:[NSString class]]);
-    
-    Theme *theme = nil;
-    
-    NSPredicate *predicate = nil;
-    if (blog) {
-        predicate = [NSPredicate predicateWithFormat:@"themeId == %@ AND blog == %@", themeId, blog];
-    } else {
-        predicate = [NSPredicate predicateWithFormat:@"themeId == %@ AND blog.@count == 0", themeId, blog];
-    }
-    NSFetchRequest *fetchRequest = [NSFetchRequest fetchRequestWithEntityName:[Theme entityName]];
-    fetchRequest.predicate = predicate;
-    
-    NSError *error = nil;
-    NSArray *results = [context executeFetchRequest:fetchRequest error:&error];
-    
-    if (results.count > 0) {
-        theme = (Theme *)[results firstObject];
-        NSAssert([theme isKindOfClass:[Theme class]],
-                 @"Expected a Theme object.");
-    } else {
-        NSAssert(error == nil,
-                 @"We shouldn't be getting errors here.  This means something's internally broken.");
-    }
-    
-    return theme;
-}
-
 #pragma mark - Remote queries: Getting theme info
 
 - (NSProgress *)getActiveThemeForBlog:(Blog *)blog
@@ -179,27 +84,16 @@ const NSInteger ThemeOrderTrailing = 9999;
                                 search:search
                               freeOnly:![blog supports:BlogFeaturePremiumThemes]
                                success:^(NSArray<RemoteTheme *> *remoteThemes, BOOL hasMore, NSInteger totalThemeCount) {
+                                   ThemeCatalogueSync *catalogueSync = [[ThemeCatalogueSync alloc] initWithScope:ThemeCatalogueSyncScopeWordPressCom];
                                    NSArray * __block themeObjectIDs = nil;
                                    [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
                                        Blog *blogInContext = [context existingObjectWithID:blog.objectID error:nil];
-                                       NSArray *themes = [self themesFromRemoteThemes:remoteThemes
-                                                                               forBlog:blogInContext
-                                                                               inContext:context];
+                                       NSArray *themes = [catalogueSync mergeRemoteThemes:remoteThemes
+                                                                                   forBlog:blogInContext
+                                                                                 inContext:context];
                                        if (sync) {
-                                           NSMutableSet *unsyncedThemes = [NSMutableSet setWithSet:blogInContext.themes];
                                            // We don't want to touch custom themes here, only WP.com themes
-                                           NSMutableSet *unsyncedWPThemes = [unsyncedThemes mutableCopy];
-                                           for (Theme *theme in unsyncedThemes) {
-                                               if (theme.custom) {
-                                                   [unsyncedWPThemes removeObject:theme];
-                                               }
-                                           }
-                                           [unsyncedWPThemes minusSet:[NSSet setWithArray:themes]];
-                                           for (Theme *deleteTheme in unsyncedWPThemes) {
-                                               if (![blogInContext.currentThemeId isEqualToString:deleteTheme.themeId]) {
-                                                   [context deleteObject:deleteTheme];
-                                               }
-                                           }
+                                           [catalogueSync deleteUnmergedThemesForBlog:blogInContext inContext:context];
                                        }
                                        [context obtainPermanentIDsForObjects:themes error:nil];
                                        themeObjectIDs = [themes wp_map:^id(Theme *obj) {
@@ -218,20 +112,15 @@ const NSInteger ThemeOrderTrailing = 9999;
         return [remote getThemesForBlogId:[blog dotComID]
                                      page:page
                                   success:^(NSArray<RemoteTheme *> *remoteThemes, BOOL hasMore, NSInteger totalThemeCount) {
+                                      ThemeCatalogueSync *catalogueSync = [[ThemeCatalogueSync alloc] initWithScope:ThemeCatalogueSyncScopeAll];
                                       NSArray * __block themeObjectIDs = nil;
                                       [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
                                           Blog *blogInContext = [context existingObjectWithID:blog.objectID error:nil];
-                                          NSArray *themes = [self themesFromRemoteThemes:remoteThemes
-                                                                                 forBlog:blogInContext
-                                                                               inContext:context];
+                                          NSArray *themes = [catalogueSync mergeRemoteThemes:remoteThemes
+                                                                                      forBlog:blogInContext
+                                                                                    inContext:context];
                                           if (sync) {
-                                              NSMutableSet *unsyncedThemes = [NSMutableSet setWithSet:blogInContext.themes];
-                                              [unsyncedThemes minusSet:[NSSet setWithArray:themes]];
-                                              for (Theme *deleteTheme in unsyncedThemes) {
-                                                  if (![blogInContext.currentThemeId isEqualToString:deleteTheme.themeId]) {
-                                                      [context deleteObject:deleteTheme];
-                                                  }
-                                              }
+                                              [catalogueSync deleteUnmergedThemesForBlog:blogInContext inContext:context];
                                           }
                                           [context obtainPermanentIDsForObjects:themes error:nil];
                                           themeObjectIDs = [themes wp_map:^id(Theme *obj) {
@@ -266,6 +155,7 @@ const NSInteger ThemeOrderTrailing = 9999;
 
     return [remote getCustomThemesForBlogId:[blog dotComID]
                                     success:^(NSArray<RemoteTheme *> *remoteThemes, BOOL hasMore, NSInteger totalThemeCount) {
+                                        ThemeCatalogueSync *catalogueSync = [[ThemeCatalogueSync alloc] initWithScope:ThemeCatalogueSyncScopeCustom];
                                         NSArray * __block themeObjectIDs = nil;
                                         [self.coreDataStack performAndSaveUsingBlock:^(NSManagedObjectContext *context) {
                                             Blog *blogInContext = [context existingObjectWithID:blog.objectID error:nil];
@@ -278,24 +168,12 @@ const NSInteger ThemeOrderTrailing = 9999;
                                                 }
                                             }
 
-                                            NSArray *themes = [self customThemesFromRemoteThemes:validRemoteThemes
-                                                                                         forBlog:blogInContext
-                                                                                       inContext:context];
+                                            NSArray *themes = [catalogueSync mergeRemoteThemes:validRemoteThemes
+                                                                                       forBlog:blogInContext
+                                                                                     inContext:context];
                                             if (sync) {
                                                 // We don't want to touch WP.com themes here, only custom themes
-                                                NSMutableSet *unsyncedThemes = [NSMutableSet setWithSet:blogInContext.themes];
-                                                NSMutableSet *unsyncedCustomThemes = [unsyncedThemes mutableCopy];
-                                                for (Theme *theme in unsyncedThemes) {
-                                                    if (!theme.custom) {
-                                                        [unsyncedCustomThemes removeObject:theme];
-                                                    }
-                                                }
-                                                [unsyncedCustomThemes minusSet:[NSSet setWithArray:themes]];
-                                                for (Theme *deleteTheme in unsyncedCustomThemes) {
-                                                    if (![blogInContext.currentThemeId isEqualToString:deleteTheme.themeId]) {
-                                                        [context deleteObject:deleteTheme];
-                                                    }
-                                                }
+                                                [catalogueSync deleteUnmergedThemesForBlog:blogInContext inContext:context];
                                             }
 
                                             [context obtainPermanentIDsForObjects:themes error:nil];
@@ -475,97 +353,10 @@ const NSInteger ThemeOrderTrailing = 9999;
                       inContext:(NSManagedObjectContext *)context
 {
     NSParameterAssert([remoteTheme isKindOfClass:[RemoteTheme class]]);
-    
-    Theme *theme = [self findOrCreateThemeWithId:remoteTheme.themeId forBlog:blog inContext:context];
-    
-    if (remoteTheme.author) {
-        theme.author = remoteTheme.author;
-        theme.authorUrl = remoteTheme.authorUrl;
-    }
-    theme.demoUrl = remoteTheme.demoUrl;
-    theme.themeUrl = remoteTheme.themeUrl;
-    theme.details = remoteTheme.desc;
-    theme.launchDate = remoteTheme.launchDate;
-    theme.name = remoteTheme.name;
-    if (remoteTheme.order != ThemeOrderUnspecified) {
-        theme.order = @(remoteTheme.order);
-    } else if (theme.order.integerValue == ThemeOrderUnspecified) {
-        theme.order = @(ThemeOrderTrailing);
-    }
-    theme.popularityRank = remoteTheme.popularityRank;
-    theme.previewUrl = remoteTheme.previewUrl;
-    BOOL availableFree = remoteTheme.purchased.boolValue || ![remoteTheme.type isEqualToString:@"managed-external"];
-    theme.premium = @(!availableFree);
-    theme.price = remoteTheme.price;
-    theme.purchased = remoteTheme.purchased;
-    theme.screenshotUrl = remoteTheme.screenshotUrl;
-    theme.stylesheet = remoteTheme.stylesheet;
-    theme.themeId = remoteTheme.themeId;
-    theme.trendingRank = remoteTheme.trendingRank;
-    theme.version = remoteTheme.version;
-    
-    if (blog && remoteTheme.active) {
-        blog.currentThemeId = theme.themeId;
-    }
-    
-    return theme;
-}
-
-/**
- *  @brief      Updates our local themes matching the specified remote themes.
- *  @details    If the local themes do not exist, they are created.
- *
- *  @param      remoteThemes    An array with the remote themes containing the data to update
- *                              locally.  Cannot be nil.
- *  @param      blog            Blog being updated. May be nil for account.
- *  @param      ordered         Whether to update displayed order
- *
- *  @returns    An array with the updated and matching local themes.
- */
-- (NSArray<Theme *> *)themesFromRemoteThemes:(NSArray<RemoteTheme *> *)remoteThemes
-                                     forBlog:(nullable Blog *)blog
-                                   inContext:(NSManagedObjectContext *)context
-{
-    return [self themesFromRemoteThemes:remoteThemes custom:NO forBlog:blog inContext:context];
-}
-
-/**
- *  @brief      Updates our local themes matching the specified remote themes.
- *  @details    If the local themes do not exist, they are created.
- *
- *  @param      remoteThemes    An array with the remote custom themes containing the data to update
- *                              locally.  Cannot be nil.
- *  @param      blog            Blog being updated. May be nil for account.
- *  @param      ordered         Whether to update displayed order
- *
- *  @returns    An array with the updated and matching local themes.
- */
-- (NSArray<Theme *> *)customThemesFromRemoteThemes:(NSArray<RemoteTheme *> *)remoteThemes
-                                           forBlog:(nullable Blog *)blog
-                                         inContext:(NSManagedObjectContext *)context
-{
-    return [self themesFromRemoteThemes:remoteThemes custom:YES forBlog:blog inContext:context];
-}
-
-- (NSArray<Theme *> *)themesFromRemoteThemes:(NSArray<RemoteTheme *> *)remoteThemes
-                                      custom:(BOOL)custom
-                                     forBlog:(nullable Blog *)blog
-                                   inContext:(NSManagedObjectContext *)context
-{
-    NSParameterAssert([remoteThemes isKindOfClass:[NSArray class]]);
-
-    NSMutableArray *themes = [[NSMutableArray alloc] initWithCapacity:remoteThemes.count];
-
-    [remoteThemes enumerateObjectsUsingBlock:^(RemoteTheme *remoteTheme, NSUInteger __unused idx, BOOL * __unused stop) {
-        NSAssert([remoteTheme isKindOfClass:[RemoteTheme class]],
-                 @"Expected a remote theme.");
-
-        Theme *theme = [self themeFromRemoteTheme:remoteTheme forBlog:blog inContext:context];
-        theme.custom = custom;
-        [themes addObject:theme];
-    }];
 
-    return [NSArray arrayWithArray:themes];
+    return [[ThemeCatalogueSync themesFromRemoteThemes:@[remoteTheme]
+                                               forBlog:blog
+                                             inContext:context] firstObject];
 }
 
 @end
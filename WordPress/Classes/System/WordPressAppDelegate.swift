@@ -293,6 +293,9 @@ public class WordPressAppDelegate: UIResponder, UIApplicationDelegate {
         updateFeatureFlags()
         updateRemoteConfig()
 
+        // Pick up the batch request changes made by the background tasks while the UI wasn't updated.
+        ContextManager.shared.mergePersistentHistory()
+
         // Skip the migration check on the call that follows the initial scene
         // connect: the window phase already ran it via `windowManager.showUI()`,
         // and running it twice emits its analytics event twice per launch. Scene
@@ -400,6 +403,7 @@ public class WordPressAppDelegate: UIResponder, UIApplicationDelegate {
                 self?.mergeDuplicateAccountsIfNeeded()
                 MediaCoordinator.shared.refreshMediaStatus()
                 MediaFileManager.clearUnusedMediaUploadFiles(onCompletion: nil, onError: nil)
+                MediaFileManager.evictExpiredMediaCacheFiles()
             }
 
         DispatchQueue.main.asyncAfter(deadline: .now() + 3) {
@@ -1,5 +1,7 @@
 import Foundation
 import AutomatticTracks
+import CocoaLumberjackSwift
+import os
 import WordPressData
 import WordPressShared
 import BuildSettingsKit
@@ -9,6 +11,12 @@ import BuildSettingsKit
     private let tracksService: TracksService
     private var userProperties: [String: Any] = [:]
     private var appURLScheme: String
+    /// Read when the tracker is created because the trackers are called on a
+    /// background queue.
+    private let isRTLLanguage: Bool
+    /// Updated on the main thread, where `UIAccessibility` has to be read.
+    private let isVoiceOverRunning: OSAllocatedUnfairLock<Bool>
+    private var voiceOverObserver: NSObjectProtocol?
     private var cachedAnonymousUserID: String?
     private var cachedCurrentUserID: String?
 
@@ -31,6 +39,22 @@ import BuildSettingsKit
         tracksService.eventNamePrefix = eventNamePrefix
         tracksService.platform = platform
         self.appURLScheme = appURLScheme
+        self.isRTLLanguage = UIApplication.shared.userInterfaceLayoutDirection == .rightToLeft
+        let isVoiceOverRunning = OSAllocatedUnfairLock(initialState: UIAccessibility.isVoiceOverRunning)
+        self.isVoiceOverRunning = isVoiceOverRunning
+        super.init()
+        voiceOverObserver = NotificationCenter.default.addObserver(
+            forName: UIAccessibility.voiceOverStatusDidChangeNotification,
+            object: nil,
+            queue: .main
+        ) { _ in
+            let isRunning = UIAccessibility.isVoiceOverRunning
+            isVoiceOverRunning.withLock { $0 = isRunning }
+        }
+    }
+
+    deinit {
+        voiceOverObserver.map(NotificationCenter.default.removeObserver)
     }
 
     // MARK: - WPAnalyticsTracker
@@ -40,14 +64,20 @@ import BuildSettingsKit
     }
 
     public func track(_ stat: WPAnalyticsStat, withProperties properties: [AnyHashable: Any]?) {
-        guard let event = TracksMappedEvent.make(for: stat) else {
+        guard let event = TracksMappedEvent.cached(for: stat) else {
             DDLogInfo("WPAnalyticsStat not supported by AnalyticsTrackerAutomatticTracks: \(stat)")
             return
         }
 
-        let properties = (event.properties ?? [:])
-            .merging(properties ?? [:]) { _, new in new }
-        trackString(event.name, withProperties: properties)
+        // Avoid copying the dictionaries when there is nothing to merge
+        let mergedProperties: [AnyHashable: Any]?
+        switch (event.properties, properties) {
+        case let (lhs?, rhs?):
+            mergedProperties = lhs.merging(rhs) { _, new in new }
+        case let (lhs, rhs):
+            mergedProperties = lhs ?? rhs
+        }
+        trackString(event.name, withProperties: mergedProperties)
     }
 
     public func trackString(_ event: String) {
@@ -55,7 +85,9 @@ import BuildSettingsKit
     }
 
     public func trackString(_ event: String, withProperties properties: [AnyHashable: Any]?) {
-        DDLogInfo("\(makeLogMessage(for: event, properties: properties))")
+        if DDLogFlag.from(dynamicLogLevel).contains(.info) {
+            DDLogInfo("\(makeLogMessage(for: event, properties: properties))")
+        }
         tracksService.trackEventName(event, withCustomProperties: properties)
     }
 
@@ -98,7 +130,8 @@ import BuildSettingsKit
     }
 
     @objc public func refreshMetadata() {
-        let session = getSessionInfo(in: ContextManager.shared.mainContext)
+        // Called on the analytics queue, which must not wait for the main thread.
+        let session = getSessionInfo(in: ContextManager.shared.newDerivedContext())
 
         if let username = session.username, UUID(uuidString: username) != nil {
             // User has authenticated but we're waiting for account details to sync.
@@ -107,7 +140,7 @@ import BuildSettingsKit
             return
         }
 
-        let userProperties = makeUserProperties(with: session)
+        let userProperties = makeUserProperties(with: session, isVoiceOverRunning: isVoiceOverRunning.withLock { $0 })
         tracksService.userProperties.removeAllObjects()
         tracksService.userProperties.addEntries(from: userProperties)
 
@@ -178,15 +211,15 @@ import BuildSettingsKit
         }
     }
 
-    private func makeUserProperties(with info: SessionInfo) -> [String: Any] {
+    private func makeUserProperties(with info: SessionInfo, isVoiceOverRunning: Bool) -> [String: Any] {
         return [
             "app_scheme": WPAnalyticsTesting.appURLScheme ?? appURLScheme,
             "platform": "iOS",
             "dotcom_user": info.isDotcomUser,
             "jetpack_user": info.hasJetpackBlogs,
             "number_of_blogs": info.blogCount,
-            "accessibility_voice_over_enabled": UIAccessibility.isVoiceOverRunning,
-            "is_rtl_language": UIApplication.shared.userInterfaceLayoutDirection == .rightToLeft,
+            "accessibility_voice_over_enabled": isVoiceOverRunning,
+            "is_rtl_language": isRTLLanguage,
             "gutenberg_enabled": info.isGutenbergEnabled,
         ]
     }
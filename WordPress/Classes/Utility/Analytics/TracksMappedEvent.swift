@@ -7,6 +7,25 @@ struct TracksMappedEvent {
 }
 
 extension TracksMappedEvent {
+    /// The events for every stat, indexed by the raw value of the stat.
+    ///
+    /// The table is built once, so tracking a stat doesn't allocate the
+    /// event names and properties every time.
+    private static let table: [TracksMappedEvent?] = {
+        (0..<WPAnalyticsStat.maxValue.rawValue).map {
+            WPAnalyticsStat(rawValue: $0).flatMap(TracksMappedEvent.make(for:))
+        }
+    }()
+
+    /// Returns the memoized event for the given stat.
+    static func cached(for stat: WPAnalyticsStat) -> TracksMappedEvent? {
+        let index = Int(stat.rawValue)
+        guard index < table.count else {
+            return make(for: stat)
+        }
+        return table[index]
+    }
+
     static func make(for stat: WPAnalyticsStat) -> TracksMappedEvent? {
         let name: String
         var properties: [AnyHashable: Any]?
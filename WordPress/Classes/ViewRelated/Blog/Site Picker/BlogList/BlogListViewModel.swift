@@ -99,6 +99,13 @@ final class BlogListViewModel: NSObject, ObservableObject {
             wpAssertionFailure("sites-fetch-failed", userInfo: ["error": "\(error)"])
         }
         updateDisplayedSites()
+        prefetchPasswords()
+    }
+
+    /// Loads the passwords of the self-hosted sites in the background, as every request reads them.
+    private func prefetchPasswords() {
+        let serviceNames = rawSites.filter { $0.account == nil }.compactMap(\.xmlrpc)
+        KeychainCredentialCache.shared.prefetchPasswords(forServiceNames: serviceNames)
     }
 
     func updateDisplayedSites() {